@@ -28,10 +28,13 @@
 #include <stdarg.h>
 #include <limits.h>
 #include <time.h>
+#include <sys/ioctl.h>
 
 #include <isula_libutils/utils_memory.h>
 #include <isula_libutils/utils_file.h>
 
+#define SPLICE_RETRY_INTERVAL_US 100
+
 int g_log_fd = -1;
 
 int init_shim_log(void)
@@ -272,3 +275,55 @@ int open_no_inherit(const char *path, int flag, mode_t mode)
 
     return fd;
 }
+
+int shim_forward_in_kernel(int fd, int *fd_to, size_t len, bool keep_data, bool block_read, ssize_t *moved)
+{
+    ssize_t n = 0;
+    int avail = 0;
+
+    if (fd_to == NULL || *fd_to < 0 || moved == NULL) {
+        return SHIM_FORWARD_FALLBACK;
+    }
+
+    for (;;) {
+        if (keep_data) {
+            n = tee(fd, *fd_to, len, SPLICE_F_NONBLOCK);
+        } else {
+            n = splice(fd, NULL, *fd_to, NULL, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        }
+        if (n > 0) {
+            *moved = n;
+            return SHIM_FORWARD_DONE;
+        }
+        if (n == 0) {
+            return SHIM_FORWARD_EOF;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EINVAL) {
+            // tee needs pipes on both sides, splice needs one
+            return SHIM_FORWARD_UNSUPPORTED;
+        }
+        if (errno != EAGAIN) {
+            /* When any error occurs, set the write fd -1  */
+            write_message(WARN_MSG, "splice to fd %d error:%d", *fd_to, SHIM_SYS_ERR(errno));
+            close(*fd_to);
+            *fd_to = -1;
+            return SHIM_FORWARD_FALLBACK;
+        }
+        if (ioctl(fd, FIONREAD, &avail) != 0) {
+            return SHIM_FORWARD_FALLBACK;
+        }
+        if (avail == 0) {
+            // nothing to read, same as read returns EAGAIN
+            if (!block_read) {
+                return SHIM_FORWARD_EOF;
+            }
+            *moved = 0;
+            return SHIM_FORWARD_DONE;
+        }
+        // fd_to is full, wait for the reader as write does
+        usleep(SPLICE_RETRY_INTERVAL_US);
+    }
+}
@@ -55,6 +55,7 @@ extern "C" {
 
 #define SHIM_BINARY "isulad-shim"
 #define SHIM_LOG_NAME "shim-log.json"
+#define SHIM_PID_SYNC_NAME "pid-sync"
 
 #define CONTAINER_ACTION_REBOOT 129
 #define CONTAINER_ACTION_SHUTDOWN 130
@@ -102,6 +103,22 @@ void close_fd(int *pfd);
 
 int open_no_inherit(const char *path, int flag, mode_t mode);
 
+enum {
+    SHIM_FORWARD_DONE = 0,
+    SHIM_FORWARD_EOF,
+    SHIM_FORWARD_FALLBACK,
+    // the fds do not support splice/tee, the caller should copy data in user space
+    SHIM_FORWARD_UNSUPPORTED,
+};
+
+/*
+ * Move at most len bytes from fd to *fd_to inside kernel. If keep_data is true, tee the data
+ * and leave it in fd to be read later, otherwise splice it. *fd_to is closed and set to -1 on
+ * write error. If nothing is readable, return SHIM_FORWARD_DONE with *moved 0 when block_read,
+ * otherwise SHIM_FORWARD_EOF.
+ */
+int shim_forward_in_kernel(int fd, int *fd_to, size_t len, bool keep_data, bool block_read, ssize_t *moved);
+
 #ifdef __cplusplus
 }
 #endif
@@ -153,6 +153,7 @@ int main(int argc, char **argv)
     }
 
     ret = create_process(p);
+    notify_create_result(p, ret);
     if (ret != SHIM_OK) {
         if (p->console_sock_path != NULL) {
             (void)unlink(p->console_sock_path);
@@ -168,12 +168,46 @@ static int sync_exit_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr
     return EPOLL_LOOP_HANDLE_CLOSE;
 }
 
+/*
+ * Move data from fd to *fd_to inside kernel. If splice is not supported by the fds
+ * of this stream, copy data of it in user space for ever, other streams keep splicing.
+ */
+static int forward_in_kernel(process_t *p, int std_id, int fd, int *fd_to, bool keep_data, ssize_t *moved)
+{
+    int ret = shim_forward_in_kernel(fd, fd_to, DEFAULT_IO_COPY_BUF, keep_data, p->block_read, moved);
+
+    if (ret == SHIM_FORWARD_UNSUPPORTED) {
+        p->no_splice[std_id] = true;
+        return SHIM_FORWARD_FALLBACK;
+    }
+
+    return ret;
+}
+
+static ssize_t read_exactly(int fd, char *buf, size_t len)
+{
+    size_t nread = 0;
+    ssize_t n = 0;
+
+    while (nread < len) {
+        n = isula_file_read_nointr(fd, buf + nread, len - nread);
+        if (n <= 0) {
+            break;
+        }
+        nread += (size_t)n;
+    }
+
+    return nread > 0 ? (ssize_t)nread : n;
+}
+
 static int stdin_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
 {
     process_t *p = (process_t *)cbdata;
     int r_count = 0;
     int w_count = 0;
     int *fd_to = NULL;
+    int ret = SHIM_FORWARD_FALLBACK;
+    ssize_t moved = 0;
 
     if (events & EPOLLHUP) {
         return EPOLL_LOOP_HANDLE_CLOSE;
@@ -183,20 +217,28 @@ static int stdin_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
 
-    (void)memset(p->buf, 0, DEFAULT_IO_COPY_BUF);
-
-    r_count = isula_file_read_nointr(fd, p->buf, DEFAULT_IO_COPY_BUF);
-    if (r_count <= 0) {
-        return EPOLL_LOOP_HANDLE_CLOSE;
-    }
-
     if (p->state->terminal) {
         fd_to = &(p->recv_fd);
     } else {
         fd_to = &(p->shim_io->in);
     }
 
-    if (fd_to == NULL || *fd_to == -1) {
+    if (!p->no_splice[STDID_IN] && *fd_to != -1) {
+        ret = forward_in_kernel(p, STDID_IN, fd, fd_to, false, &moved);
+        if (ret == SHIM_FORWARD_EOF) {
+            return EPOLL_LOOP_HANDLE_CLOSE;
+        }
+        if (ret == SHIM_FORWARD_DONE) {
+            return EPOLL_LOOP_HANDLE_CONTINUE;
+        }
+    }
+
+    r_count = isula_file_read_nointr(fd, p->buf, DEFAULT_IO_COPY_BUF);
+    if (r_count <= 0) {
+        return EPOLL_LOOP_HANDLE_CLOSE;
+    }
+
+    if (*fd_to == -1) {
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
     w_count = isula_file_total_write_nointr(*fd_to, p->buf, r_count);
@@ -210,22 +252,34 @@ static int stdin_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *
     return EPOLL_LOOP_HANDLE_CONTINUE;
 }
 
-static int stdout_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
+static int forward_output(process_t *p, int fd, int std_id, int *fd_to)
 {
-    process_t *p = (process_t *)cbdata;
+    int ret = SHIM_FORWARD_FALLBACK;
+    ssize_t moved = 0;
     int r_count = 0;
     int w_count = 0;
+    bool log_enabled = p->terminal != NULL && p->terminal->log_path != NULL;
 
-    if (events & EPOLLHUP) {
-        return EPOLL_LOOP_HANDLE_CLOSE;
+    if (!p->no_splice[std_id] && *fd_to != -1) {
+        ret = forward_in_kernel(p, std_id, fd, fd_to, log_enabled, &moved);
+        if (ret == SHIM_FORWARD_EOF) {
+            return EPOLL_LOOP_HANDLE_CLOSE;
+        }
+        if (ret == SHIM_FORWARD_DONE && (!log_enabled || moved == 0)) {
+            return EPOLL_LOOP_HANDLE_CONTINUE;
+        }
     }
 
-    if (!(events & EPOLLIN)) {
+    if (ret == SHIM_FORWARD_DONE) {
+        // data has been sent to isulad by tee, consume the same bytes for container log
+        r_count = (int)read_exactly(fd, p->buf, (size_t)moved);
+        if (r_count <= 0) {
+            return EPOLL_LOOP_HANDLE_CLOSE;
+        }
+        shim_write_container_log_file(p->terminal, std_id, p->buf, r_count);
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
 
-    (void)memset(p->buf, 0, DEFAULT_IO_COPY_BUF);
-
     if (p->block_read) {
         r_count = isula_file_read_nointr(fd, p->buf, DEFAULT_IO_COPY_BUF);
     } else {
@@ -235,28 +289,26 @@ static int stdout_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t
         return EPOLL_LOOP_HANDLE_CLOSE;
     }
 
-    shim_write_container_log_file(p->terminal, STDID_OUT, p->buf, r_count);
+    shim_write_container_log_file(p->terminal, std_id, p->buf, r_count);
 
-    if (p->isulad_io->out == -1) {
+    if (*fd_to == -1) {
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
 
-    w_count = isula_file_total_write_nointr(p->isulad_io->out, p->buf, r_count);
+    w_count = isula_file_total_write_nointr(*fd_to, p->buf, r_count);
     if (w_count < 0) {
         /* When any error occurs, set the write fd -1  */
-        write_message(WARN_MSG, "write out_fd %d error:%d", p->isulad_io->out, SHIM_SYS_ERR(errno));
-        close(p->isulad_io->out);
-        p->isulad_io->out = -1;
+        write_message(WARN_MSG, "write fd %d error:%d", *fd_to, SHIM_SYS_ERR(errno));
+        close(*fd_to);
+        *fd_to = -1;
     }
 
     return EPOLL_LOOP_HANDLE_CONTINUE;
 }
 
-static int stderr_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
+static int stdout_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
 {
     process_t *p = (process_t *)cbdata;
-    int r_count = 0;
-    int w_count = 0;
 
     if (events & EPOLLHUP) {
         return EPOLL_LOOP_HANDLE_CLOSE;
@@ -266,32 +318,22 @@ static int stderr_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
 
-    (void)memset(p->buf, 0, DEFAULT_IO_COPY_BUF);
+    return forward_output(p, fd, STDID_OUT, &p->isulad_io->out);
+}
 
-    if (p->block_read) {
-        r_count = isula_file_read_nointr(fd, p->buf, DEFAULT_IO_COPY_BUF);
-    } else {
-        r_count = read(fd, p->buf, DEFAULT_IO_COPY_BUF);
-    }
-    if (r_count <= 0) {
+static int stderr_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
+{
+    process_t *p = (process_t *)cbdata;
+
+    if (events & EPOLLHUP) {
         return EPOLL_LOOP_HANDLE_CLOSE;
     }
 
-    shim_write_container_log_file(p->terminal, STDID_ERR, p->buf, r_count);
-
-    if (p->isulad_io->err == -1) {
+    if (!(events & EPOLLIN)) {
         return EPOLL_LOOP_HANDLE_CONTINUE;
     }
 
-    w_count = isula_file_total_write_nointr(p->isulad_io->err, p->buf, r_count);
-    if (w_count < 0) {
-        /* When any error occurs, set the write fd -1  */
-        write_message(WARN_MSG, "write err_fd %d error:%d", p->isulad_io->err, SHIM_SYS_ERR(errno));
-        close(p->isulad_io->err);
-        p->isulad_io->err = -1;
-    }
-
-    return EPOLL_LOOP_HANDLE_CONTINUE;
+    return forward_output(p, fd, STDID_ERR, &p->isulad_io->err);
 }
 
 static int resize_cb(int fd, uint32_t events, void *cbdata, isula_epoll_descr_t *descr)
@@ -1217,6 +1259,42 @@ out:
     return ret;
 }
 
+/*
+ * isulad waits on the pid-sync fifo instead of polling the pid file, tell it
+ * the container process pid, or -1 if the runtime failed. The fifo only exists
+ * for container create and nobody may be reading it, so errors are ignored and
+ * isulad falls back to the pid file.
+ */
+void notify_create_result(const process_t *p, int result)
+{
+    int fd = -1;
+    int nret = 0;
+    char data[32] = { 0 };
+
+    if (p->state->exec) {
+        return;
+    }
+
+    fd = open_no_inherit(SHIM_PID_SYNC_NAME, O_WRONLY | O_NONBLOCK, -1);
+    if (fd < 0) {
+        if (errno != ENOENT && errno != ENXIO) {
+            write_message(WARN_MSG, "open pid sync fifo failed:%d", SHIM_SYS_ERR(errno));
+        }
+        return;
+    }
+
+    nret = snprintf(data, sizeof(data), "%d", result == SHIM_OK ? p->ctr_pid : -1);
+    if (nret < 0 || (size_t)nret >= sizeof(data)) {
+        close(fd);
+        return;
+    }
+
+    if (isula_file_write_nointr(fd, data, (size_t)nret) != nret) {
+        write_message(WARN_MSG, "write pid sync fifo failed:%d", SHIM_SYS_ERR(errno));
+    }
+    close(fd);
+}
+
 static int try_wait_all_child(void)
 {
     if (waitpid(-1, NULL, WNOHANG) == -1 && errno == ECHILD) {
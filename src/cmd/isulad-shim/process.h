@@ -54,6 +54,8 @@ typedef struct process {
     int listen_fd;
     int recv_fd;
     bool block_read;
+    // fds of the stream do not support splice/tee, copy its data in user space, index by STDID_*
+    bool no_splice[STDID_ERR + 1];
     log_terminal *terminal;
     stdio_t *stdio; // shim to on runtime side, in:r out/err: w
     stdio_t *shim_io; // shim io on isulad side, in: w  out/err: r
@@ -72,6 +74,7 @@ process_t* new_process(char *id, char *bundle, char *runtime);
 
 int process_io_start(process_t *p, pthread_t *tid_epoll);
 int create_process(process_t *p);
+void notify_create_result(const process_t *p, int result);
 int process_signal_handle_routine(process_t *p, const pthread_t tid_epoll, const uint64_t timeout);
 
 #ifdef __cplusplus
@@ -82,9 +82,18 @@
 #include "network_api.h"
 #endif
 #include "id_name_manager.h"
+#include "rpc_stats.h"
 
 sem_t g_daemon_shutdown_sem;
 sem_t g_daemon_wait_shutdown_sem;
+static sem_t g_rpc_stats_dump_sem;
+
+#if defined (__ANDROID__) || defined(__MUSL__)
+/* SIGUSR1 emulates pthread_cancel on these platforms, see execution_stream.c */
+#define RPC_STATS_DUMP_SIGNAL SIGUSR2
+#else
+#define RPC_STATS_DUMP_SIGNAL SIGUSR1
+#endif
 
 static int create_client_run_path(const char *group)
 {
@@ -326,10 +335,43 @@ static int ignore_signals()
         return -1;
     }
 
+    /*
+     * SIGUSR1 emulates pthread_cancel on musl and android, its default action must not kill isulad.
+     * Where it is RPC_STATS_DUMP_SIGNAL, the handler is installed after this.
+     */
     if (sigaction(SIGUSR1, &sa, NULL) < 0) {
         ERROR("Failed to ignore SIGUSR1");
         return -1;
     }
+
+    return 0;
+}
+
+static void rpc_stats_dump_handler(int signo)
+{
+    sem_post(&g_rpc_stats_dump_sem);
+}
+
+/* RPC_STATS_DUMP_SIGNAL dumps rpc statistics to the log */
+static int add_rpc_stats_dump_signal_handler()
+{
+    struct sigaction sa;
+
+    if (sem_init(&g_rpc_stats_dump_sem, 0, 0) == -1) {
+        ERROR("Failed to init rpc stats dump sem");
+        return -1;
+    }
+
+    (void)memset(&sa, 0, sizeof(struct sigaction));
+
+    sa.sa_handler = rpc_stats_dump_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(RPC_STATS_DUMP_SIGNAL, &sa, NULL) < 0) {
+        ERROR("Failed to add handler for signal %d", RPC_STATS_DUMP_SIGNAL);
+        return -1;
+    }
+
     return 0;
 }
 
@@ -388,6 +430,11 @@ static int add_sighandler()
         return -1;
     }
 
+    if (add_rpc_stats_dump_signal_handler() != 0) {
+        ERROR("Failed to add rpc stats dump signal");
+        return -1;
+    }
+
     return 0;
 }
 
@@ -1629,6 +1676,41 @@ out:
     return ret;
 }
 
+/* rpc stats dump handler */
+static void *do_rpc_stats_dump_handler(void *arg)
+{
+    if (pthread_detach(pthread_self()) != 0) {
+        CRIT("Set thread detach fail");
+    }
+
+    prctl(PR_SET_NAME, "RpcStatsDump");
+
+    for (;;) {
+        if (sem_wait(&g_rpc_stats_dump_sem) != 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SYSERROR("Failed to wait rpc stats dump sem");
+            break;
+        }
+        rpc_stats_dump_to_log();
+    }
+
+    return NULL;
+}
+
+static int new_rpc_stats_dump_handler()
+{
+    pthread_t dump_thread;
+
+    if (pthread_create(&dump_thread, NULL, do_rpc_stats_dump_handler, NULL) != 0) {
+        CRIT("Thread creation failed");
+        return -1;
+    }
+
+    return 0;
+}
+
 static int start_daemon_threads()
 {
     int ret = -1;
@@ -1638,6 +1720,11 @@ static int start_daemon_threads()
         goto out;
     }
 
+    if (new_rpc_stats_dump_handler()) {
+        ERROR("Create rpc stats dump handler thread failed");
+        goto out;
+    }
+
     if (events_module_init() != 0) {
         goto out;
     }
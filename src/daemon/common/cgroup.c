@@ -45,6 +45,10 @@
 #define CGROUP2_HUGETLB_MAX "hugetlb.%s.max"
 #define CGROUP2_PIDS_MAX "pids.max"
 #define CGROUP2_FILES_LIMIT "files.limit"
+#define CGROUP2_CPU_STAT "cpu.stat"
+#define CGROUP2_MEMORY_CURRENT "memory.current"
+#define CGROUP2_MEMORY_STAT "memory.stat"
+#define CGROUP2_PIDS_CURRENT "pids.current"
 
 #define CGROUP2_CONTROLLERS_PATH CGROUP_MOUNTPOINT"/cgroup.controllers"
 #define CGROUP2_SUBTREE_CONTROLLER_PATH CGROUP_MOUNTPOINT"/cgroup.subtree_control"
@@ -792,3 +796,209 @@ out:
 
     return ret;
 }
+
+/* expand a systemd slice to its path like runc does, "a-b.slice" is "/a.slice/a-b.slice" */
+static int expand_systemd_slice(const char *slice, size_t slice_len, char *path, size_t len)
+{
+    const size_t suffix_len = strlen(".slice");
+    size_t name_len = 0;
+    size_t used = 0;
+    size_t start = 0;
+    size_t i;
+    int nret = 0;
+
+    if (slice_len <= suffix_len || strncmp(slice + slice_len - suffix_len, ".slice", suffix_len) != 0 ||
+        memchr(slice, '/', slice_len) != NULL) {
+        return -1;
+    }
+
+    path[0] = '\0';
+    name_len = slice_len - suffix_len;
+    // the root slice
+    if (name_len == 1 && slice[0] == '-') {
+        return 0;
+    }
+
+    for (i = 0; i <= name_len; i++) {
+        if (i < name_len && slice[i] != '-') {
+            continue;
+        }
+        if (i == start) {
+            return -1;
+        }
+        nret = snprintf(path + used, len - used, "/%.*s.slice", (int)i, slice);
+        if (nret < 0 || (size_t)nret >= len - used) {
+            return -1;
+        }
+        used += (size_t)nret;
+        start = i + 1;
+    }
+
+    return 0;
+}
+
+char *common_cgroup_path_from_oci(const char *cgroups_path)
+{
+    const char *first = NULL;
+    const char *second = NULL;
+    const char *name = NULL;
+    const char *slice = "system.slice";
+    size_t slice_len = strlen(slice);
+    char slice_path[PATH_MAX] = { 0 };
+    char path[PATH_MAX] = { 0 };
+    int nret = 0;
+
+    if (cgroups_path == NULL) {
+        return NULL;
+    }
+
+    first = strchr(cgroups_path, ':');
+    if (cgroups_path[0] == '/' || first == NULL) {
+        return util_strdup_s(cgroups_path);
+    }
+
+    // systemd driver, "slice:prefix:name"
+    second = strchr(first + 1, ':');
+    if (second == NULL || strchr(second + 1, ':') != NULL || second[1] == '\0') {
+        ERROR("Invalid systemd cgroup path %s", cgroups_path);
+        return NULL;
+    }
+    if (first != cgroups_path) {
+        slice = cgroups_path;
+        slice_len = (size_t)(first - cgroups_path);
+    }
+    if (expand_systemd_slice(slice, slice_len, slice_path, sizeof(slice_path)) != 0) {
+        ERROR("Invalid systemd slice in cgroup path %s", cgroups_path);
+        return NULL;
+    }
+
+    name = second + 1;
+    if (util_has_suffix(name, ".slice")) {
+        nret = snprintf(path, sizeof(path), "%s/%s", slice_path, name);
+    } else {
+        nret = snprintf(path, sizeof(path), "%s/%.*s-%s.scope", slice_path, (int)(second - first - 1), first + 1, name);
+    }
+    if (nret < 0 || (size_t)nret >= sizeof(path)) {
+        ERROR("Cgroup path %s is too long", cgroups_path);
+        return NULL;
+    }
+
+    return util_strdup_s(path);
+}
+
+/* read a single value file, "max" is reported as UINT64_MAX like the cgroup v1 unlimited value */
+static void get_cgroup_v2_value(const char *path, const char *file, uint64_t *value)
+{
+    int nret = 0;
+    char fpath[PATH_MAX] = { 0 };
+    __isula_auto_free char *content = NULL;
+
+    nret = snprintf(fpath, sizeof(fpath), "%s/%s", path, file);
+    if (nret < 0 || (size_t)nret >= sizeof(fpath)) {
+        ERROR("Failed to snprintf");
+        return;
+    }
+
+    content = util_read_content_from_file(fpath);
+    if (content == NULL) {
+        WARN("Failed to read %s", fpath);
+        return;
+    }
+    util_trim_newline(content);
+
+    if (strcmp(content, "max") == 0) {
+        *value = UINT64_MAX;
+        return;
+    }
+
+    if (util_safe_uint64(content, value) != 0) {
+        WARN("Invalid value %s in %s", content, fpath);
+    }
+}
+
+/* read the values of the given keys from a flat keyed file such as cpu.stat or memory.stat */
+static void get_cgroup_v2_keyed_values(const char *path, const char *file, const char **keys, uint64_t **values,
+                                       size_t len)
+{
+    int nret = 0;
+    size_t i;
+    char fpath[PATH_MAX] = { 0 };
+    char *line = NULL;
+    char *saveptr = NULL;
+    __isula_auto_free char *content = NULL;
+
+    nret = snprintf(fpath, sizeof(fpath), "%s/%s", path, file);
+    if (nret < 0 || (size_t)nret >= sizeof(fpath)) {
+        ERROR("Failed to snprintf");
+        return;
+    }
+
+    content = util_read_content_from_file(fpath);
+    if (content == NULL) {
+        WARN("Failed to read %s", fpath);
+        return;
+    }
+
+    for (line = strtok_r(content, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+        char *value = strchr(line, ' ');
+
+        if (value == NULL) {
+            continue;
+        }
+        *value++ = '\0';
+        for (i = 0; i < len; i++) {
+            if (strcmp(line, keys[i]) == 0) {
+                (void)util_safe_uint64(value, values[i]);
+                break;
+            }
+        }
+    }
+}
+
+int common_get_cgroup_v2_metrics_in_mountpoint(const char *mountpoint, const char *cgroup_path,
+                                               cgroup_metrics_t *cgroup_metrics)
+{
+    int nret = 0;
+    uint64_t cpu_usage_usec = 0;
+    char path[PATH_MAX] = { 0 };
+    const char *cpu_keys[] = { "usage_usec" };
+    uint64_t *cpu_values[] = { &cpu_usage_usec };
+    const char *mem_keys[] = { "anon", "pgfault", "pgmajfault", "inactive_file" };
+    uint64_t *mem_values[4] = { NULL };
+
+    if (mountpoint == NULL || cgroup_path == NULL || strlen(cgroup_path) == 0 || cgroup_metrics == NULL) {
+        ERROR("Invalid arguments");
+        return -1;
+    }
+
+    nret = snprintf(path, sizeof(path), "%s/%s", mountpoint, cgroup_path);
+    if (nret < 0 || (size_t)nret >= sizeof(path)) {
+        ERROR("Failed to snprintf");
+        return -1;
+    }
+
+    if (!util_dir_exists(path)) {
+        ERROR("Cgroup %s does not exist", path);
+        return -1;
+    }
+
+    get_cgroup_v2_keyed_values(path, CGROUP2_CPU_STAT, cpu_keys, cpu_values, sizeof(cpu_keys) / sizeof(cpu_keys[0]));
+    cgroup_metrics->cgcpu_metrics.cpu_use_nanos = cpu_usage_usec * 1000;
+
+    get_cgroup_v2_value(path, CGROUP2_MEMORY_MAX, &cgroup_metrics->cgmem_metrics.mem_limit);
+    get_cgroup_v2_value(path, CGROUP2_MEMORY_CURRENT, &cgroup_metrics->cgmem_metrics.mem_used);
+    mem_values[0] = &cgroup_metrics->cgmem_metrics.total_rss;
+    mem_values[1] = &cgroup_metrics->cgmem_metrics.total_pgfault;
+    mem_values[2] = &cgroup_metrics->cgmem_metrics.total_pgmajfault;
+    mem_values[3] = &cgroup_metrics->cgmem_metrics.total_inactive_file;
+    get_cgroup_v2_keyed_values(path, CGROUP2_MEMORY_STAT, mem_keys, mem_values, sizeof(mem_keys) / sizeof(mem_keys[0]));
+
+    get_cgroup_v2_value(path, CGROUP2_PIDS_CURRENT, &cgroup_metrics->cgpids_metrics.pid_current);
+
+    return 0;
+}
+
+int common_get_cgroup_v2_metrics(const char *cgroup_path, cgroup_metrics_t *cgroup_metrics)
+{
+    return common_get_cgroup_v2_metrics_in_mountpoint(CGROUP_MOUNTPOINT, cgroup_path, cgroup_metrics);
+}
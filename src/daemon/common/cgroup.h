@@ -139,8 +139,20 @@ typedef struct {
     cgroup_pids_metrics_t cgpids_metrics;
 } cgroup_metrics_t;
 
+// return the cgroup path of an oci config relative to the cgroup mountpoint,
+// systemd "slice:prefix:name" paths are expanded like runc does
+char *common_cgroup_path_from_oci(const char *cgroups_path);
+
 int common_get_cgroup_v1_metrics(const char *cgroup_path, cgroup_metrics_t *cgroup_metrics);
 
+int common_get_cgroup_v1_metrics_in_layers(const cgroup_layer_t *layers, const char *cgroup_path,
+                                           cgroup_metrics_t *cgroup_metrics);
+
+int common_get_cgroup_v2_metrics(const char *cgroup_path, cgroup_metrics_t *cgroup_metrics);
+
+int common_get_cgroup_v2_metrics_in_mountpoint(const char *mountpoint, const char *cgroup_path,
+                                               cgroup_metrics_t *cgroup_metrics);
+
 #ifdef __cplusplus
 }
 #endif
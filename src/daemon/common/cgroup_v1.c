@@ -530,8 +530,52 @@ static void get_cgroup_v1_metrics_pid(const cgroup_layer_t *layers, const char *
     get_cgroup_v1_value_helper(path, PIDS_CURRENT, NULL, (void *)&cgroup_pids_metrics->pid_current);
 }
 
+/* the cgroup exists when any hierarchy the metrics are read from has it */
+static bool cgroup_v1_metrics_path_exists(const cgroup_layer_t *layers, const char *cgroup_path)
+{
+    const char *subsystems[] = { "cpuacct", "memory", "pids" };
+    char path[PATH_MAX] = { 0 };
+    size_t i;
+
+    for (i = 0; i < sizeof(subsystems) / sizeof(subsystems[0]); i++) {
+        char *mountpoint = common_find_cgroup_subsystem_mountpoint(layers, subsystems[i]);
+        int nret = 0;
+
+        if (mountpoint == NULL) {
+            continue;
+        }
+        nret = snprintf(path, sizeof(path), "%s/%s", mountpoint, cgroup_path);
+        if (nret >= 0 && (size_t)nret < sizeof(path) && util_dir_exists(path)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int common_get_cgroup_v1_metrics_in_layers(const cgroup_layer_t *layers, const char *cgroup_path,
+                                           cgroup_metrics_t *cgroup_metrics)
+{
+    if (layers == NULL || cgroup_path == NULL || strlen(cgroup_path) == 0 || cgroup_metrics == NULL) {
+        ERROR("Invalid arguments");
+        return -1;
+    }
+
+    if (!cgroup_v1_metrics_path_exists(layers, cgroup_path)) {
+        ERROR("Cgroup %s does not exist", cgroup_path);
+        return -1;
+    }
+
+    get_cgroup_v1_metrics_cpu(layers, cgroup_path, &cgroup_metrics->cgcpu_metrics);
+    get_cgroup_v1_metrics_memory(layers, cgroup_path, &cgroup_metrics->cgmem_metrics);
+    get_cgroup_v1_metrics_pid(layers, cgroup_path, &cgroup_metrics->cgpids_metrics);
+
+    return 0;
+}
+
 int common_get_cgroup_v1_metrics(const char *cgroup_path, cgroup_metrics_t *cgroup_metrics)
 {
+    int ret = 0;
     cgroup_layer_t *layers = NULL;
 
     if (cgroup_path == NULL || strlen(cgroup_path) == 0 || cgroup_metrics == NULL) {
@@ -545,12 +589,9 @@ int common_get_cgroup_v1_metrics(const char *cgroup_path, cgroup_metrics_t *cgro
         return -1;
     }
 
-    get_cgroup_v1_metrics_cpu(layers, cgroup_path, &cgroup_metrics->cgcpu_metrics);
-    get_cgroup_v1_metrics_memory(layers, cgroup_path, &cgroup_metrics->cgmem_metrics);
-    get_cgroup_v1_metrics_pid(layers, cgroup_path, &cgroup_metrics->cgpids_metrics);
+    ret = common_get_cgroup_v1_metrics_in_layers(layers, cgroup_path, cgroup_metrics);
 
     common_free_cgroup_layer(layers);
 
-    return 0;
+    return ret;
 }
-
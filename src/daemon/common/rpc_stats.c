@@ -0,0 +1,268 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide per rpc method latency and concurrency statistics
+ ******************************************************************************/
+#define _GNU_SOURCE
+#include "rpc_stats.h"
+
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+
+#include "isula_libutils/log.h"
+#include "utils.h"
+
+#define RPC_STATS_MAX_METHODS 256
+
+/*
+ * Open addressing table, a slot is claimed once and never released, so lookups
+ * only need atomic loads.
+ */
+static rpc_method_stats_t g_rpc_stats[RPC_STATS_MAX_METHODS];
+
+static size_t rpc_stats_hash(const char *kind, const char *method)
+{
+    size_t hash = 5381;
+    const char *p = NULL;
+
+    for (p = kind; *p != '\0'; p++) {
+        hash = hash * 33 + (unsigned char)*p;
+    }
+    for (p = method; *p != '\0'; p++) {
+        hash = hash * 33 + (unsigned char)*p;
+    }
+
+    return hash % RPC_STATS_MAX_METHODS;
+}
+
+static const char *rpc_stats_slot_method(rpc_method_stats_t *slot)
+{
+    const char *method = __atomic_load_n(&slot->method, __ATOMIC_ACQUIRE);
+
+    /* claimed by another thread which is still filling the slot */
+    while (method == NULL && __atomic_load_n(&slot->claimed, __ATOMIC_ACQUIRE) != 0) {
+        (void)sched_yield();
+        method = __atomic_load_n(&slot->method, __ATOMIC_ACQUIRE);
+    }
+
+    return method;
+}
+
+rpc_method_stats_t *rpc_stats_method(const char *kind, const char *method)
+{
+    size_t i = 0;
+    size_t start = 0;
+
+    if (kind == NULL || method == NULL) {
+        return NULL;
+    }
+
+    start = rpc_stats_hash(kind, method);
+    for (i = 0; i < RPC_STATS_MAX_METHODS; i++) {
+        rpc_method_stats_t *slot = &g_rpc_stats[(start + i) % RPC_STATS_MAX_METHODS];
+        const char *name = rpc_stats_slot_method(slot);
+        int expected = 0;
+
+        if (name == NULL) {
+            if (__atomic_compare_exchange_n(&slot->claimed, &expected, 1, false, __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE)) {
+                slot->kind = kind;
+                __atomic_store_n(&slot->method, util_strdup_s(method), __ATOMIC_RELEASE);
+                return slot;
+            }
+            name = rpc_stats_slot_method(slot);
+        }
+
+        if (strcmp(name, method) == 0 && strcmp(slot->kind, kind) == 0) {
+            return slot;
+        }
+    }
+
+    WARN("Rpc stats table is full, %s %s is not recorded", kind, method);
+    return NULL;
+}
+
+static int64_t rpc_stats_now_nanos(void)
+{
+    struct timespec ts = { 0 };
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static size_t rpc_stats_bucket_index(uint64_t us)
+{
+    unsigned int exp = 0;
+    size_t index = 0;
+
+    if (us < RPC_STATS_SUB_BUCKETS) {
+        return (size_t)us;
+    }
+
+    exp = 63 - (unsigned int)__builtin_clzll(us);
+    index = (size_t)(exp - RPC_STATS_SUB_BUCKET_BITS + 1) * RPC_STATS_SUB_BUCKETS +
+            ((us >> (exp - RPC_STATS_SUB_BUCKET_BITS)) & (RPC_STATS_SUB_BUCKETS - 1));
+
+    return index < RPC_STATS_LATENCY_BUCKETS ? index : RPC_STATS_LATENCY_BUCKETS - 1;
+}
+
+static uint64_t rpc_stats_bucket_lower(size_t index)
+{
+    unsigned int exp = 0;
+
+    if (index < RPC_STATS_SUB_BUCKETS) {
+        return (uint64_t)index;
+    }
+
+    exp = (unsigned int)(index / RPC_STATS_SUB_BUCKETS) + RPC_STATS_SUB_BUCKET_BITS - 1;
+    return (uint64_t)(RPC_STATS_SUB_BUCKETS + index % RPC_STATS_SUB_BUCKETS) << (exp - RPC_STATS_SUB_BUCKET_BITS);
+}
+
+static uint64_t rpc_stats_bucket_upper(size_t index)
+{
+    if (index + 1 >= RPC_STATS_LATENCY_BUCKETS) {
+        return UINT64_MAX;
+    }
+
+    return rpc_stats_bucket_lower(index + 1);
+}
+
+int64_t rpc_stats_begin(rpc_method_stats_t *stats)
+{
+    if (stats != NULL) {
+        (void)__atomic_add_fetch(&stats->in_flight, 1, __ATOMIC_RELAXED);
+    }
+
+    return rpc_stats_now_nanos();
+}
+
+void rpc_stats_end(rpc_method_stats_t *stats, int64_t begin, bool failed)
+{
+    int64_t elapsed = 0;
+    uint64_t us = 0;
+    uint64_t max = 0;
+
+    if (stats == NULL) {
+        return;
+    }
+
+    elapsed = rpc_stats_now_nanos() - begin;
+    us = elapsed > 0 ? (uint64_t)elapsed / 1000 : 0;
+
+    (void)__atomic_sub_fetch(&stats->in_flight, 1, __ATOMIC_RELAXED);
+    (void)__atomic_add_fetch(&stats->calls, 1, __ATOMIC_RELAXED);
+    if (failed) {
+        (void)__atomic_add_fetch(&stats->errors, 1, __ATOMIC_RELAXED);
+    }
+    (void)__atomic_add_fetch(&stats->latency_sum_us, us, __ATOMIC_RELAXED);
+    (void)__atomic_add_fetch(&stats->latency_buckets[rpc_stats_bucket_index(us)], 1, __ATOMIC_RELAXED);
+
+    max = __atomic_load_n(&stats->latency_max_us, __ATOMIC_RELAXED);
+    while (us > max && !__atomic_compare_exchange_n(&stats->latency_max_us, &max, us, true, __ATOMIC_RELAXED,
+                                                    __ATOMIC_RELAXED)) {
+    }
+}
+
+void rpc_stats_foreach(rpc_stats_walk_cb cb, void *ctx)
+{
+    size_t i = 0;
+
+    if (cb == NULL) {
+        return;
+    }
+
+    for (i = 0; i < RPC_STATS_MAX_METHODS; i++) {
+        if (rpc_stats_slot_method(&g_rpc_stats[i]) == NULL) {
+            continue;
+        }
+        cb(&g_rpc_stats[i], ctx);
+    }
+}
+
+uint64_t rpc_stats_latency_count_below(const rpc_method_stats_t *stats, uint64_t upper_us)
+{
+    size_t i = 0;
+    uint64_t count = 0;
+
+    if (stats == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < RPC_STATS_LATENCY_BUCKETS && rpc_stats_bucket_upper(i) <= upper_us; i++) {
+        count += __atomic_load_n(&stats->latency_buckets[i], __ATOMIC_RELAXED);
+    }
+
+    return count;
+}
+
+/* the result is the upper bound of the bucket holding the quantile, capped by the max seen */
+uint64_t rpc_stats_latency_quantile_us(const rpc_method_stats_t *stats, double quantile)
+{
+    size_t i = 0;
+    uint64_t total = 0;
+    uint64_t rank = 0;
+    uint64_t count = 0;
+    uint64_t max = 0;
+
+    if (stats == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < RPC_STATS_LATENCY_BUCKETS; i++) {
+        total += __atomic_load_n(&stats->latency_buckets[i], __ATOMIC_RELAXED);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    rank = (uint64_t)(quantile * (double)total + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    max = __atomic_load_n(&stats->latency_max_us, __ATOMIC_RELAXED);
+    for (i = 0; i < RPC_STATS_LATENCY_BUCKETS; i++) {
+        count += __atomic_load_n(&stats->latency_buckets[i], __ATOMIC_RELAXED);
+        if (count >= rank) {
+            uint64_t upper = rpc_stats_bucket_upper(i);
+            return upper - 1 < max ? upper - 1 : max;
+        }
+    }
+
+    return max;
+}
+
+static void rpc_stats_log_method(const rpc_method_stats_t *stats, void *ctx)
+{
+    uint64_t calls = __atomic_load_n(&stats->calls, __ATOMIC_RELAXED);
+    uint64_t sum = __atomic_load_n(&stats->latency_sum_us, __ATOMIC_RELAXED);
+
+    (void)ctx;
+    INFO("rpc %s %s: calls %llu, errors %llu, in flight %lld, avg %lluus, p50 %lluus, p99 %lluus, max %lluus",
+         stats->kind, stats->method, (unsigned long long)calls,
+         (unsigned long long)__atomic_load_n(&stats->errors, __ATOMIC_RELAXED),
+         (long long)__atomic_load_n(&stats->in_flight, __ATOMIC_RELAXED),
+         (unsigned long long)(calls > 0 ? sum / calls : 0),
+         (unsigned long long)rpc_stats_latency_quantile_us(stats, 0.5),
+         (unsigned long long)rpc_stats_latency_quantile_us(stats, 0.99),
+         (unsigned long long)__atomic_load_n(&stats->latency_max_us, __ATOMIC_RELAXED));
+}
+
+void rpc_stats_dump_to_log(void)
+{
+    INFO("Dump rpc statistics:");
+    rpc_stats_foreach(rpc_stats_log_method, NULL);
+}
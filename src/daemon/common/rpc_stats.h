@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide per rpc method latency and concurrency statistics
+ ******************************************************************************/
+#ifndef DAEMON_COMMON_RPC_STATS_H
+#define DAEMON_COMMON_RPC_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RPC_STATS_KIND_GRPC "grpc"
+#define RPC_STATS_KIND_REST "rest"
+
+/*
+ * Latencies are kept in microseconds in log-linear buckets: every power of two
+ * is split into RPC_STATS_SUB_BUCKETS linear buckets, so the relative error of
+ * a recorded value is at most 1 / RPC_STATS_SUB_BUCKETS.
+ */
+#define RPC_STATS_SUB_BUCKET_BITS 2
+#define RPC_STATS_SUB_BUCKETS (1 << RPC_STATS_SUB_BUCKET_BITS)
+#define RPC_STATS_MAX_EXPONENT 40
+#define RPC_STATS_LATENCY_BUCKETS (RPC_STATS_MAX_EXPONENT * RPC_STATS_SUB_BUCKETS)
+
+/* all counters are updated with atomic operations, no lock is taken on the rpc path */
+typedef struct rpc_method_stats {
+    int claimed;
+    const char *kind;
+    char *method;
+    uint64_t calls;
+    uint64_t errors;
+    int64_t in_flight;
+    uint64_t latency_sum_us;
+    uint64_t latency_max_us;
+    uint64_t latency_buckets[RPC_STATS_LATENCY_BUCKETS];
+} rpc_method_stats_t;
+
+typedef void (*rpc_stats_walk_cb)(const rpc_method_stats_t *stats, void *ctx);
+
+/* return NULL if the table is full, begin and end accept NULL */
+rpc_method_stats_t *rpc_stats_method(const char *kind, const char *method);
+
+int64_t rpc_stats_begin(rpc_method_stats_t *stats);
+
+void rpc_stats_end(rpc_method_stats_t *stats, int64_t begin, bool failed);
+
+void rpc_stats_foreach(rpc_stats_walk_cb cb, void *ctx);
+
+uint64_t rpc_stats_latency_count_below(const rpc_method_stats_t *stats, uint64_t upper_us);
+
+uint64_t rpc_stats_latency_quantile_us(const rpc_method_stats_t *stats, double quantile);
+
+void rpc_stats_dump_to_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DAEMON_COMMON_RPC_STATS_H
@@ -49,6 +49,11 @@
 static struct isulad_conf g_isulad_conf;
 static double g_jiffy = 0.0;
 static isulad_daemon_constants *g_isulad_daemon_constants = NULL;
+/* current snapshot, published with release semantic and loaded with acquire semantic */
+static struct isulad_conf_snapshot *g_isulad_conf_snapshot = NULL;
+/* replaced snapshots and their number, only touched with the conf write lock held */
+static struct isulad_conf_snapshot *g_isulad_conf_retired = NULL;
+static size_t g_isulad_conf_retired_count = 0;
 
 #ifdef ENABLE_CRI_API_V1
 #define SANDBOX_ROOTPATH_NAME "sandbox"
@@ -168,6 +173,192 @@ struct service_arguments *conf_get_server_conf(void)
     return g_isulad_conf.server_conf;
 }
 
+const struct isulad_conf_snapshot *conf_get_snapshot(void)
+{
+    return __atomic_load_n(&g_isulad_conf_snapshot, __ATOMIC_ACQUIRE);
+}
+
+/* dir + / + name, unlike util_path_join the result is not cleaned to keep the old path format */
+static int conf_join_path_buf(const char *dir, const char *name, char *path, size_t len)
+{
+    int nret = 0;
+
+    if (dir == NULL || name == NULL || path == NULL) {
+        return -1;
+    }
+
+    nret = snprintf(path, len, "%s/%s", dir, name);
+    if (nret < 0 || (size_t)nret >= len) {
+        ERROR("Path %s/%s is too long", dir, name);
+        return -1;
+    }
+
+    return 0;
+}
+
+static char *conf_join_path(const char *dir, const char *name)
+{
+    char path[PATH_MAX] = { 0 };
+
+    if (conf_join_path_buf(dir, name, path, sizeof(path)) != 0) {
+        return NULL;
+    }
+
+    return util_strdup_s(path);
+}
+
+const char *conf_snapshot_rootdir(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != NULL ? snapshot->rootdir : NULL;
+}
+
+const char *conf_snapshot_statedir(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != NULL ? snapshot->statedir : NULL;
+}
+
+const char *conf_snapshot_engine_rootpath(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != NULL ? snapshot->engine_rootpath : NULL;
+}
+
+const char *conf_snapshot_monitor_fifo_path(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != NULL ? snapshot->monitor_fifo_path : NULL;
+}
+
+/* engine rootpath + / + runtime into the buffer of the caller */
+int conf_snapshot_routine_rootdir(const char *runtime, char *path, size_t len)
+{
+    const char *engine_rootpath = conf_snapshot_engine_rootpath();
+
+    if (runtime == NULL || engine_rootpath == NULL) {
+        ERROR("Runtime is NULL or rootpath is NULL");
+        return -1;
+    }
+
+    return conf_join_path_buf(engine_rootpath, runtime, path, len);
+}
+
+/* statedir + / + runtime into the buffer of the caller */
+int conf_snapshot_routine_statedir(const char *runtime, char *path, size_t len)
+{
+    const char *statedir = conf_snapshot_statedir();
+
+    if (runtime == NULL || statedir == NULL) {
+        ERROR("Runtime is NULL or statedir is NULL");
+        return -1;
+    }
+
+    return conf_join_path_buf(statedir, runtime, path, len);
+}
+
+size_t conf_snapshot_retired_count(void)
+{
+    size_t count = 0;
+
+    if (isulad_server_conf_rdlock() != 0) {
+        return 0;
+    }
+    count = g_isulad_conf_retired_count;
+    (void)isulad_server_conf_unlock();
+
+    return count;
+}
+
+static void conf_snapshot_free(struct isulad_conf_snapshot *snapshot)
+{
+    if (snapshot == NULL) {
+        return;
+    }
+
+    free(snapshot->rootdir);
+    free(snapshot->statedir);
+    free(snapshot->engine_rootpath);
+    free(snapshot->mount_rootfs);
+    free(snapshot->graph_check_flag_file);
+    free(snapshot->monitor_fifo_path);
+    free(snapshot);
+}
+
+static struct isulad_conf_snapshot *conf_snapshot_build(const struct service_arguments *args)
+{
+    struct isulad_conf_snapshot *snapshot = NULL;
+    const char *graph = NULL;
+    const char *state = NULL;
+
+    snapshot = util_common_calloc_s(sizeof(struct isulad_conf_snapshot));
+    if (snapshot == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+
+    if (args == NULL || args->json_confs == NULL) {
+        return snapshot;
+    }
+
+    graph = args->json_confs->graph;
+    state = args->json_confs->state;
+
+    if (graph != NULL) {
+        snapshot->rootdir = util_strdup_s(graph);
+        snapshot->engine_rootpath = conf_join_path(graph, ENGINE_ROOTPATH_NAME);
+        snapshot->mount_rootfs = conf_join_path(graph, "mnt/rootfs");
+        snapshot->graph_check_flag_file = conf_join_path(graph, OCI_IMAGE_GRAPH_ROOTPATH_NAME "/"
+                                                         GRAPH_ROOTPATH_CHECKED_FLAG);
+        if (snapshot->engine_rootpath == NULL || snapshot->mount_rootfs == NULL ||
+            snapshot->graph_check_flag_file == NULL) {
+            goto err_out;
+        }
+    }
+
+    if (state != NULL) {
+        snapshot->statedir = util_strdup_s(state);
+        snapshot->monitor_fifo_path = conf_join_path(state, "monitord_fifo");
+        if (snapshot->monitor_fifo_path == NULL) {
+            goto err_out;
+        }
+    }
+
+    return snapshot;
+
+err_out:
+    conf_snapshot_free(snapshot);
+    return NULL;
+}
+
+/*
+ * must be called with the conf write lock held. Readers hold no reference on
+ * the snapshot, so the replaced one can never be freed. The daemon publishes
+ * once at startup and never reloads, so the retired list only grows by one
+ * per save_args_to_conf call and stays bounded by the number of saves.
+ */
+static void conf_snapshot_publish(struct isulad_conf_snapshot *snapshot)
+{
+    struct isulad_conf_snapshot *old = NULL;
+
+    old = __atomic_exchange_n(&g_isulad_conf_snapshot, snapshot, __ATOMIC_ACQ_REL);
+    if (old != NULL) {
+        WARN("Isulad conf snapshot is published again, retire the old one");
+        old->retired_next = g_isulad_conf_retired;
+        g_isulad_conf_retired = old;
+        g_isulad_conf_retired_count++;
+    }
+}
+
+static char *conf_snapshot_dup_path(const char *path)
+{
+    return path != NULL ? util_strdup_s(path) : NULL;
+}
+
 /* conf get isulad pidfile */
 char *conf_get_isulad_pidfile(void)
 {
@@ -193,36 +384,14 @@ out:
 /* conf get engine rootpath */
 char *conf_get_engine_rootpath(void)
 {
-    char *epath = NULL;
-    char *rootpath = NULL;
-    size_t len;
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    rootpath = conf_get_isulad_rootdir();
-    if (rootpath == NULL) {
+    if (snapshot == NULL || snapshot->engine_rootpath == NULL) {
         ERROR("Get rootpath failed");
-        return epath;
-    }
-    if (strlen(rootpath) > (PATH_MAX - strlen(ENGINE_ROOTPATH_NAME)) - 2) {
-        ERROR("Root path is too long");
-        goto free_out;
-    }
-    len = strlen(rootpath) + 1 + strlen(ENGINE_ROOTPATH_NAME) + 1;
-    epath = util_smart_calloc_s(sizeof(char), len);
-    if (epath == NULL) {
-        ERROR("Out of memory");
-        goto free_out;
-    }
-
-    int nret = snprintf(epath, len, "%s/%s", rootpath, ENGINE_ROOTPATH_NAME);
-    if (nret < 0 || (size_t)nret >= len) {
-        ERROR("Sprintf engine path failed");
-        free(epath);
-        epath = NULL;
+        return NULL;
     }
 
-free_out:
-    free(rootpath);
-    return epath;
+    return util_strdup_s(snapshot->engine_rootpath);
 }
 
 int conf_get_cgroup_cpu_rt(int64_t *cpu_rt_period, int64_t *cpu_rt_runtime)
@@ -256,135 +425,52 @@ int conf_get_cgroup_cpu_rt(int64_t *cpu_rt_period, int64_t *cpu_rt_runtime)
 /* conf get graph checked flag file path */
 char *conf_get_graph_check_flag_file(void)
 {
-    char *epath = NULL;
-    char *rootpath = NULL;
-    size_t len;
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    rootpath = conf_get_isulad_rootdir();
-    if (rootpath == NULL) {
+    if (snapshot == NULL || snapshot->graph_check_flag_file == NULL) {
         ERROR("Get rootpath failed");
-        return epath;
-    }
-    if (strlen(rootpath) >
-        ((PATH_MAX - strlen(OCI_IMAGE_GRAPH_ROOTPATH_NAME)) - strlen(GRAPH_ROOTPATH_CHECKED_FLAG)) - 3) {
-        ERROR("Root path is too long");
-        goto free_out;
-    }
-    len = strlen(rootpath) + 1 + strlen(OCI_IMAGE_GRAPH_ROOTPATH_NAME) + 1 + strlen(GRAPH_ROOTPATH_CHECKED_FLAG) + 1;
-    epath = util_smart_calloc_s(sizeof(char), len);
-    if (epath == NULL) {
-        ERROR("Out of memory");
-        goto free_out;
-    }
-
-    int nret = snprintf(epath, len, "%s/%s/%s", rootpath, OCI_IMAGE_GRAPH_ROOTPATH_NAME, GRAPH_ROOTPATH_CHECKED_FLAG);
-    if (nret < 0 || (size_t)nret >= len) {
-        ERROR("Sprintf graph checked flag failed");
-        free(epath);
-        epath = NULL;
+        return NULL;
     }
 
-free_out:
-    free(rootpath);
-    return epath;
+    return util_strdup_s(snapshot->graph_check_flag_file);
 }
 
 /* conf get routine rootdir */
 char *conf_get_routine_rootdir(const char *runtime)
 {
-    char *path = NULL;
-    struct service_arguments *conf = NULL;
-    size_t len = 0;
-    size_t graph_len = 0;
+    const struct isulad_conf_snapshot *snapshot = NULL;
 
     if (runtime == NULL) {
         ERROR("Runtime is NULL");
         return NULL;
     }
 
-    if (isulad_server_conf_rdlock() != 0) {
-        return NULL;
-    }
-
-    conf = conf_get_server_conf();
-    if (conf == NULL || conf->json_confs == NULL || conf->json_confs->graph == NULL) {
+    snapshot = conf_get_snapshot();
+    if (snapshot == NULL || snapshot->engine_rootpath == NULL) {
         ERROR("Server conf is NULL or rootpath is NULL");
-        goto out;
+        return NULL;
     }
 
     /* path = conf->rootpath + / + engines + / + runtime + /0 */
-    graph_len = strlen(conf->json_confs->graph);
-    if (graph_len > (SIZE_MAX - strlen(ENGINE_ROOTPATH_NAME) - strlen(runtime)) - 3) {
-        ERROR("Graph path is too long");
-        goto out;
-    }
-    len = graph_len + 1 + strlen(ENGINE_ROOTPATH_NAME) + 1 + strlen(runtime) + 1;
-    if (len > PATH_MAX / sizeof(char)) {
-        ERROR("The size of path exceeds the limit");
-        goto out;
-    }
-    path = util_smart_calloc_s(sizeof(char), len);
-    if (path == NULL) {
-        ERROR("Out of memory");
-        goto out;
-    }
-
-    int nret = snprintf(path, len, "%s/%s/%s", conf->json_confs->graph, ENGINE_ROOTPATH_NAME, runtime);
-    if (nret < 0 || (size_t)nret >= len) {
-        ERROR("Failed to sprintf path");
-        free(path);
-        path = NULL;
-    }
-
-out:
-    (void)isulad_server_conf_unlock();
-    return path;
+    return conf_join_path(snapshot->engine_rootpath, runtime);
 }
 
 /* conf get routine statedir */
 char *conf_get_routine_statedir(const char *runtime)
 {
-    char *path = NULL;
-    struct service_arguments *conf = NULL;
-    size_t len = 0;
+    const struct isulad_conf_snapshot *snapshot = NULL;
 
     if (runtime == NULL) {
         return NULL;
     }
 
-    if (isulad_server_conf_rdlock() != 0) {
+    snapshot = conf_get_snapshot();
+    if (snapshot == NULL || snapshot->statedir == NULL) {
         return NULL;
     }
 
-    conf = conf_get_server_conf();
-    if (conf == NULL || conf->json_confs == NULL || conf->json_confs->state == NULL) {
-        goto out;
-    }
-
     /* path = conf->statepath + / + runtime + /0 */
-    if (strlen(conf->json_confs->state) > (SIZE_MAX - strlen(runtime)) - 2) {
-        ERROR("State path is too long");
-        goto out;
-    }
-    len = strlen(conf->json_confs->state) + 1 + strlen(runtime) + 1;
-    if (len > PATH_MAX) {
-        goto out;
-    }
-    path = util_smart_calloc_s(sizeof(char), len);
-    if (path == NULL) {
-        goto out;
-    }
-
-    int nret = snprintf(path, len, "%s/%s", conf->json_confs->state, runtime);
-    if (nret < 0 || (size_t)nret >= len) {
-        ERROR("sprintf path failed");
-        free(path);
-        path = NULL;
-    }
-
-out:
-    (void)isulad_server_conf_unlock();
-    return path;
+    return conf_join_path(snapshot->statedir, runtime);
 }
 
 #ifdef ENABLE_CRI_API_V1
@@ -462,23 +548,9 @@ out:
 /* conf get isulad rootdir */
 char *conf_get_isulad_rootdir(void)
 {
-    char *path = NULL;
-    struct service_arguments *conf = NULL;
-
-    if (isulad_server_conf_rdlock() != 0) {
-        return NULL;
-    }
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    conf = conf_get_server_conf();
-    if (conf == NULL || conf->json_confs == NULL || conf->json_confs->graph == NULL) {
-        goto out;
-    }
-
-    path = util_strdup_s(conf->json_confs->graph);
-
-out:
-    (void)isulad_server_conf_unlock();
-    return path;
+    return snapshot != NULL ? conf_snapshot_dup_path(snapshot->rootdir) : NULL;
 }
 
 /* conf get registry */
@@ -556,100 +628,30 @@ out:
 /* conf get isulad statedir */
 char *conf_get_isulad_statedir(void)
 {
-    char *path = NULL;
-    struct service_arguments *conf = NULL;
-
-    if (isulad_server_conf_rdlock() != 0) {
-        return NULL;
-    }
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    conf = conf_get_server_conf();
-    if (conf == NULL || conf->json_confs == NULL || conf->json_confs->state == NULL) {
-        goto out;
-    }
-
-    path = util_strdup_s(conf->json_confs->state);
-
-out:
-    (void)isulad_server_conf_unlock();
-    return path;
+    return snapshot != NULL ? conf_snapshot_dup_path(snapshot->statedir) : NULL;
 }
 
 /* isulad monitor fifo name */
 char *conf_get_isulad_monitor_fifo_path(void)
 {
-    int ret;
-    char fifo_file_path[PATH_MAX] = { 0 };
-    char *rootpath = NULL;
-    char *result = NULL;
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    rootpath = conf_get_isulad_statedir();
-    if (rootpath == NULL) {
+    if (snapshot == NULL || snapshot->monitor_fifo_path == NULL) {
         ERROR("Invalid parameter");
-        goto out;
-    }
-    ret = snprintf(fifo_file_path, PATH_MAX, "%s/monitord_fifo", rootpath);
-    if (ret < 0 || (size_t)ret >= PATH_MAX) {
-        ERROR("Create monitord fifo path failed");
-        goto out;
-    }
-
-    result = util_strdup_s(fifo_file_path);
-
-out:
-    free(rootpath);
-    return result;
-}
-
-static char *get_parent_mount_dir(char *graph)
-{
-    int nret;
-    size_t len;
-    char *rootfsdir = NULL;
-
-    if (strlen(graph) > (PATH_MAX - strlen("/mnt/rootfs") - 1)) {
-        ERROR("Graph path is too long");
         return NULL;
     }
 
-    len = strlen(graph) + strlen("/mnt/rootfs") + 1;
-
-    rootfsdir = util_smart_calloc_s(sizeof(char), len);
-    if (rootfsdir == NULL) {
-        ERROR("Out of memory");
-        return NULL;
-    }
-
-    nret = snprintf(rootfsdir, len, "%s/mnt/rootfs", graph);
-    if (nret < 0 || (size_t)nret >= len) {
-        ERROR("Failed to print string");
-        free(rootfsdir);
-        return NULL;
-    }
-
-    return rootfsdir;
+    return util_strdup_s(snapshot->monitor_fifo_path);
 }
 
 /* conf get isulad mount rootfs */
 char *conf_get_isulad_mount_rootfs(void)
 {
-    char *path = NULL;
-    struct service_arguments *conf = NULL;
-
-    if (isulad_server_conf_rdlock() != 0) {
-        return NULL;
-    }
-
-    conf = conf_get_server_conf();
-    if (conf == NULL || conf->json_confs == NULL || conf->json_confs->graph == NULL) {
-        goto out;
-    }
-
-    path = get_parent_mount_dir(conf->json_confs->graph);
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-out:
-    (void)isulad_server_conf_unlock();
-    return path;
+    return snapshot != NULL ? conf_snapshot_dup_path(snapshot->mount_rootfs) : NULL;
 }
 
 /* conf get isulad umask for containers */
@@ -1389,6 +1391,13 @@ out:
 int save_args_to_conf(struct service_arguments *args)
 {
     int ret = 0;
+    struct isulad_conf_snapshot *snapshot = NULL;
+
+    snapshot = conf_snapshot_build(args);
+    if (snapshot == NULL) {
+        ERROR("Failed to build isulad conf snapshot");
+        return -1;
+    }
 
     ret = pthread_rwlock_init(&g_isulad_conf.isulad_conf_rwlock, NULL);
     if (ret != 0) {
@@ -1408,6 +1417,8 @@ int save_args_to_conf(struct service_arguments *args)
         free(g_isulad_conf.server_conf);
     }
     g_isulad_conf.server_conf = args;
+    conf_snapshot_publish(snapshot);
+    snapshot = NULL;
 
     if (pthread_rwlock_unlock(&g_isulad_conf.isulad_conf_rwlock) != 0) {
         ERROR("Failed to release isulad conf write lock");
@@ -1415,6 +1426,7 @@ int save_args_to_conf(struct service_arguments *args)
         goto out;
     }
 out:
+    conf_snapshot_free(snapshot);
     return ret;
 }
 
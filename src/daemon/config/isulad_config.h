@@ -36,6 +36,24 @@ struct isulad_conf {
     struct service_arguments *server_conf;
 };
 
+/*
+ * Immutable view of the paths derived from the server configuration. It is
+ * rebuilt and published as a whole by save_args_to_conf, readers get a const
+ * pointer without taking the conf lock. A replaced snapshot is retired but
+ * never freed, so a pointer obtained from conf_get_snapshot stays valid.
+ * The daemon saves the conf once at startup, so at most one snapshot is
+ * published for its lifetime and conf_snapshot_retired_count stays 0.
+ */
+struct isulad_conf_snapshot {
+    char *rootdir;
+    char *statedir;
+    char *engine_rootpath;
+    char *mount_rootfs;
+    char *graph_check_flag_file;
+    char *monitor_fifo_path;
+    struct isulad_conf_snapshot *retired_next;
+};
+
 #ifdef ENABLE_CRI_API_V1
 #define DEFAULT_SANDBOXER_NAME "shim"
 char *conf_get_sandbox_rootpath(void);
@@ -82,6 +100,17 @@ int isulad_server_conf_unlock(void);
 
 struct service_arguments *conf_get_server_conf(void);
 
+const struct isulad_conf_snapshot *conf_get_snapshot(void);
+
+/* const views of the current snapshot, must not be freed */
+const char *conf_snapshot_rootdir(void);
+const char *conf_snapshot_statedir(void);
+const char *conf_snapshot_engine_rootpath(void);
+const char *conf_snapshot_monitor_fifo_path(void);
+int conf_snapshot_routine_rootdir(const char *runtime, char *path, size_t len);
+int conf_snapshot_routine_statedir(const char *runtime, char *path, size_t len);
+size_t conf_snapshot_retired_count(void);
+
 int get_system_cpu_usage(uint64_t *val);
 
 int conf_get_isulad_hooks(oci_runtime_spec_hooks **phooks);
@@ -20,6 +20,7 @@
 #include "isula_libutils/log.h"
 #include "cri_helpers.h"
 #include "v1_cri_image_manager_service_impl.h"
+#include "grpc_server_admission.h"
 
 RuntimeV1ImageServiceImpl::RuntimeV1ImageServiceImpl()
 {
@@ -31,6 +32,8 @@ grpc::Status RuntimeV1ImageServiceImpl::PullImage(grpc::ServerContext *context,
                                                 const runtime::v1::PullImageRequest *request,
                                                 runtime::v1::PullImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -56,6 +59,8 @@ grpc::Status RuntimeV1ImageServiceImpl::ListImages(grpc::ServerContext *context,
                                                  const runtime::v1::ListImagesRequest *request,
                                                  runtime::v1::ListImagesResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::vector<std::unique_ptr<runtime::v1::Image>> images;
     Errors error;
 
@@ -89,6 +94,8 @@ grpc::Status RuntimeV1ImageServiceImpl::ImageStatus(grpc::ServerContext *context
                                                   const runtime::v1::ImageStatusRequest *request,
                                                   runtime::v1::ImageStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::unique_ptr<runtime::v1::Image> image_info = nullptr;
     Errors error;
 
@@ -120,6 +127,8 @@ grpc::Status RuntimeV1ImageServiceImpl::ImageFsInfo(grpc::ServerContext *context
                                                   const runtime::v1::ImageFsInfoRequest *request,
                                                   runtime::v1::ImageFsInfoResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::vector<std::unique_ptr<runtime::v1::FilesystemUsage>> usages;
     Errors error;
 
@@ -153,6 +162,8 @@ grpc::Status RuntimeV1ImageServiceImpl::RemoveImage(grpc::ServerContext *context
                                                   const runtime::v1::RemoveImageRequest *request,
                                                   runtime::v1::RemoveImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -22,6 +22,7 @@
 #include "callback.h"
 #include "network_plugin.h"
 #include "v1_cri_runtime_service_impl.h"
+#include "grpc_server_admission.h"
 
 using namespace CRIV1;
 
@@ -50,6 +51,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::Version(grpc::ServerContext *context,
                                                 const runtime::v1::VersionRequest *request,
                                                 runtime::v1::VersionResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
     if (request == nullptr || reply == nullptr) {
         ERROR("Invalid input arguments");
@@ -68,6 +71,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::CreateContainer(grpc::ServerContext *c
                                                         const runtime::v1::CreateContainerRequest *request,
                                                         runtime::v1::CreateContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -94,6 +99,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::StartContainer(grpc::ServerContext *co
                                                        const runtime::v1::StartContainerRequest *request,
                                                        runtime::v1::StartContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -118,6 +125,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::StopContainer(grpc::ServerContext *con
                                                       const runtime::v1::StopContainerRequest *request,
                                                       runtime::v1::StopContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr) {
@@ -142,6 +151,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::RemoveContainer(grpc::ServerContext *c
                                                         const runtime::v1::RemoveContainerRequest *request,
                                                         runtime::v1::RemoveContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -166,6 +177,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ListContainers(grpc::ServerContext *co
                                                        const runtime::v1::ListContainersRequest *request,
                                                        runtime::v1::ListContainersResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -200,6 +213,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ContainerStats(grpc::ServerContext *co
                                                        const runtime::v1::ContainerStatsRequest *request,
                                                        runtime::v1::ContainerStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -226,6 +241,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ListContainerStats(grpc::ServerContext
                                                            const runtime::v1::ListContainerStatsRequest *request,
                                                            runtime::v1::ListContainerStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -260,6 +277,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ContainerStatus(grpc::ServerContext *c
                                                         const runtime::v1::ContainerStatusRequest *request,
                                                         runtime::v1::ContainerStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -286,6 +305,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ExecSync(grpc::ServerContext *context,
                                                  const runtime::v1::ExecSyncRequest *request,
                                                  runtime::v1::ExecSyncResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -310,6 +331,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::RunPodSandbox(grpc::ServerContext *con
                                                       const runtime::v1::RunPodSandboxRequest *request,
                                                       runtime::v1::RunPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -335,6 +358,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::StopPodSandbox(grpc::ServerContext *co
                                                        const runtime::v1::StopPodSandboxRequest *request,
                                                        runtime::v1::StopPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr) {
@@ -360,6 +385,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::RemovePodSandbox(grpc::ServerContext *
                                                          const runtime::v1::RemovePodSandboxRequest *request,
                                                          runtime::v1::RemovePodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -385,6 +412,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::PodSandboxStatus(grpc::ServerContext *
                                                          const runtime::v1::PodSandboxStatusRequest *request,
                                                          runtime::v1::PodSandboxStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -412,6 +441,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::ListPodSandbox(grpc::ServerContext *co
                                                        const runtime::v1::ListPodSandboxRequest *request,
                                                        runtime::v1::ListPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -446,6 +477,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::PodSandboxStats(grpc::ServerContext *c
                                                         const runtime::v1::PodSandboxStatsRequest *request,
                                                         runtime::v1::PodSandboxStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -474,6 +507,8 @@ RuntimeV1RuntimeServiceImpl::ListPodSandboxStats(grpc::ServerContext *context,
                                                const runtime::v1::ListPodSandboxStatsRequest *request,
                                                runtime::v1::ListPodSandboxStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -508,6 +543,8 @@ RuntimeV1RuntimeServiceImpl::UpdateContainerResources(grpc::ServerContext *conte
                                                     const runtime::v1::UpdateContainerResourcesRequest *request,
                                                     runtime::v1::UpdateContainerResourcesResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -533,6 +570,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::Exec(grpc::ServerContext *context,
                                              const runtime::v1::ExecRequest *request,
                                              runtime::v1::ExecResponse *response)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || response == nullptr) {
@@ -558,6 +597,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::Attach(grpc::ServerContext *context,
                                                const runtime::v1::AttachRequest *request,
                                                runtime::v1::AttachResponse *response)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || response == nullptr) {
@@ -584,6 +625,8 @@ RuntimeV1RuntimeServiceImpl::UpdateRuntimeConfig(grpc::ServerContext *context,
                                                const runtime::v1::UpdateRuntimeConfigRequest *request,
                                                runtime::v1::UpdateRuntimeConfigResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -608,6 +651,8 @@ grpc::Status RuntimeV1RuntimeServiceImpl::Status(grpc::ServerContext *context,
                                                const runtime::v1::StatusRequest *request,
                                                runtime::v1::StatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -20,6 +20,7 @@
 #include "isula_libutils/log.h"
 #include "cri_helpers.h"
 #include "cri_image_manager_service_impl.h"
+#include "grpc_server_admission.h"
 
 RuntimeImageServiceImpl::RuntimeImageServiceImpl()
 {
@@ -31,6 +32,8 @@ grpc::Status RuntimeImageServiceImpl::PullImage(grpc::ServerContext *context,
                                                 const runtime::v1alpha2::PullImageRequest *request,
                                                 runtime::v1alpha2::PullImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -56,6 +59,8 @@ grpc::Status RuntimeImageServiceImpl::ListImages(grpc::ServerContext *context,
                                                  const runtime::v1alpha2::ListImagesRequest *request,
                                                  runtime::v1alpha2::ListImagesResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::vector<std::unique_ptr<runtime::v1alpha2::Image>> images;
     Errors error;
 
@@ -89,6 +94,8 @@ grpc::Status RuntimeImageServiceImpl::ImageStatus(grpc::ServerContext *context,
                                                   const runtime::v1alpha2::ImageStatusRequest *request,
                                                   runtime::v1alpha2::ImageStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::unique_ptr<runtime::v1alpha2::Image> image_info = nullptr;
     Errors error;
 
@@ -120,6 +127,8 @@ grpc::Status RuntimeImageServiceImpl::ImageFsInfo(grpc::ServerContext *context,
                                                   const runtime::v1alpha2::ImageFsInfoRequest *request,
                                                   runtime::v1alpha2::ImageFsInfoResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     std::vector<std::unique_ptr<runtime::v1alpha2::FilesystemUsage>> usages;
     Errors error;
 
@@ -153,6 +162,8 @@ grpc::Status RuntimeImageServiceImpl::RemoveImage(grpc::ServerContext *context,
                                                   const runtime::v1alpha2::RemoveImageRequest *request,
                                                   runtime::v1alpha2::RemoveImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
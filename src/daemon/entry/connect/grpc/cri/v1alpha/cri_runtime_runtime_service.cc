@@ -20,6 +20,7 @@
 #include <isula_libutils/log.h>
 #include "network_plugin.h"
 #include "cri_runtime_service_impl.h"
+#include "grpc_server_admission.h"
 
 using namespace CRI;
 
@@ -48,6 +49,8 @@ grpc::Status RuntimeRuntimeServiceImpl::Version(grpc::ServerContext *context,
                                                 const runtime::v1alpha2::VersionRequest *request,
                                                 runtime::v1alpha2::VersionResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
     if (request == nullptr || reply == nullptr) {
         ERROR("Invalid input arguments");
@@ -66,6 +69,8 @@ grpc::Status RuntimeRuntimeServiceImpl::CreateContainer(grpc::ServerContext *con
                                                         const runtime::v1alpha2::CreateContainerRequest *request,
                                                         runtime::v1alpha2::CreateContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -92,6 +97,8 @@ grpc::Status RuntimeRuntimeServiceImpl::StartContainer(grpc::ServerContext *cont
                                                        const runtime::v1alpha2::StartContainerRequest *request,
                                                        runtime::v1alpha2::StartContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -116,6 +123,8 @@ grpc::Status RuntimeRuntimeServiceImpl::StopContainer(grpc::ServerContext *conte
                                                       const runtime::v1alpha2::StopContainerRequest *request,
                                                       runtime::v1alpha2::StopContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr) {
@@ -140,6 +149,8 @@ grpc::Status RuntimeRuntimeServiceImpl::RemoveContainer(grpc::ServerContext *con
                                                         const runtime::v1alpha2::RemoveContainerRequest *request,
                                                         runtime::v1alpha2::RemoveContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -164,6 +175,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ListContainers(grpc::ServerContext *cont
                                                        const runtime::v1alpha2::ListContainersRequest *request,
                                                        runtime::v1alpha2::ListContainersResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -198,6 +211,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ContainerStats(grpc::ServerContext *cont
                                                        const runtime::v1alpha2::ContainerStatsRequest *request,
                                                        runtime::v1alpha2::ContainerStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -224,6 +239,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ListContainerStats(grpc::ServerContext *
                                                            const runtime::v1alpha2::ListContainerStatsRequest *request,
                                                            runtime::v1alpha2::ListContainerStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -258,6 +275,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ContainerStatus(grpc::ServerContext *con
                                                         const runtime::v1alpha2::ContainerStatusRequest *request,
                                                         runtime::v1alpha2::ContainerStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -284,6 +303,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ExecSync(grpc::ServerContext *context,
                                                  const runtime::v1alpha2::ExecSyncRequest *request,
                                                  runtime::v1alpha2::ExecSyncResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -308,6 +329,8 @@ grpc::Status RuntimeRuntimeServiceImpl::RunPodSandbox(grpc::ServerContext *conte
                                                       const runtime::v1alpha2::RunPodSandboxRequest *request,
                                                       runtime::v1alpha2::RunPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -333,6 +356,8 @@ grpc::Status RuntimeRuntimeServiceImpl::StopPodSandbox(grpc::ServerContext *cont
                                                        const runtime::v1alpha2::StopPodSandboxRequest *request,
                                                        runtime::v1alpha2::StopPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     Errors error;
 
     if (request == nullptr) {
@@ -358,6 +383,8 @@ grpc::Status RuntimeRuntimeServiceImpl::RemovePodSandbox(grpc::ServerContext *co
                                                          const runtime::v1alpha2::RemovePodSandboxRequest *request,
                                                          runtime::v1alpha2::RemovePodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -383,6 +410,8 @@ grpc::Status RuntimeRuntimeServiceImpl::PodSandboxStatus(grpc::ServerContext *co
                                                          const runtime::v1alpha2::PodSandboxStatusRequest *request,
                                                          runtime::v1alpha2::PodSandboxStatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -410,6 +439,8 @@ grpc::Status RuntimeRuntimeServiceImpl::ListPodSandbox(grpc::ServerContext *cont
                                                        const runtime::v1alpha2::ListPodSandboxRequest *request,
                                                        runtime::v1alpha2::ListPodSandboxResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -443,6 +474,8 @@ grpc::Status RuntimeRuntimeServiceImpl::PodSandboxStats(grpc::ServerContext *con
                                                         const runtime::v1alpha2::PodSandboxStatsRequest *request,
                                                         runtime::v1alpha2::PodSandboxStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -471,6 +504,8 @@ RuntimeRuntimeServiceImpl::ListPodSandboxStats(grpc::ServerContext *context,
                                                const runtime::v1alpha2::ListPodSandboxStatsRequest *request,
                                                runtime::v1alpha2::ListPodSandboxStatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -505,6 +540,8 @@ RuntimeRuntimeServiceImpl::UpdateContainerResources(grpc::ServerContext *context
                                                     const runtime::v1alpha2::UpdateContainerResourcesRequest *request,
                                                     runtime::v1alpha2::UpdateContainerResourcesResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -530,6 +567,8 @@ grpc::Status RuntimeRuntimeServiceImpl::Exec(grpc::ServerContext *context,
                                              const runtime::v1alpha2::ExecRequest *request,
                                              runtime::v1alpha2::ExecResponse *response)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || response == nullptr) {
@@ -555,6 +594,8 @@ grpc::Status RuntimeRuntimeServiceImpl::Attach(grpc::ServerContext *context,
                                                const runtime::v1alpha2::AttachRequest *request,
                                                runtime::v1alpha2::AttachResponse *response)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr || response == nullptr) {
@@ -581,6 +622,8 @@ RuntimeRuntimeServiceImpl::UpdateRuntimeConfig(grpc::ServerContext *context,
                                                const runtime::v1alpha2::UpdateRuntimeConfigRequest *request,
                                                runtime::v1alpha2::UpdateRuntimeConfigResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     Errors error;
 
     if (request == nullptr) {
@@ -605,6 +648,8 @@ grpc::Status RuntimeRuntimeServiceImpl::Status(grpc::ServerContext *context,
                                                const runtime::v1alpha2::StatusRequest *request,
                                                runtime::v1alpha2::StatusResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     Errors error;
 
     if (request == nullptr || reply == nullptr) {
@@ -47,6 +47,7 @@
 #include "resize_service.h"
 #include "version_service.h"
 #include "info_service.h"
+#include "grpc_server_admission.h"
 
 void protobuf_timestamp_to_grpc(const types_timestamp_t *timestamp, Timestamp *gtimestamp)
 {
@@ -169,24 +170,32 @@ bool grpc_copy_to_container_read_function(void *reader, void *data)
 
 Status ContainerServiceImpl::Version(ServerContext *context, const VersionRequest *request, VersionResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto versionService = QueryVersionService();
     return SpecificServiceRun<VersionRequest, VersionResponse>(versionService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Info(ServerContext *context, const InfoRequest *request, InfoResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto infoService = QueryInfoService();
     return SpecificServiceRun<InfoRequest, InfoResponse>(infoService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Create(ServerContext *context, const CreateRequest *request, CreateResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto createService = ContainerCreateService();
     return SpecificServiceRun<CreateRequest, CreateResponse>(createService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Start(ServerContext *context, const StartRequest *request, StartResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto startService = ContainerStartService();
     return SpecificServiceRun<StartRequest, StartResponse>(startService, context, request, reply);
 }
@@ -239,6 +248,8 @@ int grpc_start_stream_close(void *context, char **err)
 Status ContainerServiceImpl::RemoteStart(ServerContext *context,
                                          ServerReaderWriter<RemoteStartResponse, RemoteStartRequest> *stream)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     service_executor_t *cb = nullptr;
     container_start_request *container_req = nullptr;
     container_start_response *container_res = nullptr;
@@ -317,36 +328,48 @@ Status ContainerServiceImpl::RemoteStart(ServerContext *context,
 
 Status ContainerServiceImpl::Top(ServerContext *context, const TopRequest *request, TopResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto topService = ContainerTopService();
     return SpecificServiceRun<TopRequest, TopResponse>(topService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Stop(ServerContext *context, const StopRequest *request, StopResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     auto stopService = ContainerStopService();
     return SpecificServiceRun<StopRequest, StopResponse>(stopService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Restart(ServerContext *context, const RestartRequest *request, RestartResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     auto restartService = ContainerRestartService();
     return SpecificServiceRun<RestartRequest, RestartResponse>(restartService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Kill(ServerContext *context, const KillRequest *request, KillResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto killService = ContainerKillService();
     return SpecificServiceRun<KillRequest, KillResponse>(killService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Delete(ServerContext *context, const DeleteRequest *request, DeleteResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto deleteService = ContainerDeleteService();
     return SpecificServiceRun<DeleteRequest, DeleteResponse>(deleteService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Exec(ServerContext *context, const ExecRequest *request, ExecResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     auto execService = ContainerExecService();
     return SpecificServiceRun<ExecRequest, ExecResponse>(execService, context, request, reply);
 }
@@ -426,6 +449,8 @@ private:
 Status ContainerServiceImpl::RemoteExec(ServerContext *context,
                                         ServerReaderWriter<RemoteExecResponse, RemoteExecRequest> *stream)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     service_executor_t *cb = nullptr;
     container_exec_request *container_req = nullptr;
     container_exec_response *container_res = nullptr;
@@ -506,6 +531,8 @@ Status ContainerServiceImpl::RemoteExec(ServerContext *context,
 Status ContainerServiceImpl::Inspect(ServerContext *context, const InspectContainerRequest *request,
                                      InspectContainerResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto inspectService = ContainerInspectService();
     return SpecificServiceRun<InspectContainerRequest, InspectContainerResponse>(inspectService, context, request,
                                                                                  reply);
@@ -513,6 +540,8 @@ Status ContainerServiceImpl::Inspect(ServerContext *context, const InspectContai
 
 Status ContainerServiceImpl::List(ServerContext *context, const ListRequest *request, ListResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto listService = ContainerListService();
     return SpecificServiceRun<ListRequest, ListResponse>(listService, context, request, reply);
 }
@@ -598,6 +627,8 @@ Status ContainerServiceImpl::AttachInit(ServerContext *context, service_executor
 
 Status ContainerServiceImpl::Attach(ServerContext *context, ServerReaderWriter<AttachResponse, AttachRequest> *stream)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     service_executor_t *cb = nullptr;
     container_attach_request *container_req = nullptr;
     container_attach_response *container_res = nullptr;
@@ -667,48 +698,64 @@ Status ContainerServiceImpl::Attach(ServerContext *context, ServerReaderWriter<A
 
 Status ContainerServiceImpl::Pause(ServerContext *context, const PauseRequest *request, PauseResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto pauseService = ContainerPauseService();
     return SpecificServiceRun<PauseRequest, PauseResponse>(pauseService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Resume(ServerContext *context, const ResumeRequest *request, ResumeResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto resumeService = ContainerResumeService();
     return SpecificServiceRun<ResumeRequest, ResumeResponse>(resumeService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Export(ServerContext *context, const ExportRequest *request, ExportResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     auto exportService = ContainerExportService();
     return SpecificServiceRun<ExportRequest, ExportResponse>(exportService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Rename(ServerContext *context, const RenameRequest *request, RenameResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto renameService = ContainerRenameService();
     return SpecificServiceRun<RenameRequest, RenameResponse>(renameService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Resize(ServerContext *context, const ResizeRequest *request, ResizeResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto resizeService = ContainerResizeService();
     return SpecificServiceRun<ResizeRequest, ResizeResponse>(resizeService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Update(ServerContext *context, const UpdateRequest *request, UpdateResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     auto updateService = ContainerUpdateService();
     return SpecificServiceRun<UpdateRequest, UpdateResponse>(updateService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Stats(ServerContext *context, const StatsRequest *request, StatsResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     auto statsService = ContainerStatsService();
     return SpecificServiceRun<StatsRequest, StatsResponse>(statsService, context, request, reply);
 }
 
 Status ContainerServiceImpl::Wait(ServerContext *context, const WaitRequest *request, WaitResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     int tret;
     service_executor_t *cb = nullptr;
     container_wait_request *container_req = nullptr;
@@ -792,6 +839,8 @@ Status ContainerServiceImpl::Events(ServerContext *context, const EventsRequest
 Status ContainerServiceImpl::CopyFromContainer(ServerContext *context, const CopyFromContainerRequest *request,
                                                ServerWriter<CopyFromContainerResponse> *writer)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     int tret;
     service_executor_t *cb = nullptr;
     isulad_copy_from_container_request *isuladreq = nullptr;
@@ -841,6 +890,8 @@ ContainerServiceImpl::CopyToContainer(ServerContext *context,
                                       ServerReaderWriter<CopyToContainerResponse, CopyToContainerRequest> *stream)
 
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     int ret;
     service_executor_t *cb = nullptr;
     container_copy_to_request *isuladreq = nullptr;
@@ -953,6 +1004,8 @@ bool grpc_logs_write_function(void *writer, void *data)
 Status ContainerServiceImpl::Logs(ServerContext *context, const LogsRequest *request,
                                   ServerWriter<LogsResponse> *writer)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::STREAM);
+
     int ret = 0;
     service_executor_t *cb = nullptr;
     struct isulad_logs_request *isulad_request = nullptr;
@@ -24,6 +24,7 @@
 #include "isula_libutils/log.h"
 #include "utils.h"
 #include "grpc_server_tls_auth.h"
+#include "grpc_server_admission.h"
 
 int ImagesServiceImpl::image_list_request_from_grpc(const ListImagesRequest *grequest,
                                                     image_list_images_request **request)
@@ -243,6 +244,8 @@ void ImagesServiceImpl::inspect_response_to_grpc(const image_inspect_response *r
 
 Status ImagesServiceImpl::List(ServerContext *context, const ListImagesRequest *request, ListImagesResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -279,6 +282,8 @@ Status ImagesServiceImpl::List(ServerContext *context, const ListImagesRequest *
 
 Status ImagesServiceImpl::Delete(ServerContext *context, const DeleteImageRequest *request, DeleteImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -315,6 +320,8 @@ Status ImagesServiceImpl::Delete(ServerContext *context, const DeleteImageReques
 
 Status ImagesServiceImpl::Tag(ServerContext *context, const TagImageRequest *request, TagImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -367,6 +374,8 @@ void ImagesServiceImpl::import_response_to_grpc(const image_import_response *res
 
 Status ImagesServiceImpl::Import(ServerContext *context, const ImportRequest *request, ImportResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -403,6 +412,8 @@ Status ImagesServiceImpl::Import(ServerContext *context, const ImportRequest *re
 
 Status ImagesServiceImpl::Load(ServerContext *context, const LoadImageRequest *request, LoadImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -440,6 +451,8 @@ Status ImagesServiceImpl::Load(ServerContext *context, const LoadImageRequest *r
 Status ImagesServiceImpl::Inspect(ServerContext *context, const InspectImageRequest *request,
                                   InspectImageResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     int tret;
     service_executor_t *cb = nullptr;
     image_inspect_request *image_req = nullptr;
@@ -524,6 +537,8 @@ int ImagesServiceImpl::image_logout_request_from_grpc(const LogoutRequest *grequ
 
 Status ImagesServiceImpl::Login(ServerContext *context, const LoginRequest *request, LoginResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -562,6 +577,8 @@ Status ImagesServiceImpl::Login(ServerContext *context, const LoginRequest *requ
 
 Status ImagesServiceImpl::Logout(ServerContext *context, const LogoutRequest *request, LogoutResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -691,6 +708,8 @@ void ImagesServiceImpl::search_response_to_grpc(const image_search_images_respon
 
 Status ImagesServiceImpl::Search(ServerContext *context, const SearchRequest *request, SearchResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     int tret;
     service_executor_t *cb = nullptr;
     image_search_images_request *image_req = nullptr;
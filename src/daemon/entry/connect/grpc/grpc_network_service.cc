@@ -22,6 +22,7 @@
 #include "isula_libutils/log.h"
 #include "utils.h"
 #include "error.h"
+#include "grpc_server_admission.h"
 
 using namespace network;
 
@@ -70,6 +71,8 @@ void NetworkServiceImpl::create_response_to_grpc(const network_create_response *
 Status NetworkServiceImpl::Create(ServerContext *context, const NetworkCreateRequest *request,
                                   NetworkCreateResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     int tret;
     service_executor_t *cb = nullptr;
     network_create_response *network_res = nullptr;
@@ -137,6 +140,8 @@ void NetworkServiceImpl::inspect_response_to_grpc(const network_inspect_response
 Status NetworkServiceImpl::Inspect(ServerContext *context, const NetworkInspectRequest *request,
                                    NetworkInspectResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     int tret;
     service_executor_t *cb = nullptr;
     network_inspect_request *network_req = nullptr;
@@ -259,6 +264,8 @@ void NetworkServiceImpl::list_response_to_grpc(const network_list_response *resp
 
 Status NetworkServiceImpl::List(ServerContext *context, const NetworkListRequest *request, NetworkListResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     int tret;
     service_executor_t *cb = nullptr;
     network_list_request *network_req = nullptr;
@@ -324,6 +331,8 @@ void NetworkServiceImpl::remove_response_to_grpc(const network_remove_response *
 Status NetworkServiceImpl::Remove(ServerContext *context, const NetworkRemoveRequest *request,
                                   NetworkRemoveResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     int tret;
     service_executor_t *cb = nullptr;
     network_remove_request *network_req = nullptr;
@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide per class admission control of grpc methods
+ ******************************************************************************/
+
+#include "grpc_server_admission.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "isula_libutils/log.h"
+
+namespace {
+struct AdmissionClass {
+    const char *name;
+    size_t maxRunning;
+    size_t maxWaiting;
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t running;
+    size_t waiting;
+};
+
+// running plus waiting of all classes stays below GRPC_SERVER_MAX_THREADS,
+// the rest is left for calls without a class such as event subscriptions
+AdmissionClass g_admissionClasses[static_cast<int>(RpcClass::CLASS_NUM)] = {
+    { "query", 64, 128, {}, {}, 0, 0 },
+    { "mutation", 32, 256, {}, {}, 0, 0 },
+    { "long running", 128, 32, {}, {}, 0, 0 },
+    { "stream", 256, 32, {}, {}, 0, 0 },
+};
+
+// cancellation of a call is not notified, check it at this interval while waiting
+const std::chrono::milliseconds ADMISSION_CHECK_INTERVAL(100);
+} // namespace
+
+GrpcAdmission::GrpcAdmission(RpcClass rpcClass, const grpc::ServerContext *context)
+    : GrpcAdmission(rpcClass, context != nullptr ? context->deadline() : std::chrono::system_clock::time_point::max(),
+                    [context]() {
+                        return context != nullptr && context->IsCancelled();
+                    })
+{
+}
+
+GrpcAdmission::GrpcAdmission(RpcClass rpcClass, std::chrono::system_clock::time_point deadline,
+                             const std::function<bool()> &isCancelled)
+    : m_class(rpcClass)
+{
+    AdmissionClass &klass = g_admissionClasses[static_cast<int>(rpcClass)];
+    std::unique_lock<std::mutex> lock(klass.mutex);
+
+    if (klass.running < klass.maxRunning) {
+        klass.running++;
+        m_admitted = true;
+        return;
+    }
+
+    if (klass.waiting >= klass.maxWaiting) {
+        WARN("Too many %s calls, %zu running and %zu waiting", klass.name, klass.running, klass.waiting);
+        return;
+    }
+
+    klass.waiting++;
+    while (klass.running >= klass.maxRunning) {
+        if (isCancelled()) {
+            m_rejectedCode = grpc::StatusCode::CANCELLED;
+            break;
+        }
+        auto now = std::chrono::system_clock::now();
+        if (now >= deadline) {
+            m_rejectedCode = grpc::StatusCode::DEADLINE_EXCEEDED;
+            break;
+        }
+        // deadline may be infinite, do not add the interval to it
+        auto until = deadline - now > ADMISSION_CHECK_INTERVAL ? now + ADMISSION_CHECK_INTERVAL : deadline;
+        (void)klass.cond.wait_until(lock, until);
+    }
+    klass.waiting--;
+    if (klass.running >= klass.maxRunning) {
+        return;
+    }
+    klass.running++;
+    m_admitted = true;
+}
+
+GrpcAdmission::~GrpcAdmission()
+{
+    if (!m_admitted) {
+        return;
+    }
+
+    AdmissionClass &klass = g_admissionClasses[static_cast<int>(m_class)];
+    {
+        std::lock_guard<std::mutex> lock(klass.mutex);
+        klass.running--;
+    }
+    klass.cond.notify_one();
+}
+
+grpc::Status GrpcAdmission::RejectedStatus() const
+{
+    const AdmissionClass &klass = g_admissionClasses[static_cast<int>(m_class)];
+
+    if (m_rejectedCode == grpc::StatusCode::CANCELLED) {
+        return grpc::Status(grpc::StatusCode::CANCELLED, std::string("Cancelled while waiting for ") + klass.name +
+                            " requests");
+    }
+    if (m_rejectedCode == grpc::StatusCode::DEADLINE_EXCEEDED) {
+        return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                            std::string("Deadline exceeded while waiting for ") + klass.name + " requests");
+    }
+
+    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                        std::string("Too many ") + klass.name + " requests, try again later");
+}
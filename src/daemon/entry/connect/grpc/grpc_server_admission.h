@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide per class admission control of grpc methods
+ ******************************************************************************/
+
+#ifndef DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_ADMISSION_H
+#define DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_ADMISSION_H
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <grpc++/grpc++.h>
+
+// Concurrency classes of grpc methods, each class has its own bound so that
+// bursty queries, lifecycle mutations and long running calls can not starve each other.
+// Streams and waits live as long as the container or the client, they get their own
+// class so that they can not hold the slots of stop or kill.
+enum class RpcClass {
+    QUERY = 0,
+    MUTATION,
+    LONG_RUNNING,
+    STREAM,
+    CLASS_NUM,
+};
+
+// Upper bound of the sync server threads, grpc fails new calls with
+// RESOURCE_EXHAUSTED instead of creating more threads
+#define GRPC_SERVER_MAX_THREADS 1024
+
+// Holds a slot of the class for the lifetime of the call. A call waits for a
+// slot while the waiting queue of its class has room, otherwise it is rejected.
+// A waiting call gives up when its deadline is exceeded or it is cancelled.
+class GrpcAdmission {
+public:
+    GrpcAdmission(RpcClass rpcClass, const grpc::ServerContext *context);
+    GrpcAdmission(RpcClass rpcClass, std::chrono::system_clock::time_point deadline,
+                  const std::function<bool()> &isCancelled);
+    GrpcAdmission(const GrpcAdmission &) = delete;
+    GrpcAdmission &operator=(const GrpcAdmission &) = delete;
+    ~GrpcAdmission();
+
+    bool Admitted() const
+    {
+        return m_admitted;
+    }
+
+    grpc::Status RejectedStatus() const;
+
+private:
+    RpcClass m_class;
+    bool m_admitted { false };
+    grpc::StatusCode m_rejectedCode { grpc::StatusCode::RESOURCE_EXHAUSTED };
+};
+
+#define GRPC_ADMISSION_OR_RETURN(context, rpcClass)             \
+    GrpcAdmission grpcAdmission(rpcClass, context);             \
+    if (!grpcAdmission.Admitted()) {                            \
+        return grpcAdmission.RejectedStatus();                  \
+    }
+
+#endif // DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_ADMISSION_H
@@ -0,0 +1,47 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide grpc server interceptor recording per method statistics
+ ******************************************************************************/
+
+#include "grpc_server_stats_interceptor.h"
+
+using grpc::experimental::InterceptionHookPoints;
+
+ServerStatsInterceptor::ServerStatsInterceptor(grpc::experimental::ServerRpcInfo *info)
+{
+    m_stats = rpc_stats_method(RPC_STATS_KIND_GRPC, info->method());
+    m_begin = rpc_stats_begin(m_stats);
+}
+
+ServerStatsInterceptor::~ServerStatsInterceptor()
+{
+    // cancelled before a status was sent
+    if (!m_done) {
+        rpc_stats_end(m_stats, m_begin, true);
+    }
+}
+
+void ServerStatsInterceptor::Intercept(grpc::experimental::InterceptorBatchMethods *methods)
+{
+    if (!m_done && methods->QueryInterceptionHookPoint(InterceptionHookPoints::PRE_SEND_STATUS)) {
+        rpc_stats_end(m_stats, m_begin, !methods->GetSendStatus().ok());
+        m_done = true;
+    }
+    methods->Proceed();
+}
+
+grpc::experimental::Interceptor *
+ServerStatsInterceptorFactory::CreateServerInterceptor(grpc::experimental::ServerRpcInfo *info)
+{
+    return new ServerStatsInterceptor(info);
+}
@@ -0,0 +1,42 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide grpc server interceptor recording per method statistics
+ ******************************************************************************/
+
+#ifndef DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_STATS_INTERCEPTOR_H
+#define DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_STATS_INTERCEPTOR_H
+#include <grpc++/grpc++.h>
+#include <grpcpp/support/server_interceptor.h>
+
+#include "rpc_stats.h"
+
+// Created by grpc for every call, including CRI services, the call is done when its status is sent
+class ServerStatsInterceptor : public grpc::experimental::Interceptor {
+public:
+    explicit ServerStatsInterceptor(grpc::experimental::ServerRpcInfo *info);
+    ~ServerStatsInterceptor() override;
+
+    void Intercept(grpc::experimental::InterceptorBatchMethods *methods) override;
+
+private:
+    rpc_method_stats_t *m_stats { nullptr };
+    int64_t m_begin { 0 };
+    bool m_done { false };
+};
+
+class ServerStatsInterceptorFactory : public grpc::experimental::ServerInterceptorFactoryInterface {
+public:
+    grpc::experimental::Interceptor *CreateServerInterceptor(grpc::experimental::ServerRpcInfo *info) override;
+};
+
+#endif // DAEMON_ENTRY_CONNECT_GRPC_GRPC_SERVER_STATS_INTERCEPTOR_H
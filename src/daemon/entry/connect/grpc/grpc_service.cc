@@ -31,6 +31,8 @@
 #include "isula_libutils/log.h"
 #include "errors.h"
 #include "grpc_server_tls_auth.h"
+#include "grpc_server_stats_interceptor.h"
+#include "grpc_server_admission.h"
 #include "utils.h"
 
 using grpc::SslServerCredentialsOptions;
@@ -87,6 +89,17 @@ public:
         // Register all CRI GRPC services
         m_criService.Register(m_builder);
 
+        // Bound the sync server threads, methods are further limited per class by GrpcAdmission
+        grpc::ResourceQuota quota("isulad_grpc_server");
+        quota.SetMaxThreads(GRPC_SERVER_MAX_THREADS);
+        m_builder.SetResourceQuota(quota);
+
+        // Record latency and concurrency of every method
+        std::vector<std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>> interceptors;
+        interceptors.push_back(std::unique_ptr<grpc::experimental::ServerInterceptorFactoryInterface>(
+                                   new ServerStatsInterceptorFactory()));
+        m_builder.experimental().SetInterceptorCreators(std::move(interceptors));
+
         // Finally assemble the server.
         m_server = m_builder.BuildAndStart();
         if (m_server == nullptr) {
@@ -24,6 +24,7 @@
 #include "isula_libutils/log.h"
 #include "utils.h"
 #include "grpc_server_tls_auth.h"
+#include "grpc_server_admission.h"
 
 int VolumeServiceImpl::volume_list_request_from_grpc(const ListVolumeRequest *grequest,
                                                      volume_list_volume_request **request)
@@ -118,6 +119,8 @@ int VolumeServiceImpl::volume_prune_response_to_grpc(volume_prune_volume_respons
 
 Status VolumeServiceImpl::List(ServerContext *context, const ListVolumeRequest *request, ListVolumeResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::QUERY);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -157,6 +160,8 @@ Status VolumeServiceImpl::List(ServerContext *context, const ListVolumeRequest *
 Status VolumeServiceImpl::Remove(ServerContext *context, const RemoveVolumeRequest *request,
                                  RemoveVolumeResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::MUTATION);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
@@ -195,6 +200,8 @@ Status VolumeServiceImpl::Remove(ServerContext *context, const RemoveVolumeReque
 
 Status VolumeServiceImpl::Prune(ServerContext *context, const PruneVolumeRequest *request, PruneVolumeResponse *reply)
 {
+    GRPC_ADMISSION_OR_RETURN(context, RpcClass::LONG_RUNNING);
+
     if (context == nullptr || request == nullptr || reply == nullptr) {
         ERROR("Invalid arguments");
         return Status(StatusCode::INVALID_ARGUMENT, "Invalid arguments");
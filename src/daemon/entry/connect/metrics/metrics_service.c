@@ -38,35 +38,70 @@ typedef struct metrics_server_param {
 static struct metrics_server_param *g_metrics_htp_param = NULL;
 #endif
 
+typedef struct metrics_reply_ctx {
+    evhtp_request_t *req;
+    bool started;
+} metrics_reply_ctx_t;
+
+/* the reply is started on the first metric family, so an empty export can still fail */
+static int metrics_reply_write(void *ctx, const char *data, size_t len)
+{
+    int ret = 0;
+    metrics_reply_ctx_t *reply = (metrics_reply_ctx_t *)ctx;
+    struct evbuffer *chunk = NULL;
+
+    if (len == 0) {
+        return 0;
+    }
+
+    if (!reply->started) {
+        evhtp_headers_add_header(reply->req->headers_out,
+                                 evhtp_header_new("Content-Type", "text/plain; version=0.0.4; charset=utf-8", 0, 0));
+        evhtp_send_reply_chunk_start(reply->req, METRIC_RESPONSE_OK);
+        reply->started = true;
+    }
+
+    chunk = evbuffer_new();
+    if (chunk == NULL) {
+        ERROR("Out of memory");
+        return -1;
+    }
+
+    if (evbuffer_add(chunk, data, len) != 0) {
+        ERROR("Failed to add metrics to chunk");
+        ret = -1;
+        goto out;
+    }
+    evhtp_send_reply_chunk(reply->req, chunk);
+
+out:
+    evbuffer_free(chunk);
+    return ret;
+}
+
 void metrics_get_by_type_cb(evhtp_request_t *req, void *arg)
 {
-    char *metrics = NULL;
-    int ret_code = METRIC_RESPONSE_OK;
-    int len = 0;
     const char *req_type = NULL;
     service_executor_t *cb = NULL;
+    metrics_reply_ctx_t reply = { .req = req, .started = false };
 
     cb = get_service_executor();
     if (cb == NULL || cb->metrics.export_metrics_by_type == NULL) {
-        ret_code = METRIC_NOT_IMPL;
-        goto out;
+        evhtp_send_reply(req, METRIC_NOT_IMPL);
+        return;
     }
 
     req_type = req->uri->path->full + strlen(req->uri->path->path); /* full path include request url */
-    (void)cb->metrics.export_metrics_by_type(req_type, &metrics, &len);
-    if (metrics == NULL || len == 0) {
-        ret_code = METRIC_RESPONSE_FAIL;
-        goto out;
+    if (cb->metrics.export_metrics_by_type(req_type, metrics_reply_write, &reply) != 0) {
+        ERROR("Failed to export metrics %s", req_type);
     }
 
-    evhtp_headers_add_header(req->headers_out,
-                             evhtp_header_new("Content-Type", "text/plain; verion:0.0.4; charset=utf-8", 0, 0));
-    evbuffer_add(req->buffer_out, metrics, len);
-    free(metrics);
-    metrics = NULL;
+    if (!reply.started) {
+        evhtp_send_reply(req, METRIC_RESPONSE_FAIL);
+        return;
+    }
 
-out:
-    evhtp_send_reply(req, ret_code);
+    evhtp_send_reply_chunk_end(req);
 }
 
 #if (defined GRPC_CONNECTOR) && (defined ENABLE_METRICS)
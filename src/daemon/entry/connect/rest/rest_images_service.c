@@ -1013,52 +1013,52 @@ out:
 /* rest register images handler */
 int rest_register_images_handler(evhtp_t *htp)
 {
-    if (evhtp_set_cb(htp, ImagesServiceLoad, rest_image_load_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceLoad, rest_image_load_cb) == NULL) {
         ERROR("Failed to register image load callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceList, rest_image_list_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceList, rest_image_list_cb) == NULL) {
         ERROR("Failed to register image list callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceDelete, rest_image_delete_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceDelete, rest_image_delete_cb) == NULL) {
         ERROR("Failed to register image delete callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceInspect, rest_image_inspect_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceInspect, rest_image_inspect_cb) == NULL) {
         ERROR("Failed to register image inspect callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServicePull, rest_image_pull_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServicePull, rest_image_pull_cb) == NULL) {
         ERROR("Failed to register image pull callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceLogin, rest_image_login_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceLogin, rest_image_login_cb) == NULL) {
         ERROR("Failed to register image login callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceLogout, rest_image_logout_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceLogout, rest_image_logout_cb) == NULL) {
         ERROR("Failed to register image logout callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceTag, rest_image_tag_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceTag, rest_image_tag_cb) == NULL) {
         ERROR("Failed to register image logout callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, ImagesServiceImport, rest_image_import_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceImport, rest_image_import_cb) == NULL) {
         ERROR("Failed to register image logout callback");
         return -1;
     }
 #ifdef ENABLE_IMAGE_SEARCH
-    if (evhtp_set_cb(htp, ImagesServiceSearch, rest_image_search_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, ImagesServiceSearch, rest_image_search_cb) == NULL) {
         ERROR("Failed to register image search callback");
         return -1;
     }
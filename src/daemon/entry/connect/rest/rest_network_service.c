@@ -404,19 +404,19 @@ out:
 /* rest register network handler */
 int rest_register_network_handler(evhtp_t *htp)
 {
-    if (evhtp_set_cb(htp, NetworkServiceCreate, rest_network_create_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, NetworkServiceCreate, rest_network_create_cb) == NULL) {
         ERROR("Failed to register create callback");
         return -1;
     }
-    if (evhtp_set_cb(htp, NetworkServiceInspect, rest_network_inspect_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, NetworkServiceInspect, rest_network_inspect_cb) == NULL) {
         ERROR("Failed to register inspect callback");
         return -1;
     }
-    if (evhtp_set_cb(htp, NetworkServiceList, rest_network_list_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, NetworkServiceList, rest_network_list_cb) == NULL) {
         ERROR("Failed to register list callback");
         return -1;
     }
-    if (evhtp_set_cb(htp, NetworkServiceRemove, rest_network_remove_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, NetworkServiceRemove, rest_network_remove_cb) == NULL) {
         ERROR("Failed to register remove callback");
         return -1;
     }
@@ -19,6 +19,7 @@
 
 #include "isula_libutils/log.h"
 #include "utils.h"
+#include "rpc_stats.h"
 
 #define UNIX_PATH_MAX 128
 #define MAX_BODY_SIZE (128 * 1024)
@@ -96,3 +97,46 @@ void evhtp_send_response(evhtp_request_t *req, const char *responsedata, int res
     evhtp_send_reply(req, rescode);
 }
 
+typedef struct rest_stats_cb_arg {
+    evhtp_callback_cb cb;
+    rpc_method_stats_t *stats;
+} rest_stats_cb_arg_t;
+
+/* handlers reply before they return, so the callback duration is the request latency */
+static void rest_stats_cb(evhtp_request_t *req, void *arg)
+{
+    rest_stats_cb_arg_t *stats_arg = (rest_stats_cb_arg_t *)arg;
+    int64_t begin = rpc_stats_begin(stats_arg->stats);
+
+    stats_arg->cb(req, NULL);
+
+    rpc_stats_end(stats_arg->stats, begin, evhtp_request_status(req) >= EVHTP_RES_400);
+}
+
+/* register a rest handler with per path statistics, the handler gets a NULL arg */
+evhtp_callback_t *rest_set_cb(evhtp_t *htp, const char *path, evhtp_callback_cb cb)
+{
+    evhtp_callback_t *htp_cb = NULL;
+    rest_stats_cb_arg_t *stats_arg = NULL;
+
+    if (htp == NULL || path == NULL || cb == NULL) {
+        ERROR("Invalid input arguments");
+        return NULL;
+    }
+
+    /* lives as long as the registered callback, which is never unregistered */
+    stats_arg = util_common_calloc_s(sizeof(rest_stats_cb_arg_t));
+    if (stats_arg == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+    stats_arg->cb = cb;
+    stats_arg->stats = rpc_stats_method(RPC_STATS_KIND_REST, path);
+
+    htp_cb = evhtp_set_cb(htp, path, rest_stats_cb, stats_arg);
+    if (htp_cb == NULL) {
+        free(stats_arg);
+    }
+
+    return htp_cb;
+}
@@ -29,6 +29,8 @@ void put_body(char *body);
 
 void evhtp_send_response(evhtp_request_t *req, const char *responsedata, int rescode);
 
+evhtp_callback_t *rest_set_cb(evhtp_t *htp, const char *path, evhtp_callback_cb cb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -299,17 +299,17 @@ out:
 
 int rest_register_volumes_handler(evhtp_t *htp)
 {
-    if (evhtp_set_cb(htp, VolumesServiceList, rest_volumes_list_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, VolumesServiceList, rest_volumes_list_cb) == NULL) {
         ERROR("Failed to register list callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, VolumesServiceRemove, rest_volumes_remove_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, VolumesServiceRemove, rest_volumes_remove_cb) == NULL) {
         ERROR("Failed to register remove callback");
         return -1;
     }
 
-    if (evhtp_set_cb(htp, VolumesServicePrune, rest_volumes_prune_cb, NULL) == NULL) {
+    if (rest_set_cb(htp, VolumesServicePrune, rest_volumes_prune_cb) == NULL) {
         ERROR("Failed to register prune callback");
         return -1;
     }
@@ -14,68 +14,237 @@
  ******************************************************************************/
 #include "session.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <atomic>
+#include <vector>
 #include <isula_libutils/log.h>
 #include "ws_server.h"
 #include "utils.h"
 
 namespace {
-// io copy maximum single transfer 4K, let max total buffer size: 1GB
-const int FIFO_LIST_BUFFER_MAX_LEN = 262144;
+// every session buffers at most 256K data for the client, a frame carries at most MAX_BUFFER_SIZE bytes
+const size_t SESSION_RING_SIZE = 256 * 1024;
+const size_t SESSION_FRAME_HEADER_LEN = 1 + sizeof(uint32_t);
+// keep the rings of closed sessions for reuse, short exec sessions come and go frequently
+const size_t SESSION_RING_POOL_MAX = 32;
+// how long a writer waits for the client to drain the ring before the data is dropped
+const auto SESSION_WRITE_TIMEOUT = std::chrono::seconds(30);
+
+std::mutex g_ringPoolMutex;
+std::vector<unsigned char *> g_ringPool;
+
+std::atomic<uint64_t> g_sessionsClosed { 0 };
+std::atomic<uint64_t> g_sessionBytesOut { 0 };
+std::atomic<uint64_t> g_sessionMessagesDropped { 0 };
+
+unsigned char *GetRingFromPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_ringPoolMutex);
+        if (!g_ringPool.empty()) {
+            auto *ring = g_ringPool.back();
+            g_ringPool.pop_back();
+            return ring;
+        }
+    }
+
+    return static_cast<unsigned char *>(util_common_calloc_s(SESSION_RING_SIZE));
+}
+
+void PutRingToPool(unsigned char *ring)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_ringPoolMutex);
+        if (g_ringPool.size() < SESSION_RING_POOL_MAX) {
+            g_ringPool.push_back(ring);
+            return;
+        }
+    }
+
+    free(ring);
+}
+
+void RingCopyIn(unsigned char *ring, size_t offset, const void *data, size_t len)
+{
+    size_t first = std::min(len, SESSION_RING_SIZE - offset);
+
+    (void)memcpy(ring + offset, data, first);
+    if (first < len) {
+        (void)memcpy(ring, static_cast<const unsigned char *>(data) + first, len - first);
+    }
+}
+
+// write as much as the fd takes now, return the written length
+ssize_t WriteAvailable(int fd, const char *data, size_t len)
+{
+    size_t written = 0;
+
+    while (written < len) {
+        ssize_t n = write(fd, data + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return -1;
+        }
+        written += static_cast<size_t>(n);
+    }
+
+    return static_cast<ssize_t>(written);
+}
+
+void RingCopyOut(const unsigned char *ring, size_t offset, void *data, size_t len)
+{
+    size_t first = std::min(len, SESSION_RING_SIZE - offset);
+
+    (void)memcpy(data, ring + offset, first);
+    if (first < len) {
+        (void)memcpy(static_cast<unsigned char *>(data) + first, ring, len - first);
+    }
+}
 }; // namespace
 
-unsigned char *SessionData::FrontMessage()
+int SessionData::InitBuffer()
+{
+    ring = GetRingFromPool();
+    if (ring == nullptr) {
+        ERROR("Out of memory");
+        return -1;
+    }
+    ringHead = 0;
+    ringUsed = 0;
+    stalled = false;
+    pendingStdin.clear();
+    stdinPaused = false;
+    stats = SessionStats {};
+    stats.created = std::chrono::steady_clock::now();
+
+    return 0;
+}
+
+void SessionData::FreeBuffer()
 {
-    unsigned char *message = nullptr;
+    if (ring == nullptr) {
+        return;
+    }
+
+    PutRingToPool(ring);
+    ring = nullptr;
+    ringHead = 0;
+    ringUsed = 0;
+}
 
+bool SessionData::HasMessage()
+{
     if (sessionMutex == nullptr) {
-        return nullptr;
+        return false;
     }
 
-    sessionMutex->lock();
-    message = buffer.front();
-    sessionMutex->unlock();
+    std::lock_guard<std::mutex> lock(*sessionMutex);
+    return ringUsed > 0;
+}
 
-    return message;
+ssize_t SessionData::FrontMessage(unsigned char *buf, size_t len)
+{
+    uint32_t dataLen = 0;
+
+    if (sessionMutex == nullptr || buf == nullptr || len == 0) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(*sessionMutex);
+    if (ringUsed == 0) {
+        return -1;
+    }
+
+    buf[0] = ring[ringHead];
+    RingCopyOut(ring, (ringHead + 1) % SESSION_RING_SIZE, &dataLen, sizeof(dataLen));
+    if (dataLen > len - 1) {
+        ERROR("Message length %u exceeds the buffer length %zu", dataLen, len);
+        return -1;
+    }
+    RingCopyOut(ring, (ringHead + SESSION_FRAME_HEADER_LEN) % SESSION_RING_SIZE, buf + 1, dataLen);
+
+    return static_cast<ssize_t>(dataLen) + 1;
 }
 
 void SessionData::PopMessage()
 {
+    uint32_t dataLen = 0;
+
     if (sessionMutex == nullptr) {
         return;
     }
 
-    sessionMutex->lock();
-    buffer.pop_front();
-    sessionMutex->unlock();
+    {
+        std::lock_guard<std::mutex> lock(*sessionMutex);
+        if (ringUsed == 0) {
+            return;
+        }
+        RingCopyOut(ring, (ringHead + 1) % SESSION_RING_SIZE, &dataLen, sizeof(dataLen));
+        ringHead = (ringHead + SESSION_FRAME_HEADER_LEN + dataLen) % SESSION_RING_SIZE;
+        ringUsed -= SESSION_FRAME_HEADER_LEN + dataLen;
+        stats.bytesOut += dataLen;
+        stats.messagesOut++;
+        stalled = false;
+    }
+
+    // wake up the writers waiting for room
+    bufferCond->notify_all();
 }
 
-int SessionData::PushMessage(unsigned char *message)
+int SessionData::PushMessage(unsigned char channel, const void *data, size_t len)
 {
-    if (sessionMutex == nullptr) {
+    size_t frameLen = SESSION_FRAME_HEADER_LEN + len;
+    uint32_t dataLen = static_cast<uint32_t>(len);
+
+    if (sessionMutex == nullptr || bufferCond == nullptr) {
         return -1;
     }
 
-    sessionMutex->lock();
-
-    if (!close && buffer.size() < FIFO_LIST_BUFFER_MAX_LEN) {
-        buffer.push_back(message);
-        sessionMutex->unlock();
-        return 0;
+    std::unique_lock<std::mutex> lock(*sessionMutex);
+    if (ring == nullptr || frameLen > SESSION_RING_SIZE) {
+        stats.messagesDropped++;
+        return -1;
     }
 
-    // In extreme scenarios, websocket data cannot be processed,
-    // ignore the data coming in later to prevent iSulad from getting stuck
-    free(message);
-    sessionMutex->unlock();
+    if (!close && ringUsed + frameLen > SESSION_RING_SIZE) {
+        // the client did not read within the timeout, do not hold up every following message as well
+        if (stalled) {
+            stats.messagesDropped++;
+            return -1;
+        }
+        stats.backpressureWaits++;
+        // the client drains the ring from the websocket service thread, wait for it
+        if (!bufferCond->wait_for(lock, SESSION_WRITE_TIMEOUT,
+                                  [this, frameLen] { return close || ringUsed + frameLen <= SESSION_RING_SIZE; })) {
+            // In extreme scenarios, websocket data cannot be processed,
+            // ignore the data coming in later to prevent iSulad from getting stuck
+            stalled = true;
+            stats.messagesDropped++;
+            ERROR("Client of session %s does not read data, drop messages until it does", suffix.c_str());
+            return -1;
+        }
+    }
 
     if (close) {
+        stats.messagesDropped++;
         DEBUG("Closed session");
-    }
-    if (buffer.size() >= FIFO_LIST_BUFFER_MAX_LEN) {
-        ERROR("Too large: %zu message!", buffer.size());
+        return -1;
     }
 
-    return -1;
+    size_t tail = (ringHead + ringUsed) % SESSION_RING_SIZE;
+    ring[tail] = channel;
+    RingCopyIn(ring, (tail + 1) % SESSION_RING_SIZE, &dataLen, sizeof(dataLen));
+    RingCopyIn(ring, (tail + SESSION_FRAME_HEADER_LEN) % SESSION_RING_SIZE, data, len);
+    ringUsed += frameLen;
+    stats.peakQueueBytes = std::max(stats.peakQueueBytes, ringUsed);
+
+    return 0;
 }
 
 bool SessionData::IsClosed()
@@ -102,6 +271,10 @@ void SessionData::CloseSession()
     sessionMutex->lock();
     close = true;
     sessionMutex->unlock();
+
+    if (bufferCond != nullptr) {
+        bufferCond->notify_all();
+    }
 }
 
 bool SessionData::IsStdinComplete()
@@ -130,6 +303,63 @@ void SessionData::SetStdinComplete(bool complete)
     sessionMutex->unlock();
 }
 
+int SessionData::WriteStdin(const char *data, size_t len)
+{
+    ssize_t n = 0;
+
+    if (len == 0) {
+        return 0;
+    }
+
+    // keep the order of stdin, the new data goes after what the container has not taken yet
+    if (!pendingStdin.empty()) {
+        pendingStdin.append(data, len);
+        return FlushStdin();
+    }
+
+    if (pipes.at(1) < 0) {
+        return -1;
+    }
+
+    n = WriteAvailable(pipes.at(1), data, len);
+    if (n < 0) {
+        return -1;
+    }
+    if (static_cast<size_t>(n) < len) {
+        pendingStdin.assign(data + n, len - static_cast<size_t>(n));
+    }
+
+    return 0;
+}
+
+int SessionData::FlushStdin()
+{
+    ssize_t n = 0;
+
+    if (pendingStdin.empty()) {
+        return 0;
+    }
+
+    if (pipes.at(1) < 0) {
+        pendingStdin.clear();
+        return -1;
+    }
+
+    n = WriteAvailable(pipes.at(1), pendingStdin.data(), pendingStdin.size());
+    if (n < 0) {
+        pendingStdin.clear();
+        return -1;
+    }
+    pendingStdin.erase(0, static_cast<size_t>(n));
+
+    return 0;
+}
+
+bool SessionData::HasPendingStdin()
+{
+    return !pendingStdin.empty();
+}
+
 void SessionData::EraseAllMessage()
 {
     if (sessionMutex == nullptr) {
@@ -137,12 +367,36 @@ void SessionData::EraseAllMessage()
     }
 
     sessionMutex->lock();
-    for (auto iter = buffer.begin(); iter != buffer.end();) {
-        free(*iter);
-        *iter = NULL;
-        iter = buffer.erase(iter);
-    }
+    ringHead = 0;
+    ringUsed = 0;
     sessionMutex->unlock();
+
+    if (bufferCond != nullptr) {
+        bufferCond->notify_all();
+    }
+}
+
+void SessionData::LogStats()
+{
+    auto lifetime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                          stats.created);
+    uint64_t closed = ++g_sessionsClosed;
+    uint64_t totalBytes = (g_sessionBytesOut += stats.bytesOut);
+    uint64_t totalDropped = (g_sessionMessagesDropped += stats.messagesDropped);
+
+    DEBUG("Session %s of container %s closed: lifetime %lldms, sent %llu bytes in %llu messages, "
+          "peak queue %zu bytes, %llu backpressure waits, %llu messages dropped",
+          suffix.c_str(), containerID.c_str(), static_cast<long long>(lifetime.count()),
+          static_cast<unsigned long long>(stats.bytesOut), static_cast<unsigned long long>(stats.messagesOut),
+          stats.peakQueueBytes, static_cast<unsigned long long>(stats.backpressureWaits),
+          static_cast<unsigned long long>(stats.messagesDropped));
+    if (stats.messagesDropped > 0) {
+        WARN("Session %s dropped %llu messages, %llu messages dropped by %llu closed sessions in total",
+             suffix.c_str(), static_cast<unsigned long long>(stats.messagesDropped),
+             static_cast<unsigned long long>(totalDropped), static_cast<unsigned long long>(closed));
+    }
+    DEBUG("Websocket sessions closed %llu, sent %llu bytes in total", static_cast<unsigned long long>(closed),
+          static_cast<unsigned long long>(totalBytes));
 }
 
 
@@ -150,23 +404,13 @@ namespace {
 // TODO: we should change WebsocketChannel to common type
 void DoWriteToClient(SessionData *session, const void *data, size_t len, WebsocketChannel channel)
 {
-    auto *buf = static_cast<unsigned char *>(util_common_calloc_s(LWS_PRE + MAX_BUFFER_SIZE + 1));
-    if (buf == nullptr) {
-        ERROR("Out of memory");
-        return;
-    }
     if (len > MAX_BUFFER_SIZE) {
         ERROR("Message exceeds maximum length %d, len = %zu", MAX_BUFFER_SIZE, len);
-        free(buf);
         return;
     }
-    // Determine if it is standard output channel or error channel
-    buf[LWS_PRE] = static_cast<int>(channel);
-
-    (void)memcpy(&buf[LWS_PRE + 1], const_cast<void *>(data), len);
 
-    // push back to message list
-    if (session->PushMessage(buf) != 0) {
+    // Determine if it is standard output channel or error channel, blocks while the ring is full
+    if (session->PushMessage(static_cast<unsigned char>(channel), data, len) != 0) {
         ERROR("Abnormal, websocket data cannot be processed, ignore the data"
               "coming in later to prevent daemon from getting stuck");
     }
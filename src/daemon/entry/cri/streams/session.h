@@ -22,6 +22,9 @@
 #include <map>
 #include <unistd.h>
 #include <array>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <semaphore.h>
 #include "request_cache.h"
 
@@ -29,24 +32,60 @@ namespace {
 const int MAX_ARRAY_LEN = 2;
 }
 
+struct SessionStats {
+    std::chrono::steady_clock::time_point created;
+    uint64_t bytesOut;
+    uint64_t messagesOut;
+    uint64_t messagesDropped;
+    uint64_t backpressureWaits;
+    size_t peakQueueBytes;
+};
+
+/*
+ * Messages to the client are queued in a bounded ring of frames, every frame is
+ * a one byte channel, a four bytes length and the payload. The ring is taken from
+ * a shared pool of fixed size buffers, writers block while the ring is full. Once
+ * a writer timed out, later writers drop at once until the client reads again.
+ *
+ * Stdin from the client is never written blocking, the service thread drains the
+ * ring too. What the container does not take yet waits in pendingStdin.
+ */
 struct SessionData {
     std::array<int, MAX_ARRAY_LEN> pipes;
     volatile bool close;
     std::mutex *sessionMutex;
+    std::condition_variable *bufferCond;
     sem_t *syncCloseSem;
-    std::list<unsigned char *> buffer;
+    unsigned char *ring;
+    size_t ringHead;
+    size_t ringUsed;
     std::string containerID;
     std::string suffix;
     volatile bool completeStdin;
+    // only used by the websocket service thread
+    std::string pendingStdin;
+    bool stdinPaused;
+    // guarded by sessionMutex
+    bool stalled;
+    SessionStats stats;
 
-    unsigned char *FrontMessage();
+    int InitBuffer();
+    void FreeBuffer();
+    bool HasMessage();
+    // copy the front message to buf as channel byte followed by the payload, return the copied length
+    ssize_t FrontMessage(unsigned char *buf, size_t len);
     void PopMessage();
-    int PushMessage(unsigned char *message);
+    int PushMessage(unsigned char channel, const void *data, size_t len);
     bool IsClosed();
     void CloseSession();
     void EraseAllMessage();
     bool IsStdinComplete();
     void SetStdinComplete(bool complete);
+    // write stdin to the container without blocking, keep the rest for FlushStdin
+    int WriteStdin(const char *data, size_t len);
+    int FlushStdin();
+    bool HasPendingStdin();
+    void LogStats();
 };
 
 ssize_t WsWriteStdoutToClient(void *context, const void *data, size_t len);
@@ -154,21 +154,78 @@ void WebsocketServer::RegisterCallback(const std::string &path, std::shared_ptr<
     m_handler.RegisterCallback(path, callback);
 }
 
+void WebsocketServer::ReleaseSession(SessionData *session)
+{
+    session->LogStats();
+    if (session->pipes.at(1) >= 0) {
+        close(session->pipes.at(1));
+        session->pipes.at(1) = -1;
+    }
+    close(session->pipes.at(0));
+    (void)sem_destroy(session->syncCloseSem);
+    delete session->syncCloseSem;
+    session->syncCloseSem = nullptr;
+    session->FreeBuffer();
+    delete session->bufferCond;
+    session->bufferCond = nullptr;
+    delete session->sessionMutex;
+    session->sessionMutex = nullptr;
+    delete session;
+}
+
 void WebsocketServer::CloseAllWsSession()
 {
     WriteGuard<RWMutex> lock(m_mutex);
     for (auto it = m_wsis.begin(); it != m_wsis.end(); ++it) {
         it->second->EraseAllMessage();
-        close(it->second->pipes.at(0));
-        close(it->second->pipes.at(1));
-        (void)sem_destroy(it->second->syncCloseSem);
-        delete it->second->syncCloseSem;
-        delete it->second->sessionMutex;
-        delete it->second;
+        ReleaseSession(it->second);
     }
     m_wsis.clear();
 }
 
+void WebsocketServer::SessionReaperThread()
+{
+    const auto pollInterval = std::chrono::milliseconds(100);
+
+    prctl(PR_SET_NAME, "WSSessionGC");
+
+    std::unique_lock<std::mutex> lock(m_reapMutex);
+    while (!m_reaperExit) {
+        for (auto it = m_closingSessions.begin(); it != m_closingSessions.end();) {
+            // the stream task posts the semaphore once it stops using the session
+            if (sem_trywait((*it)->syncCloseSem) == 0) {
+                ReleaseSession(*it);
+                it = m_closingSessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (m_closingSessions.empty()) {
+            m_reapCond.wait(lock, [this] { return m_reaperExit || !m_closingSessions.empty(); });
+        } else {
+            (void)m_reapCond.wait_for(lock, pollInterval);
+        }
+    }
+
+    if (!m_closingSessions.empty()) {
+        WARN("%zu websocket sessions are still in use at exit", m_closingSessions.size());
+    }
+}
+
+void WebsocketServer::StopSessionReaper()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_reapMutex);
+        m_reaperExit = true;
+    }
+    m_reapCond.notify_all();
+
+    if (m_sessionReaper.joinable()) {
+        m_sessionReaper.join();
+    }
+}
+
 void WebsocketServer::CloseWsSession(int socketID)
 {
     m_mutex.wrlock();
@@ -183,25 +240,20 @@ void WebsocketServer::CloseWsSession(int socketID)
     m_wsis.erase(it);
     m_mutex.unlock();
 
-    std::thread([session]() {
-        prctl(PR_SET_NAME, "WSSessionGC");
-        session->CloseSession();
-        session->EraseAllMessage();
-        // close the pipe write endpoint first, make sure io copy thread exit,
-        // otherwise epoll will trigger EOF
-        if (session->pipes.at(1) >= 0) {
-            close(session->pipes.at(1));
-            session->pipes.at(1) = -1;
-        }
-        (void)sem_wait(session->syncCloseSem);
-        (void)sem_destroy(session->syncCloseSem);
-        delete session->syncCloseSem;
-        session->syncCloseSem = nullptr;
-        close(session->pipes.at(0));
-        delete session->sessionMutex;
-        session->sessionMutex = nullptr;
-        delete session;
-    }).detach();
+    session->CloseSession();
+    session->EraseAllMessage();
+    // close the pipe write endpoint first, make sure io copy thread exit,
+    // otherwise epoll will trigger EOF
+    if (session->pipes.at(1) >= 0) {
+        close(session->pipes.at(1));
+        session->pipes.at(1) = -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_reapMutex);
+        m_closingSessions.push_back(session);
+    }
+    m_reapCond.notify_one();
 }
 
 int WebsocketServer::GenerateSessionData(SessionData *session, const std::string &containerID) noexcept
@@ -209,6 +261,7 @@ int WebsocketServer::GenerateSessionData(SessionData *session, const std::string
     char *suffix = nullptr;
     int readPipeFd[2] = { -1, -1 };
     std::mutex *bufMutex = nullptr;
+    std::condition_variable *bufCond = nullptr;
     sem_t *syncCloseSem = nullptr;
 
     suffix = CRIHelpers::GenerateExecSuffix();
@@ -223,6 +276,7 @@ int WebsocketServer::GenerateSessionData(SessionData *session, const std::string
     }
 
     bufMutex = new std::mutex;
+    bufCond = new std::condition_variable;
     syncCloseSem = new sem_t;
 
     if (sem_init(syncCloseSem, 0, 0) != 0) {
@@ -230,8 +284,15 @@ int WebsocketServer::GenerateSessionData(SessionData *session, const std::string
         goto out;
     }
 
+    if (session->InitBuffer() != 0) {
+        ERROR("Failed to init session buffer");
+        (void)sem_destroy(syncCloseSem);
+        goto out;
+    }
+
     session->pipes = std::array<int, MAX_ARRAY_LEN> { readPipeFd[0], readPipeFd[1] };
     session->sessionMutex = bufMutex;
+    session->bufferCond = bufCond;
     session->syncCloseSem = syncCloseSem;
     session->close = false;
     session->completeStdin = true;
@@ -255,6 +316,9 @@ out:
     if (bufMutex != nullptr) {
         delete bufMutex;
     }
+    if (bufCond != nullptr) {
+        delete bufCond;
+    }
     if (syncCloseSem) {
         delete syncCloseSem;
     }
@@ -313,7 +377,8 @@ int WebsocketServer::RegisterStreamTask(struct lws *wsi) noexcept
     auto insertRet = m_wsis.insert(std::make_pair(socketID, session));
     if (!insertRet.second) {
         ERROR("failed to insert session data to map");
-        delete session;
+        // give the pooled ring, pipes and locks back like a closed session
+        ReleaseSession(session);
         return -1;
     }
 
@@ -350,15 +415,15 @@ void WebsocketServer::DumpHandshakeInfo(struct lws *wsi) noexcept
     } while (c != nullptr);
 }
 
-int WebsocketServer::Wswrite(struct lws *wsi, const unsigned char *message)
+// message holds LWS_PRE bytes of headroom, then the channel byte and the payload, len covers the latter two
+int WebsocketServer::Wswrite(struct lws *wsi, unsigned char *message, size_t len)
 {
     auto it = m_wsis.find(lws_get_socket_fd(wsi));
     if (it != m_wsis.end()) {
-        if (strlen((const char *)(&message[LWS_PRE + 1])) == 0) {
+        if (len <= 1) {
             return 0;
         }
-        auto n = lws_write(wsi, (unsigned char *)(&message[LWS_PRE]), strlen((const char *)(&message[LWS_PRE + 1])) + 1,
-                           LWS_WRITE_TEXT);
+        auto n = lws_write(wsi, &message[LWS_PRE], len, LWS_WRITE_TEXT);
         if (n < 0) {
             ERROR("ERROR %d writing to socket, hanging up", n);
             return -1;
@@ -439,8 +504,8 @@ void WebsocketServer::Receive(int socketID, void *in, size_t len, bool complete)
 
     if (!it->second->IsStdinComplete()) {
         DEBUG("Receive remaning stdin data with length %zu", len);
-        // Too much data may cause error 'resource temporarily unavaliable' by using 'write'
-        if (util_write_nointr_in_total(m_wsis[socketID]->pipes.at(1), static_cast<char *>(in), len) < 0) {
+        // the pipe is non-blocking, what the container does not take now is written on writable
+        if (it->second->WriteStdin(static_cast<char *>(in), len) != 0) {
             SYSERROR("Sub write over!");
         }
         goto out;
@@ -457,7 +522,7 @@ void WebsocketServer::Receive(int socketID, void *in, size_t len, bool complete)
     }
 
     if (*static_cast<char *>(in) == WebsocketChannel::STDINCHANNEL) {
-        if (util_write_nointr_in_total(m_wsis[socketID]->pipes.at(1), static_cast<char *>(in) + 1, len - 1) < 0) {
+        if (it->second->WriteStdin(static_cast<char *>(in) + 1, len - 1) != 0) {
             SYSERROR("Sub write over!");
         }
         goto out;
@@ -502,12 +567,23 @@ int WebsocketServer::Callback(struct lws *wsi, enum lws_callback_reasons reason,
                     return -1;
                 }
 
+                auto *server = WebsocketServer::GetInstance();
                 auto sessionClosed = it->second->IsClosed();
-                while (!it->second->buffer.empty()) {
-                    auto *message = it->second->FrontMessage();
-                    // send success! free it and erase for list
-                    if (WebsocketServer::GetInstance()->Wswrite(wsi, const_cast<const unsigned char *>(message)) == 0) {
-                        free(message);
+                // the container took some stdin, read the client again once all of it is written
+                if (it->second->FlushStdin() != 0) {
+                    SYSERROR("Failed to write stdin of session %s", it->second->suffix.c_str());
+                }
+                if (it->second->stdinPaused && !it->second->HasPendingStdin()) {
+                    it->second->stdinPaused = false;
+                    (void)lws_rx_flow_control(wsi, 1);
+                }
+                while (it->second->HasMessage()) {
+                    auto len = it->second->FrontMessage(&server->m_sendBuf[LWS_PRE], server->m_sendBuf.size() - LWS_PRE);
+                    if (len < 0) {
+                        break;
+                    }
+                    // send success! drop it from the ring and wake up the blocked writer
+                    if (server->Wswrite(wsi, server->m_sendBuf.data(), static_cast<size_t>(len)) == 0) {
                         it->second->PopMessage();
                     } else {
                         // Another case ret > 0, send fail! keep message and send it again!
@@ -527,8 +603,14 @@ int WebsocketServer::Callback(struct lws *wsi, enum lws_callback_reasons reason,
         case LWS_CALLBACK_RECEIVE: {
                 ReadGuard<RWMutex> lock(m_mutex);
                 size_t bytesLen = lws_remaining_packet_payload(wsi);
-                WebsocketServer::GetInstance()->Receive(lws_get_socket_fd(wsi), static_cast<char *>(in),
-                                                        len, bytesLen == 0);
+                int socketID = lws_get_socket_fd(wsi);
+                WebsocketServer::GetInstance()->Receive(socketID, static_cast<char *>(in), len, bytesLen == 0);
+                // the container does not read stdin as fast as the client sends it, stop reading the client
+                auto it = m_wsis.find(socketID);
+                if (it != m_wsis.end() && it->second->HasPendingStdin() && !it->second->stdinPaused) {
+                    it->second->stdinPaused = true;
+                    (void)lws_rx_flow_control(wsi, 0);
+                }
             }
             break;
         case LWS_CALLBACK_CLOSED: {
@@ -562,6 +644,7 @@ void WebsocketServer::Start(Errors &err)
                      std::to_string(m_listenPort) + " is occupied)");
         return;
     }
+    m_sessionReaper = std::thread(&WebsocketServer::SessionReaperThread, this);
     m_pthreadService = std::thread(&WebsocketServer::ServiceWorkThread, this, 0);
 }
 
@@ -571,6 +654,7 @@ void WebsocketServer::Wait()
         m_pthreadService.join();
     }
 
+    StopSessionReaper();
     CloseAllWsSession();
 
     lws_context_destroy(m_context);
@@ -24,12 +24,14 @@
 #include <list>
 #include <array>
 #include <thread>
+#include <condition_variable>
 #include <libwebsockets.h>
 #include "route_callback_register.h"
 #include "session.h"
 #include "url.h"
 #include "errors.h"
 #include "read_write_lock.h"
+#include "utils.h"
 
 namespace {
 const int MAX_ECHO_PAYLOAD = 4096;
@@ -59,13 +61,16 @@ private:
 
     int CreateContext();
     inline void Receive(int socketID, void *in, size_t len, bool complete);
-    int Wswrite(struct lws *wsi, const unsigned char *message);
+    int Wswrite(struct lws *wsi, unsigned char *message, size_t len);
     inline void DumpHandshakeInfo(struct lws *wsi) noexcept;
     int RegisterStreamTask(struct lws *wsi) noexcept;
     int GenerateSessionData(SessionData *session, const std::string &containerID) noexcept;
     void ServiceWorkThread(int threadid);
     void CloseWsSession(int socketID);
     void CloseAllWsSession();
+    void ReleaseSession(SessionData *session);
+    void SessionReaperThread();
+    void StopSessionReaper();
     int ResizeTerminal(int socketID, const char *jsonData, size_t len, const std::string &containerID,
                        const std::string &suffix);
     int ParseTerminalSize(const char *jsonData, size_t len, uint16_t &width, uint16_t &height);
@@ -82,6 +87,14 @@ private:
     static struct lws_context *m_context;
     volatile int m_forceExit = 0;
     std::thread m_pthreadService;
+    // closed sessions wait here until their stream task finishes
+    std::thread m_sessionReaper;
+    std::mutex m_reapMutex;
+    std::condition_variable m_reapCond;
+    std::list<SessionData *> m_closingSessions;
+    bool m_reaperExit = false;
+    // only used by the service thread to frame messages for lws_write
+    std::array<unsigned char, LWS_PRE + MAX_BUFFER_SIZE + 1> m_sendBuf;
     const struct lws_protocols m_protocols[MAX_PROTOCOL_NUM] = {
         {
             "channel.k8s.io",
@@ -300,8 +300,11 @@ typedef struct {
 } service_volume_callback_t;
 
 #ifdef ENABLE_METRICS
+/* receives the exposition text one metric family at a time */
+typedef int (*metrics_write_cb_t)(void *ctx, const char *data, size_t len);
+
 typedef struct {
-    int (*export_metrics_by_type)(const char *metric_type, char **data, int *len);
+    int (*export_metrics_by_type)(const char *metric_type, metrics_write_cb_t write_cb, void *ctx);
 } service_metrics_callback_t;
 #endif
 
@@ -64,7 +64,7 @@
 
 static int container_version_cb(const container_version_request *request, container_version_response **response)
 {
-    char *rootpath = NULL;
+    const char *rootpath = NULL;
     uint32_t cc = ISULAD_SUCCESS;
 
     DAEMON_CLEAR_ERRMSG();
@@ -85,7 +85,7 @@ static int container_version_cb(const container_version_request *request, contai
     (*response)->git_commit = util_strdup_s(ISULAD_GIT_COMMIT);
     (*response)->build_time = util_strdup_s(ISULAD_BUILD_TIME);
 
-    rootpath = conf_get_isulad_rootdir();
+    rootpath = conf_snapshot_rootdir();
     if (rootpath == NULL) {
         ERROR("Failed to get root directory");
         cc = ISULAD_ERR_EXEC;
@@ -98,8 +98,6 @@ pack_response:
         (*response)->cc = cc;
     }
 
-    free(rootpath);
-
     isula_libutils_free_log_prefix();
     DAEMON_CLEAR_ERRMSG();
     return (cc == ISULAD_SUCCESS) ? 0 : -1;
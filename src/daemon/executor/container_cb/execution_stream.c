@@ -443,7 +443,7 @@ static int archive_and_send_copy_data(const stream_func_wrapper *stream,
     char *absbase = NULL;
     char *err = NULL;
     char *buf = NULL;
-    char *root_dir = NULL;
+    const char *root_dir = NULL;
     char cleaned[PATH_MAX + 2] = { 0 };
     struct io_read_wrapper reader = { 0 };
     char *tar_path = NULL;
@@ -476,7 +476,7 @@ static int archive_and_send_copy_data(const stream_func_wrapper *stream,
         goto cleanup;
     }
 
-    root_dir = conf_get_isulad_rootdir();
+    root_dir = conf_snapshot_rootdir();
     if (root_dir == NULL) {
         ERROR("Failed to get isulad rootdir");
         goto cleanup;
@@ -512,7 +512,6 @@ cleanup:
     free(srcdir);
     free(srcbase);
     free(absbase);
-    free(root_dir);
     if (reader.close != NULL) {
         int cret = reader.close(reader.context, &err);
         if (err != NULL) {
@@ -785,12 +784,12 @@ static int read_and_extract_archive(stream_func_wrapper *stream, const char *con
 {
     int ret = -1;
     char *err = NULL;
-    char *root_dir = NULL;
+    const char *root_dir = NULL;
     struct io_read_wrapper content = { 0 };
     content.context = stream;
     content.read = extract_stream_to_io_read;
 
-    root_dir = conf_get_isulad_rootdir();
+    root_dir = conf_snapshot_rootdir();
     if (root_dir == NULL) {
         ERROR("Failed to get isulad rootdir");
         isulad_set_error_message("Failed to get isulad rootdir");
@@ -803,7 +802,6 @@ static int read_and_extract_archive(stream_func_wrapper *stream, const char *con
         isulad_set_error_message("Can not untar to container: %s", (err != NULL) ? err : "unknown");
     }
     free(err);
-    free(root_dir);
     return ret;
 }
 
@@ -400,6 +400,53 @@ cleanup:
     return filtered_ids;
 }
 
+/*
+ * narrow the ids by the container store label index, so that the full container
+ * info is only built for containers carrying the labels, the label filter is still
+ * applied exactly by container_info_match
+ */
+static int filter_by_label_index(const struct list_context *ctx, char ***idsarray)
+{
+    int ret = 0;
+    size_t i;
+    size_t labels_len;
+    char **labels = NULL;
+    char **filtered_ids = NULL;
+    map_t *matches = NULL;
+
+    labels = filters_args_get(ctx->ps_filters, "label");
+    labels_len = util_array_len((const char **)labels);
+    if (labels_len == 0 || *idsarray == NULL) {
+        goto out;
+    }
+
+    matches = containers_store_match_labels((const char **)labels, labels_len);
+    if (matches == NULL) {
+        ret = -1;
+        goto out;
+    }
+
+    for (i = 0; (*idsarray)[i] != NULL; i++) {
+        if (map_search(matches, (void *)(*idsarray)[i]) == NULL) {
+            continue;
+        }
+        if (util_array_append(&filtered_ids, (*idsarray)[i]) != 0) {
+            ERROR("Out of memory");
+            util_free_array(filtered_ids);
+            ret = -1;
+            goto out;
+        }
+    }
+
+    util_free_array(*idsarray);
+    *idsarray = filtered_ids;
+
+out:
+    util_free_array(labels);
+    map_free(matches);
+    return ret;
+}
+
 char *container_get_health_state(const container_state *cont_state)
 {
     if (cont_state == NULL || cont_state->health == NULL || cont_state->health->status == NULL) {
@@ -818,6 +865,11 @@ int container_list_cb(const container_list_request *request, container_list_resp
     // end up querying many more containers than intended
     idsarray = filter_by_name_id_matches(ctx, map_id_name);
 
+    if (filter_by_label_index(ctx, &idsarray) != 0) {
+        cc = ISULAD_ERR_EXEC;
+        goto pack_response;
+    }
+
     if (pack_list_containers(idsarray, ctx, (*response)) != 0) {
         cc = ISULAD_ERR_EXEC;
         goto pack_response;
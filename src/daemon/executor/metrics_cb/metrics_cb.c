@@ -17,9 +17,15 @@
 #include "metrics_cb.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
 
 #include "callback.h"
 #include "utils.h"
+#include "utils_timestamp.h"
+#include "buffer.h"
+#include "rpc_stats.h"
 #include "isula_libutils/log.h"
 
 typedef enum {
@@ -39,17 +45,17 @@ typedef struct isula_metrics {
     Isula_Metrics_Type metrics_type;
     /* The metric help info */
     const char *descripe;
-    /* The metric data, the format is independent of the type */
-    int (*metrics_data_get)(const char *name, char *buf, int size);
+    /* Append the metric samples to buf, return the number of samples, the format is independent of the type */
+    int (*metrics_data_get)(const char *name, Buffer *buf);
 } isula_metrics_t;
 
-#define METRIC_RESPONSE_OK      200
-#define METRIC_RESPONSE_FAIL    401
-
 #define ISULA_PREFIX        "isula_"
 #define HELP_HEAD           "# HELP "
 #define TYPE_HEAD           "# TYPE "
-#define METRICS_BUF_SIZE    (1024 * 1024)
+#define METRICS_FAMILY_INIT_SIZE    (4 * 1024)
+
+/* container stats are shared by all metrics of a scrape, and by scrapes within the interval */
+#define METRICS_SNAPSHOT_INTERVAL   (5 * Time_Second)
 
 /* metric name, no spaces allowed */
 #define METRICS_REQUEST_COUNT   ISULA_PREFIX "metrics_http_req_count"
@@ -58,6 +64,15 @@ typedef struct isula_metrics {
 #define ISULA_CONT_CPU_STAT     ISULA_PREFIX "container_cpu_stat"
 #define ISULA_CONT_PIDS         ISULA_PREFIX "container_pids"
 #define DAEMON_CALLOC_TOTAL     ISULA_PREFIX "daemon_calloced_memory_total"
+#define METRICS_SNAPSHOT_SECONDS    ISULA_PREFIX "metrics_stats_snapshot_seconds"
+#define RPC_REQUESTS_TOTAL      ISULA_PREFIX "rpc_requests_total"
+#define RPC_ERRORS_TOTAL        ISULA_PREFIX "rpc_errors_total"
+#define RPC_IN_FLIGHT           ISULA_PREFIX "rpc_in_flight"
+#define RPC_LATENCY_SECONDS     ISULA_PREFIX "rpc_latency_seconds"
+
+/* rpc latency buckets are exported at power of two microseconds, from 128us to about 134s */
+#define RPC_LATENCY_MIN_EXPONENT    7
+#define RPC_LATENCY_MAX_EXPONENT    27
 
 /* metric help info */
 static const char g_isula_daemon_mem_desc[] = "is isula daemon memory occupied";
@@ -66,9 +81,33 @@ static const char g_cpu_stat_desc[] = "is containers's cpu stats";
 static const char g_req_count_desc[] = "is metrics server accepted request count";
 static const char g_cont_pids_desc[] = "is containers's pid count";
 static const char g_daemon_calloc_desc[] = "is isula deamon calloced total";
+static const char g_snapshot_desc[] = "is time spent collecting containers's stats snapshot";
+static const char g_rpc_requests_desc[] = "is finished requests of each rpc method";
+static const char g_rpc_errors_desc[] = "is failed requests of each rpc method";
+static const char g_rpc_in_flight_desc[] = "is requests being served of each rpc method";
+static const char g_rpc_latency_desc[] = "is latency of each rpc method";
 
 static unsigned long long g_mem_alloced_total;
 
+typedef struct {
+    pthread_mutex_t mutex;
+    container_stats_response *cur;
+    /* previous snapshot, cpu usage is the delta between the two */
+    container_stats_response *prev;
+    int64_t timestamp;
+} metrics_stats_snapshot_t;
+
+static metrics_stats_snapshot_t g_stats_snapshot = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cur = NULL,
+    .prev = NULL,
+    .timestamp = 0,
+};
+
+static const double g_snapshot_buckets[] = { 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+
+static metrics_histogram_t g_snapshot_histogram = METRICS_HISTOGRAM_INITIALIZER(g_snapshot_buckets);
+
 const char *get_metric_name(Isula_Metrics_Type e)
 {
     if (e < COUNTER || e >= METRIC_TYPE_BUTT) {
@@ -85,7 +124,90 @@ const char *get_metric_name(Isula_Metrics_Type e)
     return metric_type_name[e];
 }
 
-static int metrics_get_isulad_mem_stat(const char *name, char *buffer, int size)
+static int metrics_buffer_printf(Buffer *buf, const char *format, ...)
+{
+    int len = 0;
+    char *line = NULL;
+    va_list args;
+
+    va_start(args, format);
+    len = vasprintf(&line, format, args);
+    va_end(args);
+    if (len < 0) {
+        ERROR("Out of memory");
+        return -1;
+    }
+
+    if (buffer_append(buf, line, (size_t)len) != 0) {
+        ERROR("Failed to append metrics");
+        len = -1;
+    }
+
+    free(line);
+    return len;
+}
+
+void metrics_histogram_observe(metrics_histogram_t *histogram, double value)
+{
+    size_t i = 0;
+
+    if (histogram == NULL) {
+        return;
+    }
+
+    if (pthread_mutex_lock(&histogram->mutex) != 0) {
+        ERROR("Failed to lock metrics histogram");
+        return;
+    }
+
+    for (i = 0; i < histogram->bounds_len && i < METRICS_HISTOGRAM_MAX_BUCKETS; i++) {
+        if (value <= histogram->bounds[i]) {
+            histogram->buckets[i]++;
+        }
+    }
+    histogram->sum += value;
+    histogram->count++;
+
+    if (pthread_mutex_unlock(&histogram->mutex) != 0) {
+        ERROR("Failed to unlock metrics histogram");
+    }
+}
+
+/* buckets are cumulative as the exposition format expects, +Inf is the total count */
+static int metrics_histogram_format(const char *name, metrics_histogram_t *histogram, Buffer *buf)
+{
+    int ret = 0;
+    size_t i = 0;
+
+    if (pthread_mutex_lock(&histogram->mutex) != 0) {
+        ERROR("Failed to lock metrics histogram");
+        return -1;
+    }
+
+    for (i = 0; i < histogram->bounds_len && i < METRICS_HISTOGRAM_MAX_BUCKETS; i++) {
+        if (metrics_buffer_printf(buf, "%s_bucket{le=\"%g\"} %llu\n", name, histogram->bounds[i],
+                                  (unsigned long long)histogram->buckets[i]) < 0) {
+            ret = -1;
+            goto unlock;
+        }
+    }
+
+    if (metrics_buffer_printf(buf, "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %g\n%s_count %llu\n", name,
+                              (unsigned long long)histogram->count, name, histogram->sum, name,
+                              (unsigned long long)histogram->count) < 0) {
+        ret = -1;
+        goto unlock;
+    }
+    ret = (int)i + 3;
+
+unlock:
+    if (pthread_mutex_unlock(&histogram->mutex) != 0) {
+        ERROR("Failed to unlock metrics histogram");
+    }
+    return ret;
+}
+
+static int metrics_get_isulad_mem_stat(const char *name, Buffer *buf)
 {
     FILE *fp = NULL;
     int vm_size = 0;
@@ -106,18 +228,18 @@ static int metrics_get_isulad_mem_stat(const char *name, char *buffer, int size)
         return -1;
     }
 
-    int len = snprintf(buffer, size,
-                       "%s{section=\"vmsize\"} %d\n"
-                       "%s{section=\"vmrss\"} %d\n"
-                       "%s{section=\"share_page\"} %d\n"
-                       "%s{section=\"text_size\"} %d\n"
-                       "%s{section=\"stack_size\"} %d\n",
-                       name, vm_size * 4, name, vm_rss * 4, name,
-                       share_page * 4, name, text_size * 4, name, stack_size * 4);
+    int len = metrics_buffer_printf(buf,
+                                    "%s{section=\"vmsize\"} %d\n"
+                                    "%s{section=\"vmrss\"} %d\n"
+                                    "%s{section=\"share_page\"} %d\n"
+                                    "%s{section=\"text_size\"} %d\n"
+                                    "%s{section=\"stack_size\"} %d\n",
+                                    name, vm_size * 4, name, vm_rss * 4, name,
+                                    share_page * 4, name, text_size * 4, name, stack_size * 4);
 
     fclose(fp);
 
-    return len;
+    return len < 0 ? -1 : 5;
 }
 
 static int metrics_get_container_info(container_stats_response **response)
@@ -143,34 +265,53 @@ out:
     return ret;
 }
 
-static int metrics_containers_mem_stats(const char *name, char *buffer, int size)
+/* called with snapshot mutex held, collect containers's stats at most once per interval */
+static void metrics_refresh_stats_snapshot(void)
 {
-    int ret = 0;
-    int i = 0;
-    int len = 0;
+    int64_t now = util_get_now_time_nanos();
     container_stats_response *response = NULL;
 
+    if (g_stats_snapshot.cur != NULL && now - g_stats_snapshot.timestamp < METRICS_SNAPSHOT_INTERVAL) {
+        return;
+    }
+
     if (metrics_get_container_info(&response) != 0 || response == NULL) {
-        ret = -1;
-        goto out;
+        ERROR("Failed to collect containers stats for metrics");
+        free_container_stats_response(response);
+        return;
     }
 
-    for (i = 0; i < response->container_stats_len; i++) {
-        len = snprintf(buffer + ret, size - ret,
-                       "%s{container_id=\"%4.4s\",limit=\"%ld Kb\"} %ld\n",
-                       name, response->container_stats[i]->id, response->container_stats[i]->mem_limit / 1024,
-                       response->container_stats[i]->mem_used);
-        if (len < 0 || (size_t)len >= size - ret) {
-            break;
-        }
+    metrics_histogram_observe(&g_snapshot_histogram, (double)(util_get_now_time_nanos() - now) / Time_Second);
+
+    free_container_stats_response(g_stats_snapshot.prev);
+    g_stats_snapshot.prev = g_stats_snapshot.cur;
+    g_stats_snapshot.cur = response;
+    g_stats_snapshot.timestamp = now;
+}
+
+#define CONTAINER_LABELS_FORMAT "container_id=\"%s\",name=\"%s\",image_type=\"%s\""
+#define CONTAINER_LABELS(info) (info)->id, (info)->name != NULL ? (info)->name : "", \
+    (info)->image_type != NULL ? (info)->image_type : ""
+
+static int metrics_containers_mem_stats(const char *name, Buffer *buf)
+{
+    size_t i = 0;
+    container_stats_response *response = g_stats_snapshot.cur;
 
-        ret += len;
+    if (response == NULL) {
+        return -1;
     }
 
-    free_container_stats_response(response);
+    for (i = 0; i < response->container_stats_len; i++) {
+        container_info *info = response->container_stats[i];
 
-out:
-    return ret;
+        if (metrics_buffer_printf(buf, "%s{" CONTAINER_LABELS_FORMAT ",limit=\"%ld Kb\"} %ld\n", name,
+                                  CONTAINER_LABELS(info), info->mem_limit / 1024, info->mem_used) < 0) {
+            return -1;
+        }
+    }
+
+    return (int)response->container_stats_len;
 }
 
 static float generate_cpu_info(container_info *stats, container_stats_response *old_stat)
@@ -200,94 +341,186 @@ static float generate_cpu_info(container_info *stats, container_stats_response *
     return cpu_percent;
 }
 
-static int metrics_containers_cpu_stats(const char *name, char *buffer, int size)
+static int metrics_containers_cpu_stats(const char *name, Buffer *buf)
 {
-    int ret = 0;
-    int i = 0;
-    int len = 0;
-    container_stats_response *response = NULL;
-    static container_stats_response *old_stat = NULL;
+    size_t i = 0;
+    container_stats_response *response = g_stats_snapshot.cur;
 
-    if (metrics_get_container_info(&response) != 0 || response == NULL) {
-        goto out;
+    /* cpu usage needs two snapshots */
+    if (response == NULL || g_stats_snapshot.prev == NULL) {
+        return 0;
     }
 
-    if (old_stat == NULL) {
-        old_stat = response;
-        goto out;
+    for (i = 0; i < response->container_stats_len; i++) {
+        container_info *info = response->container_stats[i];
+
+        if (metrics_buffer_printf(buf, "%s{" CONTAINER_LABELS_FORMAT "} %.2f\n", name, CONTAINER_LABELS(info),
+                                  generate_cpu_info(info, g_stats_snapshot.prev)) < 0) {
+            return -1;
+        }
+    }
+
+    return (int)response->container_stats_len;
+}
+
+static int metrics_http_req_count_info(const char *name, Buffer *buf)
+{
+    static unsigned int req_count = 0;
+
+    req_count++;
+    return metrics_buffer_printf(buf, "%s %u\n", name, req_count) < 0 ? -1 : 1;
+}
+
+static int metrics_containers_pids(const char *name, Buffer *buf)
+{
+    size_t i = 0;
+    container_stats_response *response = g_stats_snapshot.cur;
+
+    if (response == NULL) {
+        return -1;
     }
 
     for (i = 0; i < response->container_stats_len; i++) {
-        len = snprintf(buffer + ret, size - ret, "%s{container_id=\"%4.4s\"} %-10.2f\n",
-                       name, response->container_stats[i]->id,
-                       generate_cpu_info(response->container_stats[i], old_stat));
-        if (len < 0 || (size_t)len >= size - ret) {
-            break;
-        }
+        container_info *info = response->container_stats[i];
 
-        ret += len;
+        if (metrics_buffer_printf(buf, "%s{" CONTAINER_LABELS_FORMAT "} %ld\n", name, CONTAINER_LABELS(info),
+                                  info->pids_current) < 0) {
+            return -1;
+        }
     }
 
-    free_container_stats_response(old_stat);
-    old_stat = response;
+    return (int)response->container_stats_len;
+}
 
-out:
-    return ret;
+void metrics_add_calloced_mem(unsigned size)
+{
+    g_mem_alloced_total += size;
 }
 
-static int metrics_http_req_count_info(const char *name, char *buffer, int size)
+static int metrics_daemon_alloced_mem_total(const char *name, Buffer *buf)
 {
-    static unsigned int req_count = 0;
-    int len = 0;
+    return metrics_buffer_printf(buf, "%s %llu\n", name, g_mem_alloced_total) < 0 ? -1 : 1;
+}
 
-    req_count++;
-    len = snprintf(buffer, size, "%s %u\n", name, req_count);
+static int metrics_stats_snapshot_seconds(const char *name, Buffer *buf)
+{
+    return metrics_histogram_format(name, &g_snapshot_histogram, buf);
+}
 
-    return len;
+typedef struct {
+    const char *name;
+    Buffer *buf;
+    int samples;
+    int ret;
+} rpc_metrics_ctx_t;
+
+#define RPC_LABELS_FORMAT "kind=\"%s\",method=\"%s\""
+
+static void rpc_requests_total_walk(const rpc_method_stats_t *stats, void *ctx)
+{
+    rpc_metrics_ctx_t *rctx = (rpc_metrics_ctx_t *)ctx;
+
+    if (rctx->ret != 0) {
+        return;
+    }
+    if (metrics_buffer_printf(rctx->buf, "%s{" RPC_LABELS_FORMAT "} %llu\n", rctx->name, stats->kind, stats->method,
+                              (unsigned long long)__atomic_load_n(&stats->calls, __ATOMIC_RELAXED)) < 0) {
+        rctx->ret = -1;
+        return;
+    }
+    rctx->samples++;
 }
 
-static int metrics_containers_pids(const char *name, char *buffer, int size)
+static void rpc_errors_total_walk(const rpc_method_stats_t *stats, void *ctx)
 {
-    int ret = 0;
-    int i = 0;
-    int len = 0;
-    container_stats_response *response = NULL;
+    rpc_metrics_ctx_t *rctx = (rpc_metrics_ctx_t *)ctx;
 
-    if (metrics_get_container_info(&response) != 0 || response == NULL) {
-        goto out;
+    if (rctx->ret != 0) {
+        return;
     }
+    if (metrics_buffer_printf(rctx->buf, "%s{" RPC_LABELS_FORMAT "} %llu\n", rctx->name, stats->kind, stats->method,
+                              (unsigned long long)__atomic_load_n(&stats->errors, __ATOMIC_RELAXED)) < 0) {
+        rctx->ret = -1;
+        return;
+    }
+    rctx->samples++;
+}
 
-    for (i = 0; i < response->container_stats_len; i++) {
-        len = snprintf(buffer + ret, size - ret,
-                       "%s{container_id=\"%4.4s\"} %ld\n",
-                       name, response->container_stats[i]->id, response->container_stats[i]->pids_current);
-        if (len < 0 || (size_t)len >= size - ret) {
-            break;
+static void rpc_in_flight_walk(const rpc_method_stats_t *stats, void *ctx)
+{
+    rpc_metrics_ctx_t *rctx = (rpc_metrics_ctx_t *)ctx;
+
+    if (rctx->ret != 0) {
+        return;
+    }
+    if (metrics_buffer_printf(rctx->buf, "%s{" RPC_LABELS_FORMAT "} %lld\n", rctx->name, stats->kind, stats->method,
+                              (long long)__atomic_load_n(&stats->in_flight, __ATOMIC_RELAXED)) < 0) {
+        rctx->ret = -1;
+        return;
+    }
+    rctx->samples++;
+}
+
+static void rpc_latency_walk(const rpc_method_stats_t *stats, void *ctx)
+{
+    int exp = 0;
+    rpc_metrics_ctx_t *rctx = (rpc_metrics_ctx_t *)ctx;
+    uint64_t calls = __atomic_load_n(&stats->calls, __ATOMIC_RELAXED);
+
+    if (rctx->ret != 0 || calls == 0) {
+        return;
+    }
+
+    for (exp = RPC_LATENCY_MIN_EXPONENT; exp <= RPC_LATENCY_MAX_EXPONENT; exp++) {
+        if (metrics_buffer_printf(rctx->buf, "%s_bucket{" RPC_LABELS_FORMAT ",le=\"%g\"} %llu\n", rctx->name,
+                                  stats->kind, stats->method, (double)(1ULL << exp) / 1000000,
+                                  (unsigned long long)rpc_stats_latency_count_below(stats, 1ULL << exp)) < 0) {
+            rctx->ret = -1;
+            return;
         }
+    }
 
-        ret += len;
+    if (metrics_buffer_printf(rctx->buf,
+                              "%s_bucket{" RPC_LABELS_FORMAT ",le=\"+Inf\"} %llu\n"
+                              "%s_sum{" RPC_LABELS_FORMAT "} %g\n"
+                              "%s_count{" RPC_LABELS_FORMAT "} %llu\n",
+                              rctx->name, stats->kind, stats->method, (unsigned long long)calls,
+                              rctx->name, stats->kind, stats->method,
+                              (double)__atomic_load_n(&stats->latency_sum_us, __ATOMIC_RELAXED) / 1000000,
+                              rctx->name, stats->kind, stats->method, (unsigned long long)calls) < 0) {
+        rctx->ret = -1;
+        return;
     }
+    rctx->samples++;
+}
+
+static int metrics_rpc_walk(const char *name, Buffer *buf, rpc_stats_walk_cb cb)
+{
+    rpc_metrics_ctx_t ctx = { .name = name, .buf = buf, .samples = 0, .ret = 0 };
 
-    free_container_stats_response(response);
+    rpc_stats_foreach(cb, &ctx);
 
-out:
-    return ret;
+    return ctx.ret != 0 ? -1 : ctx.samples;
 }
 
-void metrics_add_calloced_mem(unsigned size)
+static int metrics_rpc_requests_total(const char *name, Buffer *buf)
 {
-    g_mem_alloced_total += size;
+    return metrics_rpc_walk(name, buf, rpc_requests_total_walk);
 }
 
-static int metrics_daemon_alloced_mem_total(const char *name, char *buffer, int size)
+static int metrics_rpc_errors_total(const char *name, Buffer *buf)
 {
-    static unsigned int req_count = 0;
-    int len = 0;
+    return metrics_rpc_walk(name, buf, rpc_errors_total_walk);
+}
 
-    len = snprintf(buffer, size, "%s %llu\n", name, g_mem_alloced_total);
-    req_count++;
+static int metrics_rpc_in_flight(const char *name, Buffer *buf)
+{
+    return metrics_rpc_walk(name, buf, rpc_in_flight_walk);
+}
 
-    return len;
+static int metrics_rpc_latency_seconds(const char *name, Buffer *buf)
+{
+    return metrics_rpc_walk(name, buf, rpc_latency_walk);
 }
 
 static isula_metrics_t g_metrics[] = {
@@ -297,63 +530,103 @@ static isula_metrics_t g_metrics[] = {
     {"cpu", ISULA_CONT_CPU_STAT, GAUGE, g_cpu_stat_desc, metrics_containers_cpu_stats},
     {"pids", ISULA_CONT_PIDS, GAUGE, g_cont_pids_desc, metrics_containers_pids},
     {"sys", DAEMON_CALLOC_TOTAL, COUNTER, g_daemon_calloc_desc, metrics_daemon_alloced_mem_total},
+    {"sys", METRICS_SNAPSHOT_SECONDS, HISTOGRAM, g_snapshot_desc, metrics_stats_snapshot_seconds},
+    {"rpc", RPC_REQUESTS_TOTAL, COUNTER, g_rpc_requests_desc, metrics_rpc_requests_total},
+    {"rpc", RPC_ERRORS_TOTAL, COUNTER, g_rpc_errors_desc, metrics_rpc_errors_total},
+    {"rpc", RPC_IN_FLIGHT, GAUGE, g_rpc_in_flight_desc, metrics_rpc_in_flight},
+    {"rpc", RPC_LATENCY_SECONDS, HISTOGRAM, g_rpc_latency_desc, metrics_rpc_latency_seconds},
 };
 
-static int metrics_msg_get_by_type(const char *url, char **metrics, int *len)
+static bool metrics_selected(const isula_metrics_t *metric, const char *url, bool export_all)
 {
-#define E_SIZE  (512 * 1024)
-    char *msg = NULL;
-    char *element = NULL;
-    int msg_len = 0;
-    int i = 0;
+    if (metric->metrics_data_get == NULL) {
+        return false;
+    }
+
+    return metric->url == NULL || export_all || strcasestr(url, metric->url) != NULL;
+}
+
+static bool metrics_need_container_stats(const char *url, bool export_all)
+{
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(g_metrics) / sizeof(g_metrics[0]); i++) {
+        if (g_metrics[i].metrics_data_get != metrics_containers_mem_stats &&
+            g_metrics[i].metrics_data_get != metrics_containers_cpu_stats &&
+            g_metrics[i].metrics_data_get != metrics_containers_pids) {
+            continue;
+        }
+        if (metrics_selected(&g_metrics[i], url, export_all)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Every metric family is rendered into its own buffer and handed to write_cb as
+ * soon as it is complete, so the size of the output is not limited and only one
+ * family is kept in memory at a time.
+ */
+static int metrics_msg_get_by_type(const char *url, metrics_write_cb_t write_cb, void *ctx)
+{
+    int ret = 0;
+    size_t i = 0;
     bool export_all = false;
+    Buffer *family = NULL;
 
-    if (url == NULL) {
+    if (url == NULL || write_cb == NULL) {
         ERROR("invalid request url");
         return -1;
     }
 
     export_all = !strcmp(url, "all");
-    msg = (char *)util_common_calloc_s(METRICS_BUF_SIZE);
-    if (msg == NULL) {
+    family = buffer_alloc(METRICS_FAMILY_INIT_SIZE);
+    if (family == NULL) {
         ERROR("Out of memory");
         return -1;
     }
 
-    element = (char *)util_common_calloc_s(E_SIZE);
-    if (element == NULL) {
-        ERROR("Out of memory");
-        free(msg);
+    if (pthread_mutex_lock(&g_stats_snapshot.mutex) != 0) {
+        ERROR("Failed to lock metrics stats snapshot");
+        buffer_free(family);
         return -1;
     }
 
+    if (metrics_need_container_stats(url, export_all)) {
+        metrics_refresh_stats_snapshot();
+    }
+
     for (i = 0; i < sizeof(g_metrics) / sizeof(g_metrics[0]); i++) {
-        if (g_metrics[i].metrics_data_get == NULL) {
+        if (!metrics_selected(&g_metrics[i], url, export_all)) {
             continue;
         }
 
-        if (g_metrics[i].url != NULL && strcasestr(url, g_metrics[i].url) == NULL && !export_all) {
-            continue;
+        buffer_empty(family);
+        if (metrics_buffer_printf(family, HELP_HEAD "%s %s\n" TYPE_HEAD "%s %s\n", g_metrics[i].name,
+                                  g_metrics[i].descripe, g_metrics[i].name,
+                                  get_metric_name(g_metrics[i].metrics_type)) < 0) {
+            ret = -1;
+            break;
         }
 
-        if (g_metrics[i].metrics_data_get(g_metrics[i].name, element, E_SIZE) <= 0) {
+        if (g_metrics[i].metrics_data_get(g_metrics[i].name, family) <= 0) {
             continue;
         }
-        int tmp = snprintf(msg + msg_len, METRICS_BUF_SIZE - msg_len,
-                           HELP_HEAD "%s %s\n"
-                           TYPE_HEAD "%s %s\n"
-                           "%s\n", g_metrics[i].name, g_metrics[i].descripe, g_metrics[i].name,
-                           get_metric_name(g_metrics[i].metrics_type), element);
-        if (tmp < 0 || (size_t)tmp >= METRICS_BUF_SIZE - msg_len) {
+
+        if (buffer_append(family, "\n", 1) != 0 || write_cb(ctx, family->contents, family->bytes_used) != 0) {
+            ret = -1;
             break;
         }
-        msg_len += tmp;
     }
 
-    free(element);
-    *len = msg_len;
-    *metrics = msg;
-    return 0;
+    if (pthread_mutex_unlock(&g_stats_snapshot.mutex) != 0) {
+        ERROR("Failed to unlock metrics stats snapshot");
+    }
+
+    buffer_free(family);
+    return ret;
 }
 
 void metrics_callback_init(service_metrics_callback_t *cb)
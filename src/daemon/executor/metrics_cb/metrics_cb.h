@@ -16,12 +16,35 @@
 #ifndef DAEMON_EXECUTOR_METRICS_CB_METRICS_CB_H
 #define DAEMON_EXECUTOR_METRICS_CB_METRICS_CB_H
 
+#include <stdint.h>
+#include <pthread.h>
+
 #include "callback.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define METRICS_HISTOGRAM_MAX_BUCKETS 16
+
+/* bounds are the upper bounds of the buckets in ascending order, +Inf is implied */
+typedef struct metrics_histogram {
+    pthread_mutex_t mutex;
+    const double *bounds;
+    size_t bounds_len;
+    uint64_t buckets[METRICS_HISTOGRAM_MAX_BUCKETS];
+    double sum;
+    uint64_t count;
+} metrics_histogram_t;
+
+#define METRICS_HISTOGRAM_INITIALIZER(bounds_array) { \
+    .mutex = PTHREAD_MUTEX_INITIALIZER, \
+    .bounds = (bounds_array), \
+    .bounds_len = sizeof(bounds_array) / sizeof((bounds_array)[0]), \
+}
+
+void metrics_histogram_observe(metrics_histogram_t *histogram, double value);
+
 void metrics_callback_init(service_metrics_callback_t *cb);
 
 #ifdef __cplusplus
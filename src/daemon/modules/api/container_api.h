@@ -57,6 +57,8 @@ typedef struct health_check_manager {
 typedef struct _container_state_t_ {
     pthread_mutex_t mutex;
     container_state *state;
+    // state json last written to disk, an unchanged state is not written again
+    char *disk_json;
 } container_state_t;
 
 typedef struct _restart_manager_t {
@@ -126,6 +128,8 @@ int containers_store_list(container_t ***out, size_t *size);
 
 char **containers_store_list_ids(void);
 
+map_t *containers_store_match_labels(const char **labels, size_t len);
+
 /* name indexs */
 int container_name_index_init(void);
 
@@ -208,6 +212,10 @@ container_inspect_state *container_state_to_inspect_state(container_state_t *s);
 
 void container_restart_update_start_and_finish_time(container_state_t *s, const char *finish_at);
 
+int container_state_generate_changed_json(container_state_t *s, char **json);
+
+void container_state_set_disk_json(container_state_t *s, char *json);
+
 void container_state_set_starting(container_state_t *s);
 
 void container_state_reset_starting(container_state_t *s);
@@ -32,6 +32,8 @@ struct context_lists {
 
 void events_handler(struct monitord_msg *msg);
 
+int monitord_post_msg(const struct monitord_msg *msg);
+
 int add_monitor_client(char *name, const types_timestamp_t *since, const types_timestamp_t *until,
                        const stream_func_wrapper *stream);
 
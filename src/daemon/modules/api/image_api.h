@@ -259,6 +259,12 @@ int im_mount_container_rootfs(const char *image_type, const char *image_name, co
 
 int im_umount_container_rootfs(const char *image_type, const char *image_name, const char *container_id);
 
+#define IM_ROOTFS_PREFETCH_ANNOTATION "rootfs.prefetch"
+
+/* opt-in by IM_ROOTFS_PREFETCH_ANNOTATION, warm the page cache with the files the image opened on its first run */
+int im_prefetch_container_rootfs(const char *image_type, const char *image_name, const char *container_id,
+                                 const char *rootfs, const json_map_string_string *annotations);
+
 int im_remove_container_rootfs(const char *image_type, const char *container_id);
 
 int im_remove_broken_rootfs(const char *image_type, const char *container_id);
@@ -25,7 +25,10 @@
 #include <signal.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <time.h>
+#include <sys/eventfd.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 
 #include "constants.h"
 #include "isulad_config.h"
@@ -36,10 +39,30 @@
 #include "container_api.h"
 #include "runtime_api.h"
 #include "restartmanager.h"
+#include "utils_convert.h"
 #include "utils_file.h"
+#include "utils_string.h"
 #include "utils_timestamp.h"
+#include "mainloop.h"
 
-static containers_gc_t g_gc_containers;
+#define GCCONFIGJSON "garbage.json"
+/* add/del records appended since garbage.json was last written */
+#define GCJOURNAL "garbage.journal"
+#define GC_JOURNAL_COMPACT_RECORDS 64
+#define GC_RETRY_MIN_MS 100
+#define GC_RETRY_MAX_MS (10 * 1000)
+
+/* a container in the gc list with its scheduling state, only the gc thread changes the state */
+typedef struct {
+    container_garbage_config_gc_containers_element *cont;
+    /* pidfd of the container process while waiting for it to exit, -1 if none */
+    int pidfd;
+    unsigned int retries;
+    /* monotonic time in ms, the entry is handled again once it is reached */
+    uint64_t next_run_ms;
+} gc_entry_t;
+
+static containers_gc_t g_gc_containers = { .wakeup_fd = -1 };
 
 /* gc containers lock */
 static void gc_containers_lock()
@@ -57,47 +80,49 @@ static void gc_containers_unlock()
     }
 }
 
-#define GCCONFIGJSON "garbage.json"
-/* save gc config */
-static int save_gc_config(const char *json_gc_config)
+static uint64_t gc_now_ms(void)
+{
+    struct timespec ts = { 0 };
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static int gc_file_path(const char *name, char *path, size_t len)
 {
-    int ret = 0;
     int nret;
-    char filename[PATH_MAX] = { 0 };
-    char *rootpath = NULL;
-    int fd = -1;
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
 
-    rootpath = conf_get_isulad_rootdir();
-    if (rootpath == NULL) {
+    if (snapshot == NULL || snapshot->rootdir == NULL) {
         ERROR("Root path is NULL");
-        ret = -1;
-        goto out;
+        return -1;
     }
 
-    nret = snprintf(filename, sizeof(filename), "%s/%s", rootpath, GCCONFIGJSON);
-    if (nret < 0 || (size_t)nret >= sizeof(filename)) {
+    nret = snprintf(path, len, "%s/%s", snapshot->rootdir, name);
+    if (nret < 0 || (size_t)nret >= len) {
         ERROR("Failed to print string");
-        ret = -1;
-        goto out;
+        return -1;
     }
 
-    fd = util_open(filename, O_CREAT | O_TRUNC | O_CLOEXEC | O_WRONLY, CONFIG_FILE_MODE);
-    if (fd == -1) {
-        SYSERROR("Create file %s failed.", filename);
-        ret = -1;
-        goto out;
+    return 0;
+}
+
+/* save gc config */
+static int save_gc_config(const char *json_gc_config)
+{
+    char filename[PATH_MAX] = { 0 };
+
+    if (gc_file_path(GCCONFIGJSON, filename, sizeof(filename)) != 0) {
+        return -1;
     }
 
-    nret = util_write_nointr(fd, json_gc_config, strlen(json_gc_config));
-    if (nret < 0 || (size_t)nret != strlen(json_gc_config)) {
-        SYSERROR("write %s failed.", filename);
-        ret = -1;
+    /* replaced atomically and synced, the journal is dropped right after and must never outlive the new file */
+    if (util_atomic_write_file(filename, json_gc_config, strlen(json_gc_config), CONFIG_FILE_MODE, true) != 0) {
+        ERROR("Failed to write %s", filename);
+        return -1;
     }
-    close(fd);
 
-out:
-    free(rootpath);
-    return ret;
+    return 0;
 }
 
 /* gc save containers config */
@@ -155,7 +180,7 @@ static int gc_containers_to_disk()
             return -1;
         }
         linked_list_for_each_safe(it, &g_gc_containers.containers_list, next) {
-            conts[i] = (container_garbage_config_gc_containers_element *)it->elem;
+            conts[i] = ((gc_entry_t *)it->elem)->cont;
             i++;
         }
     }
@@ -170,24 +195,170 @@ static int gc_containers_to_disk()
     return ret;
 }
 
-/* gc is gc progress */
-bool gc_is_gc_progress(const char *id)
+/* notes: this function must be called with gc_containers_lock */
+static int gc_journal_compact()
+{
+    char filename[PATH_MAX] = { 0 };
+
+    if (gc_containers_to_disk() != 0) {
+        return -1;
+    }
+
+    if (gc_file_path(GCJOURNAL, filename, sizeof(filename)) != 0) {
+        return -1;
+    }
+
+    if (unlink(filename) != 0 && errno != ENOENT) {
+        SYSERROR("Failed to remove %s", filename);
+        return -1;
+    }
+
+    g_gc_containers.journal_records = 0;
+    return 0;
+}
+
+/* notes: this function must be called with gc_containers_lock */
+static void gc_journal_append(const char *record)
+{
+    int fd = -1;
+    ssize_t nret = 0;
+    char filename[PATH_MAX] = { 0 };
+
+    if (gc_file_path(GCJOURNAL, filename, sizeof(filename)) != 0) {
+        goto compact;
+    }
+
+    fd = util_open(filename, O_CREAT | O_APPEND | O_CLOEXEC | O_WRONLY, CONFIG_FILE_MODE);
+    if (fd == -1) {
+        SYSERROR("Open file %s failed.", filename);
+        goto compact;
+    }
+
+    nret = util_write_nointr(fd, record, strlen(record));
+    close(fd);
+    if (nret < 0 || (size_t)nret != strlen(record)) {
+        SYSERROR("write %s failed.", filename);
+        goto compact;
+    }
+
+    g_gc_containers.journal_records++;
+    if (g_gc_containers.journal_records < GC_JOURNAL_COMPACT_RECORDS) {
+        return;
+    }
+
+compact:
+    /* a full rewrite of garbage.json also repairs a journal missing a record */
+    if (gc_journal_compact() != 0) {
+        ERROR("Failed to compact garbage collector journal");
+    }
+}
+
+/* notes: this function must be called with gc_containers_lock */
+static void gc_journal_add(const container_garbage_config_gc_containers_element *cont)
+{
+    int nret;
+    char record[PATH_MAX] = { 0 };
+
+    nret = snprintf(record, sizeof(record), "add %s %s %d %llu %d %llu\n", cont->id, cont->runtime, cont->pid,
+                    (unsigned long long)cont->start_time, cont->ppid, (unsigned long long)cont->p_start_time);
+    if (nret < 0 || (size_t)nret >= sizeof(record)) {
+        ERROR("Failed to print gc journal record of %s", cont->id);
+        (void)gc_journal_compact();
+        return;
+    }
+
+    gc_journal_append(record);
+}
+
+/* notes: this function must be called with gc_containers_lock */
+static void gc_journal_del(const container_garbage_config_gc_containers_element *cont)
+{
+    int nret;
+    char record[PATH_MAX] = { 0 };
+
+    nret = snprintf(record, sizeof(record), "del %s %d\n", cont->id, cont->pid);
+    if (nret < 0 || (size_t)nret >= sizeof(record)) {
+        ERROR("Failed to print gc journal record of %s", cont->id);
+        (void)gc_journal_compact();
+        return;
+    }
+
+    gc_journal_append(record);
+}
+
+/* notes: this function must be called with gc_containers_lock */
+static struct linked_list *gc_find_entry(const char *id, int pid)
 {
-    bool ret = false;
     struct linked_list *it = NULL;
     struct linked_list *next = NULL;
-    container_garbage_config_gc_containers_element *cont = NULL;
-
-    gc_containers_lock();
 
     linked_list_for_each_safe(it, &g_gc_containers.containers_list, next) {
-        cont = (container_garbage_config_gc_containers_element *)it->elem;
-        if (strcmp(id, cont->id) == 0) {
-            ret = true;
-            break;
+        const container_garbage_config_gc_containers_element *cont = ((gc_entry_t *)it->elem)->cont;
+        if (strcmp(id, cont->id) == 0 && (pid < 0 || cont->pid == pid)) {
+            return it;
         }
     }
 
+    return NULL;
+}
+
+static struct linked_list *gc_new_entry_node(container_garbage_config_gc_containers_element *cont)
+{
+    struct linked_list *newnode = NULL;
+    gc_entry_t *entry = NULL;
+
+    newnode = util_common_calloc_s(sizeof(struct linked_list));
+    if (newnode == NULL) {
+        return NULL;
+    }
+
+    entry = util_common_calloc_s(sizeof(gc_entry_t));
+    if (entry == NULL) {
+        free(newnode);
+        return NULL;
+    }
+
+    entry->cont = cont;
+    entry->pidfd = -1;
+    linked_list_add_elem(newnode, entry);
+
+    return newnode;
+}
+
+static void gc_free_entry_node(struct linked_list *node)
+{
+    gc_entry_t *entry = (gc_entry_t *)node->elem;
+
+    if (entry->pidfd >= 0) {
+        close(entry->pidfd);
+    }
+    free_container_garbage_config_gc_containers_element(entry->cont);
+    free(entry);
+    free(node);
+}
+
+static void gc_wakeup()
+{
+    uint64_t val = 1;
+
+    if (g_gc_containers.wakeup_fd < 0) {
+        return;
+    }
+
+    if (util_write_nointr(g_gc_containers.wakeup_fd, &val, sizeof(val)) < 0 && errno != EAGAIN) {
+        SYSERROR("Failed to wake up garbage collector");
+    }
+}
+
+/* gc is gc progress */
+bool gc_is_gc_progress(const char *id)
+{
+    bool ret = false;
+
+    gc_containers_lock();
+
+    ret = gc_find_entry(id, -1) != NULL;
+
     gc_containers_unlock();
 
     return ret;
@@ -206,16 +377,9 @@ int gc_add_container(const char *id, const char *runtime, const pid_ppid_info_t
 
     EVENT("Event: {Object: GC, Type: Add container %s with pid %u into garbage collector}", id, pid_info->pid);
 
-    newnode = util_common_calloc_s(sizeof(struct linked_list));
-    if (newnode == NULL) {
-        CRIT("Memory allocation error.");
-        return -1;
-    }
-
     gc_cont = util_common_calloc_s(sizeof(container_garbage_config_gc_containers_element));
     if (gc_cont == NULL) {
         CRIT("Memory allocation error.");
-        free(newnode);
         return -1;
     }
 
@@ -226,35 +390,33 @@ int gc_add_container(const char *id, const char *runtime, const pid_ppid_info_t
     gc_cont->ppid = pid_info->ppid;
     gc_cont->p_start_time = pid_info->pstart_time;
 
+    newnode = gc_new_entry_node(gc_cont);
+    if (newnode == NULL) {
+        CRIT("Memory allocation error.");
+        free_container_garbage_config_gc_containers_element(gc_cont);
+        return -1;
+    }
+
     gc_containers_lock();
 
-    linked_list_add_elem(newnode, gc_cont);
     linked_list_add_tail(&g_gc_containers.containers_list, newnode);
-    (void)gc_containers_to_disk();
+    gc_journal_add(gc_cont);
 
     gc_containers_unlock();
 
+    gc_wakeup();
+
     return 0;
 }
 
 /* read gc config */
 container_garbage_config *read_gc_config()
 {
-    int nret;
     char filename[PATH_MAX] = { 0x00 };
     parser_error err = NULL;
     container_garbage_config *gcconfig = NULL;
-    char *rootpath = NULL;
 
-    rootpath = conf_get_isulad_rootdir();
-    if (rootpath == NULL) {
-        ERROR("Root path is NULL");
-        goto out;
-    }
-
-    nret = snprintf(filename, sizeof(filename), "%s/%s", rootpath, GCCONFIGJSON);
-    if (nret < 0 || (size_t)nret >= sizeof(filename)) {
-        ERROR("Failed to print string");
+    if (gc_file_path(GCCONFIGJSON, filename, sizeof(filename)) != 0) {
         goto out;
     }
 
@@ -265,10 +427,111 @@ container_garbage_config *read_gc_config()
     }
 out:
     free(err);
-    free(rootpath);
     return gcconfig;
 }
 
+static container_garbage_config_gc_containers_element *gc_parse_add_record(const char **fields)
+{
+    container_garbage_config_gc_containers_element *cont = NULL;
+    int pid = 0;
+    int ppid = 0;
+    uint64_t start_time = 0;
+    uint64_t p_start_time = 0;
+
+    if (util_safe_int(fields[3], &pid) != 0 || util_safe_uint64(fields[4], &start_time) != 0 ||
+        util_safe_int(fields[5], &ppid) != 0 || util_safe_uint64(fields[6], &p_start_time) != 0) {
+        return NULL;
+    }
+
+    cont = util_common_calloc_s(sizeof(container_garbage_config_gc_containers_element));
+    if (cont == NULL) {
+        return NULL;
+    }
+
+    cont->id = util_strdup_s(fields[1]);
+    cont->runtime = util_strdup_s(fields[2]);
+    cont->pid = pid;
+    cont->start_time = start_time;
+    cont->ppid = ppid;
+    cont->p_start_time = p_start_time;
+
+    return cont;
+}
+
+/*
+ * notes: this function must be called with gc_containers_lock.
+ * Records are idempotent, so a journal surviving a crash during compaction replays cleanly.
+ */
+static void gc_replay_journal_record(const char *line)
+{
+    char **fields = NULL;
+    size_t len = 0;
+    int pid = 0;
+    struct linked_list *node = NULL;
+    container_garbage_config_gc_containers_element *cont = NULL;
+
+    fields = util_string_split(line, ' ');
+    len = util_array_len((const char **)fields);
+
+    if (len == 7 && strcmp(fields[0], "add") == 0) {
+        cont = gc_parse_add_record((const char **)fields);
+        if (cont == NULL) {
+            goto invalid;
+        }
+        if (gc_find_entry(cont->id, cont->pid) != NULL) {
+            free_container_garbage_config_gc_containers_element(cont);
+            goto out;
+        }
+        node = gc_new_entry_node(cont);
+        if (node == NULL) {
+            CRIT("Memory allocation error.");
+            free_container_garbage_config_gc_containers_element(cont);
+            goto out;
+        }
+        linked_list_add_tail(&g_gc_containers.containers_list, node);
+        goto out;
+    }
+
+    if (len == 3 && strcmp(fields[0], "del") == 0 && util_safe_int(fields[2], &pid) == 0) {
+        node = gc_find_entry(fields[1], pid);
+        if (node != NULL) {
+            linked_list_del(node);
+            gc_free_entry_node(node);
+        }
+        goto out;
+    }
+
+invalid:
+    WARN("Ignore invalid garbage collector journal record: %s", line);
+out:
+    util_free_array(fields);
+}
+
+/* notes: this function must be called with gc_containers_lock */
+static void gc_replay_journal()
+{
+    char filename[PATH_MAX] = { 0 };
+    char *content = NULL;
+    char *line = NULL;
+    char *saveptr = NULL;
+
+    if (gc_file_path(GCJOURNAL, filename, sizeof(filename)) != 0 || !util_file_exists(filename)) {
+        return;
+    }
+
+    content = util_read_content_from_file(filename);
+    if (content == NULL) {
+        ERROR("Failed to read %s", filename);
+        return;
+    }
+
+    for (line = strtok_r(content, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+        gc_replay_journal_record(line);
+    }
+
+    free(content);
+}
+
 /* gc restore */
 int gc_restore()
 {
@@ -278,14 +541,11 @@ int gc_restore()
     struct linked_list *newnode = NULL;
 
     gcconfig = read_gc_config();
-    if (gcconfig == NULL) {
-        goto out;
-    }
 
     gc_containers_lock();
 
-    for (i = 0; i < gcconfig->gc_containers_len; i++) {
-        newnode = util_common_calloc_s(sizeof(struct linked_list));
+    for (i = 0; gcconfig != NULL && i < gcconfig->gc_containers_len; i++) {
+        newnode = gc_new_entry_node(gcconfig->gc_containers[i]);
         if (newnode == NULL) {
             gc_containers_unlock();
             CRIT("Memory allocation error, failed to restore garbage collector.");
@@ -293,13 +553,13 @@ int gc_restore()
             goto out;
         }
 
-        linked_list_add_elem(newnode, gcconfig->gc_containers[i]);
         linked_list_add_tail(&g_gc_containers.containers_list, newnode);
         gcconfig->gc_containers[i] = NULL;
     }
-    gcconfig->gc_containers_len = 0;
 
-    (void)gc_containers_to_disk();
+    gc_replay_journal();
+
+    (void)gc_journal_compact();
     gc_containers_unlock();
 
 out:
@@ -394,12 +654,25 @@ static void gc_monitor_process(const char *id, pid_t pid, unsigned long long sta
     }
 }
 
-static void add_to_list_tail_to_retry_gc(struct linked_list *it)
+static int gc_open_pidfd(pid_t pid)
 {
-    gc_containers_lock();
-    linked_list_del(it);
-    linked_list_add_tail(&g_gc_containers.containers_list, it);
-    gc_containers_unlock();
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+static void retry_gc_later(gc_entry_t *entry)
+{
+    uint64_t delay = GC_RETRY_MAX_MS;
+
+    if (entry->retries < 16 && ((uint64_t)GC_RETRY_MIN_MS << entry->retries) < GC_RETRY_MAX_MS) {
+        delay = (uint64_t)GC_RETRY_MIN_MS << entry->retries;
+    }
+    entry->retries++;
+    entry->next_run_ms = gc_now_ms() + delay;
 }
 
 static int do_runtime_resume_container(const container_t *cont)
@@ -453,16 +726,51 @@ out:
     container_unref(cont);
 }
 
-static void gc_container_process(struct linked_list *it)
+static int gc_pidfd_cb(int fd, uint32_t events, void *cbdata, struct epoll_descr *descr)
+{
+    gc_entry_t *entry = (gc_entry_t *)cbdata;
+
+    /* the process exited, a pidfd stays readable so stop watching it */
+    (void)epoll_loop_del_handler(descr, fd);
+    close(fd);
+    entry->pidfd = -1;
+    entry->next_run_ms = 0;
+
+    /* leave epoll_loop to handle the entry */
+    return EPOLL_LOOP_HANDLE_CLOSE;
+}
+
+/* wait for the killed process on its pidfd, the retry timer is kept as a fallback */
+static void gc_watch_process(struct epoll_descr *descr, gc_entry_t *entry)
+{
+    if (entry->pidfd >= 0) {
+        return;
+    }
+
+    entry->pidfd = gc_open_pidfd(entry->cont->pid);
+    if (entry->pidfd < 0) {
+        return;
+    }
+
+    if (epoll_loop_add_handler(descr, entry->pidfd, gc_pidfd_cb, entry) != 0) {
+        WARN("Failed to watch process %d of container %s", entry->cont->pid, entry->cont->id);
+        close(entry->pidfd);
+        entry->pidfd = -1;
+    }
+}
+
+static void gc_container_process(struct epoll_descr *descr, struct linked_list *it)
 {
     int ret = 0;
     int pid = 0;
     unsigned long long start_time = 0;
     char *runtime = NULL;
     char *id = NULL;
+    gc_entry_t *entry = NULL;
     container_garbage_config_gc_containers_element *gc_cont = NULL;
 
-    gc_cont = (container_garbage_config_gc_containers_element *)it->elem;
+    entry = (gc_entry_t *)it->elem;
+    gc_cont = entry->cont;
     id = gc_cont->id;
     runtime = gc_cont->runtime;
     pid = gc_cont->pid;
@@ -472,7 +780,7 @@ static void gc_container_process(struct linked_list *it)
         ret = clean_container_resource(id, runtime, pid);
         if (ret != 0) {
             WARN("Failed to clean resources of container %s", id);
-            add_to_list_tail_to_retry_gc(it);
+            retry_gc_later(entry);
             return;
         }
 
@@ -480,10 +788,14 @@ static void gc_container_process(struct linked_list *it)
         gc_containers_lock();
 
         linked_list_del(it);
-        (void)gc_containers_to_disk();
+        gc_journal_del(gc_cont);
 
         gc_containers_unlock();
 
+        if (entry->pidfd >= 0) {
+            (void)epoll_loop_del_handler(descr, entry->pidfd);
+        }
+
         EVENT("Event: {Object: GC, Type: Delete container %s with pid %u from garbage collector}", id, pid);
 
         /* apply restart policy for the container after gc */
@@ -491,34 +803,74 @@ static void gc_container_process(struct linked_list *it)
 
         apply_auto_remove_after_gc(id);
 
-        free_container_garbage_config_gc_containers_element(gc_cont);
-        free(it);
+        gc_free_entry_node(it);
     } else {
         try_to_resume_container(id, runtime);
         ret = kill(pid, SIGKILL);
         if (ret < 0 && errno != ESRCH) {
             ERROR("Can not kill process (pid=%d) with SIGKILL for container %s", pid, id);
         }
-        add_to_list_tail_to_retry_gc(it);
+        gc_watch_process(descr, entry);
+        retry_gc_later(entry);
     }
 }
-static void do_gc_container(struct linked_list *it)
+
+static void do_gc_container(struct epoll_descr *descr, struct linked_list *it)
 {
     container_garbage_config_gc_containers_element *gc_cont = NULL;
 
-    gc_cont = (container_garbage_config_gc_containers_element *)it->elem;
+    gc_cont = ((gc_entry_t *)it->elem)->cont;
 
     gc_monitor_process(gc_cont->id, gc_cont->ppid, gc_cont->p_start_time);
 
-    gc_container_process(it);
+    gc_container_process(descr, it);
 
     return;
 }
 
+/* return the first entry due at now, and the time until the next one in timeout, -1 if none */
+static struct linked_list *gc_next_due_entry(uint64_t now, int *timeout)
+{
+    struct linked_list *it = NULL;
+    struct linked_list *next = NULL;
+    struct linked_list *due = NULL;
+    uint64_t earliest = UINT64_MAX;
+
+    gc_containers_lock();
+
+    linked_list_for_each_safe(it, &g_gc_containers.containers_list, next) {
+        gc_entry_t *entry = (gc_entry_t *)it->elem;
+        if (entry->next_run_ms <= now) {
+            due = it;
+            break;
+        }
+        if (entry->next_run_ms < earliest) {
+            earliest = entry->next_run_ms;
+        }
+    }
+
+    gc_containers_unlock();
+
+    *timeout = earliest == UINT64_MAX ? -1 : (int)(earliest - now);
+    return due;
+}
+
+static int gc_wakeup_cb(int fd, uint32_t events, void *cbdata, struct epoll_descr *descr)
+{
+    uint64_t val = 0;
+
+    (void)util_read_nointr(fd, &val, sizeof(val));
+
+    /* leave epoll_loop to handle the new entries */
+    return EPOLL_LOOP_HANDLE_CLOSE;
+}
+
 static void *gchandler(void *arg)
 {
     int ret = 0;
+    int timeout = -1;
     struct linked_list *it = NULL;
+    struct epoll_descr descr = { 0 };
 
     ret = pthread_detach(pthread_self());
     if (ret != 0) {
@@ -528,22 +880,32 @@ static void *gchandler(void *arg)
 
     prctl(PR_SET_NAME, "Garbage_collector");
 
-    for (;;) {
-        gc_containers_lock();
-
-        if (linked_list_empty(&g_gc_containers.containers_list)) {
-            gc_containers_unlock();
-            goto wait_continue;
-        }
-        it = linked_list_first_node(&g_gc_containers.containers_list);
+    if (epoll_loop_open(&descr) != 0) {
+        CRIT("Failed to create epoll for garbage collector");
+        goto error;
+    }
 
-        gc_containers_unlock();
+    if (epoll_loop_add_handler(&descr, g_gc_containers.wakeup_fd, gc_wakeup_cb, NULL) != 0) {
+        CRIT("Failed to add wakeup handler for garbage collector");
+        goto close_out;
+    }
 
-        do_gc_container(it);
+    /* sleep until a container is added, a watched process exits or a retry is due */
+    for (;;) {
+        it = gc_next_due_entry(gc_now_ms(), &timeout);
+        if (it != NULL) {
+            do_gc_container(&descr, it);
+            continue;
+        }
 
-wait_continue:
-        util_usleep_nointerupt(100 * 1000); /* wait 100 millisecond to check next gc container */
+        if (epoll_loop(&descr, timeout) != 0) {
+            SYSERROR("Garbage collector epoll failed");
+            util_usleep_nointerupt(GC_RETRY_MIN_MS * 1000);
+        }
     }
+
+close_out:
+    (void)epoll_loop_close(&descr);
 error:
     return NULL;
 }
@@ -554,6 +916,14 @@ int new_gchandler()
     int ret = -1;
 
     linked_list_init(&(g_gc_containers.containers_list));
+    g_gc_containers.journal_records = 0;
+
+    g_gc_containers.wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_gc_containers.wakeup_fd < 0) {
+        SYSERROR("Failed to create garbage collector wakeup eventfd");
+        ret = -1;
+        goto out;
+    }
 
     ret = pthread_mutex_init(&(g_gc_containers.mutex), NULL);
     if (ret != 0) {
@@ -566,11 +936,16 @@ int new_gchandler()
     if (gc_restore()) {
         ERROR("Failed to restore garbage collector");
         pthread_mutex_destroy(&(g_gc_containers.mutex));
+        ret = -1;
         goto out;
     }
 
     ret = 0;
 out:
+    if (ret != 0 && g_gc_containers.wakeup_fd >= 0) {
+        close(g_gc_containers.wakeup_fd);
+        g_gc_containers.wakeup_fd = -1;
+    }
     return ret;
 }
 
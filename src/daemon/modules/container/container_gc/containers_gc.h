@@ -28,6 +28,10 @@ extern "C" {
 typedef struct _containers_gc_t_ {
     pthread_mutex_t mutex;
     struct linked_list containers_list;
+    /* eventfd to wake up the gc thread when a container is added */
+    int wakeup_fd;
+    /* records in the journal since garbage.json was last written */
+    size_t journal_records;
 } containers_gc_t;
 
 int new_gchandler();
@@ -83,11 +83,53 @@ void container_state_free(container_state_t *state)
 
     free_container_state(state->state);
     state->state = NULL;
+    free(state->disk_json);
+    state->disk_json = NULL;
 
     pthread_mutex_destroy(&state->mutex);
     free(state);
 }
 
+/* generate the state json, *json is NULL when it is the same as the json last written to disk, must hold the lock */
+int container_state_generate_changed_json(container_state_t *s, char **json)
+{
+    parser_error err = NULL;
+    char *new_json = NULL;
+
+    if (s == NULL || json == NULL) {
+        return -1;
+    }
+
+    *json = NULL;
+    new_json = container_state_generate_json(s->state, NULL, &err);
+    if (new_json == NULL) {
+        ERROR("Failed to generate container state json string:%s", err ? err : " ");
+        free(err);
+        return -1;
+    }
+    free(err);
+
+    if (s->disk_json != NULL && strcmp(s->disk_json, new_json) == 0) {
+        free(new_json);
+        return 0;
+    }
+
+    *json = new_json;
+    return 0;
+}
+
+/* record the json written to disk, takes the ownership of json, must hold the lock */
+void container_state_set_disk_json(container_state_t *s, char *json)
+{
+    if (s == NULL) {
+        free(json);
+        return;
+    }
+
+    free(s->disk_json);
+    s->disk_json = json;
+}
+
 /* state set starting */
 void container_state_set_starting(container_state_t *s)
 {
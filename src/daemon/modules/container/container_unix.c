@@ -704,7 +704,6 @@ out:
 static int container_save_container_state_config(const container_t *cont)
 {
     int ret = 0;
-    parser_error err = NULL;
     char *json_container_state = NULL;
 
     if (cont == NULL) {
@@ -713,10 +712,8 @@ static int container_save_container_state_config(const container_t *cont)
 
     container_state_lock(cont->state);
 
-    json_container_state = container_state_generate_json(cont->state->state, NULL, &err);
-    if (json_container_state == NULL) {
-        ERROR("Failed to generate container state json string:%s", err ? err : " ");
-        ret = -1;
+    ret = container_state_generate_changed_json(cont->state, &json_container_state);
+    if (ret != 0 || json_container_state == NULL) {
         goto out;
     }
 
@@ -727,9 +724,11 @@ static int container_save_container_state_config(const container_t *cont)
         goto out;
     }
 
+    container_state_set_disk_json(cont->state, json_container_state);
+    json_container_state = NULL;
+
 out:
     free(json_container_state);
-    free(err);
     container_state_unlock(cont->state);
 
     return ret;
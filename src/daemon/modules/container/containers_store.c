@@ -26,6 +26,8 @@
 
 typedef struct memory_store_t {
     map_t *map; // map string container_t
+    // label index, map "key" and "key=value" of every container label to the set of container ids
+    map_t *label_index; // map string map(string bool)
     pthread_rwlock_t rwlock;
 } memory_store;
 
@@ -46,6 +48,14 @@ static void memory_store_map_kvfree(void *key, void *value)
     container_unref((container_t *)value);
 }
 
+/* label index map kvfree */
+static void label_index_map_kvfree(void *key, void *value)
+{
+    free(key);
+
+    map_free((map_t *)value);
+}
+
 /* memory store free */
 static void memory_store_free(memory_store *store)
 {
@@ -54,6 +64,8 @@ static void memory_store_free(memory_store *store)
     }
     map_free(store->map);
     store->map = NULL;
+    map_free(store->label_index);
+    store->label_index = NULL;
     pthread_rwlock_destroy(&(store->rwlock));
     free(store);
 }
@@ -80,12 +92,100 @@ static memory_store *memory_store_new(void)
         ERROR("Out of memory");
         goto error_out;
     }
+    store->label_index = map_new(MAP_STR_PTR, MAP_DEFAULT_CMP_FUNC, label_index_map_kvfree);
+    if (store->label_index == NULL) {
+        ERROR("Out of memory");
+        goto error_out;
+    }
     return store;
 error_out:
     memory_store_free(store);
     return NULL;
 }
 
+static json_map_string_string *container_labels(const container_t *cont)
+{
+    if (cont == NULL || cont->common_config == NULL || cont->common_config->config == NULL) {
+        return NULL;
+    }
+
+    return cont->common_config->config->labels;
+}
+
+static void label_index_add_term(const char *term, const char *id)
+{
+    bool value = true;
+    map_t *ids = NULL;
+
+    ids = map_search(g_containers_store->label_index, (void *)term);
+    if (ids == NULL) {
+        ids = map_new(MAP_STR_BOOL, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+        if (ids == NULL) {
+            ERROR("Out of memory");
+            return;
+        }
+        if (!map_insert(g_containers_store->label_index, (void *)term, (void *)ids)) {
+            ERROR("Failed to insert label %s to index", term);
+            map_free(ids);
+            return;
+        }
+    }
+
+    if (!map_replace(ids, (void *)id, (void *)&value)) {
+        ERROR("Failed to insert container %s to label %s index", id, term);
+    }
+}
+
+static void label_index_remove_term(const char *term, const char *id)
+{
+    map_t *ids = NULL;
+
+    ids = map_search(g_containers_store->label_index, (void *)term);
+    if (ids == NULL) {
+        return;
+    }
+
+    (void)map_remove(ids, (void *)id);
+    if (map_size(ids) == 0) {
+        (void)map_remove(g_containers_store->label_index, (void *)term);
+    }
+}
+
+/* index both "key" and "key=value", the two forms accepted by the label filter; must hold the store wrlock */
+static void label_index_update(const container_t *cont, const char *id, bool add)
+{
+    size_t i;
+    json_map_string_string *labels = container_labels(cont);
+
+    if (labels == NULL) {
+        return;
+    }
+
+    for (i = 0; i < labels->len; i++) {
+        const char *parts[] = { labels->keys[i], labels->values[i] };
+        char *term = NULL;
+
+        if (labels->keys[i] == NULL || labels->values[i] == NULL) {
+            continue;
+        }
+
+        term = util_string_join("=", parts, sizeof(parts) / sizeof(parts[0]));
+        if (term == NULL) {
+            ERROR("Out of memory");
+            continue;
+        }
+
+        if (add) {
+            label_index_add_term(labels->keys[i], id);
+            label_index_add_term(term, id);
+        } else {
+            label_index_remove_term(labels->keys[i], id);
+            label_index_remove_term(term, id);
+        }
+        free(term);
+    }
+}
+
 /* containers store add */
 bool containers_store_add(const char *id, container_t *cont)
 {
@@ -95,7 +195,11 @@ bool containers_store_add(const char *id, container_t *cont)
         ERROR("lock memory store failed");
         return false;
     }
+    label_index_update(map_search(g_containers_store->map, (void *)id), id, false);
     ret = map_replace(g_containers_store->map, (void *)id, (void *)cont);
+    if (ret) {
+        label_index_update(cont, id, true);
+    }
     if (pthread_rwlock_unlock(&g_containers_store->rwlock)) {
         ERROR("unlock memory store failed");
         return false;
@@ -103,6 +207,80 @@ bool containers_store_add(const char *id, container_t *cont)
     return ret;
 }
 
+/*
+ * containers store match labels, return the set of container ids carrying all the label
+ * filters, each filter is "key" or "key=value"; the caller must free the returned map
+ */
+map_t *containers_store_match_labels(const char **labels, size_t len)
+{
+    size_t i;
+    bool value = true;
+    map_t *smallest = NULL;
+    map_t *result = NULL;
+    map_itor *itor = NULL;
+
+    if (labels == NULL) {
+        return NULL;
+    }
+
+    result = map_new(MAP_STR_BOOL, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    if (result == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+
+    if (pthread_rwlock_rdlock(&g_containers_store->rwlock) != 0) {
+        ERROR("lock memory store failed");
+        map_free(result);
+        return NULL;
+    }
+
+    // intersect from the smallest id set, any unknown label gives an empty result
+    for (i = 0; i < len; i++) {
+        map_t *ids = map_search(g_containers_store->label_index, (void *)labels[i]);
+        if (ids == NULL) {
+            goto unlock;
+        }
+        if (smallest == NULL || map_size(ids) < map_size(smallest)) {
+            smallest = ids;
+        }
+    }
+    if (smallest == NULL) {
+        goto unlock;
+    }
+
+    itor = map_itor_new(smallest);
+    if (itor == NULL) {
+        ERROR("Out of memory");
+        map_free(result);
+        result = NULL;
+        goto unlock;
+    }
+
+    for (; map_itor_valid(itor); map_itor_next(itor)) {
+        const char *id = map_itor_key(itor);
+        bool match = true;
+
+        for (i = 0; i < len && match; i++) {
+            map_t *ids = map_search(g_containers_store->label_index, (void *)labels[i]);
+            match = ids == smallest || map_search(ids, (void *)id) != NULL;
+        }
+        if (match && !map_replace(result, (void *)id, (void *)&value)) {
+            ERROR("Out of memory");
+            map_free(result);
+            result = NULL;
+            break;
+        }
+    }
+    map_itor_free(itor);
+
+unlock:
+    if (pthread_rwlock_unlock(&g_containers_store->rwlock) != 0) {
+        ERROR("unlock memory store failed");
+    }
+    return result;
+}
+
 /* containers store get */
 static container_t *containers_store_get_by_id(const char *id)
 {
@@ -345,6 +523,7 @@ bool containers_store_remove(const char *id)
         ERROR("lock memory store failed");
         return false;
     }
+    label_index_update(map_search(g_containers_store->map, (void *)id), id, false);
     ret = map_remove(g_containers_store->map, (void *)id);
     if (pthread_rwlock_unlock(&g_containers_store->rwlock) != 0) {
         ERROR("unlock memory store failed");
@@ -73,20 +73,39 @@ static char *get_health_status(container_state_t *s)
     return status;
 }
 
-static void set_health_status(container_t *cont, const char *new)
+static void save_health_state(container_t *cont)
 {
+    if (container_state_to_disk(cont)) {
+        WARN("Failed to save container \"%s\" to disk", cont->common_config->id);
+    }
+}
+
+/*
+ * Health status and failing streak changes are saved to disk, a new probe log alone is not. The
+ * log is kept in memory and saved along with the next change, so a steady container does not
+ * rewrite its state file on every probe. Return true if the status changed and was saved.
+ */
+static bool set_health_status(container_t *cont, const char *new)
+{
+    bool changed = false;
+
     if (cont->state == NULL || new == NULL) {
-        return;
+        return false;
     }
 
     container_state_lock(cont->state);
-    free(cont->state->state->health->status);
-    cont->state->state->health->status = util_strdup_s(new);
+    changed = cont->state->state->health->status == NULL || strcmp(cont->state->state->health->status, new) != 0;
+    if (changed) {
+        free(cont->state->state->health->status);
+        cont->state->state->health->status = util_strdup_s(new);
+    }
     container_state_unlock(cont->state);
 
-    if (container_state_to_disk(cont)) {
-        WARN("Failed to save container \"%s\" to disk", cont->common_config->id);
+    if (changed) {
+        save_health_state(cont);
     }
+
+    return changed;
 }
 
 static void init_monitor_idle_status(health_check_manager_t *health)
@@ -414,7 +433,9 @@ static int handle_increment_streak(container_t *cont, int retries)
     health = cont->state->state->health;
     health->failing_streak++;
     if (health->failing_streak >= retries) {
-        set_health_status(cont, UNHEALTHY);
+        if (!set_health_status(cont, UNHEALTHY)) {
+            save_health_state(cont);
+        }
         if (cont->common_config->config->healthcheck->exit_on_unhealthy) {
             pthread_t stop_container_tid = { 0 };
             char *container_id = util_strdup_s(cont->common_config->id);
@@ -425,9 +446,7 @@ static int handle_increment_streak(container_t *cont, int retries)
             }
         }
     } else {
-        if (container_state_to_disk(cont)) {
-            WARN("Failed to save container \"%s\" to disk", cont->common_config->id);
-        }
+        save_health_state(cont);
     }
 
     return ret;
@@ -498,7 +517,7 @@ out:
 }
 
 // Update the container's Status.Health struct based on the latest probe's result.
-static int handle_probe_result(const char *container_id, const defs_health_log_element *result)
+int health_check_handle_probe_result(const char *container_id, const defs_health_log_element *result)
 {
     int ret = 0;
     int retries = 0;
@@ -531,8 +550,12 @@ static int handle_probe_result(const char *container_id, const defs_health_log_e
     }
 
     if (result->exit_code == EXIT_STATUS_HEALTHY) {
+        bool streak_reset = health->failing_streak != 0;
+
         health->failing_streak = 0;
-        set_health_status(cont, HEALTHY);
+        if (!set_health_status(cont, HEALTHY) && streak_reset) {
+            save_health_state(cont);
+        }
     } else {
         if (handle_unhealthy_case(cont, result, retries)) {
             ERROR("failed to handle unhealthy case");
@@ -664,7 +687,7 @@ static void health_check_run(const char *container_id)
     (void)util_get_now_time_buffer(timebuffer, sizeof(timebuffer));
     result->end = util_strdup_s(timebuffer);
 
-    if (handle_probe_result(cont->common_config->id, result) != 0) {
+    if (health_check_handle_probe_result(cont->common_config->id, result) != 0) {
         ERROR("Failed to handle probe result");
     }
 
@@ -18,6 +18,7 @@
 #include "utils_timestamp.h"
 #include "container_api.h"
 #include "isula_libutils/container_config_v2.h"
+#include "isula_libutils/defs.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -27,6 +28,8 @@ typedef enum { CMD, CMD_SHELL, HEALTH_NONE, HEALTH_UNKNOWN } health_probe_t;
 
 void health_check_manager_free(health_check_manager_t *health_check);
 
+int health_check_handle_probe_result(const char *container_id, const defs_health_log_element *result);
+
 #ifdef __cplusplus
 }
 #endif
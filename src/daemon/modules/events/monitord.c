@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/prctl.h>
+#include <sys/eventfd.h>
 
 #include "isula_libutils/log.h"
 #include "mainloop.h"
@@ -38,6 +39,198 @@ struct monitored_handler {
     char *fifo_path;
 };
 
+/*
+ * Daemon internal producers hand their messages to the monitored thread
+ * through this bounded ring, the fifo is left for external producers.
+ */
+#define MONITORD_QUEUE_SIZE 2048
+
+struct monitord_queue {
+    pthread_mutex_t mutex;
+    // signaled when a full ring gets space, or the ring is closed
+    pthread_cond_t not_full;
+    struct monitord_msg *msgs;
+    size_t head;
+    size_t count;
+    int event_fd;
+    // the monitored thread drains the ring, it must not wait for space itself
+    pthread_t consumer;
+    uint64_t dropped;
+};
+
+static struct monitord_queue g_monitord_queue = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .not_full = PTHREAD_COND_INITIALIZER,
+    .msgs = NULL,
+    .head = 0,
+    .count = 0,
+    .event_fd = -1,
+    .dropped = 0,
+};
+
+int monitord_post_msg(const struct monitord_msg *msg)
+{
+    int ret = 0;
+    uint64_t one = 1;
+
+    if (msg == NULL) {
+        return -1;
+    }
+
+    if (pthread_mutex_lock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to lock monitord queue");
+        return -1;
+    }
+
+    /*
+     * Wait for space when the ring is full, falling back to the fifo here would let this
+     * message overtake the queued ones. Only fall back when monitored is not running.
+     */
+    while (g_monitord_queue.event_fd >= 0 && g_monitord_queue.count == MONITORD_QUEUE_SIZE) {
+        if (pthread_equal(pthread_self(), g_monitord_queue.consumer)) {
+            g_monitord_queue.dropped++;
+            WARN("Monitord queue is full, drop event %s, %lu events dropped", msg->name,
+                 (unsigned long)g_monitord_queue.dropped);
+            goto unlock;
+        }
+        if (pthread_cond_wait(&g_monitord_queue.not_full, &g_monitord_queue.mutex) != 0) {
+            ERROR("Failed to wait for space of monitord queue");
+            ret = -1;
+            goto unlock;
+        }
+    }
+
+    if (g_monitord_queue.event_fd < 0) {
+        ret = -1;
+        goto unlock;
+    }
+
+    g_monitord_queue.msgs[(g_monitord_queue.head + g_monitord_queue.count) % MONITORD_QUEUE_SIZE] = *msg;
+    g_monitord_queue.count++;
+
+    /* consumer drains until empty, so only the first message needs a wakeup */
+    if (g_monitord_queue.count == 1 &&
+        util_write_nointr(g_monitord_queue.event_fd, &one, sizeof(one)) != (ssize_t)sizeof(one)) {
+        SYSERROR("Failed to wake up monitored");
+    }
+
+unlock:
+    if (pthread_mutex_unlock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to unlock monitord queue");
+    }
+    return ret;
+}
+
+static bool monitord_queue_pop(struct monitord_msg *msg)
+{
+    bool got = false;
+
+    if (pthread_mutex_lock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to lock monitord queue");
+        return false;
+    }
+
+    if (g_monitord_queue.count > 0) {
+        *msg = g_monitord_queue.msgs[g_monitord_queue.head];
+        g_monitord_queue.head = (g_monitord_queue.head + 1) % MONITORD_QUEUE_SIZE;
+        if (g_monitord_queue.count == MONITORD_QUEUE_SIZE) {
+            (void)pthread_cond_broadcast(&g_monitord_queue.not_full);
+        }
+        g_monitord_queue.count--;
+        got = true;
+    }
+
+    if (pthread_mutex_unlock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to unlock monitord queue");
+    }
+    return got;
+}
+
+static int monitord_queue_open(void)
+{
+    int ret = 0;
+    struct monitord_msg *msgs = NULL;
+    int efd = -1;
+
+    msgs = util_smart_calloc_s(sizeof(struct monitord_msg), MONITORD_QUEUE_SIZE);
+    if (msgs == NULL) {
+        ERROR("Out of memory");
+        return -1;
+    }
+
+    efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (efd < 0) {
+        SYSERROR("Failed to create monitord queue eventfd");
+        free(msgs);
+        return -1;
+    }
+
+    if (pthread_mutex_lock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to lock monitord queue");
+        free(msgs);
+        close(efd);
+        return -1;
+    }
+    g_monitord_queue.msgs = msgs;
+    g_monitord_queue.head = 0;
+    g_monitord_queue.count = 0;
+    g_monitord_queue.event_fd = efd;
+    g_monitord_queue.consumer = pthread_self();
+    g_monitord_queue.dropped = 0;
+    if (pthread_mutex_unlock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to unlock monitord queue");
+        ret = -1;
+    }
+
+    return ret;
+}
+
+static void monitord_queue_close(void)
+{
+    if (pthread_mutex_lock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to lock monitord queue");
+        return;
+    }
+
+    if (g_monitord_queue.event_fd >= 0) {
+        close(g_monitord_queue.event_fd);
+        g_monitord_queue.event_fd = -1;
+    }
+    free(g_monitord_queue.msgs);
+    g_monitord_queue.msgs = NULL;
+    g_monitord_queue.head = 0;
+    g_monitord_queue.count = 0;
+    // wake up producers waiting for space, they fall back to the fifo
+    (void)pthread_cond_broadcast(&g_monitord_queue.not_full);
+
+    if (pthread_mutex_unlock(&g_monitord_queue.mutex) != 0) {
+        ERROR("Failed to unlock monitord queue");
+    }
+}
+
+/* monitor queue cb */
+static int monitor_queue_cb(int fd, uint32_t events, void *cbdata, struct epoll_descr *descr)
+{
+    uint64_t val = 0;
+    bool handled = false;
+    struct monitord_msg mmsg = { 0 };
+
+    if (util_read_nointr(fd, &val, sizeof(val)) < 0 && errno != EAGAIN) {
+        SYSERROR("Failed to read monitord queue eventfd");
+    }
+
+    while (monitord_queue_pop(&mmsg)) {
+        events_handler(&mmsg);
+        handled = true;
+    }
+
+    if (handled && malloc_trim(0) == 0) {
+        DEBUG("Malloc trim failed");
+    }
+
+    return EPOLL_LOOP_HANDLE_CONTINUE;
+}
+
 /* monitor event cb */
 static int monitor_event_cb(int fd, uint32_t events, void *cbdata, struct epoll_descr *descr)
 {
@@ -143,6 +336,17 @@ static void *monitored(void *arg)
         goto err;
     }
 
+    /* 2. monitor queue: to wait daemon internal message */
+    if (monitord_queue_open() != 0) {
+        goto err;
+    }
+
+    ret = epoll_loop_add_handler(&descr, g_monitord_queue.event_fd, monitor_queue_cb, NULL);
+    if (ret != 0) {
+        ERROR("Failed to add handler for monitord queue");
+        goto err;
+    }
+
     sem_post(msync->monitord_sem);
 
     /* loop forever except error occurred */
@@ -157,6 +361,10 @@ err:
     *(msync->exit_code) = -1;
     sem_post(msync->monitord_sem);
 err2:
+    if (g_monitord_queue.event_fd >= 0) {
+        epoll_loop_del_handler(&descr, g_monitord_queue.event_fd);
+    }
+    monitord_queue_close();
     free_monitored(&mhandler);
     epoll_loop_close(&descr);
 
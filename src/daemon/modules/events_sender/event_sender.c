@@ -22,6 +22,7 @@
 #include <fcntl.h>
 
 #include "events_sender_api.h"
+#include "events_collector_api.h"
 #include "isula_libutils/log.h"
 #include "isulad_config.h"
 #include "event_type.h"
@@ -33,17 +34,18 @@ static void isulad_monitor_fifo_send(const struct monitord_msg *msg)
 {
     int fd = -1;
     ssize_t ret = 0;
-    char *fifo_path = NULL;
+    const struct isulad_conf_snapshot *snapshot = NULL;
 
-    fifo_path = conf_get_isulad_monitor_fifo_path();
-    if (fifo_path == NULL) {
+    /* the snapshot is immutable, no need to lock the conf or copy the path for every event */
+    snapshot = conf_get_snapshot();
+    if (snapshot == NULL || snapshot->monitor_fifo_path == NULL) {
         return;
     }
 
     /* Open the fifo nonblock in case the monitor is dead, we don't want the
      * open to wait for a reader since it may never come.
      */
-    fd = util_open(fifo_path, O_WRONLY | O_NONBLOCK, 0);
+    fd = util_open(snapshot->monitor_fifo_path, O_WRONLY | O_NONBLOCK, 0);
     if (fd < 0) {
         /* It is normal for this open() to fail with ENXIO when there is
          * no monitor running, so we don't log it.
@@ -64,12 +66,21 @@ static void isulad_monitor_fifo_send(const struct monitord_msg *msg)
     } while (ret != sizeof(struct monitord_msg));
 
 out:
-    free(fifo_path);
     if (fd >= 0) {
         close(fd);
     }
 }
 
+/* isulad monitor send: use the in-process queue, the fifo is only used when monitored is not running */
+static void isulad_monitor_send(const struct monitord_msg *msg)
+{
+    if (monitord_post_msg(msg) == 0) {
+        return;
+    }
+
+    isulad_monitor_fifo_send(msg);
+}
+
 /* isulad monitor send container event */
 int isulad_monitor_send_container_event(const char *name, runtime_state_t state, int pid, int exit_code,
                                         const char *args, const char *extra_annations)
@@ -110,7 +121,7 @@ int isulad_monitor_send_container_event(const char *name, runtime_state_t state,
         msg.exit_code = exit_code;
     }
 
-    isulad_monitor_fifo_send(&msg);
+    isulad_monitor_send(&msg);
 
 out:
     return ret;
@@ -137,7 +148,7 @@ int isulad_monitor_send_image_event(const char *name, image_state_t state)
     (void)strncpy(msg.name, name, sizeof(msg.name) - 1);
     msg.name[sizeof(msg.name) - 1] = '\0';
 
-    isulad_monitor_fifo_send(&msg);
+    isulad_monitor_send(&msg);
 
 out:
     return ret;
@@ -49,6 +49,7 @@ struct bim_ops {
     int (*prepare_rf)(const im_prepare_request *request, char **real_rootfs);
     int (*mount_rf)(const im_mount_request *request);
     int (*umount_rf)(const im_umount_request *request);
+    int (*prefetch_rf)(const char *container_id, const char *rootfs, const json_map_string_string *annotations);
     int (*delete_rf)(const im_delete_rootfs_request *request);
     int (*export_rf)(const im_export_request *request);
     char *(*resolve_image_name)(const char *image_name);
@@ -123,6 +124,7 @@ struct bim_type {
 #include "driver.h"
 #include "storage.h"
 #include "oci_image.h"
+#include "oci_rootfs_prefetch.h"
 #endif
 
 #ifdef ENABLE_EMBEDDED_IMAGE
@@ -138,6 +140,7 @@ static const struct bim_ops g_embedded_ops = {
     .prepare_rf = embedded_prepare_rf,
     .mount_rf = embedded_mount_rf,
     .umount_rf = embedded_umount_rf,
+    .prefetch_rf = NULL,
     .delete_rf = embedded_delete_rf,
     .delete_broken_rf = NULL,
     .export_rf = NULL,
@@ -177,6 +180,7 @@ static const struct bim_ops g_oci_ops = {
     .prepare_rf = oci_prepare_rf,
     .mount_rf = oci_mount_rf,
     .umount_rf = oci_umount_rf,
+    .prefetch_rf = oci_rootfs_prefetch,
     .delete_rf = oci_delete_rf,
     .delete_broken_rf = oci_delete_broken_rf,
     .export_rf = oci_export_rf,
@@ -215,6 +219,7 @@ static const struct bim_ops g_ext_ops = {
     .prepare_rf = ext_prepare_rf,
     .mount_rf = ext_mount_rf,
     .umount_rf = ext_umount_rf,
+    .prefetch_rf = NULL,
     .delete_rf = ext_delete_rf,
     .delete_broken_rf = NULL,
     .export_rf = NULL,
@@ -738,6 +743,38 @@ out:
     return ret;
 }
 
+int im_prefetch_container_rootfs(const char *image_type, const char *image_name, const char *container_id,
+                                 const char *rootfs, const json_map_string_string *annotations)
+{
+    int ret = 0;
+    struct bim *bim = NULL;
+
+    if (image_name == NULL || container_id == NULL || image_type == NULL || rootfs == NULL) {
+        ERROR("Invalid input arguments");
+        return -1;
+    }
+
+    bim = bim_get(image_type, image_name, NULL, container_id);
+    if (bim == NULL) {
+        ERROR("Failed to init bim for container %s", container_id);
+        return -1;
+    }
+    if (bim->ops->prefetch_rf == NULL) {
+        DEBUG("Unimplements rootfs prefetch in %s", bim->type);
+        goto out;
+    }
+
+    ret = bim->ops->prefetch_rf(container_id, rootfs, annotations);
+    if (ret != 0) {
+        ERROR("Failed to prefetch rootfs for container %s", container_id);
+        ret = -1;
+    }
+
+out:
+    bim_put(bim);
+    return ret;
+}
+
 char *im_get_image_type(const char *image, const char *external_rootfs)
 {
     const char *image_name = NULL;
@@ -305,6 +305,7 @@ static int registry_layer_from_tarball(const load_layer_blob_t *layer, const cha
         .compressed_digest = layer->compressed_digest,
         .writable = false,
         .layer_data_path = layer->fpath,
+        .verify_uncompress_digest = true,
     };
 
     if (storage_layer_create(id, &copts) != 0) {
@@ -624,11 +625,10 @@ out:
     return ret;
 }
 
+// Diff id of layer is taken from image config here and verified while the layer is
+// unpacked, so the tarball is only read by storage instead of being digested in advance.
 static int check_and_set_digest_from_tarball(load_layer_blob_t *layer, const char *conf_diff_id)
 {
-    int ret = 0;
-    bool gzip = false;
-
     if (layer == NULL || conf_diff_id == NULL) {
         ERROR("Invalid input param");
         return -1;
@@ -637,39 +637,13 @@ static int check_and_set_digest_from_tarball(load_layer_blob_t *layer, const cha
     if (!util_file_exists(layer->fpath)) {
         ERROR("Layer data file:%s is not exist", layer->fpath);
         isulad_try_set_error_message("%s no such file", layer->fpath);
-        ret = -1;
-        goto out;
+        return -1;
     }
 
     layer->alread_exist = false;
-    layer->diff_id = oci_calc_diffid(layer->fpath);
-    if (layer->diff_id == NULL) {
-        ERROR("Calc layer:%s diff id failed", layer->fpath);
-        ret = -1;
-        goto out;
-    }
-
-    if (util_gzip_compressed(layer->fpath, &gzip) != 0) {
-        ERROR("Judge layer file gzip attr err");
-        ret = -1;
-        goto out;
-    }
+    layer->diff_id = util_strdup_s(conf_diff_id);
 
-    layer->compressed_digest = gzip ? sha256_full_file_digest(layer->fpath) : util_strdup_s(layer->diff_id);
-    if (layer->compressed_digest == NULL) {
-        ERROR("Calc layer %s compressed digest failed", layer->fpath);
-        ret = -1;
-        goto out;
-    }
-
-    if (strcmp(layer->diff_id, conf_diff_id) != 0) {
-        ERROR("invalid diff id for layer:%s: expected %s, got %s", layer->chain_id, conf_diff_id, layer->diff_id);
-        ret = -1;
-        goto out;
-    }
-
-out:
-    return ret;
+    return 0;
 }
 
 static int oci_load_set_layers_info(load_image_t *im, const image_manifest_items_element *manifest, const char *dstdir)
@@ -0,0 +1,473 @@
+/******************************************************************************
+* Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+* iSulad licensed under the Mulan PSL v2.
+* You can use this software according to the terms and conditions of the Mulan PSL v2.
+* You may obtain a copy of Mulan PSL v2 at:
+*     http://license.coscl.org.cn/MulanPSL2
+* THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+* PURPOSE.
+* See the Mulan PSL v2 for more details.
+* Author: isulad
+* Create: 2026-10-18
+* Description: record the file access order of container rootfs and prefetch it on later starts
+*******************************************************************************/
+#define _GNU_SOURCE
+#include "oci_rootfs_prefetch.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/fanotify.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "isula_libutils/log.h"
+#include "image_api.h"
+#include "map.h"
+#include "path.h"
+#include "storage.h"
+#include "utils.h"
+#include "utils_array.h"
+#include "utils_string.h"
+
+/* the first run is traced for this long, long enough to cover the startup of most runtimes */
+#define ROOTFS_TRACE_RECORD_SECONDS 60
+#define ROOTFS_TRACE_INIT_FILES 256
+#define ROOTFS_TRACE_EVENT_BUF_SIZE 8192
+
+struct rootfs_prefetch_args {
+    char *image_id;
+    char *rootfs;
+    char *trace;
+};
+
+/* images whose access trace is being recorded, concurrent first starts of an image record it once */
+static map_t *g_recording_images = NULL; // map string bool
+static pthread_mutex_t g_recording_images_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void free_rootfs_prefetch_args(struct rootfs_prefetch_args *args)
+{
+    if (args == NULL) {
+        return;
+    }
+    free(args->image_id);
+    free(args->rootfs);
+    free(args->trace);
+    free(args);
+}
+
+static bool begin_recording(const char *image_id)
+{
+    bool value = true;
+    bool ret = false;
+
+    (void)pthread_mutex_lock(&g_recording_images_lock);
+    if (g_recording_images == NULL) {
+        g_recording_images = map_new(MAP_STR_BOOL, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+        if (g_recording_images == NULL) {
+            ERROR("Out of memory");
+            goto out;
+        }
+    }
+
+    if (map_search(g_recording_images, (void *)image_id) != NULL) {
+        goto out;
+    }
+    ret = map_insert(g_recording_images, (void *)image_id, (void *)&value);
+
+out:
+    (void)pthread_mutex_unlock(&g_recording_images_lock);
+    return ret;
+}
+
+static void end_recording(const char *image_id)
+{
+    (void)pthread_mutex_lock(&g_recording_images_lock);
+    if (g_recording_images != NULL) {
+        (void)map_remove(g_recording_images, (void *)image_id);
+    }
+    (void)pthread_mutex_unlock(&g_recording_images_lock);
+}
+
+int oci_rootfs_prefetch_file(const char *rootfs, const char *path)
+{
+    int ret = -1;
+    int path_fd = -1;
+    int fd = -1;
+    int nret = 0;
+    char *real_path = NULL;
+    char proc_path[PATH_MAX] = { 0 };
+    struct stat st = { 0 };
+
+    // the trace is stored with the image, resolve it inside the rootfs like any other container path
+    if (util_realpath_in_scope(rootfs, path, &real_path) != 0) {
+        return -1;
+    }
+
+    // an O_PATH fd never opens a fifo or a device, and O_NOFOLLOW leaves a symlink swapped in
+    // after the resolution as the link itself, which is rejected as not regular below
+    path_fd = util_open(real_path, O_PATH | O_NOFOLLOW, 0);
+    if (path_fd < 0) {
+        goto out;
+    }
+
+    if (fstat(path_fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        goto out;
+    }
+    if (st.st_size == 0) {
+        ret = 0;
+        goto out;
+    }
+
+    nret = snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", path_fd);
+    if (nret < 0 || (size_t)nret >= sizeof(proc_path)) {
+        goto out;
+    }
+    fd = open(proc_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        goto out;
+    }
+
+    if (readahead(fd, 0, (size_t)st.st_size) != 0) {
+        (void)posix_fadvise(fd, 0, st.st_size, POSIX_FADV_WILLNEED);
+    }
+    ret = 0;
+
+out:
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (path_fd >= 0) {
+        close(path_fd);
+    }
+    free(real_path);
+    return ret;
+}
+
+char *oci_rootfs_trace_serialize(const string_array *trace)
+{
+    size_t len = 0;
+
+    if (trace == NULL || trace->len == 0) {
+        return NULL;
+    }
+
+    len = trace->len < OCI_ROOTFS_TRACE_MAX_FILES ? trace->len : OCI_ROOTFS_TRACE_MAX_FILES;
+    return util_string_join("\n", (const char **)trace->items, len);
+}
+
+char **oci_rootfs_trace_split(const char *trace)
+{
+    char **lines = NULL;
+    char **paths = NULL;
+    size_t lines_len = 0;
+    size_t len = 0;
+    size_t i = 0;
+
+    if (trace == NULL) {
+        return NULL;
+    }
+
+    lines = util_string_split(trace, '\n');
+    if (lines == NULL) {
+        return NULL;
+    }
+    lines_len = util_array_len((const char **)lines);
+
+    paths = util_smart_calloc_s(sizeof(char *), lines_len + 1);
+    if (paths == NULL) {
+        ERROR("Out of memory");
+        goto out;
+    }
+
+    // a trace is only written by this daemon, skip whatever else found its way into the big data
+    for (i = 0; i < lines_len && len < OCI_ROOTFS_TRACE_MAX_FILES; i++) {
+        if (lines[i][0] != '/') {
+            continue;
+        }
+        paths[len++] = lines[i];
+        lines[i] = NULL;
+    }
+
+out:
+    util_free_array_by_len(lines, lines_len);
+    return paths;
+}
+
+static void *rootfs_prefetch_thread(void *arg)
+{
+    struct rootfs_prefetch_args *args = (struct rootfs_prefetch_args *)arg;
+    char **paths = NULL;
+    size_t i = 0;
+
+    if (pthread_detach(pthread_self()) != 0) {
+        ERROR("Failed to detach rootfs prefetch thread");
+    }
+    prctl(PR_SET_NAME, "RootfsPrefetch");
+
+    paths = oci_rootfs_trace_split(args->trace);
+    if (paths == NULL) {
+        goto out;
+    }
+
+    for (i = 0; paths[i] != NULL; i++) {
+        (void)oci_rootfs_prefetch_file(args->rootfs, paths[i]);
+    }
+    DEBUG("Prefetched %zu traced files of image %s", i, args->image_id);
+
+out:
+    util_free_array(paths);
+    free_rootfs_prefetch_args(args);
+    return NULL;
+}
+
+/* the event fd is opened in the namespace of the daemon, strip the rootfs if the path is seen through it */
+char *oci_rootfs_trace_event_path(int event_fd, const char *rootfs)
+{
+    char proc_path[PATH_MAX] = { 0 };
+    char path[PATH_MAX] = { 0 };
+    size_t rootfs_len = strlen(rootfs);
+    ssize_t len = 0;
+    int nret = 0;
+
+    nret = snprintf(proc_path, sizeof(proc_path), "/proc/self/fd/%d", event_fd);
+    if (nret < 0 || (size_t)nret >= sizeof(proc_path)) {
+        return NULL;
+    }
+
+    len = readlink(proc_path, path, sizeof(path) - 1);
+    if (len <= 0) {
+        return NULL;
+    }
+    path[len] = '\0';
+
+    // the trace keeps one path per line
+    if (strchr(path, '\n') != NULL) {
+        return NULL;
+    }
+
+    if (strncmp(path, rootfs, rootfs_len) == 0 && path[rootfs_len] == '/') {
+        return util_strdup_s(path + rootfs_len);
+    }
+
+    // files opened by the container after it pivoted into the rootfs
+    return path[0] == '/' ? util_strdup_s(path) : NULL;
+}
+
+static int record_trace_events(int fan_fd, const char *rootfs, map_t *seen, string_array *trace)
+{
+    char buf[ROOTFS_TRACE_EVENT_BUF_SIZE] __attribute__((aligned(__alignof__(struct fanotify_event_metadata))));
+    struct fanotify_event_metadata *metadata = NULL;
+    bool value = true;
+    ssize_t len = 0;
+
+    len = util_read_nointr(fan_fd, buf, sizeof(buf));
+    if (len <= 0) {
+        return len == 0 || errno == EAGAIN ? 0 : -1;
+    }
+
+    for (metadata = (struct fanotify_event_metadata *)buf; FAN_EVENT_OK(metadata, len);
+         metadata = FAN_EVENT_NEXT(metadata, len)) {
+        char *path = NULL;
+
+        if (metadata->vers != FANOTIFY_METADATA_VERSION) {
+            ERROR("Mismatch of fanotify metadata version");
+            return -1;
+        }
+        if (metadata->fd < 0) {
+            continue;
+        }
+
+        path = oci_rootfs_trace_event_path(metadata->fd, rootfs);
+        close(metadata->fd);
+        if (path == NULL || trace->len >= OCI_ROOTFS_TRACE_MAX_FILES || map_search(seen, (void *)path) != NULL) {
+            free(path);
+            continue;
+        }
+
+        if (!map_insert(seen, (void *)path, (void *)&value) || util_append_string_array(trace, path) != 0) {
+            ERROR("Out of memory");
+            free(path);
+            return -1;
+        }
+        free(path);
+    }
+
+    return 0;
+}
+
+static int init_trace_fanotify(const char *rootfs)
+{
+    int fan_fd = -1;
+    unsigned int mark_flags = FAN_MARK_ADD;
+
+    fan_fd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK, O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+    if (fan_fd < 0) {
+        SYSERROR("Failed to init fanotify to trace rootfs %s", rootfs);
+        return -1;
+    }
+
+#ifdef FAN_MARK_FILESYSTEM
+    // the container sees a copy of the rootfs mount in its own mount namespace, mark the whole overlay instead
+    mark_flags |= FAN_MARK_FILESYSTEM;
+#else
+    mark_flags |= FAN_MARK_MOUNT;
+#endif
+    if (fanotify_mark(fan_fd, mark_flags, FAN_OPEN, AT_FDCWD, rootfs) != 0) {
+        SYSERROR("Failed to mark rootfs %s for fanotify", rootfs);
+        close(fan_fd);
+        return -1;
+    }
+
+    return fan_fd;
+}
+
+static void *rootfs_trace_thread(void *arg)
+{
+    struct rootfs_prefetch_args *args = (struct rootfs_prefetch_args *)arg;
+    int fan_fd = -1;
+    time_t deadline = 0;
+    map_t *seen = NULL;
+    string_array *trace = NULL;
+    char *content = NULL;
+
+    if (pthread_detach(pthread_self()) != 0) {
+        ERROR("Failed to detach rootfs trace thread");
+    }
+    prctl(PR_SET_NAME, "RootfsTrace");
+
+    seen = map_new(MAP_STR_BOOL, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    trace = util_string_array_new(ROOTFS_TRACE_INIT_FILES);
+    if (seen == NULL || trace == NULL) {
+        ERROR("Out of memory");
+        goto out;
+    }
+
+    fan_fd = init_trace_fanotify(args->rootfs);
+    if (fan_fd < 0) {
+        goto out;
+    }
+
+    deadline = time(NULL) + ROOTFS_TRACE_RECORD_SECONDS;
+    while (trace->len < OCI_ROOTFS_TRACE_MAX_FILES) {
+        struct pollfd pfd = { .fd = fan_fd, .events = POLLIN };
+        time_t now = time(NULL);
+        int nret = 0;
+
+        if (now >= deadline) {
+            break;
+        }
+        nret = poll(&pfd, 1, (int)(deadline - now) * 1000);
+        if (nret < 0 && errno != EINTR) {
+            SYSERROR("Failed to poll fanotify of rootfs %s", args->rootfs);
+            goto out;
+        }
+        if (nret > 0 && record_trace_events(fan_fd, args->rootfs, seen, trace) != 0) {
+            goto out;
+        }
+    }
+
+    if (trace->len == 0) {
+        goto out;
+    }
+
+    content = oci_rootfs_trace_serialize(trace);
+    if (content == NULL || storage_img_set_big_data(args->image_id, OCI_ROOTFS_ACCESS_TRACE_KEY, content) != 0) {
+        ERROR("Failed to save rootfs access trace of image %s", args->image_id);
+        goto out;
+    }
+    INFO("Recorded %zu rootfs files in access trace of image %s", trace->len, args->image_id);
+
+out:
+    if (fan_fd >= 0) {
+        close(fan_fd);
+    }
+    free(content);
+    util_free_string_array(trace);
+    map_free(seen);
+    end_recording(args->image_id);
+    free_rootfs_prefetch_args(args);
+    return NULL;
+}
+
+bool oci_rootfs_prefetch_enabled(const json_map_string_string *annotations)
+{
+    size_t i = 0;
+
+    if (annotations == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < annotations->len; i++) {
+        if (annotations->keys[i] != NULL && strcmp(annotations->keys[i], IM_ROOTFS_PREFETCH_ANNOTATION) == 0) {
+            return annotations->values[i] != NULL && strcmp(annotations->values[i], "true") == 0;
+        }
+    }
+
+    return false;
+}
+
+int oci_rootfs_prefetch(const char *container_id, const char *rootfs, const json_map_string_string *annotations)
+{
+    int ret = 0;
+    pthread_t tid = 0;
+    char *image_id = NULL;
+    struct rootfs_prefetch_args *args = NULL;
+    void *(*worker)(void *) = rootfs_prefetch_thread;
+
+    if (container_id == NULL || rootfs == NULL) {
+        ERROR("Invalid arguments");
+        return -1;
+    }
+
+    if (!oci_rootfs_prefetch_enabled(annotations)) {
+        return 0;
+    }
+
+    image_id = storage_rootfs_get_image_id(container_id);
+    if (image_id == NULL) {
+        // container created from an external rootfs has no image to keep the trace
+        return 0;
+    }
+
+    args = util_common_calloc_s(sizeof(struct rootfs_prefetch_args));
+    if (args == NULL) {
+        ERROR("Out of memory");
+        free(image_id);
+        return -1;
+    }
+    args->image_id = image_id;
+    args->rootfs = util_strdup_s(rootfs);
+    args->trace = storage_img_get_big_data(image_id, OCI_ROOTFS_ACCESS_TRACE_KEY);
+
+    if (args->trace == NULL) {
+        if (!begin_recording(image_id)) {
+            goto out;
+        }
+        worker = rootfs_trace_thread;
+    }
+
+    if (pthread_create(&tid, NULL, worker, (void *)args) != 0) {
+        ERROR("Failed to create rootfs prefetch thread for container %s", container_id);
+        if (worker == rootfs_trace_thread) {
+            end_recording(image_id);
+        }
+        ret = -1;
+        goto out;
+    }
+
+    return 0;
+
+out:
+    free_rootfs_prefetch_args(args);
+    return ret;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+* Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+* iSulad licensed under the Mulan PSL v2.
+* You can use this software according to the terms and conditions of the Mulan PSL v2.
+* You may obtain a copy of Mulan PSL v2 at:
+*     http://license.coscl.org.cn/MulanPSL2
+* THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+* PURPOSE.
+* See the Mulan PSL v2 for more details.
+* Author: isulad
+* Create: 2026-10-18
+* Description: record the file access order of container rootfs and prefetch it on later starts
+*******************************************************************************/
+#ifndef DAEMON_MODULES_IMAGE_OCI_OCI_ROOTFS_PREFETCH_H
+#define DAEMON_MODULES_IMAGE_OCI_OCI_ROOTFS_PREFETCH_H
+
+#include <stdbool.h>
+#include <isula_libutils/json_common.h>
+
+#include "utils_array.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* image big data holding the rootfs paths opened by the first run, one per line in access order */
+#define OCI_ROOTFS_ACCESS_TRACE_KEY "rootfs-access-trace"
+
+/* at most this many files of a rootfs are traced and prefetched */
+#define OCI_ROOTFS_TRACE_MAX_FILES 8192
+
+/* whether the container annotations opt in by IM_ROOTFS_PREFETCH_ANNOTATION */
+bool oci_rootfs_prefetch_enabled(const json_map_string_string *annotations);
+
+/*
+ * Prefetch the traced files of the image into page cache in background, or start recording the
+ * access trace if the image has none yet. Both run detached, the container start never waits.
+ */
+int oci_rootfs_prefetch(const char *container_id, const char *rootfs, const json_map_string_string *annotations);
+
+/* the trace big data of the traced paths, at most OCI_ROOTFS_TRACE_MAX_FILES of them */
+char *oci_rootfs_trace_serialize(const string_array *trace);
+
+/* the absolute paths of a trace big data, at most OCI_ROOTFS_TRACE_MAX_FILES of them */
+char **oci_rootfs_trace_split(const char *trace);
+
+/* the path of the file behind a fanotify event fd inside rootfs, NULL if it can not be kept in a trace */
+char *oci_rootfs_trace_event_path(int event_fd, const char *rootfs);
+
+/* read ahead a regular file of rootfs, anything else is skipped and returns -1 */
+int oci_rootfs_prefetch_file(const char *rootfs, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1210,23 +1210,15 @@ static void *fetch_layer_in_thread(void *arg)
 
     prctl(PR_SET_NAME, "fetch_layer");
 
-    if (fetch_layer(desc, info->index) != 0) {
-        ERROR("fetch layer %zu failed", info->index);
-        ret = -1;
-        goto out;
-    }
-
     // calc diffid only if it's schema v1. schema v1 have
     // no diff id so we need to calc it. schema v2 have
     // diff id in config and we do not want to calc it again
-    // as it cost too much time.
-    if (is_manifest_schemav1(desc->manifest.media_type)) {
-        diffid = oci_calc_diffid(info->file);
-        if (diffid == NULL) {
-            ERROR("calc diffid for layer %zu failed", info->index);
-            ret = -1;
-            goto out;
-        }
+    // as it cost too much time. diffid is calculated in the
+    // same pass with digest check of fetched layer.
+    if (fetch_layer(desc, info->index, is_manifest_schemav1(desc->manifest.media_type) ? &diffid : NULL) != 0) {
+        ERROR("fetch layer %zu failed", info->index);
+        ret = -1;
+        goto out;
     }
 
 out:
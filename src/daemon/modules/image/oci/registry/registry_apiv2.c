@@ -730,7 +730,35 @@ static void try_log_resp_body(char *path, char *file)
     return;
 }
 
-static int fetch_data(pull_descriptor *desc, char *path, char *file, char *content_type, char *digest)
+// check digest of fetched file, and calculate diff id in the same pass if required
+static bool valid_fetched_data(const char *file, const char *digest, char **diffid)
+{
+    char *file_digest = NULL;
+    char *file_diffid = NULL;
+
+    if (diffid == NULL) {
+        return sha256_valid_digest_file(file, digest);
+    }
+
+    if (sha256_full_layer_digests(file, &file_digest, &file_diffid) != 0) {
+        ERROR("calc digests of file %s failed", file);
+        return false;
+    }
+
+    if (strcmp(file_digest, digest) != 0) {
+        ERROR("file %s digest %s not match %s", file, file_digest, digest);
+        free(file_digest);
+        free(file_diffid);
+        return false;
+    }
+
+    free(file_digest);
+    free(*diffid);
+    *diffid = file_diffid;
+    return true;
+}
+
+static int fetch_data(pull_descriptor *desc, char *path, char *file, char *content_type, char *digest, char **diffid)
 {
     int ret = 0;
     int sret = 0;
@@ -782,7 +810,7 @@ static int fetch_data(pull_descriptor *desc, char *path, char *file, char *conte
 
         // If content is signatured, digest is for payload but not fetched data
         if (strcmp(content_type, DOCKER_MANIFEST_SCHEMA1_PRETTYJWS) && digest != NULL) {
-            if (!sha256_valid_digest_file(file, digest)) {
+            if (!valid_fetched_data(file, digest, diffid)) {
                 type = BODY_ONLY;
                 if (retry_times > 0 && !desc->cancel) {
                     continue;
@@ -1019,7 +1047,7 @@ static int fetch_manifest_data(pull_descriptor *desc, char *file, char **content
             goto out;
         }
 
-        ret = fetch_data(desc, path, file, *content_type, *digest);
+        ret = fetch_data(desc, path, file, *content_type, *digest, NULL);
         if (ret != 0) {
             ERROR("registry: Get %s failed", path);
             goto out;
@@ -1100,7 +1128,7 @@ int fetch_config(pull_descriptor *desc)
         goto out;
     }
 
-    ret = fetch_data(desc, path, file, desc->config.media_type, desc->config.digest);
+    ret = fetch_data(desc, path, file, desc->config.media_type, desc->config.digest, NULL);
     if (ret != 0) {
         ERROR("registry: Get %s failed", path);
         goto out;
@@ -1113,7 +1141,7 @@ out:
     return ret;
 }
 
-int fetch_layer(pull_descriptor *desc, size_t index)
+int fetch_layer(pull_descriptor *desc, size_t index, char **diffid)
 {
     int ret = 0;
     int sret = 0;
@@ -1145,12 +1173,24 @@ int fetch_layer(pull_descriptor *desc, size_t index)
         goto out;
     }
 
-    ret = fetch_data(desc, path, file, layer->media_type, layer->digest);
+    ret = fetch_data(desc, path, file, layer->media_type, layer->digest, diffid);
     if (ret != 0) {
         ERROR("registry: Get %s failed", path);
         goto out;
     }
 
+    // digest check skipped, calculate diff id alone
+    if (diffid != NULL && *diffid == NULL) {
+        char *file_digest = NULL;
+
+        ret = sha256_full_layer_digests(file, &file_digest, diffid);
+        free(file_digest);
+        if (ret != 0) {
+            ERROR("calc diff id for layer %zu failed", index);
+            goto out;
+        }
+    }
+
 out:
 
     return ret;
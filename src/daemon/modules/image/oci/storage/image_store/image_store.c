@@ -76,6 +76,8 @@ typedef struct image_store {
     map_t *byid;
     map_t *byname;
     map_t *bydigest;
+    // number of images using the key as top layer
+    map_t *bytoplayer;
 
     bool loaded;
 } image_store_t;
@@ -134,6 +136,9 @@ static void free_image_store(image_store_t *store)
     (void)map_free(store->bydigest);
     store->bydigest = NULL;
 
+    (void)map_free(store->bytoplayer);
+    store->bytoplayer = NULL;
+
     linked_list_for_each_safe(item, &(store->images_list), next) {
         linked_list_del(item);
         image_ref_dec((image_t *)item->elem);
@@ -183,16 +188,14 @@ static int get_image_path(const char *id, char *path, size_t len)
     return (nret < 0 || (size_t)nret >= len) ? -1 : 0;
 }
 
-static int save_image(storage_image *img)
+static int write_image_json(const char *id, const char *json_data)
 {
     int ret = 0;
     char image_path[PATH_MAX] = { 0x00 };
     char image_dir[PATH_MAX] = { 0x00 };
-    parser_error err = NULL;
-    char *json_data = NULL;
 
-    if (get_image_path(img->id, image_path, sizeof(image_path)) != 0) {
-        ERROR("Failed to get image path by id: %s", img->id);
+    if (get_image_path(id, image_path, sizeof(image_path)) != 0) {
+        ERROR("Failed to get image path by id: %s", id);
         return -1;
     }
 
@@ -203,6 +206,20 @@ static int save_image(storage_image *img)
         return -1;
     }
 
+    if (util_atomic_write_file(image_path, json_data, strlen(json_data), SECURE_CONFIG_FILE_MODE, true) != 0) {
+        ERROR("Failed to save image json file");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int save_image(storage_image *img)
+{
+    int ret = 0;
+    parser_error err = NULL;
+    char *json_data = NULL;
+
     json_data = storage_image_generate_json(img, NULL, &err);
     if (json_data == NULL) {
         ERROR("Failed to generate image json path string:%s", err ? err : " ");
@@ -210,11 +227,7 @@ static int save_image(storage_image *img)
         goto out;
     }
 
-    if (util_atomic_write_file(image_path, json_data, strlen(json_data), SECURE_CONFIG_FILE_MODE, true) != 0) {
-        ERROR("Failed to save image json file");
-        ret = -1;
-        goto out;
-    }
+    ret = write_image_json(img->id, json_data);
 
 out:
     free(json_data);
@@ -223,6 +236,68 @@ out:
     return ret;
 }
 
+/*
+ * Image json is generated under the exclusive store lock and written after the lock is released,
+ * so a slow disk only holds up the writers of the same image. Every json carries its generation,
+ * a json older than the one on disk is dropped, and the file ends up with the latest generation
+ * whatever order the writers reach the disk in.
+ */
+typedef struct image_save_job {
+    image_t *img;
+    char *id;
+    char *json;
+    uint64_t seq;
+} image_save_job_t;
+
+/* must hold the exclusive store lock */
+static int prepare_image_save(image_t *img, image_save_job_t *job)
+{
+    parser_error err = NULL;
+
+    job->json = storage_image_generate_json(img->simage, NULL, &err);
+    if (job->json == NULL) {
+        ERROR("Failed to generate image json path string:%s", err ? err : " ");
+        free(err);
+        return -1;
+    }
+
+    img->save_seq++;
+    job->seq = img->save_seq;
+    job->id = util_strdup_s(img->simage->id);
+    image_ref_inc(img);
+    job->img = img;
+
+    return 0;
+}
+
+/* must not hold the store lock */
+static int commit_image_save(image_save_job_t *job)
+{
+    int ret = 0;
+    image_t *img = job->img;
+
+    if (img == NULL) {
+        return 0;
+    }
+
+    (void)pthread_mutex_lock(&img->save_mutex);
+    if (!img->removed && job->seq > img->disk_seq) {
+        ret = write_image_json(job->id, job->json);
+        if (ret == 0) {
+            img->disk_seq = job->seq;
+        }
+    }
+    (void)pthread_mutex_unlock(&img->save_mutex);
+
+    image_ref_dec(img);
+    job->img = NULL;
+    free(job->id);
+    job->id = NULL;
+    free(job->json);
+    job->json = NULL;
+    return ret;
+}
+
 static int remove_name(image_t *img, const char *name)
 {
     size_t i;
@@ -567,6 +642,49 @@ static int remove_image_from_digest_index(image_t *image, const char *digest)
     return 0;
 }
 
+static int add_image_to_top_layer_index(const char *layer)
+{
+    int *images = NULL;
+    int one = 1;
+
+    if (layer == NULL) {
+        return 0;
+    }
+
+    images = map_search(g_image_store->bytoplayer, (void *)layer);
+    if (images != NULL) {
+        (*images)++;
+        return 0;
+    }
+
+    if (!map_insert(g_image_store->bytoplayer, (void *)layer, (void *)&one)) {
+        ERROR("Failed to insert image to top layer index");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void remove_image_from_top_layer_index(const char *layer)
+{
+    int *images = NULL;
+
+    if (layer == NULL) {
+        return;
+    }
+
+    images = map_search(g_image_store->bytoplayer, (void *)layer);
+    if (images == NULL) {
+        WARN("No image recorded with top layer %s", layer);
+        return;
+    }
+
+    (*images)--;
+    if (*images <= 0 && !map_remove(g_image_store->bytoplayer, (void *)layer)) {
+        WARN("Failed to remove layer %s from top layer index", layer);
+    }
+}
+
 static int remove_image_from_memory(const char *id)
 {
     struct linked_list *item = NULL;
@@ -588,6 +706,7 @@ static int remove_image_from_memory(const char *id)
         ret = -1;
         goto out;
     }
+    remove_image_from_top_layer_index(img->simage->layer);
 
     for (i = 0; i < img->simage->names_len; i++) {
         if (!map_remove(g_image_store->byname, (void *)img->simage->names[i])) {
@@ -664,7 +783,12 @@ static int do_delete_image_info(const char *id)
         goto out;
     }
 
-    if (remove_image_dir(img->simage->id) != 0) {
+    // pending saves of the image must not bring its directory back
+    (void)pthread_mutex_lock(&img->save_mutex);
+    img->removed = true;
+    ret = remove_image_dir(img->simage->id);
+    (void)pthread_mutex_unlock(&img->save_mutex);
+    if (ret != 0) {
         ERROR("Failed to delete image directory");
         ret = -1;
         goto out;
@@ -802,6 +926,11 @@ static int image_store_append_image(const char *id, const char *searchable_diges
         }
     }
 
+    if (add_image_to_top_layer_index(img->simage->layer) != 0) {
+        ret = -1;
+        goto err_out;
+    }
+
     return 0;
 
 err_out:
@@ -837,7 +966,9 @@ char *image_store_create(const char *id, const char **names, size_t names_len, c
     char **unique_names = NULL;
     size_t unique_names_len = 0;
     image_t *img = NULL;
+    image_t *created = NULL;
     storage_image *im = NULL;
+    image_save_job_t job = { 0 };
 
     if (g_image_store == NULL) {
         ERROR("Image store is not ready");
@@ -894,7 +1025,7 @@ char *image_store_create(const char *id, const char **names, size_t names_len, c
         goto out;
     }
 
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to save image");
         if (do_delete_image_info(dst_id) != 0) {
             ERROR("Failed to delete image info");
@@ -905,6 +1036,10 @@ char *image_store_create(const char *id, const char **names, size_t names_len, c
         goto out;
     }
 
+    // keep the image alive until the save is done, so the rollback below can tell it is still this one
+    image_ref_inc(img);
+    created = img;
+
 out:
     if (ret != 0) {
         free(dst_id);
@@ -916,6 +1051,23 @@ out:
     }
     util_free_array_by_len(unique_names, unique_names_len);
     image_store_unlock();
+
+    if (ret == 0 && commit_image_save(&job) != 0) {
+        ERROR("Failed to save image");
+        if (!image_store_lock(EXCLUSIVE)) {
+            ERROR("Failed to lock image store with exclusive lock, not allowed to delete image info");
+        } else {
+            // the id may have been deleted and created again while the store was unlocked,
+            // only roll back the image created here
+            if (map_search(g_image_store->byid, (void *)dst_id) == created && do_delete_image_info(dst_id) != 0) {
+                ERROR("Failed to delete image info");
+            }
+            image_store_unlock();
+        }
+        free(dst_id);
+        dst_id = NULL;
+    }
+    image_ref_dec(created);
     return dst_id;
 }
 
@@ -1171,14 +1323,53 @@ out:
     return ret;
 }
 
-int image_store_set_big_data(const char *id, const char *key, const char *data)
+static int write_image_big_data(image_t *img, const char *image_id, const char *key, const char *data)
 {
     int ret = 0;
-    image_t *img = NULL;
-    const char *image_id = NULL;
     char image_dir[PATH_MAX] = { 0x00 };
     char big_data_file[PATH_MAX] = { 0x00 };
+
+    if (get_data_dir(image_id, image_dir, sizeof(image_dir)) != 0) {
+        ERROR("Failed to get image data dir: %s", image_id);
+        return -1;
+    }
+
+    if (get_data_path(image_id, key, big_data_file, sizeof(big_data_file)) != 0) {
+        ERROR("Failed to get big data file path: %s.", key);
+        return -1;
+    }
+
+    (void)pthread_mutex_lock(&img->save_mutex);
+    if (img->removed) {
+        ERROR("Image %s is removed", image_id);
+        ret = -1;
+        goto out;
+    }
+
+    if (util_mkdir_p(image_dir, IMAGE_STORE_PATH_MODE) < 0) {
+        ERROR("Unable to create directory %s.", image_dir);
+        ret = -1;
+        goto out;
+    }
+
+    if (util_atomic_write_file(big_data_file, data, strlen(data), SECURE_CONFIG_FILE_MODE, true) != 0) {
+        ERROR("Failed to save big data file: %s", big_data_file);
+        ret = -1;
+        goto out;
+    }
+
+out:
+    (void)pthread_mutex_unlock(&img->save_mutex);
+    return ret;
+}
+
+int image_store_set_big_data(const char *id, const char *key, const char *data)
+{
+    int ret = 0;
+    image_t *img = NULL;
+    char *image_id = NULL;
     bool save = false;
+    image_save_job_t job = { 0 };
 
     if (key == NULL || strlen(key) == 0) {
         ERROR("Not a valid name for a big data item, can't set empty name for image big data item");
@@ -1195,64 +1386,68 @@ int image_store_set_big_data(const char *id, const char *key, const char *data)
         return -1;
     }
 
-    if (!image_store_lock(EXCLUSIVE)) {
-        ERROR("Failed to lock image store with exclusive lock, not allowed to change image big data assignments");
-        ret = -1;
-        goto out;
+    if (!image_store_lock(SHARED)) {
+        ERROR("Failed to lock image store with shared lock, not allowed to change image big data assignments");
+        return -1;
     }
-
     img = lookup(id);
-    if (img == NULL) {
-        ERROR("Failed to lookup image from store");
-        ret = -1;
-        goto out;
+    if (img != NULL) {
+        image_id = util_strdup_s(img->simage->id);
     }
-    image_id = img->simage->id;
+    image_store_unlock();
 
-    if (get_data_dir(image_id, image_dir, sizeof(image_dir)) != 0) {
-        ERROR("Failed to get image data dir: %s", id);
-        ret = -1;
-        goto out;
+    if (img == NULL) {
+        ERROR("Failed to lookup image from store");
+        return -1;
     }
 
-    ret = util_mkdir_p(image_dir, IMAGE_STORE_PATH_MODE);
-    if (ret < 0) {
-        ERROR("Unable to create directory %s.", image_dir);
+    // the big data file is written out of the store lock, only the image itself is held up. Setters of
+    // the same image go one by one, the digest in memory is always the one of the file on disk
+    (void)pthread_mutex_lock(&img->big_data_mutex);
+    if (write_image_big_data(img, image_id, key, data) != 0) {
         ret = -1;
         goto out;
     }
 
-    if (get_data_path(image_id, key, big_data_file, sizeof(big_data_file)) != 0) {
-        ERROR("Failed to get big data file path: %s.", key);
+    if (!image_store_lock(EXCLUSIVE)) {
+        ERROR("Failed to lock image store with exclusive lock, not allowed to change image big data assignments");
         ret = -1;
         goto out;
     }
 
-    if (util_atomic_write_file(big_data_file, data, strlen(data), SECURE_CONFIG_FILE_MODE, true) != 0) {
-        ERROR("Failed to save big data file: %s", big_data_file);
+    if (img->removed) {
+        ERROR("Image %s is removed", image_id);
         ret = -1;
-        goto out;
+        goto unlock_out;
     }
 
     if (update_image_with_big_data(img, key, data, &save) != 0) {
         ERROR("Failed to update image big data");
         ret = -1;
-        goto out;
+        goto unlock_out;
     }
 
     if (img->spec == NULL) {
         (void)try_fill_image_spec(img, image_id, g_image_store->dir);
     }
 
-    if (save && save_image(img->simage) != 0) {
+    if (save && prepare_image_save(img, &job) != 0) {
+        ERROR("Failed to complete persistence to disk");
+        ret = -1;
+        goto unlock_out;
+    }
+
+unlock_out:
+    image_store_unlock();
+    if (commit_image_save(&job) != 0) {
         ERROR("Failed to complete persistence to disk");
         ret = -1;
-        goto out;
     }
 
 out:
+    (void)pthread_mutex_unlock(&img->big_data_mutex);
     image_ref_dec(img);
-    image_store_unlock();
+    free(image_id);
     return ret;
 }
 
@@ -1290,6 +1485,9 @@ int image_store_add_name(const char *id, const char *name)
     char **unique_names = NULL;
     size_t unique_names_len = 0;
     size_t i;
+    image_save_job_t job = { 0 };
+    image_save_job_t *other_jobs = NULL;
+    size_t other_jobs_len = 0;
 
     if (id == NULL || name == NULL) {
         ERROR("Invalid input paratemer");
@@ -1331,6 +1529,13 @@ int image_store_add_name(const char *id, const char *name)
         goto out;
     }
 
+    other_jobs = util_smart_calloc_s(sizeof(image_save_job_t), unique_names_len);
+    if (other_jobs == NULL) {
+        ERROR("Out of memory");
+        ret = -1;
+        goto out;
+    }
+
     for (i = 0; i < img->simage->names_len; i++) {
         if (!map_remove(g_image_store->byname, (void *)names[i])) {
             ERROR("Failed to remove image from names index in image store");
@@ -1347,11 +1552,12 @@ int image_store_add_name(const char *id, const char *name)
                 ret = -1;
                 goto out;
             }
-            if (save_image(other_image->simage) != 0) {
+            if (prepare_image_save(other_image, &other_jobs[other_jobs_len]) != 0) {
                 ERROR("Failed to save other image");
                 ret = -1;
                 goto out;
             }
+            other_jobs_len++;
         }
 
         if (!map_replace(g_image_store->byname, unique_names[i], (void *)img)) {
@@ -1368,7 +1574,7 @@ int image_store_add_name(const char *id, const char *name)
     unique_names = NULL;
     unique_names_len = 0;
 
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to update image");
         ret = -1;
         goto out;
@@ -1379,6 +1585,17 @@ out:
     util_free_array_by_len(unique_names, unique_names_len);
     image_ref_dec(img);
     image_store_unlock();
+    for (i = 0; i < other_jobs_len; i++) {
+        if (commit_image_save(&other_jobs[i]) != 0) {
+            ERROR("Failed to save other image");
+            ret = -1;
+        }
+    }
+    free(other_jobs);
+    if (commit_image_save(&job) != 0) {
+        ERROR("Failed to update image");
+        ret = -1;
+    }
     return ret;
 }
 
@@ -1386,6 +1603,7 @@ int image_store_set_names(const char *id, const char **names, size_t names_len)
 {
     int ret = 0;
     image_t *img = NULL;
+    image_save_job_t job = { 0 };
     image_t *other_image = NULL;
     char **unique_names = NULL;
     size_t unique_names_len = 0;
@@ -1452,7 +1670,7 @@ int image_store_set_names(const char *id, const char **names, size_t names_len)
     unique_names = NULL;
     unique_names_len = 0;
 
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to update image");
         ret = -1;
         goto out;
@@ -1462,6 +1680,10 @@ out:
     util_free_array_by_len(unique_names, unique_names_len);
     image_ref_dec(img);
     image_store_unlock();
+    if (commit_image_save(&job) != 0) {
+        ERROR("Failed to save image");
+        ret = -1;
+    }
     return ret;
 }
 
@@ -1518,6 +1740,7 @@ int image_store_set_metadata(const char *id, const char *metadata)
 {
     int ret = 0;
     image_t *img = NULL;
+    image_save_job_t job = { 0 };
 
     if (id == NULL || metadata == NULL) {
         ERROR("Invalid paratemer");
@@ -1543,7 +1766,7 @@ int image_store_set_metadata(const char *id, const char *metadata)
 
     free(img->simage->metadata);
     img->simage->metadata = util_strdup_s(metadata);
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to save image");
         ret = -1;
         goto out;
@@ -1552,6 +1775,10 @@ int image_store_set_metadata(const char *id, const char *metadata)
 out:
     image_ref_dec(img);
     image_store_unlock();
+    if (commit_image_save(&job) != 0) {
+        ERROR("Failed to save image");
+        ret = -1;
+    }
     return ret;
 }
 
@@ -1559,6 +1786,7 @@ int image_store_set_load_time(const char *id, const types_timestamp_t *time)
 {
     int ret = 0;
     image_t *img = NULL;
+    image_save_job_t job = { 0 };
     char timebuffer[TIME_STR_SIZE] = { 0x00 };
 
     if (id == NULL || time == NULL) {
@@ -1591,7 +1819,7 @@ int image_store_set_load_time(const char *id, const types_timestamp_t *time)
 
     free(img->simage->loaded);
     img->simage->loaded = util_strdup_s(timebuffer);
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to save image");
         ret = -1;
     }
@@ -1599,6 +1827,10 @@ int image_store_set_load_time(const char *id, const types_timestamp_t *time)
 out:
     image_ref_dec(img);
     image_store_unlock();
+    if (commit_image_save(&job) != 0) {
+        ERROR("Failed to save image");
+        ret = -1;
+    }
     return ret;
 }
 
@@ -1927,6 +2159,32 @@ out:
     return metadata;
 }
 
+bool image_store_is_top_layer(const char *layer_id)
+{
+    bool ret = false;
+
+    if (layer_id == NULL) {
+        ERROR("Invalid parameter, layer id is NULL");
+        return false;
+    }
+
+    if (g_image_store == NULL) {
+        ERROR("Image store is not ready");
+        return false;
+    }
+
+    if (!image_store_lock(SHARED)) {
+        ERROR("Failed to lock image store with shared lock, not allowed to get top layer index");
+        // be conservative, a layer which may be in use must not be deleted
+        return true;
+    }
+
+    ret = map_search(g_image_store->bytoplayer, (void *)layer_id) != NULL;
+
+    image_store_unlock();
+    return ret;
+}
+
 char *image_store_top_layer(const char *id)
 {
     image_t *img = NULL;
@@ -1965,6 +2223,7 @@ int image_store_set_image_size(const char *id, uint64_t size)
 {
     int ret = 0;
     image_t *img = NULL;
+    image_save_job_t job = { 0 };
 
     if (id == NULL) {
         ERROR("Invalid parameter, id is NULL");
@@ -1989,7 +2248,7 @@ int image_store_set_image_size(const char *id, uint64_t size)
     }
 
     img->simage->size = size;
-    if (save_image(img->simage) != 0) {
+    if (prepare_image_save(img, &job) != 0) {
         ERROR("Failed to save image");
         ret = -1;
         goto out;
@@ -1998,6 +2257,10 @@ int image_store_set_image_size(const char *id, uint64_t size)
 out:
     image_ref_dec(img);
     image_store_unlock();
+    if (commit_image_save(&job) != 0) {
+        ERROR("Failed to save image");
+        ret = -1;
+    }
     return ret;
 }
 
@@ -2694,8 +2957,8 @@ int image_store_get_all_images(imagetool_images_list *images_list)
         return -1;
     }
 
-    if (!image_store_lock(EXCLUSIVE)) {
-        ERROR("Failed to lock image store with exclusive lock, not allowed to get all the known images");
+    if (!image_store_lock(SHARED)) {
+        ERROR("Failed to lock image store with shared lock, not allowed to get all the known images");
         return -1;
     }
 
@@ -2866,13 +3129,19 @@ static int load_image_to_store_field(image_t *img)
 {
     int ret = 0;
     bool should_save = false;
+    bool reloaded = false;
     size_t i;
 
+    reloaded = map_search(g_image_store->byid, (void *)img->simage->id) != NULL;
     if (!map_replace(g_image_store->byid, (void *)img->simage->id, (void *)img)) {
         ERROR("Failed to insert image to ids");
         return -1;
     }
 
+    if (!reloaded && add_image_to_top_layer_index(img->simage->layer) != 0) {
+        return -1;
+    }
+
     for (i = 0; i < img->simage->names_len; i++) {
         image_t *conflict_image = (image_t *)map_search(g_image_store->byname, (void *)img->simage->names[i]);
         if (conflict_image != NULL) {
@@ -3674,6 +3943,13 @@ int image_store_init(struct storage_module_init_options *opts)
         goto out;
     }
 
+    g_image_store->bytoplayer = map_new(MAP_STR_INT, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    if (g_image_store->bytoplayer == NULL) {
+        ERROR("Out of memory");
+        ret = -1;
+        goto out;
+    }
+
     ret = image_store_load();
     if (ret != 0) {
         ERROR("Failed to load image store");
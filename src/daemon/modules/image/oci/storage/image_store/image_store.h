@@ -89,6 +89,9 @@ char *image_store_metadata(const char *id);
 // Reads top layer associated with an item with the specified ID.
 char *image_store_top_layer(const char *id);
 
+// Check if any image uses the layer as its top layer.
+bool image_store_is_top_layer(const char *layer_id);
+
 // Updates the image size associated with the item with the specified ID.
 int image_store_set_image_size(const char *id, uint64_t size);
 
@@ -33,15 +33,23 @@ static image_t *create_empty_image()
     result = (image_t *)util_smart_calloc_s(sizeof(image_t), 1);
     if (result == NULL) {
         ERROR("Out of memory");
-        goto err_out;
+        return NULL;
+    }
+
+    if (pthread_mutex_init(&result->save_mutex, NULL) != 0) {
+        ERROR("Failed to init image save mutex");
+        free(result);
+        return NULL;
+    }
+    if (pthread_mutex_init(&result->big_data_mutex, NULL) != 0) {
+        ERROR("Failed to init image big data mutex");
+        pthread_mutex_destroy(&result->save_mutex);
+        free(result);
+        return NULL;
     }
     atomic_int_set(&result->refcnt, 1);
 
     return result;
-
-err_out:
-    free_image_t(result);
-    return NULL;
 }
 
 int try_fill_image_spec(image_t *img, const char *id, const char *image_store_dir)
@@ -148,6 +156,8 @@ void free_image_t(image_t *ptr)
     ptr->simage = NULL;
     free_oci_image_spec(ptr->spec);
     ptr->spec = NULL;
+    pthread_mutex_destroy(&ptr->save_mutex);
+    pthread_mutex_destroy(&ptr->big_data_mutex);
 
     free(ptr);
 }
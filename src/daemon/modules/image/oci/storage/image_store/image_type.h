@@ -31,6 +31,17 @@ typedef struct _image_t_ {
     storage_image *simage;
     oci_image_spec *spec;
     uint64_t refcnt;
+    // generation of the image json, bumped under the exclusive store lock
+    uint64_t save_seq;
+    // guards the files of the image and the fields below, taken alone or inside the store lock
+    pthread_mutex_t save_mutex;
+    // generation of the image json on disk
+    uint64_t disk_seq;
+    // set with the exclusive store lock held as well, so it can be read under either lock
+    bool removed;
+    // serializes the big data setters of the image, so the big data files and their digests in memory
+    // are updated in the same order, taken before the store lock and save_mutex
+    pthread_mutex_t big_data_mutex;
 } image_t;
 
 int try_fill_image_spec(image_t *img, const char *id, const char *image_store_dir);
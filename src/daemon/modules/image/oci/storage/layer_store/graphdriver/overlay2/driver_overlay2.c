@@ -25,6 +25,7 @@
 #include <errno.h>
 #include <stdio.h>
 #include <strings.h>
+#include <pthread.h>
 
 #include "isula_libutils/log.h"
 #ifdef ENABLE_USERNS_REMAP
@@ -46,6 +47,7 @@
 #include "selinux_label.h"
 #include "err_msg.h"
 #include "isulad_config.h"
+#include "map.h"
 #ifdef ENABLE_REMOTE_LAYER_STORE
 #include "ro_symlink_maintain.h"
 #endif
@@ -70,6 +72,19 @@ struct io_read_wrapper;
 // ((idLength + len(linkDir) + 1) * maxDepth) <= (pageSize - 512)
 #define MAX_LAYER_ID_LENGTH 26
 
+struct lower_dir_cache_entry {
+    char *abs_lower_dir;
+    char *rel_lower_dir;
+};
+
+/*
+ * lower dirs of the layers mounted before, keyed by layer dir. Building them reads the lower
+ * file and stats every lower layer, which is the same for every mount of the layer until its
+ * lower file is rewritten or the layer is removed.
+ */
+static map_t *g_lower_dir_cache = NULL; // map string lower_dir_cache_entry
+static pthread_mutex_t g_lower_dir_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
 void free_driver_create_opts(struct driver_create_opts *opts)
 {
     if (opts == NULL) {
@@ -745,6 +760,122 @@ out:
     return lower;
 }
 
+static void lower_dir_cache_kvfree(void *key, void *value)
+{
+    struct lower_dir_cache_entry *entry = (struct lower_dir_cache_entry *)value;
+
+    free(key);
+    if (entry == NULL) {
+        return;
+    }
+    free(entry->abs_lower_dir);
+    free(entry->rel_lower_dir);
+    free(entry);
+}
+
+static void lower_dir_cache_invalidate(const char *layer_dir)
+{
+    (void)pthread_mutex_lock(&g_lower_dir_cache_lock);
+    if (g_lower_dir_cache != NULL) {
+        (void)map_remove(g_lower_dir_cache, (void *)layer_dir);
+    }
+    (void)pthread_mutex_unlock(&g_lower_dir_cache_lock);
+}
+
+static bool abs_lower_dirs_exist(const char *abs_lower_dir)
+{
+    bool exist = true;
+    char **abs_lowers = NULL;
+    size_t i;
+
+    abs_lowers = util_string_split(abs_lower_dir, ':');
+    if (abs_lowers == NULL) {
+        return false;
+    }
+
+    for (i = 0; abs_lowers[i] != NULL; i++) {
+        if (!util_dir_exists(abs_lowers[i])) {
+            WARN("Cached lower layer %s not exists", abs_lowers[i]);
+            exist = false;
+            break;
+        }
+    }
+
+    util_free_array(abs_lowers);
+    return exist;
+}
+
+static bool lower_dir_cache_get(const char *layer_dir, char **abs_lower_dir, char **rel_lower_dir)
+{
+    bool found = false;
+    struct lower_dir_cache_entry *entry = NULL;
+
+    (void)pthread_mutex_lock(&g_lower_dir_cache_lock);
+    if (g_lower_dir_cache != NULL) {
+        entry = map_search(g_lower_dir_cache, (void *)layer_dir);
+    }
+    if (entry != NULL) {
+        *abs_lower_dir = util_strdup_s(entry->abs_lower_dir);
+        *rel_lower_dir = util_strdup_s(entry->rel_lower_dir);
+        found = true;
+    }
+    (void)pthread_mutex_unlock(&g_lower_dir_cache_lock);
+
+    if (!found) {
+        return false;
+    }
+
+    // a lower layer may be removed behind the cache, stat them as building the lower dirs does
+    if (!abs_lower_dirs_exist(*abs_lower_dir)) {
+        lower_dir_cache_invalidate(layer_dir);
+        free(*abs_lower_dir);
+        *abs_lower_dir = NULL;
+        free(*rel_lower_dir);
+        *rel_lower_dir = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+static void lower_dir_cache_put(const char *layer_dir, const char *abs_lower_dir, const char *rel_lower_dir)
+{
+    struct lower_dir_cache_entry *entry = NULL;
+
+    entry = util_common_calloc_s(sizeof(struct lower_dir_cache_entry));
+    if (entry == NULL) {
+        ERROR("Out of memory");
+        return;
+    }
+    entry->abs_lower_dir = util_strdup_s(abs_lower_dir);
+    entry->rel_lower_dir = util_strdup_s(rel_lower_dir);
+
+    (void)pthread_mutex_lock(&g_lower_dir_cache_lock);
+    if (g_lower_dir_cache == NULL) {
+        g_lower_dir_cache = map_new(MAP_STR_PTR, MAP_DEFAULT_CMP_FUNC, lower_dir_cache_kvfree);
+    }
+    if (g_lower_dir_cache == NULL || !map_replace(g_lower_dir_cache, (void *)layer_dir, (void *)entry)) {
+        WARN("Failed to cache lower dirs of %s", layer_dir);
+        lower_dir_cache_kvfree(NULL, entry);
+    }
+    (void)pthread_mutex_unlock(&g_lower_dir_cache_lock);
+}
+
+bool overlay2_lower_dir_cached(const char *layer_dir)
+{
+    bool cached = false;
+
+    if (layer_dir == NULL) {
+        return false;
+    }
+
+    (void)pthread_mutex_lock(&g_lower_dir_cache_lock);
+    cached = g_lower_dir_cache != NULL && map_search(g_lower_dir_cache, (void *)layer_dir) != NULL;
+    (void)pthread_mutex_unlock(&g_lower_dir_cache_lock);
+
+    return cached;
+}
+
 static int write_lowers(const char *layer_dir, const char *lowers)
 {
     int ret = 0;
@@ -757,6 +888,8 @@ static int write_lowers(const char *layer_dir, const char *lowers)
         goto out;
     }
 
+    lower_dir_cache_invalidate(layer_dir);
+
     ret = util_atomic_write_file(lowers_file, lowers, strlen(lowers), 0666, false);
     if (ret) {
         SYSERROR("Failed to write %s", lowers_file);
@@ -1163,6 +1296,8 @@ int overlay2_rm_layer(const char *id, const struct graphdriver *driver)
         goto out;
     }
 
+    lower_dir_cache_invalidate(layer_dir);
+
     link_id = read_layer_link_file(layer_dir);
     if (link_id != NULL) {
         nret = snprintf(link_path, PATH_MAX, "%s/%s/%s", driver->home, OVERLAY_LINK_DIR, link_id);
@@ -1295,6 +1430,10 @@ static int get_mount_opt_lower_dir(const char *id, const char *layer_dir, const
     size_t lowers_size = 0;
     size_t i = 0;
 
+    if (lower_dir_cache_get(layer_dir, abs_lower_dir, rel_lower_dir)) {
+        return 0;
+    }
+
     lowers_str = read_layer_lower_file(layer_dir);
     lowers = util_string_split(lowers_str, ':');
     lowers_size = util_array_len((const char **)lowers);
@@ -1336,6 +1475,8 @@ static int get_mount_opt_lower_dir(const char *id, const char *layer_dir, const
         goto out;
     }
 
+    lower_dir_cache_put(layer_dir, *abs_lower_dir, *rel_lower_dir);
+
 out:
     free(lowers_str);
     util_free_array(lowers);
@@ -1704,6 +1845,8 @@ static char *do_mount_layer(const char *id, const char *layer_dir, const struct
     goto out;
 
 error_out:
+    // the cached lower dirs may be the reason of the failure, build them again for the next mount
+    lower_dir_cache_invalidate(layer_dir);
     free(merged_dir);
     merged_dir = NULL;
 
@@ -2120,6 +2263,12 @@ int overlay2_clean_up(struct graphdriver *driver)
         goto out;
     }
 
+    // drop the cache even if the umount fails, the layers are not mounted by this driver any more
+    (void)pthread_mutex_lock(&g_lower_dir_cache_lock);
+    map_free(g_lower_dir_cache);
+    g_lower_dir_cache = NULL;
+    (void)pthread_mutex_unlock(&g_lower_dir_cache_lock);
+
     if (umount(driver->home) != 0) {
         ret = -1;
         goto out;
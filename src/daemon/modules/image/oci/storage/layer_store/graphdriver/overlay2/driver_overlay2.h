@@ -62,6 +62,9 @@ int overlay2_repair_lowers(const char *id, const char *parent, const struct grap
 
 int overlay2_get_layer_fs_info(const char *id, const struct graphdriver *driver, imagetool_fs_info *fs_info);
 
+// whether the lower dirs of the layer dir are cached by a previous mount
+bool overlay2_lower_dir_cached(const char *layer_dir);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,7 +25,6 @@
 #include <isula_libutils/json_common.h>
 #include <isula_libutils/log.h>
 #include <isula_libutils/storage_entry.h>
-#include <isula_libutils/go_crc64.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,6 +40,8 @@
 #include "utils.h"
 #include "utils_array.h"
 #include "utils_file.h"
+#include "utils_crc64.h"
+#include "utils_thread_pool.h"
 #include "util_gzip.h"
 #include "http.h"
 #include "utils_base64.h"
@@ -58,8 +59,14 @@ typedef struct __layer_store_metadata_t {
     map_t *by_name;
     map_t *by_compress_digest;
     map_t *by_uncompress_digest;
+    // number of layers using the key as parent
+    map_t *by_parent;
     struct linked_list layers_list;
     size_t layers_list_len;
+    // ids of layers being created outside of rwlock, guarded by staging_mutex
+    map_t *staging;
+    pthread_mutex_t staging_mutex;
+    pthread_cond_t staging_cond;
 } layer_store_metadata;
 
 typedef struct digest_layer {
@@ -130,6 +137,10 @@ void layer_store_cleanup(void)
     g_metadata.by_compress_digest = NULL;
     map_free(g_metadata.by_uncompress_digest);
     g_metadata.by_uncompress_digest = NULL;
+    map_free(g_metadata.by_parent);
+    g_metadata.by_parent = NULL;
+    map_free(g_metadata.staging);
+    g_metadata.staging = NULL;
 
     linked_list_for_each_safe(item, &(g_metadata.layers_list), next) {
         linked_list_del(item);
@@ -140,6 +151,8 @@ void layer_store_cleanup(void)
     g_metadata.layers_list_len = 0;
 
     pthread_rwlock_destroy(&(g_metadata.rwlock));
+    pthread_mutex_destroy(&(g_metadata.staging_mutex));
+    pthread_cond_destroy(&(g_metadata.staging_cond));
 
     free(g_run_dir);
     g_run_dir = NULL;
@@ -695,6 +708,49 @@ free_out:
     return -1;
 }
 
+static int add_child_of_parent(const char *parent)
+{
+    int *children = NULL;
+    int one = 1;
+
+    if (parent == NULL) {
+        return 0;
+    }
+
+    children = map_search(g_metadata.by_parent, (void *)parent);
+    if (children != NULL) {
+        (*children)++;
+        return 0;
+    }
+
+    if (!map_insert(g_metadata.by_parent, (void *)parent, (void *)&one)) {
+        ERROR("Failed to record child of layer %s", parent);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void remove_child_of_parent(const char *parent)
+{
+    int *children = NULL;
+
+    if (parent == NULL) {
+        return;
+    }
+
+    children = map_search(g_metadata.by_parent, (void *)parent);
+    if (children == NULL) {
+        WARN("Layer %s has no child recorded", parent);
+        return;
+    }
+
+    (*children)--;
+    if (*children <= 0 && !map_remove(g_metadata.by_parent, (void *)parent)) {
+        WARN("Remove children of layer %s failed", parent);
+    }
+}
+
 static int remove_memory_stores(const char *id)
 {
     struct linked_list *item = NULL;
@@ -723,6 +779,7 @@ static int remove_memory_stores(const char *id)
     if (!map_remove(g_metadata.by_id, (void *)l->slayer->id)) {
         WARN("Remove by id: %s failed", id);
     }
+    remove_child_of_parent(l->slayer->parent);
 
     for (; i < l->slayer->names_len; i++) {
         if (!map_remove(g_metadata.by_name, (void *)l->slayer->names[i])) {
@@ -782,7 +839,16 @@ static int insert_memory_stores(const char *id, const struct layer_opts *opts, l
         }
     }
 
+    ret = add_child_of_parent(l->slayer->parent);
+    if (ret != 0) {
+        goto clear_uncompress_digest;
+    }
+
     goto out;
+clear_uncompress_digest:
+    if (l->slayer->diff_digest != NULL) {
+        (void)delete_digest_from_map(g_metadata.by_uncompress_digest, l->slayer->diff_digest, id);
+    }
 clear_compress_digest:
     if (l->slayer->compressed_diff_digest != NULL) {
         (void)delete_digest_from_map(g_metadata.by_compress_digest, l->slayer->compressed_diff_digest, id);
@@ -805,7 +871,8 @@ out:
     return ret;
 }
 
-static int make_tar_split_file(const char *lid, const struct io_read_wrapper *diff, int64_t *size)
+static int make_tar_split_file(const char *lid, const struct io_read_wrapper *diff, int64_t *size,
+                               struct archive_layer_digests *digests)
 {
     int *pfd = (int *)diff->context;
     char *save_fname = NULL;
@@ -831,8 +898,8 @@ static int make_tar_split_file(const char *lid, const struct io_read_wrapper *di
     tfd = -1;
 
     // step 2: build entry json;
-    // step 3: write into tar split;
-    ret = archive_copy_oci_tar_split_and_ret_size(*pfd, save_fname, size);
+    // step 3: write into tar split, and calculate digests of layer in the same pass;
+    ret = archive_copy_oci_tar_split_and_digest(*pfd, save_fname, size, digests);
     if (ret != 0) {
         goto out;
     }
@@ -857,10 +924,37 @@ out:
     return ret;
 }
 
-static int apply_diff(layer_t *l, const struct io_read_wrapper *diff)
+static int update_digests_after_apply(layer_t *l, const struct layer_opts *opts,
+                                      const struct archive_layer_digests *digests)
+{
+    if (opts->verify_uncompressed_digest && l->slayer->diff_digest != NULL &&
+        strcmp(l->slayer->diff_digest, digests->uncompressed_digest) != 0) {
+        ERROR("Invalid diff id for layer %s: expected %s, got %s", l->slayer->id, l->slayer->diff_digest,
+              digests->uncompressed_digest);
+        return -1;
+    }
+
+    // digest maps are updated by insert_memory_stores when the layer is published
+    if (l->slayer->diff_digest == NULL) {
+        l->slayer->diff_digest = util_strdup_s(digests->uncompressed_digest);
+    }
+
+    if (l->slayer->compressed_diff_digest == NULL) {
+        l->slayer->compressed_diff_digest = util_strdup_s(digests->compressed_digest);
+    }
+
+    if (strcmp(l->slayer->compressed_diff_digest, digests->compressed_digest) == 0) {
+        l->slayer->compressed_size = digests->compressed_size;
+    }
+
+    return 0;
+}
+
+static int apply_diff(layer_t *l, const struct layer_opts *opts, const struct io_read_wrapper *diff)
 {
     int64_t size = 0;
     int ret = 0;
+    struct archive_layer_digests digests = { 0 };
 
     if (diff == NULL) {
         return 0;
@@ -871,13 +965,19 @@ static int apply_diff(layer_t *l, const struct io_read_wrapper *diff)
         goto out;
     }
 
-    // uncompress digest get from up caller
-    ret = make_tar_split_file(l->slayer->id, diff, &size);
+    // uncompress digest get from up caller, or calculated when making tar split
+    ret = make_tar_split_file(l->slayer->id, diff, &size, &digests);
+    if (ret != 0) {
+        goto out;
+    }
 
     INFO("Apply layer get size: %ld", size);
     l->slayer->diff_size = size;
 
+    ret = update_digests_after_apply(l, opts, &digests);
+
 out:
+    free_archive_layer_digests(&digests);
     return ret;
 }
 
@@ -901,7 +1001,7 @@ static bool build_layer_dir(const char *id)
     return ret;
 }
 
-static int new_layer_by_opts(const char *id, const struct layer_opts *opts)
+static layer_t *new_layer_by_opts(const char *id, const struct layer_opts *opts)
 {
     int ret = 0;
     layer_t *l = NULL;
@@ -932,17 +1032,128 @@ static int new_layer_by_opts(const char *id, const struct layer_opts *opts)
 #endif
 
     ret = update_layer_datas(id, opts, l);
+
+out:
     if (ret != 0) {
-        goto out;
+        layer_ref_dec(l);
+        l = NULL;
+    }
+    return l;
+}
+
+/* wait for a concurrent creation of the same id, then own the id until release_staging_layer */
+static bool reserve_staging_layer(const char *id)
+{
+    bool staging = true;
+    bool ret = true;
+
+    if (pthread_mutex_lock(&g_metadata.staging_mutex) != 0) {
+        ERROR("Lock staging layers failed");
+        return false;
     }
 
-    // update memory store
-    ret = insert_memory_stores(id, opts, l);
+    while (map_search(g_metadata.staging, (void *)id) != NULL) {
+        if (pthread_cond_wait(&g_metadata.staging_cond, &g_metadata.staging_mutex) != 0) {
+            ERROR("Wait for staging layer %s failed", id);
+            ret = false;
+            goto out;
+        }
+    }
+
+    if (!map_insert(g_metadata.staging, (void *)id, (void *)&staging)) {
+        ERROR("Failed to reserve staging layer %s", id);
+        ret = false;
+    }
 
 out:
-    if (ret != 0) {
-        layer_ref_dec(l);
+    (void)pthread_mutex_unlock(&g_metadata.staging_mutex);
+    return ret;
+}
+
+#ifdef ENABLE_REMOTE_LAYER_STORE
+static bool is_staging_layer(const char *id)
+{
+    bool ret = false;
+
+    if (pthread_mutex_lock(&g_metadata.staging_mutex) != 0) {
+        ERROR("Lock staging layers failed");
+        // can not tell, leave the layer to its creator
+        return true;
+    }
+    ret = map_search(g_metadata.staging, (void *)id) != NULL;
+    (void)pthread_mutex_unlock(&g_metadata.staging_mutex);
+
+    return ret;
+}
+#endif
+
+static void release_staging_layer(const char *id)
+{
+    if (pthread_mutex_lock(&g_metadata.staging_mutex) != 0) {
+        ERROR("Lock staging layers failed");
+        return;
+    }
+
+    if (!map_remove(g_metadata.staging, (void *)id)) {
+        WARN("Remove staging layer %s failed", id);
+    }
+    (void)pthread_cond_broadcast(&g_metadata.staging_cond);
+    (void)pthread_mutex_unlock(&g_metadata.staging_mutex);
+}
+
+/* build the complete layer on disk, it is invisible to the store until published */
+static layer_t *stage_layer(const char *id, const struct layer_opts *opts, const struct io_read_wrapper *diff)
+{
+    layer_t *l = NULL;
+
+    l = new_layer_by_opts(id, opts);
+    if (l == NULL) {
+        return NULL;
+    }
+
+    l->slayer->incompelte = true;
+    if (save_layer(l) != 0) {
+        goto err_out;
+    }
+
+    if (apply_diff(l, opts, diff) != 0) {
+        goto err_out;
+    }
+    if (update_mount_point(l) != 0) {
+        goto err_out;
+    }
+
+    l->slayer->incompelte = false;
+    if (save_layer(l) != 0) {
+        ERROR("Save layer failed");
+        goto err_out;
+    }
+
+    return l;
+err_out:
+    layer_ref_dec(l);
+    return NULL;
+}
+
+/* the staged layer is owned by the memory stores after a successful publish */
+static int publish_layer(const char *id, const struct layer_opts *opts, layer_t *l)
+{
+    int ret = 0;
+
+    if (!layer_store_lock(true)) {
+        // the child recorded while staging must go with the layer, or the parent could never be deleted
+        remove_child_of_parent(opts->parent);
+        return -1;
+    }
+
+    ret = insert_memory_stores(id, opts, l);
+    if (ret == 0) {
+        l->hold_refs_num++; // increase refs number, so others can't delete this layer
     }
+    // drop the child recorded for parent while staging, insert_memory_stores has recorded its own
+    remove_child_of_parent(opts->parent);
+
+    layer_store_unlock();
     return ret;
 }
 
@@ -1020,7 +1231,7 @@ int layer_get_hold_refs(const char *layer_id, int *refs_num)
         return -1;
     }
 
-    if (!layer_store_lock(true)) {
+    if (!layer_store_lock(false)) {
         ERROR("Failed to lock layer store, get hold refs of layer %s failed", layer_id);
         return -1;
     }
@@ -1044,86 +1255,93 @@ int layer_store_create(const char *id, const struct layer_opts *opts, const stru
     int ret = 0;
     char *lid = NULL;
     layer_t *l = NULL;
+    bool reserved = false;
+    bool hold_parent = false;
 
     if (opts == NULL) {
         ERROR("Invalid argument");
         return -1;
     }
 
-    if (!layer_store_lock(true)) {
-        return -1;
+    lid = util_strdup_s(id);
+
+    // only one creation of the same layer may be staged at a time
+    if (lid != NULL) {
+        if (!reserve_staging_layer(lid)) {
+            free(lid);
+            return -1;
+        }
+        reserved = true;
     }
 
-    lid = util_strdup_s(id);
+    if (!layer_store_lock(true)) {
+        ret = -1;
+        goto free_out;
+    }
 
     // If the layer already exist, increase refs number to hold the layer is enough
     l = lookup(lid);
     if (l != NULL) {
         l->hold_refs_num++; // increase refs number, so others can't delete this layer
+        layer_store_unlock();
+        layer_ref_dec(l);
         goto free_out;
     }
 
-    // create layer by driver
-    ret = driver_create_layer(lid, opts->parent, opts->writable, opts->opts);
+    // keep the parent from being deleted while the layer is staged without the lock
+    ret = add_child_of_parent(opts->parent);
+    layer_store_unlock();
     if (ret != 0) {
         goto free_out;
     }
-    ret = new_layer_by_opts(lid, opts);
+    hold_parent = true;
+
+    // driver create, unpack and tar split are slow, do not block readers of the store with them
+    ret = driver_create_layer(lid, opts->parent, opts->writable, opts->opts);
     if (ret != 0) {
-        goto driver_remove;
+        goto free_out;
     }
 
-    l = lookup(lid);
+    l = stage_layer(lid, opts, diff);
     if (l == NULL) {
         ret = -1;
-        goto clear_memory;
-    }
-    l->slayer->incompelte = true;
-    if (save_layer(l) != 0) {
-        ret = -1;
-        goto clear_memory;
+        goto driver_remove;
     }
 
-    ret = apply_diff(l, diff);
+    ret = publish_layer(lid, opts, l);
+    // publish_layer drops the child of parent recorded while staging, whether it succeeds or not
+    hold_parent = false;
     if (ret != 0) {
-        goto clear_memory;
-    }
-    ret = update_mount_point(l);
-    if (ret != 0) {
-        goto clear_memory;
+        layer_ref_dec(l);
+        goto driver_remove;
     }
 
-    l->slayer->incompelte = false;
-
-    ret = save_layer(l);
-    if (ret == 0) {
-        DEBUG("create layer success");
-        if (new_id != NULL) {
-            *new_id = lid;
-            lid = NULL;
-        }
-        l->hold_refs_num++; // increase refs number, so others can't delete this layer
-        goto free_out;
+    DEBUG("create layer success");
+    if (new_id != NULL) {
+        *new_id = lid;
+        lid = NULL;
     }
-    ERROR("Save layer failed");
-clear_memory:
-    (void)remove_memory_stores(lid);
+    goto free_out;
+
 driver_remove:
-    if (ret != 0) {
-        (void)graphdriver_rm_layer(lid);
+    (void)graphdriver_rm_layer(lid);
 #ifdef ENABLE_REMOTE_LAYER_STORE
-        if (g_enable_remote_layer && !opts->writable) {
-            (void)remote_layer_remove_ro_dir(lid);
-        } else {
-            (void)layer_store_remove_layer(lid);
-        }
-#else
+    if (g_enable_remote_layer && !opts->writable) {
+        (void)remote_layer_remove_ro_dir(lid);
+    } else {
         (void)layer_store_remove_layer(lid);
-#endif
     }
+#else
+    (void)layer_store_remove_layer(lid);
+#endif
 free_out:
-    layer_store_unlock();
-    layer_ref_dec(l);
+    if (hold_parent && layer_store_lock(true)) {
+        remove_child_of_parent(opts->parent);
+        layer_store_unlock();
+    }
+    if (reserved) {
+        release_staging_layer(id);
+    }
     free(lid);
     return ret;
 }
@@ -1210,6 +1428,25 @@ free_out:
     return ret;
 }
 
+bool layer_store_has_children(const char *id)
+{
+    bool ret = false;
+
+    if (id == NULL) {
+        return false;
+    }
+
+    if (!layer_store_lock(false)) {
+        // be conservative, a layer which may have children must not be deleted
+        return true;
+    }
+
+    ret = map_search(g_metadata.by_parent, (void *)id) != NULL;
+
+    layer_store_unlock();
+    return ret;
+}
+
 int layer_store_delete(const char *id)
 {
     int ret = 0;
@@ -1667,6 +1904,11 @@ static int load_layers_from_json_files()
             goto unlock_out;
         }
 
+        if (add_child_of_parent(tl->slayer->parent) != 0) {
+            ret = -1;
+            goto unlock_out;
+        }
+
         for (; i < tl->slayer->names_len; i++) {
             if (remove_name(tl->slayer->names[i])) {
                 should_save = true;
@@ -1732,6 +1974,16 @@ int layer_store_init(const struct storage_module_init_options *conf)
         ERROR("Failed to init metadata rwlock");
         goto free_out;
     }
+    nret = pthread_mutex_init(&(g_metadata.staging_mutex), NULL);
+    if (nret != 0) {
+        ERROR("Failed to init staging mutex");
+        goto free_out;
+    }
+    nret = pthread_cond_init(&(g_metadata.staging_cond), NULL);
+    if (nret != 0) {
+        ERROR("Failed to init staging cond");
+        goto free_out;
+    }
     g_metadata.by_id = map_new(MAP_STR_PTR, MAP_DEFAULT_CMP_FUNC, layer_map_kvfree);
     if (g_metadata.by_id == NULL) {
         ERROR("Failed to new ids map");
@@ -1752,6 +2004,16 @@ int layer_store_init(const struct storage_module_init_options *conf)
         ERROR("Failed to new uncompress map");
         goto free_out;
     }
+    g_metadata.by_parent = map_new(MAP_STR_INT, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    if (g_metadata.by_parent == NULL) {
+        ERROR("Failed to new parent map");
+        goto free_out;
+    }
+    g_metadata.staging = map_new(MAP_STR_BOOL, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    if (g_metadata.staging == NULL) {
+        ERROR("Failed to new staging map");
+        goto free_out;
+    }
 
     // build root dir and run dir
     nret = util_mkdir_p(g_root_dir, IMAGE_STORE_PATH_MODE);
@@ -1814,62 +2076,7 @@ static uint64_t payload_to_crc(char *payload)
     return crc;
 }
 
-static int file_crc64(char *file, uint64_t *crc, uint64_t policy)
-{
-#define BLKSIZE 32768
-    int ret = 0;
-    const isula_crc_table_t *ctab = NULL;
-    int fd = 0;
-    void *buffer = NULL;
-    ssize_t size = 0;
-
-    fd = util_open(file, O_RDONLY, 0);
-    if (fd < 0) {
-        SYSERROR("Open file: %s, failed", file);
-        return -1;
-    }
-
-    ctab = new_isula_crc_table(policy);
-    if (ctab == NULL || !ctab->inited) {
-        ERROR("create crc table failed");
-        ret = -1;
-        goto out;
-    }
-
-    buffer = util_common_calloc_s(BLKSIZE);
-    if (buffer == NULL) {
-        ERROR("out of memory");
-        ret = -1;
-        goto out;
-    }
-
-    *crc = 0;
-    while (true) {
-        size = util_read_nointr(fd, buffer, BLKSIZE);
-        if (size < 0) {
-            SYSERROR("read file %s failed", file);
-            ret = -1;
-            break;
-        } else if (size == 0) {
-            break;
-        }
-
-        if (!isula_crc_update(ctab, crc, buffer, (size_t)size)) {
-            ERROR("crc update failed");
-            ret = -1;
-            break;
-        }
-    }
-
-out:
-
-    close(fd);
-    free(buffer);
-
-    return ret;
-}
-
-static int valid_crc64(storage_entry *entry, char *rootfs)
+static int valid_crc64(const storage_entry *entry, const char *rootfs)
 {
     int ret = 0;
     int nret = 0;
@@ -1904,7 +2111,7 @@ static int valid_crc64(storage_entry *entry, char *rootfs)
             goto out;
         }
 
-        ret = file_crc64(file, &crc, ISO_POLY);
+        ret = util_file_crc64_iso(file, &crc);
         if (ret != 0) {
             ERROR("calc crc of file %s failed", file);
             ret = -1;
@@ -2027,13 +2234,85 @@ out:
     return ret;
 }
 
-static int do_integration_check(layer_t *l, char *rootfs)
+struct integration_check_ctx {
+    pthread_mutex_t mutex;
+    const char *layer_id;
+    const char *rootfs;
+    // first failure of all files
+    int ret;
+};
+
+struct integration_check_task {
+    struct integration_check_ctx *ctx;
+    storage_entry *entry;
+};
+
+static void integration_check_task_cb(void *arg)
+{
+    struct integration_check_task *task = (struct integration_check_task *)arg;
+    struct integration_check_ctx *ctx = task->ctx;
+    bool failed = false;
+    int ret = 0;
+
+    (void)pthread_mutex_lock(&ctx->mutex);
+    failed = ctx->ret != 0;
+    (void)pthread_mutex_unlock(&ctx->mutex);
+
+    // layer is already invalid, no need to check other files
+    if (!failed) {
+        ret = valid_crc64(task->entry, ctx->rootfs);
+        if (ret != 0) {
+            ERROR("integration check failed, layer %s, file %s", ctx->layer_id, task->entry->name);
+            (void)pthread_mutex_lock(&ctx->mutex);
+            if (ctx->ret == 0) {
+                ctx->ret = ret;
+            }
+            (void)pthread_mutex_unlock(&ctx->mutex);
+        }
+    }
+
+    free_storage_entry(task->entry);
+    free(task);
+}
+
+static int submit_integration_check(thread_pool_t *pool, struct integration_check_ctx *ctx, tar_split *ts)
+{
+    struct integration_check_task *task = NULL;
+
+    task = util_common_calloc_s(sizeof(struct integration_check_task));
+    if (task == NULL) {
+        ERROR("Out of memory");
+        return -1;
+    }
+
+    // take over the entry, tar split will parse next entry into a new one
+    task->ctx = ctx;
+    task->entry = ts->entry;
+    ts->entry = NULL;
+
+    if (util_thread_pool_submit(pool, integration_check_task_cb, task) != 0) {
+        ERROR("submit integration check failed, layer %s, file %s", ctx->layer_id, task->entry->name);
+        free_storage_entry(task->entry);
+        free(task);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int do_integration_check(layer_t *l, char *rootfs, thread_pool_t *workers)
 {
 #define STORAGE_ENTRY_TYPE_CRC 1
     int ret = 0;
     tar_split *ts = NULL;
     storage_entry *entry = NULL;
     char *tspath = NULL;
+    struct integration_check_ctx ctx = {
+        .mutex = PTHREAD_MUTEX_INITIALIZER,
+        .layer_id = l->slayer->id,
+        .rootfs = rootfs,
+        .ret = 0,
+    };
 
     tspath = tar_split_path(l->slayer->id);
     if (tspath == NULL) {
@@ -2059,10 +2338,10 @@ static int do_integration_check(layer_t *l, char *rootfs)
         goto out;
     }
     while (entry != NULL) {
+        // files are independent, check them in parallel
         if (entry->type == STORAGE_ENTRY_TYPE_CRC) {
-            ret = valid_crc64(entry, rootfs);
+            ret = submit_integration_check(workers, &ctx, ts);
             if (ret != 0) {
-                ERROR("integration check failed, layer %s, file %s", l->slayer->id, entry->name);
                 goto out;
             }
         }
@@ -2075,25 +2354,38 @@ static int do_integration_check(layer_t *l, char *rootfs)
     }
 
 out:
+    // ctx lives on this stack, wait for the files of this layer submitted so far
+    util_thread_pool_wait(workers);
+    if (ret == 0) {
+        ret = ctx.ret;
+    }
     free(tspath);
     free_tar_split(ts);
 
     return ret;
 }
 
+thread_pool_t *layer_store_new_check_workers(void)
+{
+#define INTEGRATION_CHECK_MAX_THREADS 8
+#define INTEGRATION_CHECK_MAX_PENDING 256
+    return util_thread_pool_new(util_thread_pool_default_size(INTEGRATION_CHECK_MAX_THREADS),
+                                INTEGRATION_CHECK_MAX_PENDING, "LayerCheck");
+}
+
 /*
  * return value:
  *   <0: operator failed
  *    0: valid layer
  *   >0: invalid layer
  * */
-int layer_store_check(const char *id)
+int layer_store_check(const char *id, thread_pool_t *workers)
 {
     int ret = 0;
     char *rootfs = NULL;
 
-    if (id == NULL) {
-        ERROR("Failed to do layer store check for Empty id");
+    if (id == NULL || workers == NULL) {
+        ERROR("Failed to do layer store check for Empty id or workers");
         return -1;
     }
 
@@ -2115,7 +2407,7 @@ int layer_store_check(const char *id)
         goto out;
     }
 
-    ret = do_integration_check(l, rootfs);
+    ret = do_integration_check(l, rootfs, workers);
     if (ret != 0) {
         goto out;
     }
@@ -2237,18 +2529,36 @@ int remote_load_one_layer(const char *id)
         goto unlock_out;
     }
 
+    // a layer created by this isulad is published by layer_store_create itself
+    if (is_staging_layer(id)) {
+        DEBUG("remote layer is being created, not added: %s", id);
+        goto unlock_out;
+    }
+
     tl = load_one_layer_from_json(id);
     if (tl == NULL) {
         ret = -1;
         goto unlock_out;
     }
 
+    // the json of a layer still being unpacked by another isulad, it is added again once complete
+    if (tl->slayer->incompelte) {
+        DEBUG("remote layer is incomplete, not added: %s", id);
+        layer_ref_dec(tl);
+        goto unlock_out;
+    }
+
     if (!map_insert(g_metadata.by_id, (void *)tl->slayer->id, (void *)tl)) {
         ERROR("Insert id: %s for layer failed", tl->slayer->id);
         ret = -1;
         goto unlock_out;
     }
 
+    if (add_child_of_parent(tl->slayer->parent) != 0) {
+        ret = -1;
+        goto unlock_out;
+    }
+
     for (; i < tl->slayer->names_len; i++) {
         // this should be done by master isulad
         if (!map_insert(g_metadata.by_name, (void *)tl->slayer->names[i], (void *)tl)) {
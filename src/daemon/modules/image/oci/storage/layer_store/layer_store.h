@@ -23,6 +23,7 @@
 
 #include "storage.h"
 #include "io_wrapper.h"
+#include "utils_thread_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,8 @@ struct layer_opts {
 
     char *uncompressed_digest;
     char *compressed_digest;
+    // uncompressed_digest is the expected diff id, check it after apply diff
+    bool verify_uncompressed_digest;
 
     // mount options
     struct layer_store_mount_opts *opts;
@@ -57,6 +60,7 @@ int layer_inc_hold_refs(const char *layer_id);
 int layer_dec_hold_refs(const char *layer_id);
 int layer_get_hold_refs(const char *layer_id, int *ref_num);
 int layer_store_delete(const char *id);
+bool layer_store_has_children(const char *id);
 int layer_store_list(struct layer_list *resp);
 int layer_store_by_compress_digest(const char *digest, struct layer_list *resp);
 struct layer *layer_store_lookup(const char *name);
@@ -69,7 +73,10 @@ void free_layer_opts(struct layer_opts *opts);
 
 int layer_store_get_layer_fs_info(const char *layer_id, imagetool_fs_info *fs_info);
 
-int layer_store_check(const char *id);
+// workers shared by the layer checks of one integration check run, free by util_thread_pool_free
+thread_pool_t *layer_store_new_check_workers(void);
+
+int layer_store_check(const char *id, thread_pool_t *workers);
 
 container_inspect_graph_driver *layer_store_get_metadata_by_layer_id(const char *id);
 
@@ -26,6 +26,8 @@
 #include "image_store.h"
 #include "utils_array.h"
 
+#define IMAGE_ID_PATTEN "^[a-f0-9]{64}$"
+
 static map_t *image_byid_old = NULL;
 static map_t *image_byid_new = NULL;
 
@@ -85,7 +87,6 @@ static int remote_dir_scan(void *data)
     char **image_dirs = NULL;
     size_t image_dirs_num = 0;
     size_t i;
-    char *id_patten = "^[a-f0-9]{64}$";
     char image_path[PATH_MAX] = { 0x00 };
     bool exist = true;
     struct remote_image_data *img_data = (struct remote_image_data *)data;
@@ -100,7 +101,7 @@ static int remote_dir_scan(void *data)
     for (i = 0; i < image_dirs_num; i++) {
         bool is_v1_image = false;
 
-        if (util_reg_match(id_patten, image_dirs[i]) != 0) {
+        if (util_reg_match(IMAGE_ID_PATTEN, image_dirs[i]) != 0) {
             DEBUG("Image's json is placed inside image's data directory, so skip any other file or directory: %s",
                   image_dirs[i]);
             continue;
@@ -223,3 +224,75 @@ void remote_image_refresh(struct remote_image_data *data)
         ERROR("refresh overlay failed");
     }
 }
+
+static bool remote_image_entry_valid(struct remote_image_data *data, const char *id)
+{
+    int nret = 0;
+    bool is_v1_image = false;
+    char image_path[PATH_MAX] = { 0x00 };
+
+    if (util_reg_match(IMAGE_ID_PATTEN, id) != 0) {
+        return false;
+    }
+
+    nret = snprintf(image_path, sizeof(image_path), "%s/%s", data->image_home, id);
+    if (nret < 0 || (size_t)nret >= sizeof(image_path)) {
+        ERROR("Failed to get image path");
+        return false;
+    }
+
+    if (!util_dir_exists(image_path)) {
+        return false;
+    }
+
+    if (image_store_validate_manifest_schema_version_1(image_path, &is_v1_image) != 0) {
+        ERROR("Failed to validate manifest schema version 1 format");
+        return false;
+    }
+
+    return !is_v1_image;
+}
+
+void remote_image_apply_changes(struct remote_image_data *data, const char **ids, char ***retry_ids)
+{
+    size_t i = 0;
+    bool exist = true;
+    char *top_layer = NULL;
+
+    if (data == NULL || retry_ids == NULL) {
+        ERROR("Skip apply changes of remote image for empty data");
+        return;
+    }
+
+    for (i = 0; i < util_array_len(ids); i++) {
+        bool on_disk = remote_image_entry_valid(data, ids[i]);
+        bool in_memory = map_search(image_byid_old, (void *)ids[i]) != NULL;
+
+        if (on_disk && !in_memory) {
+            // image json or top layer may not be ready yet, retry it later
+            top_layer = remote_image_get_top_layer_from_json(ids[i]);
+            if (top_layer == NULL || !remote_layer_layer_valid(top_layer) ||
+                remote_append_image_by_directory_with_lock(ids[i]) != 0) {
+                DEBUG("Remote image %s not ready, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                free(top_layer);
+                top_layer = NULL;
+                continue;
+            }
+            free(top_layer);
+            top_layer = NULL;
+            if (!map_insert(image_byid_old, (void *)ids[i], (void *)&exist)) {
+                ERROR("can't insert remote image %s into map", ids[i]);
+            }
+        } else if (!on_disk && in_memory) {
+            if (remote_remove_image_from_memory_with_lock(ids[i]) != 0) {
+                DEBUG("Failed to remove remote image: %s, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                continue;
+            }
+            if (!map_remove(image_byid_old, (void *)ids[i])) {
+                ERROR("can't remove remote image %s from map", ids[i]);
+            }
+        }
+    }
+}
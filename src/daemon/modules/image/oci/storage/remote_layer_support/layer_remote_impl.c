@@ -252,6 +252,42 @@ void remote_layer_refresh(struct remote_layer_data *data)
     }
 }
 
+void remote_layer_apply_changes(struct remote_layer_data *data, const char **ids, char ***retry_ids)
+{
+    size_t i = 0;
+    bool exist = true;
+
+    if (data == NULL || retry_ids == NULL) {
+        ERROR("Skip apply changes of remote layer for empty data");
+        return;
+    }
+
+    for (i = 0; i < util_array_len(ids); i++) {
+        bool on_disk = remote_ro_entry_exists(data->layer_ro, ids[i]);
+        bool in_memory = map_search(layer_byid_old, (void *)ids[i]) != NULL;
+
+        if (on_disk && !in_memory) {
+            // overlay layer of the same id must be loaded first
+            if (!remote_overlay_layer_valid(ids[i]) || add_one_remote_layer(data, (char *)ids[i]) != 0) {
+                DEBUG("Remote layer %s not ready, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                continue;
+            }
+            if (!map_insert(layer_byid_old, (void *)ids[i], (void *)&exist)) {
+                ERROR("can't insert remote layer %s into map", ids[i]);
+            }
+        } else if (!on_disk && in_memory) {
+            if (remove_one_remote_layer(data, (char *)ids[i]) != 0) {
+                DEBUG("Failed to delete remote layer: %s, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                continue;
+            }
+            if (!map_remove(layer_byid_old, (void *)ids[i])) {
+                ERROR("can't remove remote layer %s from map", ids[i]);
+            }
+        }
+    }
+}
 
 bool remote_layer_layer_valid(const char *layer_id)
 {
@@ -271,7 +271,7 @@ static int add_one_remote_overlay_layer(struct remote_overlay_data *data, const
     }
 
     diff_symlink = util_read_content_from_file(link_file);
-    if (link_file == NULL) {
+    if (diff_symlink == NULL) {
         ERROR("Failed to read content from link file of layer %s", layer_dir);
         ret = -1;
         goto free_out;
@@ -360,6 +360,43 @@ void remote_overlay_refresh(struct remote_overlay_data *data)
     }
 }
 
+void remote_overlay_apply_changes(struct remote_overlay_data *data, const char **ids, char ***retry_ids)
+{
+    size_t i = 0;
+    bool exist = true;
+
+    if (data == NULL || retry_ids == NULL) {
+        ERROR("Skip apply changes of remote overlay for empty data");
+        return;
+    }
+
+    for (i = 0; i < util_array_len(ids); i++) {
+        bool on_disk = remote_ro_entry_exists(data->overlay_ro, ids[i]);
+        bool in_memory = map_search(overlay_byid_old, (void *)ids[i]) != NULL;
+
+        if (on_disk && !in_memory) {
+            // link file may not be written yet, retry it later
+            if (add_one_remote_overlay_layer(data, ids[i]) != 0) {
+                DEBUG("Failed to add remote overlay layer: %s, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                continue;
+            }
+            if (!map_insert(overlay_byid_old, (void *)ids[i], (void *)&exist)) {
+                ERROR("can't insert remote overlay layer %s into map", ids[i]);
+            }
+        } else if (!on_disk && in_memory) {
+            if (remove_one_remote_overlay_layer(data, ids[i]) != 0) {
+                DEBUG("Failed to delete remote overlay layer: %s, retry later", ids[i]);
+                (void)util_array_append(retry_ids, ids[i]);
+                continue;
+            }
+            if (!map_remove(overlay_byid_old, (void *)ids[i])) {
+                ERROR("can't remove remote overlay layer %s from map", ids[i]);
+            }
+        }
+    }
+}
+
 bool remote_overlay_layer_valid(const char *layer_id)
 {
     return map_search(overlay_byid_old, (void *)layer_id) != NULL;
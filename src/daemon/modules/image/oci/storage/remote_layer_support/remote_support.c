@@ -16,9 +16,49 @@
 #include "remote_support.h"
 
 #include <pthread.h>
+#include <poll.h>
+#include <stdio.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/inotify.h>
 
 #include "isula_libutils/log.h"
 #include "utils.h"
+#include "utils_array.h"
+#include "utils_file.h"
+#include "map.h"
+
+#define REMOTE_POLL_INTERVAL_MS (5 * 1000)
+#define REMOTE_RETRY_INTERVAL_MS 1000
+#define REMOTE_RETRY_MAX_INTERVAL_MS (64 * 1000)
+#define REMOTE_EVENTS_SETTLE_MS 100
+#define REMOTE_EVENTS_BUFFER_SIZE (64 * (sizeof(struct inotify_event) + NAME_MAX + 1))
+#define REMOTE_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+#define REMOTE_KIND_OVERLAY "overlay"
+#define REMOTE_KIND_LAYER "layer"
+#define REMOTE_KIND_IMAGE "image"
+
+struct remote_watcher {
+    int fd;
+    int overlay_wd;
+    int layer_wd;
+    int image_wd;
+};
+
+// ids of entries changed in ro dirs, which are not applied to memory stores yet
+struct remote_changes {
+    char **overlay_ids;
+    char **layer_ids;
+    char **image_ids;
+};
+
+// backoff of an entry which failed to apply, it is reset by a new event of the entry
+struct remote_retry_state {
+    int64_t interval_ms;
+    int64_t next_ms;
+};
 
 struct supporters {
     struct remote_image_data *image_data;
@@ -29,6 +69,9 @@ struct supporters {
 
 static struct supporters supporters;
 
+// keyed by "<kind>/<id>", only used by the refresh thread
+static map_t *g_retry_states;
+
 static inline bool remote_refresh_lock(pthread_rwlock_t *remote_lock, bool writable)
 {
     int nret = 0;
@@ -58,26 +101,387 @@ static inline void remote_refresh_unlock(pthread_rwlock_t *remote_lock)
     }
 }
 
+static void remote_full_refresh(struct supporters *refresh_supporters)
+{
+    DEBUG("remote refresh start\n");
+
+    if (!remote_refresh_lock(refresh_supporters->remote_lock, true)) {
+        WARN("Failed to lock remote store failed, skip this refresh");
+        return;
+    }
+    remote_overlay_refresh(refresh_supporters->overlay_data);
+    remote_layer_refresh(refresh_supporters->layer_data);
+    remote_image_refresh(refresh_supporters->image_data);
+    remote_refresh_unlock(refresh_supporters->remote_lock);
+
+    DEBUG("remote refresh end\n");
+}
+
+// fallback when ro dirs can not be watched
+static void remote_poll_refresh(struct supporters *refresh_supporters)
+{
+    while (true) {
+        util_usleep_nointerupt(REMOTE_POLL_INTERVAL_MS * 1000);
+        remote_full_refresh(refresh_supporters);
+    }
+}
+
+static int remote_watcher_init(struct remote_watcher *watcher)
+{
+    maintain_context ctx = get_maintain_context();
+
+    watcher->fd = inotify_init1(IN_CLOEXEC);
+    if (watcher->fd < 0) {
+        SYSERROR("Failed to initialize inotify instance");
+        return -1;
+    }
+
+    watcher->overlay_wd = inotify_add_watch(watcher->fd, ctx.overlay_ro_dir, REMOTE_WATCH_MASK);
+    if (watcher->overlay_wd < 0) {
+        SYSERROR("Failed to watch remote overlay dir %s", ctx.overlay_ro_dir);
+        goto err_out;
+    }
+
+    watcher->layer_wd = inotify_add_watch(watcher->fd, ctx.layer_ro_dir, REMOTE_WATCH_MASK);
+    if (watcher->layer_wd < 0) {
+        SYSERROR("Failed to watch remote layer dir %s", ctx.layer_ro_dir);
+        goto err_out;
+    }
+
+    watcher->image_wd = inotify_add_watch(watcher->fd, ctx.image_home, REMOTE_WATCH_MASK);
+    if (watcher->image_wd < 0) {
+        SYSERROR("Failed to watch remote image dir %s", ctx.image_home);
+        goto err_out;
+    }
+
+    return 0;
+
+err_out:
+    close(watcher->fd);
+    watcher->fd = -1;
+    return -1;
+}
+
+static int remote_wait_events(int fd, int timeout_ms)
+{
+    struct pollfd pfd = { 0 };
+    int nret = 0;
+
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    do {
+        nret = poll(&pfd, 1, timeout_ms);
+    } while (nret < 0 && errno == EINTR);
+
+    return nret;
+}
+
+static void remote_changes_append(char ***ids, const char *id)
+{
+    if (util_array_contain((const char **)*ids, id)) {
+        return;
+    }
+
+    if (util_array_append(ids, id) != 0) {
+        ERROR("Failed to record remote change of %s, it will be handled in next full refresh", id);
+    }
+}
+
+static void remote_changes_clear(struct remote_changes *changes)
+{
+    util_free_array(changes->overlay_ids);
+    changes->overlay_ids = NULL;
+    util_free_array(changes->layer_ids);
+    changes->layer_ids = NULL;
+    util_free_array(changes->image_ids);
+    changes->image_ids = NULL;
+}
+
+static bool remote_changes_empty(const struct remote_changes *changes)
+{
+    return changes->overlay_ids == NULL && changes->layer_ids == NULL && changes->image_ids == NULL;
+}
+
+static void remote_retry_state_kvfree(void *key, void *value)
+{
+    free(key);
+    free(value);
+}
+
+static int64_t remote_now_ms(void)
+{
+    struct timespec ts = { 0 };
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static bool remote_retry_key(const char *kind, const char *id, char *key, size_t len)
+{
+    int nret = snprintf(key, len, "%s/%s", kind, id);
+
+    return nret >= 0 && (size_t)nret < len;
+}
+
+static void remote_retry_reset(const char *kind, const char *id)
+{
+    char key[PATH_MAX] = { 0 };
+
+    if (g_retry_states == NULL || !remote_retry_key(kind, id, key, sizeof(key))) {
+        return;
+    }
+    (void)map_remove(g_retry_states, (void *)key);
+}
+
+// move ids which are still backing off from *ids to *deferred
+static void remote_retry_split(const char *kind, char ***ids, char ***deferred, int64_t now_ms)
+{
+    char **due = NULL;
+    size_t i = 0;
+
+    for (i = 0; i < util_array_len((const char **)*ids); i++) {
+        char key[PATH_MAX] = { 0 };
+        struct remote_retry_state *state = NULL;
+
+        if (g_retry_states != NULL && remote_retry_key(kind, (*ids)[i], key, sizeof(key))) {
+            state = map_search(g_retry_states, (void *)key);
+        }
+        remote_changes_append((state != NULL && now_ms < state->next_ms) ? deferred : &due, (*ids)[i]);
+    }
+
+    util_free_array(*ids);
+    *ids = due;
+}
+
+// double the retry interval of failed entries, and forget entries applied successfully
+static void remote_retry_update(const char *kind, const char **applied, const char **failed, int64_t now_ms)
+{
+    size_t i = 0;
+
+    if (g_retry_states == NULL) {
+        g_retry_states = map_new(MAP_STR_PTR, MAP_DEFAULT_CMP_FUNC, remote_retry_state_kvfree);
+        if (g_retry_states == NULL) {
+            ERROR("Out of memory");
+            return;
+        }
+    }
+
+    for (i = 0; i < util_array_len(applied); i++) {
+        char key[PATH_MAX] = { 0 };
+        struct remote_retry_state *state = NULL;
+
+        if (!remote_retry_key(kind, applied[i], key, sizeof(key))) {
+            continue;
+        }
+
+        if (!util_array_contain(failed, applied[i])) {
+            (void)map_remove(g_retry_states, (void *)key);
+            continue;
+        }
+
+        state = map_search(g_retry_states, (void *)key);
+        if (state != NULL) {
+            state->interval_ms = state->interval_ms * 2 > REMOTE_RETRY_MAX_INTERVAL_MS ? REMOTE_RETRY_MAX_INTERVAL_MS :
+                                 state->interval_ms * 2;
+            state->next_ms = now_ms + state->interval_ms;
+            continue;
+        }
+
+        // log once per entry, the following failures only back off
+        WARN("Failed to apply remote %s %s, retry later", kind, applied[i]);
+        state = util_common_calloc_s(sizeof(struct remote_retry_state));
+        if (state == NULL) {
+            ERROR("Out of memory");
+            continue;
+        }
+        state->interval_ms = REMOTE_RETRY_INTERVAL_MS;
+        state->next_ms = now_ms + state->interval_ms;
+        if (!map_insert(g_retry_states, (void *)key, (void *)state)) {
+            ERROR("Failed to record retry state of remote %s %s", kind, applied[i]);
+            free(state);
+        }
+    }
+}
+
+static void remote_changes_merge(struct remote_changes *dst, const struct remote_changes *src)
+{
+    size_t i = 0;
+
+    for (i = 0; i < util_array_len((const char **)src->overlay_ids); i++) {
+        remote_changes_append(&dst->overlay_ids, src->overlay_ids[i]);
+    }
+    for (i = 0; i < util_array_len((const char **)src->layer_ids); i++) {
+        remote_changes_append(&dst->layer_ids, src->layer_ids[i]);
+    }
+    for (i = 0; i < util_array_len((const char **)src->image_ids); i++) {
+        remote_changes_append(&dst->image_ids, src->image_ids[i]);
+    }
+}
+
+// return 1 if a full refresh is required, -1 if watches are lost
+static int remote_read_events(const struct remote_watcher *watcher, struct remote_changes *changes)
+{
+    char buffer[REMOTE_EVENTS_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event)))) = { 0 };
+    ssize_t events_length = 0;
+    ssize_t events_index = 0;
+    int ret = 0;
+
+    events_length = util_read_nointr(watcher->fd, buffer, sizeof(buffer));
+    if (events_length <= 0) {
+        SYSERROR("Failed to read remote ro dirs events");
+        return 1;
+    }
+
+    while (events_index < events_length) {
+        const struct inotify_event *event = (const struct inotify_event *)(&buffer[events_index]);
+        ssize_t event_size = (ssize_t)sizeof(struct inotify_event) + (ssize_t)event->len;
+
+        if (event_size > (events_length - events_index)) {
+            break;
+        }
+        events_index += event_size;
+
+        if ((event->mask & IN_Q_OVERFLOW) != 0) {
+            WARN("Remote ro dirs events overflow, do full refresh");
+            ret = 1;
+            continue;
+        }
+        if ((event->mask & IN_IGNORED) != 0) {
+            WARN("Remote ro dir is no longer watched");
+            return -1;
+        }
+        if ((event->mask & IN_ISDIR) == 0 || event->len == 0) {
+            continue;
+        }
+
+        // a new change of the entry is worth trying at once
+        if (event->wd == watcher->overlay_wd) {
+            remote_retry_reset(REMOTE_KIND_OVERLAY, event->name);
+            remote_changes_append(&changes->overlay_ids, event->name);
+        } else if (event->wd == watcher->layer_wd) {
+            remote_retry_reset(REMOTE_KIND_LAYER, event->name);
+            remote_changes_append(&changes->layer_ids, event->name);
+        } else if (event->wd == watcher->image_wd) {
+            remote_retry_reset(REMOTE_KIND_IMAGE, event->name);
+            remote_changes_append(&changes->image_ids, event->name);
+        }
+    }
+
+    return ret;
+}
+
+// apply changes stage by stage, failed items are left in changes for retry with backoff
+static void remote_apply_changes(struct supporters *refresh_supporters, struct remote_changes *changes)
+{
+    struct remote_changes due = { 0 };
+    struct remote_changes retry = { 0 };
+    int64_t now_ms = remote_now_ms();
+    size_t i = 0;
+
+    // remote layer is valid only if overlay layer with the same id is valid
+    for (i = 0; i < util_array_len((const char **)changes->overlay_ids); i++) {
+        remote_changes_append(&changes->layer_ids, changes->overlay_ids[i]);
+    }
+
+    // entries still backing off are left in changes
+    due = *changes;
+    *changes = (struct remote_changes) { 0 };
+    remote_retry_split(REMOTE_KIND_OVERLAY, &due.overlay_ids, &changes->overlay_ids, now_ms);
+    remote_retry_split(REMOTE_KIND_LAYER, &due.layer_ids, &changes->layer_ids, now_ms);
+    remote_retry_split(REMOTE_KIND_IMAGE, &due.image_ids, &changes->image_ids, now_ms);
+
+    if (!remote_refresh_lock(refresh_supporters->remote_lock, true)) {
+        WARN("Failed to lock remote store, retry later");
+        goto out;
+    }
+    remote_overlay_apply_changes(refresh_supporters->overlay_data, (const char **)due.overlay_ids,
+                                 &retry.overlay_ids);
+    remote_refresh_unlock(refresh_supporters->remote_lock);
+
+    if (!remote_refresh_lock(refresh_supporters->remote_lock, true)) {
+        WARN("Failed to lock remote store, retry later");
+        goto out;
+    }
+    remote_layer_apply_changes(refresh_supporters->layer_data, (const char **)due.layer_ids, &retry.layer_ids);
+    remote_refresh_unlock(refresh_supporters->remote_lock);
+
+    if (!remote_refresh_lock(refresh_supporters->remote_lock, true)) {
+        WARN("Failed to lock remote store, retry later");
+        goto out;
+    }
+    remote_image_apply_changes(refresh_supporters->image_data, (const char **)due.image_ids, &retry.image_ids);
+    remote_refresh_unlock(refresh_supporters->remote_lock);
+
+    remote_retry_update(REMOTE_KIND_OVERLAY, (const char **)due.overlay_ids, (const char **)retry.overlay_ids, now_ms);
+    remote_retry_update(REMOTE_KIND_LAYER, (const char **)due.layer_ids, (const char **)retry.layer_ids, now_ms);
+    remote_retry_update(REMOTE_KIND_IMAGE, (const char **)due.image_ids, (const char **)retry.image_ids, now_ms);
+    remote_changes_merge(changes, &retry);
+    remote_changes_clear(&retry);
+    remote_changes_clear(&due);
+    return;
+
+out:
+    // stages already applied are idempotent, keep everything and retry
+    remote_changes_merge(changes, &due);
+    remote_changes_clear(&retry);
+    remote_changes_clear(&due);
+}
+
 static void *remote_refresh_ro_symbol_link(void *arg)
 {
     struct supporters *refresh_supporters = (struct supporters *)arg;
+    struct remote_watcher watcher = { .fd = -1, .overlay_wd = -1, .layer_wd = -1, .image_wd = -1 };
+    struct remote_changes pending = { 0 };
+    int timeout_ms = 0;
+    int nret = 0;
     prctl(PR_SET_NAME, "RoLayerRefresh");
 
+    if (remote_watcher_init(&watcher) != 0) {
+        WARN("Failed to watch remote ro dirs, fallback to refresh every %d ms", REMOTE_POLL_INTERVAL_MS);
+        remote_poll_refresh(refresh_supporters);
+        return NULL;
+    }
+
+    // watches are ready, so a full refresh now will not miss any change
+    remote_full_refresh(refresh_supporters);
+
     while (true) {
-        util_usleep_nointerupt(5 * 1000 * 1000);
-        DEBUG("remote refresh start\n");
+        bool need_full_refresh = false;
+
+        timeout_ms = remote_changes_empty(&pending) ? -1 : REMOTE_RETRY_INTERVAL_MS;
+        nret = remote_wait_events(watcher.fd, timeout_ms);
+        if (nret < 0) {
+            SYSERROR("Failed to wait remote ro dirs events");
+            util_usleep_nointerupt(REMOTE_RETRY_INTERVAL_MS * 1000);
+            continue;
+        }
+
+        // coalesce a burst of events, such as a layer dir and its contents being created
+        while (nret > 0) {
+            int rret = remote_read_events(&watcher, &pending);
+            if (rret < 0) {
+                goto fallback;
+            }
+            need_full_refresh = need_full_refresh || rret > 0;
+            nret = remote_wait_events(watcher.fd, REMOTE_EVENTS_SETTLE_MS);
+        }
 
-        if (!remote_refresh_lock(supporters.remote_lock, true)) {
-            WARN("Failed to lock remote store failed, try to lock after 5 seconds");
+        if (need_full_refresh) {
+            remote_changes_clear(&pending);
+            map_clear(g_retry_states);
+            remote_full_refresh(refresh_supporters);
             continue;
         }
-        remote_overlay_refresh(refresh_supporters->overlay_data);
-        remote_layer_refresh(refresh_supporters->layer_data);
-        remote_image_refresh(refresh_supporters->image_data);
-        remote_refresh_unlock(supporters.remote_lock);
 
-        DEBUG("remote refresh end\n");
+        remote_apply_changes(refresh_supporters, &pending);
     }
+
+fallback:
+    remote_changes_clear(&pending);
+    close(watcher.fd);
+    WARN("Fallback to refresh remote ro dirs every %d ms", REMOTE_POLL_INTERVAL_MS);
+    remote_poll_refresh(refresh_supporters);
     return NULL;
 }
 
@@ -173,3 +577,21 @@ char **remote_added_layers(const map_t *old, const map_t *new)
 {
     return map_diff(new, old);
 }
+
+bool remote_ro_entry_exists(const char *ro_dir, const char *name)
+{
+    char path[PATH_MAX] = { 0 };
+    int nret = 0;
+
+    if (ro_dir == NULL || name == NULL) {
+        return false;
+    }
+
+    nret = snprintf(path, sizeof(path), "%s/%s", ro_dir, name);
+    if (nret < 0 || (size_t)nret >= sizeof(path)) {
+        ERROR("Failed to get remote ro entry path of %s", name);
+        return false;
+    }
+
+    return util_dir_exists(path);
+}
@@ -47,6 +47,8 @@ void remote_image_destroy(struct remote_image_data *data);
 
 void remote_image_refresh(struct remote_image_data *data);
 
+void remote_image_apply_changes(struct remote_image_data *data, const char **ids, char ***retry_ids);
+
 // layer impl
 struct remote_layer_data *remote_layer_create(const char *layer_home, const char *layer_ro);
 
@@ -54,6 +56,8 @@ void remote_layer_destroy(struct remote_layer_data *data);
 
 void remote_layer_refresh(struct remote_layer_data *data);
 
+void remote_layer_apply_changes(struct remote_layer_data *data, const char **ids, char ***retry_ids);
+
 bool remote_layer_layer_valid(const char *layer_id);
 
 // overlay impl
@@ -63,6 +67,8 @@ void remote_overlay_destroy(struct remote_overlay_data *data);
 
 void remote_overlay_refresh(struct remote_overlay_data *data);
 
+void remote_overlay_apply_changes(struct remote_overlay_data *data, const char **ids, char ***retry_ids);
+
 bool remote_overlay_layer_valid(const char *layer_id);
 
 // start refresh remote
@@ -73,6 +79,8 @@ char **remote_deleted_layers(const map_t *old, const map_t *new_l);
 
 char **remote_added_layers(const map_t *old, const map_t *new_l);
 
+bool remote_ro_entry_exists(const char *ro_dir, const char *name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -50,6 +50,8 @@ typedef struct rootfs_store {
     map_t *byid;
     map_t *bylayer;
     map_t *byname;
+    // number of rootfs created from the image of the key
+    map_t *byimage;
 
     bool loaded;
 } rootfs_store_t;
@@ -109,6 +111,9 @@ static void free_rootfs_store(rootfs_store_t *store)
     (void)map_free(store->byname);
     store->byname = NULL;
 
+    (void)map_free(store->byimage);
+    store->byimage = NULL;
+
     linked_list_for_each_safe(item, &(store->rootfs_list), next) {
         linked_list_del(item);
         rootfs_ref_dec((cntrootfs_t *)item->elem);
@@ -139,6 +144,49 @@ static inline int get_data_dir(const char *id, char *path, size_t len)
     return (nret < 0 || (size_t)nret >= len) ? -1 : 0;
 }
 
+static int add_rootfs_to_image_index(const char *image)
+{
+    int *users = NULL;
+    int one = 1;
+
+    if (image == NULL) {
+        return 0;
+    }
+
+    users = map_search(g_rootfs_store->byimage, (void *)image);
+    if (users != NULL) {
+        (*users)++;
+        return 0;
+    }
+
+    if (!map_insert(g_rootfs_store->byimage, (void *)image, (void *)&one)) {
+        ERROR("Failed to insert container to image index");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void remove_rootfs_from_image_index(const char *image)
+{
+    int *users = NULL;
+
+    if (image == NULL) {
+        return;
+    }
+
+    users = map_search(g_rootfs_store->byimage, (void *)image);
+    if (users == NULL) {
+        WARN("No rootfs recorded for image %s", image);
+        return;
+    }
+
+    (*users)--;
+    if (*users <= 0 && !map_remove(g_rootfs_store->byimage, (void *)image)) {
+        WARN("Failed to remove image %s from image index", image);
+    }
+}
+
 static int do_append_container(storage_rootfs *c)
 {
     cntrootfs_t *cntr = NULL;
@@ -356,13 +404,19 @@ static int load_container_to_store_field(cntrootfs_t *cntr)
 {
     int ret = 0;
     bool should_save = false;
+    bool reloaded = false;
     size_t i;
 
+    reloaded = map_search(g_rootfs_store->byid, (void *)cntr->srootfs->id) != NULL;
     if (!map_replace(g_rootfs_store->byid, (void *)cntr->srootfs->id, (void *)cntr)) {
         ERROR("Failed to insert container to id index");
         return -1;
     }
 
+    if (!reloaded && add_rootfs_to_image_index(cntr->srootfs->image) != 0) {
+        return -1;
+    }
+
     if (!map_replace(g_rootfs_store->bylayer, (void *)cntr->srootfs->layer, (void *)cntr)) {
         ERROR("Failed to insert container to layer index");
         return -1;
@@ -510,6 +564,13 @@ int rootfs_store_init(struct storage_module_init_options *opts)
         goto out;
     }
 
+    g_rootfs_store->byimage = map_new(MAP_STR_INT, MAP_DEFAULT_CMP_FUNC, MAP_DEFAULT_FREE_FUNC);
+    if (g_rootfs_store->byimage == NULL) {
+        ERROR("Out of memory");
+        ret = -1;
+        goto out;
+    }
+
     ret = rootfs_store_load();
     if (ret != 0) {
         ERROR("Failed to load container store");
@@ -732,6 +793,8 @@ static int rootfs_store_append_container_rootfs(const char *id, const char *laye
         }
     }
 
+    ret = add_rootfs_to_image_index(cntr->srootfs->image);
+
 out:
     if (ret != 0) {
         linked_list_del(item);
@@ -830,6 +893,7 @@ static int remove_rootfs_from_memory(const char *id)
         ret = -1;
         goto out;
     }
+    remove_rootfs_from_image_index(cntr->srootfs->image);
 
     if (!map_remove(g_rootfs_store->bylayer, cntr->srootfs->layer)) {
         ERROR("Failed to remove rootfs from layers map in rootfs store");
@@ -1219,6 +1283,78 @@ out:
     return ret;
 }
 
+char *rootfs_store_get_image_id(const char *id)
+{
+    char *image = NULL;
+    cntrootfs_t *cntr = NULL;
+
+    if (id == NULL) {
+        ERROR("Invalid paratemer, id is NULL");
+        return NULL;
+    }
+
+    if (g_rootfs_store == NULL) {
+        ERROR("Rootfs store is not ready");
+        return NULL;
+    }
+
+    if (!rootfs_store_lock(SHARED)) {
+        ERROR("Failed to lock rootfs store with shared lock, not allowed to get rootfs image");
+        return NULL;
+    }
+
+    cntr = lookup(id);
+    if (cntr == NULL) {
+        ERROR("Rootfs not known");
+        goto out;
+    }
+
+    image = util_strdup_s(cntr->srootfs->image);
+
+out:
+    rootfs_ref_dec(cntr);
+    rootfs_store_unlock();
+    return image;
+}
+
+int rootfs_store_get_image_user(const char *image, char **user)
+{
+    struct linked_list *item = NULL;
+    struct linked_list *next = NULL;
+
+    if (image == NULL || user == NULL) {
+        ERROR("Invalid paratemer, image is NULL");
+        return -1;
+    }
+
+    if (g_rootfs_store == NULL) {
+        ERROR("Rootfs store is not ready");
+        return -1;
+    }
+
+    if (!rootfs_store_lock(SHARED)) {
+        ERROR("Failed to lock rootfs store with shared lock, not allowed to get image users");
+        return -1;
+    }
+
+    // the index answers the common case of an unused image without walking the rootfs list
+    if (map_search(g_rootfs_store->byimage, (void *)image) == NULL) {
+        goto out;
+    }
+
+    linked_list_for_each_safe(item, &(g_rootfs_store->rootfs_list), next) {
+        cntrootfs_t *tmp = (cntrootfs_t *)item->elem;
+        if (tmp->srootfs->image != NULL && strcmp(tmp->srootfs->image, image) == 0) {
+            *user = util_strdup_s(tmp->srootfs->id);
+            break;
+        }
+    }
+
+out:
+    rootfs_store_unlock();
+    return 0;
+}
+
 static storage_rootfs *copy_rootfs(const storage_rootfs *rootfs)
 {
     char *json = NULL;
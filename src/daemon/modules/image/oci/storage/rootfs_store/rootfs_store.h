@@ -61,6 +61,12 @@ storage_rootfs *rootfs_store_get_rootfs(const char *id);
 // Return a slice enumerating the known containers.
 int rootfs_store_get_all_rootfs(struct rootfs_list *all_rootfs);
 
+// Get the id of the image a container is created from.
+char *rootfs_store_get_image_id(const char *id);
+
+// Get the id of a container created from the image, user is left NULL if the image is not used.
+int rootfs_store_get_image_user(const char *image, char **user);
+
 // Return rootfs store data dir
 char *rootfs_store_get_data_dir(void);
 
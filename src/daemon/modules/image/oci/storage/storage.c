@@ -158,6 +158,7 @@ static struct layer_opts *fill_create_layer_opts(storage_layer_create_opts_t *co
     opts->uncompressed_digest = util_strdup_s(copts->uncompress_digest);
     opts->compressed_digest = util_strdup_s(copts->compressed_digest);
     opts->writable = copts->writable;
+    opts->verify_uncompressed_digest = copts->verify_uncompress_digest;
 
     opts->opts = util_common_calloc_s(sizeof(struct layer_store_mount_opts));
     if (opts->opts == NULL) {
@@ -471,6 +472,16 @@ out:
     return ret;
 }
 
+char *storage_img_get_big_data(const char *img_id, const char *key)
+{
+    if (img_id == NULL || key == NULL) {
+        ERROR("Invalid arguments");
+        return NULL;
+    }
+
+    return image_store_big_data(img_id, key);
+}
+
 int storage_img_get_names(const char *img_id, char ***names, size_t *names_len)
 {
     int ret = 0;
@@ -550,42 +561,15 @@ char *storage_img_get_image_id(const char *img_name)
     return image_store_lookup(img_name);
 }
 
-static bool is_top_layer_of_other_image(const char *img_id, const imagetool_images_list *all_images, const char *layer_id)
-{
-    size_t i = 0;
-
-    for (i = 0; i < all_images->images_len; i++) {
-        if (strcmp(all_images->images[i]->top_layer, layer_id) == 0 &&
-            strcmp(all_images->images[i]->id, layer_id) != 0) {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-bool is_parent_layer_of_other_layer(const char *layer_id, const char *last_deleted_layer_id,
-                                    const struct layer_list *all_layers)
-{
-    size_t i = 0;
-
-    for (i = 0; i < all_layers->layers_len; i++) {
-        if (all_layers->layers[i]->parent != NULL && strcmp(all_layers->layers[i]->parent, layer_id) == 0) {
-            if (last_deleted_layer_id == NULL || strcmp(all_layers->layers[i]->id, last_deleted_layer_id) != 0) {
-                return true;
-            }
-        }
-    }
-
-    return false;
-}
-
-static int do_delete_related_layers(const char *img_id, const char *img_top_layer_id,
-                                    const imagetool_images_list *all_images, const struct layer_list *all_layers)
+/*
+ * Walk down the chain from the top layer and delete every layer which is not held, not the top
+ * layer of an image and not the parent of another layer. The reverse indexes of the image and
+ * layer stores are updated on every delete, so only the layers of the chain are visited.
+ */
+static int delete_img_related_layers(const char *img_id, const char *img_top_layer_id)
 {
     int ret = 0;
     char *layer_id = NULL;
-    char *last_deleted_layer_id = NULL;
     struct layer *layer_info = NULL;
     int refs_num = 0;
 
@@ -608,11 +592,11 @@ static int do_delete_related_layers(const char *img_id, const char *img_top_laye
         }
 
         // if the layer is the top layer of other image, then break
-        if (is_top_layer_of_other_image(img_id, all_images, layer_id)) {
+        if (image_store_is_top_layer(layer_id)) {
             break;
         }
 
-        if (is_parent_layer_of_other_layer(layer_id, last_deleted_layer_id, all_layers)) {
+        if (layer_store_has_children(layer_id)) {
             break;
         }
 
@@ -629,61 +613,17 @@ static int do_delete_related_layers(const char *img_id, const char *img_top_laye
             goto out;
         }
 
-        free(last_deleted_layer_id);
-        last_deleted_layer_id = util_strdup_s(layer_id);
         free(layer_id);
         layer_id = util_strdup_s(layer_info->parent);
         free_layer(layer_info);
         layer_info = NULL;
     }
 out:
-    free(last_deleted_layer_id);
     free(layer_id);
     free_layer(layer_info);
     return ret;
 }
 
-static int delete_img_related_layers(const char *img_id, const char *img_top_layer_id)
-{
-    int ret = 0;
-    imagetool_images_list *all_images = NULL;
-    struct layer_list *all_layers = NULL;
-
-    all_images = util_common_calloc_s(sizeof(imagetool_images_list));
-    if (all_images == NULL) {
-        ERROR("Memory out");
-        ret = -1;
-        goto out;
-    }
-
-    all_layers = util_common_calloc_s(sizeof(struct layer_list));
-    if (all_layers == NULL) {
-        ERROR("Memory out");
-        ret = -1;
-        goto out;
-    }
-
-    if (image_store_get_all_images(all_images) != 0) {
-        ERROR("Failed to get all images info");
-        ret = -1;
-        goto out;
-    }
-
-    if (layer_store_list(all_layers) != 0) {
-        ERROR("Failed to get all images info");
-        ret = -1;
-        goto out;
-    }
-
-    ret = do_delete_related_layers(img_id, img_top_layer_id, all_images, all_layers);
-
-out:
-    free_imagetool_images_list(all_images);
-    free_layer_list(all_layers);
-
-    return ret;
-}
-
 int storage_layer_chain_delete(const char *layer_id)
 {
     int ret = 0;
@@ -725,10 +665,9 @@ static void free_rootfs_list(struct rootfs_list *list)
 
 static int check_image_occupancy_status(const char *img_id, bool *in_using)
 {
-    bool ret = 0;
-    size_t i;
-    struct rootfs_list *all_rootfs = NULL;
+    int ret = 0;
     char *img_long_id = NULL;
+    char *user = NULL;
 
     img_long_id = image_store_lookup(img_id);
     if (img_long_id == NULL) {
@@ -736,31 +675,21 @@ static int check_image_occupancy_status(const char *img_id, bool *in_using)
         return -1;
     }
 
-    all_rootfs = util_common_calloc_s(sizeof(struct rootfs_list));
-    if (all_rootfs == NULL) {
-        ERROR("Out of memory");
-        ret = -1;
-        goto out;
-    }
-
-    if (rootfs_store_get_all_rootfs(all_rootfs) != 0) {
-        ERROR("Failed to get all container rootfs information");
+    if (rootfs_store_get_image_user(img_long_id, &user) != 0) {
+        ERROR("Failed to get container rootfs of image %s", img_long_id);
         ret = -1;
         goto out;
     }
 
-    for (i = 0; i < all_rootfs->rootfs_len; i++) {
-        if (strcmp(all_rootfs->rootfs[i]->image, img_long_id) == 0) {
-            isulad_set_error_message("Image used by %s", all_rootfs->rootfs[i]->id);
-            ERROR("Image used by %s", all_rootfs->rootfs[i]->id);
-            *in_using = true;
-            goto out;
-        }
+    if (user != NULL) {
+        isulad_set_error_message("Image used by %s", user);
+        ERROR("Image used by %s", user);
+        *in_using = true;
     }
 
 out:
+    free(user);
     free(img_long_id);
-    free_rootfs_list(all_rootfs);
     return ret;
 }
 
@@ -1310,6 +1239,16 @@ out:
     return mount_point;
 }
 
+char *storage_rootfs_get_image_id(const char *container_id)
+{
+    if (container_id == NULL) {
+        ERROR("Invalid input arguments");
+        return NULL;
+    }
+
+    return rootfs_store_get_image_id(container_id);
+}
+
 int storage_rootfs_umount(const char *container_id, bool force)
 {
     int ret = 0;
@@ -1476,7 +1415,8 @@ out:
     return ret;
 }
 
-static int do_check_layers_list(const char *path, struct linked_list *layer_ids, map_t *checked_layers)
+static int do_check_layers_list(const char *path, struct linked_list *layer_ids, map_t *checked_layers,
+                                thread_pool_t *workers)
 {
     struct linked_list *iter = NULL;
     struct linked_list *next = NULL;
@@ -1497,7 +1437,7 @@ static int do_check_layers_list(const char *path, struct linked_list *layer_ids,
             INFO("Layer: %s checked, skip", tmp_id);
             continue;
         }
-        nret = layer_store_check(tmp_id);
+        nret = layer_store_check(tmp_id, workers);
         if (nret != 0) {
             ERROR("Layer: %s check failed", tmp_id);
             // this layer is invalid
@@ -1523,7 +1463,7 @@ out:
     return ret;
 }
 
-static int do_storage_check_image(const char *path, const char *id, map_t *checked_layers)
+static int do_storage_check_image(const char *path, const char *id, map_t *checked_layers, thread_pool_t *workers)
 {
     int ret = -1;
     imagetool_image *img = NULL;
@@ -1544,7 +1484,7 @@ static int do_storage_check_image(const char *path, const char *id, map_t *check
     }
 
     // check for all layers belong to the image
-    ret = do_check_layers_list(path, layer_ids, checked_layers);
+    ret = do_check_layers_list(path, layer_ids, checked_layers, workers);
 
 out:
     free_imagetool_image(img);
@@ -1572,7 +1512,7 @@ static bool is_rootfs_layer(const char *layer_id, const struct rootfs_list *all_
     return false;
 }
 
-static bool do_storage_integration_check(const char *path, map_t *checked_layers)
+static bool do_storage_integration_check(const char *path, map_t *checked_layers, thread_pool_t *workers)
 {
     struct rootfs_list *all_rootfs = NULL;
     bool ret = false;
@@ -1603,7 +1543,7 @@ static bool do_storage_integration_check(const char *path, map_t *checked_layers
     }
 
     for (i = 0; i < all_images->images_len; i++) {
-        nret = do_storage_check_image(path, all_images->images[i]->id, checked_layers);
+        nret = do_storage_check_image(path, all_images->images[i]->id, checked_layers, workers);
         if (nret == 0) {
             continue;
         }
@@ -1701,6 +1641,7 @@ static bool storage_integration_check()
     bool ret = false;
     map_t *checked_layers = NULL;
     char *checked_layer_data_path = NULL;
+    thread_pool_t *workers = NULL;
 
     if (!storage_lock(&g_storage_rwlock, true)) {
         ERROR("Failed to lock storage, not allowed to delete image");
@@ -1722,7 +1663,13 @@ static bool storage_integration_check()
         ERROR("Load checked layer file failed");
         goto out;
     }
-    ret = do_storage_integration_check(checked_layer_data_path, checked_layers);
+    // one worker pool checks the files of all layers
+    workers = layer_store_new_check_workers();
+    if (workers == NULL) {
+        ERROR("Failed to create integration check workers");
+        goto out;
+    }
+    ret = do_storage_integration_check(checked_layer_data_path, checked_layers, workers);
     if (!ret) {
         goto out;
     }
@@ -1731,6 +1678,7 @@ static bool storage_integration_check()
 
     ret = true;
 out:
+    util_thread_pool_free(workers);
     map_free(checked_layers);
     storage_unlock(&g_storage_rwlock);
     free(checked_layer_data_path);
@@ -114,6 +114,8 @@ typedef struct storage_layer_create_opts {
     const char *compressed_digest;
     const char *layer_data_path;
     bool writable;
+    // check uncompress_digest while applying layer data, instead of calculating it in advance
+    bool verify_uncompress_digest;
     json_map_string_string *storage_opts;
 } storage_layer_create_opts_t;
 
@@ -133,6 +135,8 @@ imagetool_image_summary *storage_img_get_summary(const char *img_id);
 
 int storage_img_set_big_data(const char *img_id, const char *key, const char *val);
 
+char *storage_img_get_big_data(const char *img_id, const char *key);
+
 int storage_img_add_name(const char *img_id, const char *img_name);
 
 int storage_img_delete(const char *img_id, bool commit);
@@ -193,6 +197,8 @@ int storage_rootfs_umount(const char *container_id, bool force);
 
 char *storage_rootfs_get_dir(void);
 
+char *storage_rootfs_get_image_id(const char *container_id);
+
 container_inspect_graph_driver *storage_get_metadata_by_container_id(const char *id);
 
 #ifdef __cplusplus
@@ -45,11 +45,10 @@ bool rt_lcr_detect(const char *runtime)
 int rt_lcr_create(const char *name, const char *runtime, const rt_create_params_t *params)
 {
     int ret = 0;
-    char *runtime_root = NULL;
+    char runtime_root[PATH_MAX] = { 0 };
     struct engine_operation *engine_ops = NULL;
 
-    runtime_root = conf_get_routine_rootdir(runtime);
-    if (runtime_root == NULL) {
+    if (conf_snapshot_routine_rootdir(runtime, runtime_root, sizeof(runtime_root)) != 0) {
         ERROR("Root path is NULL");
         ret = -1;
         goto out;
@@ -78,7 +77,6 @@ out:
     if (engine_ops != NULL && engine_ops->engine_clear_errmsg_op != NULL) {
         engine_ops->engine_clear_errmsg_op();
     }
-    free(runtime_root);
     return ret;
 }
 
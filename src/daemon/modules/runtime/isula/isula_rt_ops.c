@@ -33,6 +33,9 @@
 #include <string.h>
 #include <strings.h>
 #include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <poll.h>
 #include <time.h>
 
 #include "isula_libutils/log.h"
@@ -52,10 +55,13 @@
 
 #define SHIM_BINARY "isulad-shim"
 #define RESIZE_FIFO_NAME "resize_fifo"
+#define PID_SYNC_FIFO_NAME "pid-sync"
 #define SHIM_LOG_SIZE ((BUFSIZ - 100) / 2)
 #define RESIZE_DATA_SIZE 100
 #define PID_WAIT_TIME 120
+#define PID_POLL_INTERVAL_MS 100
 #define SHIM_EXIT_TIMEOUT 2
+#define CGROUP_MOUNTPOINT "/sys/fs/cgroup"
 
 // file name formats of cgroup resources json
 #define RESOURCE_FNAME_FORMATS "%s/resources.json"
@@ -589,6 +595,177 @@ out:
     return ret;
 }
 
+enum fast_status_result {
+    FAST_STATUS_DECIDED = 0,
+    FAST_STATUS_AMBIGUOUS,
+};
+
+static bool cgroup_controllers_contain(const char *controllers, const char *name)
+{
+    size_t len = strlen(name);
+    const char *p = controllers;
+
+    while (p != NULL && *p != '\0') {
+        if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0')) {
+            return true;
+        }
+        p = strchr(p, ',');
+        if (p != NULL) {
+            p++;
+        }
+    }
+
+    return false;
+}
+
+static int read_cgroup_frozen_file(const char *path, const char *file, const char *frozen, const char *thawed)
+{
+    char fname[PATH_MAX] = { 0 };
+    __isula_auto_free char *content = NULL;
+    int nret = 0;
+
+    nret = snprintf(fname, sizeof(fname), "%s/%s", path, file);
+    if (nret < 0 || (size_t)nret >= sizeof(fname)) {
+        return -1;
+    }
+
+    content = util_read_content_from_file(fname);
+    if (content == NULL) {
+        return -1;
+    }
+
+    if (strstr(content, frozen) != NULL) {
+        return 1;
+    }
+    return strstr(content, thawed) != NULL ? 0 : -1;
+}
+
+/* return 1 if the cgroup of pid is frozen, 0 if it is thawed, -1 if it can not be decided */
+static int cgroup_frozen_state(int pid)
+{
+    char fname[PATH_MAX] = { 0 };
+    char path[PATH_MAX] = { 0 };
+    __isula_auto_free char *content = NULL;
+    char *line = NULL;
+    char *saveptr = NULL;
+    int nret = 0;
+
+    nret = snprintf(fname, sizeof(fname), "/proc/%d/cgroup", pid);
+    if (nret < 0 || (size_t)nret >= sizeof(fname)) {
+        return -1;
+    }
+
+    content = util_read_content_from_file(fname);
+    if (content == NULL) {
+        return -1;
+    }
+
+    for (line = strtok_r(content, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+        char *controllers = strchr(line, ':');
+        char *cgpath = controllers != NULL ? strchr(controllers + 1, ':') : NULL;
+
+        if (cgpath == NULL) {
+            continue;
+        }
+        controllers++;
+        *cgpath = '\0';
+        cgpath++;
+
+        if (*controllers == '\0' && strncmp(line, "0:", strlen("0:")) == 0) {
+            /* cgroup v2 reports the effective freezer state in cgroup.events */
+            nret = snprintf(path, sizeof(path), "%s%s", CGROUP_MOUNTPOINT, cgpath);
+            if (nret < 0 || (size_t)nret >= sizeof(path)) {
+                return -1;
+            }
+            return read_cgroup_frozen_file(path, "cgroup.events", "frozen 1", "frozen 0");
+        }
+
+        if (cgroup_controllers_contain(controllers, "freezer")) {
+            nret = snprintf(path, sizeof(path), "%s/freezer%s", CGROUP_MOUNTPOINT, cgpath);
+            if (nret < 0 || (size_t)nret >= sizeof(path)) {
+                return -1;
+            }
+            /* FREEZING is neither, leave it to the runtime */
+            return read_cgroup_frozen_file(path, "freezer.state", "FROZEN", "THAWED");
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Derive the container status from the shim pid file, the container pid file,
+ * /proc and the freezer cgroup, without forking the runtime state command.
+ * Only certain answers are returned, everything else is left to the runtime.
+ */
+static int fast_container_status(const char *workdir, const char *runtime, const char *id,
+                                 struct runtime_container_status_info *status)
+{
+    char fname[PATH_MAX] = { 0 };
+    int shim_pid = 0;
+    int pid = 0;
+    int frozen = 0;
+    int nret = 0;
+    proc_t *proc = NULL;
+    int ret = FAST_STATUS_AMBIGUOUS;
+
+    nret = snprintf(fname, sizeof(fname), "%s/shim-pid", workdir);
+    if (nret < 0 || (size_t)nret >= sizeof(fname)) {
+        return FAST_STATUS_AMBIGUOUS;
+    }
+    file_read_int(fname, &shim_pid);
+
+    nret = snprintf(fname, sizeof(fname), "%s/pid", workdir);
+    if (nret < 0 || (size_t)nret >= sizeof(fname)) {
+        return FAST_STATUS_AMBIGUOUS;
+    }
+    file_read_int(fname, &pid);
+    if (shim_pid <= 0 || pid <= 0) {
+        return FAST_STATUS_AMBIGUOUS;
+    }
+
+    /* created but not started yet, the init process is still waiting on the exec fifo */
+    nret = snprintf(fname, sizeof(fname), "%s/%s/%s/exec.fifo", workdir, runtime, id);
+    if (nret < 0 || (size_t)nret >= sizeof(fname) || util_file_exists(fname)) {
+        return FAST_STATUS_AMBIGUOUS;
+    }
+
+    proc = util_get_process_proc_info(pid);
+    if (proc == NULL) {
+        /* the shim is the subreaper of the container, a vanished init process means it exited */
+        if (kill(pid, 0) != 0 && errno == ESRCH) {
+            status->status = RUNTIME_CONTAINER_STATUS_STOPPED;
+            ret = FAST_STATUS_DECIDED;
+        }
+        goto out;
+    }
+
+    /* the pid may have been reused, or the runtime does not run the container under the shim */
+    if (proc->ppid != shim_pid) {
+        goto out;
+    }
+
+    if (proc->state == 'Z' || proc->state == 'X') {
+        status->status = RUNTIME_CONTAINER_STATUS_STOPPED;
+        ret = FAST_STATUS_DECIDED;
+        goto out;
+    }
+
+    frozen = cgroup_frozen_state(pid);
+    if (frozen < 0) {
+        goto out;
+    }
+
+    status->status = frozen == 1 ? RUNTIME_CONTAINER_STATUS_PAUSED : RUNTIME_CONTAINER_STATUS_RUNNING;
+    status->pid = pid;
+    status->has_pid = true;
+    ret = FAST_STATUS_DECIDED;
+
+out:
+    free(proc);
+    return ret;
+}
+
 static int runtime_call_stats(const char *workdir, const char *runtime, const char *id,
                               struct runtime_container_resources_stats_info *info)
 {
@@ -940,12 +1117,138 @@ out:
     return ret;
 }
 
+static int64_t elapsed_ms_since(const struct timespec *beg)
+{
+    struct timespec now = { 0 };
+
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) {
+        return -1;
+    }
+
+    return (int64_t)(now.tv_sec - beg->tv_sec) * 1000 + (now.tv_nsec - beg->tv_nsec) / 1000000;
+}
+
+static int open_pidfd(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+    (void)pid;
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+/* pidfd of the shim lets us sleep until it exits instead of probing it with kill(0) */
+static int open_shim_pidfd(const char *workdir)
+{
+    int pid = 0;
+    char fpid[PATH_MAX] = { 0 };
+
+    int nret = snprintf(fpid, sizeof(fpid), "%s/shim-pid", workdir);
+    if (nret < 0 || (size_t)nret >= sizeof(fpid)) {
+        return -1;
+    }
+
+    file_read_int(fpid, &pid);
+    if (pid <= 0) {
+        return -1;
+    }
+
+    return open_pidfd(pid);
+}
+
+static void create_pid_sync_fifo(const char *workdir)
+{
+    char fname[PATH_MAX] = { 0 };
+
+    int nret = snprintf(fname, sizeof(fname), "%s/%s", workdir, PID_SYNC_FIFO_NAME);
+    if (nret < 0 || (size_t)nret >= sizeof(fname)) {
+        return;
+    }
+
+    if (mkfifo(fname, 0600) != 0 && errno != EEXIST) {
+        SYSWARN("Failed to create pid sync fifo %s, fall back to polling pid file", fname);
+    }
+}
+
+/*
+ * Wait for an event on the pid sync fifo or the shim pidfd.
+ * Returns 1 with *pid set when the shim reported its create result, 0 when the
+ * caller should recheck the pid file, -1 on error.
+ */
+static int wait_pid_sync_event(int *sync_fd, int pidfd, int timeout_ms, int *pid)
+{
+    struct pollfd pfds[2] = { 0 };
+    nfds_t nfds = 0;
+    char buf[32] = { 0 };
+    ssize_t nread = 0;
+    int val = 0;
+
+    if (*sync_fd < 0) {
+        util_usleep_nointerupt(PID_POLL_INTERVAL_MS * 1000);
+        return 0;
+    }
+
+    pfds[nfds].fd = *sync_fd;
+    pfds[nfds].events = POLLIN;
+    nfds++;
+    if (pidfd >= 0) {
+        pfds[nfds].fd = pidfd;
+        pfds[nfds].events = POLLIN;
+        nfds++;
+    } else if (timeout_ms > PID_POLL_INTERVAL_MS) {
+        /* without pidfd shim death is only noticed by the periodic liveness check */
+        timeout_ms = PID_POLL_INTERVAL_MS;
+    }
+
+    if (poll(pfds, nfds, timeout_ms) < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        SYSERROR("Failed to poll pid sync fifo");
+        return -1;
+    }
+
+    if ((pfds[0].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+        return 0;
+    }
+
+    nread = util_read_nointr(*sync_fd, buf, sizeof(buf) - 1);
+    if (nread <= 0) {
+        if (nread == 0 || errno != EAGAIN) {
+            /* writer went away without a message, only the pid file is left */
+            close(*sync_fd);
+            *sync_fd = -1;
+        }
+        return 0;
+    }
+
+    if (util_safe_int(buf, &val) != 0) {
+        ERROR("Invalid pid sync message: %s", buf);
+        return -1;
+    }
+    *pid = val;
+    return 1;
+}
+
+/*
+ * The shim reports the container process pid over the pid sync fifo as soon as
+ * the runtime created it, so we block on the fifo and the shim pidfd rather than
+ * polling the pid file. The pid file is still the source of truth for restore
+ * and for shims that predate the fifo.
+ */
 static int get_container_process_pid(const char *workdir)
 {
     char fname[PATH_MAX] = { 0 };
+    char sync_fname[PATH_MAX] = { 0 };
     int pid = 0;
+    int sync_pid = 0;
+    int sync_fd = -1;
+    int pidfd = -1;
+    int64_t remain_ms = 0;
+    int ret = 0;
     struct timespec beg = { 0 };
-    struct timespec end = { 0 };
 
     int nret = snprintf(fname, sizeof(fname), "%s/pid", workdir);
     if (nret < 0 || (size_t)nret >= sizeof(fname)) {
@@ -953,32 +1256,72 @@ static int get_container_process_pid(const char *workdir)
         return -1;
     }
 
+    nret = snprintf(sync_fname, sizeof(sync_fname), "%s/%s", workdir, PID_SYNC_FIFO_NAME);
+    if (nret < 0 || (size_t)nret >= sizeof(sync_fname)) {
+        ERROR("failed make pid sync fifo full path");
+        return -1;
+    }
+
     if (clock_gettime(CLOCK_MONOTONIC, &beg) != 0) {
         ERROR("failed get time");
         return -1;
     }
 
+    /* open the fifo before checking the pid file, so a notification cannot slip in between */
+    if (util_file_exists(sync_fname)) {
+        sync_fd = util_open(sync_fname, O_RDONLY | O_NONBLOCK | O_CLOEXEC, 0);
+        if (sync_fd < 0) {
+            SYSWARN("Failed to open pid sync fifo %s", sync_fname);
+        } else {
+            pidfd = open_shim_pidfd(workdir);
+        }
+    }
+
     while (1) {
-        if (clock_gettime(CLOCK_MONOTONIC, &end) != 0) {
-            ERROR("failed get time");
-            return -1;
+        file_read_int(fname, &pid);
+        if (pid > 0) {
+            break;
+        }
+        if (!shim_alive(workdir)) {
+            ERROR("failed read pid from dead shim %s", workdir);
+            pid = -1;
+            break;
         }
-        if (end.tv_sec - beg.tv_sec > PID_WAIT_TIME) {
+
+        remain_ms = (int64_t)PID_WAIT_TIME * 1000 - elapsed_ms_since(&beg);
+        if (remain_ms <= 0) {
             ERROR("wait container process pid timeout %s", workdir);
-            return -1;
+            pid = -1;
+            break;
         }
-        file_read_int(fname, &pid);
-        if (!pid) {
-            if (shim_alive(workdir)) {
-                util_usleep_nointerupt(100000);
-                continue;
+
+        ret = wait_pid_sync_event(&sync_fd, pidfd, (int)remain_ms, &sync_pid);
+        if (ret < 0) {
+            pid = -1;
+            break;
+        }
+        if (ret > 0) {
+            if (sync_pid <= 0) {
+                ERROR("shim failed to create container process %s", workdir);
+                pid = -1;
+            } else {
+                pid = sync_pid;
             }
-            ERROR("failed read pid from dead shim %s", workdir);
-            return -1;
+            break;
         }
-        return pid; /* success */
     }
-    return -1;
+
+    if (sync_fd >= 0) {
+        close(sync_fd);
+        if (unlink(sync_fname) != 0 && errno != ENOENT) {
+            SYSWARN("Failed to remove pid sync fifo %s", sync_fname);
+        }
+    }
+    if (pidfd >= 0) {
+        close(pidfd);
+    }
+
+    return pid;
 }
 
 static void shim_kill_force(const char *workdir)
@@ -1051,6 +1394,8 @@ int rt_isula_create(const char *id, const char *runtime, const rt_create_params_
         goto out;
     }
 
+    create_pid_sync_fifo(workdir);
+
     get_runtime_cmd(runtime, &cmd);
     ret = shim_create(false, id, workdir, params->bundle, cmd, NULL, NULL, &shim_exit_code);
     if (ret != 0) {
@@ -1074,12 +1419,20 @@ int rt_isula_start(const char *id, const char *runtime, const rt_start_params_t
     int nret = 0;
     __isula_auto_free proc_t *proc = NULL;
     __isula_auto_free proc_t *p_proc = NULL;
+    struct timespec beg = { 0 };
+    int64_t wait_pid_ms = 0;
+    int64_t proc_info_ms = 0;
 
     if (id == NULL || runtime == NULL || params == NULL || pid_info == NULL) {
         ERROR("nullptr arguments not allowed");
         return -1;
     }
 
+    if (clock_gettime(CLOCK_MONOTONIC, &beg) != 0) {
+        ERROR("failed get time");
+        return -1;
+    }
+
     nret = snprintf(workdir, sizeof(workdir), "%s/%s", params->state, id);
     if (nret < 0 || (size_t)nret >= sizeof(workdir)) {
         ERROR("%s: missing shim workdir", id);
@@ -1097,6 +1450,7 @@ int rt_isula_start(const char *id, const char *runtime, const rt_start_params_t
         ERROR("%s: failed wait init pid", id);
         goto out;
     }
+    wait_pid_ms = elapsed_ms_since(&beg);
 
     file_read_int(shim_pid_file_name, &shim_pid);
     if (shim_pid < 0) {
@@ -1120,12 +1474,16 @@ int rt_isula_start(const char *id, const char *runtime, const rt_start_params_t
     pid_info->start_time = proc->start_time;
     pid_info->ppid = shim_pid;
     pid_info->pstart_time = p_proc->start_time;
+    proc_info_ms = elapsed_ms_since(&beg);
 
     if (runtime_call_simple(workdir, runtime, "start", NULL, 0, id, NULL) != 0) {
         ERROR("call runtime start id failed");
         goto out;
     }
 
+    INFO("%s: start phases: wait pid %lldms, read proc info %lldms, runtime start %lldms", id,
+         (long long)wait_pid_ms, (long long)(proc_info_ms - wait_pid_ms),
+         (long long)(elapsed_ms_since(&beg) - proc_info_ms));
     ret = 0;
 out:
     if (ret != 0) {
@@ -1299,6 +1657,228 @@ static int preparation_exec(const char *id, const char *runtime, const char *wor
     return 0;
 }
 
+/*
+ * A probe exec (sync, no stdin, no tty) does not need a shim: the runtime exec
+ * runs in the foreground straight from isulad, writes the output into the exec
+ * fifos and exits with the exit status of the process. This saves the double
+ * forked shim for every health check and CRI ExecSync.
+ */
+static bool probe_exec_enabled(const char *runtime, const rt_exec_params_t *params)
+{
+    if (params->spec == NULL || params->spec->terminal || params->attach_stdin) {
+        return false;
+    }
+
+    if (params->console_fifos[0] != NULL || (params->console_fifos[1] == NULL && params->console_fifos[2] == NULL)) {
+        return false;
+    }
+
+    // vm based runtimes manage the exec io on their own
+    return strcasecmp(runtime, "kata-runtime") != 0;
+}
+
+static int open_probe_stdio(const char *fifo, int flags)
+{
+    if (fifo == NULL) {
+        return util_open("/dev/null", flags, 0);
+    }
+
+    return util_open(fifo, flags, 0);
+}
+
+typedef struct {
+    runtime_exec_info *rei;
+    const rt_exec_params_t *params;
+    int err_fd;
+} probe_exec_info;
+
+static void probe_exec_func(const probe_exec_info *info)
+{
+    int fds[3] = { -1, -1, -1 };
+    int i = 0;
+
+    fds[0] = util_open("/dev/null", O_RDONLY, 0);
+    fds[1] = open_probe_stdio(info->params->console_fifos[1], O_WRONLY);
+    fds[2] = open_probe_stdio(info->params->console_fifos[2], O_WRONLY);
+    for (i = 0; i < 3; i++) {
+        if (fds[i] < 0 || dup2(fds[i], i) < 0) {
+            (void)dprintf(info->err_fd, "failed to setup stdio %d of probe exec: %s", i, strerror(errno));
+            _exit(EXIT_FAILURE);
+        }
+    }
+
+    if (chdir(info->rei->workdir) < 0) {
+        (void)dprintf(info->err_fd, "chdir %s failed", info->rei->workdir);
+        _exit(EXIT_FAILURE);
+    }
+
+    if (setsid() < 0) {
+        (void)dprintf(info->err_fd, "failed setsid for process %d", getpid());
+        _exit(EXIT_FAILURE);
+    }
+
+    if (util_check_inherited(true, info->err_fd) != 0) {
+        (void)dprintf(info->err_fd, "close inherited fds failed");
+        _exit(EXIT_FAILURE);
+    }
+
+    execvp(info->rei->cmd, info->rei->params);
+    (void)dprintf(info->err_fd, "exec %s exec %s failed: %s", info->rei->cmd, info->rei->id, strerror(errno));
+    _exit(EXIT_FAILURE);
+}
+
+/* kill the exec process first, the runtime exits once it is gone */
+static void kill_probe_exec(const char *workdir, pid_t runtime_pid)
+{
+    char fname[PATH_MAX] = { 0 };
+    int pid = 0;
+    int nret = 0;
+
+    nret = snprintf(fname, sizeof(fname), "%s/pid", workdir);
+    if (nret >= 0 && (size_t)nret < sizeof(fname)) {
+        file_read_int(fname, &pid);
+    }
+    if (pid > 0 && kill(pid, SIGKILL) != 0 && errno != ESRCH) {
+        SYSWARN("Failed to kill probe exec process %d", pid);
+    }
+    if (kill(runtime_pid, SIGKILL) != 0 && errno != ESRCH) {
+        SYSWARN("Failed to kill runtime process %d", runtime_pid);
+    }
+}
+
+/* return 0 if the process exited in time, 1 on timeout and -1 on error */
+static int wait_probe_exit(pid_t pid, int64_t timeout_sec)
+{
+    struct pollfd pfd = { 0 };
+    int nret = 0;
+
+    if (timeout_sec <= 0) {
+        return 0;
+    }
+
+    pfd.fd = open_pidfd(pid);
+    if (pfd.fd < 0) {
+        return -1;
+    }
+    pfd.events = POLLIN;
+
+    do {
+        nret = poll(&pfd, 1, timeout_sec > INT_MAX / 1000 ? -1 : (int)(timeout_sec * 1000));
+    } while (nret < 0 && errno == EINTR);
+    close(pfd.fd);
+
+    if (nret < 0) {
+        SYSERROR("Failed to poll pidfd of process %d", pid);
+        return -1;
+    }
+
+    return nret == 0 ? 1 : 0;
+}
+
+static void probe_exec_timeout_cb(pid_t pid)
+{
+    (void)kill(pid, SIGKILL);
+}
+
+static int probe_exec(const char *id, const char *runtime, const char *workdir, const rt_exec_params_t *params,
+                      int *exit_code)
+{
+    int nret = 0;
+    int status = 0;
+    bool reaped = false;
+    pid_t pid = 0;
+    int err_pipe[2] = { -1, -1 };
+    char buf[BUFSIZ + 1] = { 0 };
+    char root_path[PATH_MAX] = { 0 };
+    char pid_file[PATH_MAX] = { 0 };
+    char *rei_params[PARAM_NUM] = { 0 };
+    const char *opts[] = { "--process", "process.json", "--pid-file", pid_file };
+    runtime_exec_info rei = { 0 };
+    probe_exec_info info = { 0 };
+
+    nret = snprintf(root_path, sizeof(root_path), "%s/%s/%s", params->state, id, runtime);
+    if (nret < 0 || (size_t)nret >= sizeof(root_path)) {
+        ERROR("Failed to sprintf root_path");
+        return -1;
+    }
+
+    nret = snprintf(pid_file, sizeof(pid_file), "%s/pid", workdir);
+    if (nret < 0 || (size_t)nret >= sizeof(pid_file)) {
+        ERROR("Failed to sprintf pid file path");
+        return -1;
+    }
+
+    if (runtime_exec_info_init(&rei, workdir, root_path, runtime, "exec", opts, sizeof(opts) / sizeof(opts[0]), id,
+                               rei_params, PARAM_NUM) != 0) {
+        ERROR("Failed to init runtime exec info");
+        return -1;
+    }
+
+    if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+        SYSERROR("Failed to create pipe for probe exec");
+        return -1;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        SYSERROR("Failed fork for probe exec");
+        close(err_pipe[0]);
+        close(err_pipe[1]);
+        return -1;
+    }
+
+    if (pid == (pid_t)0) {
+        close(err_pipe[0]);
+        info.rei = &rei;
+        info.params = params;
+        info.err_fd = err_pipe[1];
+        probe_exec_func(&info);
+    }
+
+    close(err_pipe[1]);
+    nret = util_read_nointr(err_pipe[0], buf, sizeof(buf) - 1);
+    close(err_pipe[0]);
+    if (nret > 0) {
+        ERROR("Probe exec failed: %s", buf);
+        (void)util_wait_for_pid_status(pid);
+        return -1;
+    }
+
+    nret = wait_probe_exit(pid, params->timeout);
+    if (nret < 0) {
+        // no pidfd, fall back to polling waitpid which also reaps the process
+        status = util_waitpid_with_timeout(pid, params->timeout, probe_exec_timeout_cb);
+        reaped = true;
+        nret = status < 0 ? 1 : 0;
+    }
+    if (nret == 1) {
+        kill_probe_exec(workdir, pid);
+        if (!reaped) {
+            (void)util_wait_for_pid_status(pid);
+        }
+        isulad_set_error_message("Exec container error;exec timeout");
+        ERROR("Probe exec %s of container %s timeout", workdir, id);
+        return -1;
+    }
+    if (!reaped) {
+        status = util_wait_for_pid_status(pid);
+    }
+    if (status < 0) {
+        SYSERROR("Failed wait runtime exec %d exit", pid);
+        return -1;
+    }
+
+    // the pid file is written once the process is started, without it the runtime failed
+    if (!util_file_exists(pid_file)) {
+        ERROR("%s: runtime failed to start probe exec process", workdir);
+        isulad_set_error_message("Exec container error;runtime failed to start exec process");
+        return -1;
+    }
+
+    *exit_code = status_to_exit_code(status);
+    return 0;
+}
+
 int rt_isula_exec(const char *id, const char *runtime, const rt_exec_params_t *params, int *exit_code)
 {
     const char *cmd = NULL;
@@ -1343,6 +1923,11 @@ int rt_isula_exec(const char *id, const char *runtime, const rt_exec_params_t *p
         goto del_out;
     }
 
+    if (probe_exec_enabled(runtime, params)) {
+        ret = probe_exec(id, runtime, workdir, params, exit_code);
+        goto del_out;
+    }
+
     get_runtime_cmd(runtime, &cmd);
 
     // execSync timeout
@@ -1417,6 +2002,12 @@ int rt_isula_status(const char *id, const char *runtime, const rt_status_params_
         goto out;
     }
 
+    if (fast_container_status(workdir, runtime, id, status) == FAST_STATUS_DECIDED) {
+        DEBUG("container %s status %d pid %d derived without runtime", id, status->status, status->pid);
+        ret = 0;
+        goto out;
+    }
+
     ret = runtime_call_status(workdir, runtime, id, status);
 
 out:
@@ -17,6 +17,7 @@
 
 #include "shim_rt_ops.h"
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
@@ -31,6 +32,8 @@
 #include "engine.h"
 #include "shim_rt_monitor.h"
 #include "supervisor.h"
+#include "specs_api.h"
+#include "cgroup.h"
 
 #define EXIT_SIGNAL_OFFSET_X 128
 
@@ -729,11 +732,113 @@ int rt_shim_listpids(const char *id, const char *runtime, const rt_listpids_para
     return 0;
 }
 
+/*
+ * The shim v2 client has no stats call, sample the cgroup of the container in process
+ * instead, the cgroup path is the one isulad merged into the oci config on create.
+ */
+#define SHIM_SANDBOX_ID_ANNOTATION "io.kubernetes.cri.sandbox-id"
+
+static int get_oci_cgroup_metrics(const char *id, const oci_runtime_spec *oci_spec, cgroup_metrics_t *metrics)
+{
+    int ret = -1;
+    int cgroup_version = 0;
+    char *cgroup_path = NULL;
+
+    if (oci_spec->linux == NULL || oci_spec->linux->cgroups_path == NULL) {
+        WARN("%s: no cgroup path in oci config", id);
+        return -1;
+    }
+
+    cgroup_path = common_cgroup_path_from_oci(oci_spec->linux->cgroups_path);
+    if (cgroup_path == NULL) {
+        return -1;
+    }
+
+    cgroup_version = common_get_cgroup_version();
+    if (cgroup_version == CGROUP_VERSION_1) {
+        ret = common_get_cgroup_v1_metrics(cgroup_path, metrics);
+    } else if (cgroup_version == CGROUP_VERSION_2) {
+        ret = common_get_cgroup_v2_metrics(cgroup_path, metrics);
+    } else {
+        ERROR("Invalid cgroup version");
+    }
+    if (ret != 0) {
+        WARN("%s: failed to get cgroup metrics of %s", id, cgroup_path);
+    }
+
+    free(cgroup_path);
+    return ret;
+}
+
+static const char *get_sandbox_id(const char *id, const oci_runtime_spec *oci_spec)
+{
+    size_t i;
+
+    if (oci_spec->annotations == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < oci_spec->annotations->len; i++) {
+        if (strcmp(oci_spec->annotations->keys[i], SHIM_SANDBOX_ID_ANNOTATION) == 0) {
+            const char *sandbox_id = oci_spec->annotations->values[i];
+            return (sandbox_id != NULL && strcmp(sandbox_id, id) != 0) ? sandbox_id : NULL;
+        }
+    }
+
+    return NULL;
+}
+
 int rt_shim_resources_stats(const char *id, const char *runtime, const rt_stats_params_t *params,
                             struct runtime_container_resources_stats_info *rs_stats)
 {
-    ERROR("rt_shim_resources_stats not impl");
-    return -1;
+    int ret = -1;
+    const char *sandbox_id = NULL;
+    oci_runtime_spec *oci_spec = NULL;
+    oci_runtime_spec *sandbox_spec = NULL;
+    cgroup_metrics_t metrics = { 0 };
+
+    if (id == NULL || params == NULL || params->rootpath == NULL || rs_stats == NULL) {
+        ERROR("Invalid input params");
+        return -1;
+    }
+
+    oci_spec = load_oci_config(params->rootpath, id);
+    if (oci_spec == NULL) {
+        ERROR("%s: failed to load oci config", id);
+        goto out;
+    }
+
+    ret = get_oci_cgroup_metrics(id, oci_spec, &metrics);
+    if (ret != 0) {
+        // vm based runtimes like kata with sandbox_cgroup_only only create the sandbox cgroup,
+        // the container processes run inside the guest and are accounted there
+        sandbox_id = get_sandbox_id(id, oci_spec);
+        if (sandbox_id == NULL) {
+            ERROR("%s: failed to get cgroup metrics", id);
+            goto out;
+        }
+        sandbox_spec = load_oci_config(params->rootpath, sandbox_id);
+        if (sandbox_spec == NULL || get_oci_cgroup_metrics(sandbox_id, sandbox_spec, &metrics) != 0) {
+            ERROR("%s: failed to get cgroup metrics of container and sandbox %s", id, sandbox_id);
+            ret = -1;
+            goto out;
+        }
+        ret = 0;
+    }
+
+    rs_stats->pids_current = metrics.cgpids_metrics.pid_current;
+    rs_stats->cpu_use_nanos = metrics.cgcpu_metrics.cpu_use_nanos;
+    rs_stats->mem_used = metrics.cgmem_metrics.mem_used;
+    rs_stats->mem_limit = metrics.cgmem_metrics.mem_limit;
+    rs_stats->rss_bytes = metrics.cgmem_metrics.total_rss;
+    rs_stats->page_faults = metrics.cgmem_metrics.total_pgfault;
+    rs_stats->major_page_faults = metrics.cgmem_metrics.total_pgmajfault;
+    rs_stats->inactive_file_total = metrics.cgmem_metrics.total_inactive_file;
+
+out:
+    free_oci_runtime_spec(sandbox_spec);
+    free_oci_runtime_spec(oci_spec);
+    return ret;
 }
 
 int rt_shim_resize(const char *id, const char *runtime, const rt_resize_params_t *params)
@@ -112,7 +112,7 @@ int create_daemon_fifos(const char *id, const char *runtime, bool attach_stdin,
 {
     int nret;
     int ret = -1;
-    char *statepath = NULL;
+    char statepath[PATH_MAX] = { 0 };
     char subpath[PATH_MAX] = { 0 };
     char fifodir[PATH_MAX] = { 0 };
     struct timespec now;
@@ -126,8 +126,7 @@ int create_daemon_fifos(const char *id, const char *runtime, bool attach_stdin,
 
     tid = pthread_self();
 
-    statepath = conf_get_routine_statedir(runtime);
-    if (statepath == NULL) {
+    if (conf_snapshot_routine_statedir(runtime, statepath, sizeof(statepath)) != 0) {
         ERROR("State path is NULL");
         goto cleanup;
     }
@@ -152,7 +151,6 @@ int create_daemon_fifos(const char *id, const char *runtime, bool attach_stdin,
 
     ret = 0;
 cleanup:
-    free(statepath);
     return ret;
 }
 
@@ -451,7 +449,7 @@ static void *io_copy_thread_main(void *arg)
 
     sem_post(&thread_arg->wait_sem);
     posted = true;
-    (void)console_loop_io_copy(sync_fd, srcfds, writers, channels, len);
+    (void)console_loop_io_copy(sync_fd, srcfds, outfds, writers, channels, len);
 err:
     if (!posted) {
         sem_post(&thread_arg->wait_sem);
@@ -762,6 +762,12 @@ static int do_start_container(container_t *cont, const char *console_fifos[], bo
         goto close_exit_fd;
     }
 
+    if (cont->common_config->base_fs != NULL &&
+        im_prefetch_container_rootfs(cont->common_config->image_type, cont->common_config->image, id,
+                                     cont->common_config->base_fs, oci_spec->annotations) != 0) {
+        WARN("Failed to prefetch rootfs for container %s", id);
+    }
+
     nret = setup_ipc_dirs(cont->hostconfig, cont->common_config);
     if (nret != 0) {
         ERROR("Failed to setup ipc dirs");
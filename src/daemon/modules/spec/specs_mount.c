@@ -2559,7 +2559,7 @@ out:
 static char *get_prepare_share_shm_path(const char *truntime, const char *cid)
 {
 #define SHM_MOUNT_FILE_NAME "/mounts/shm"
-    char *c_root_path = NULL;
+    char c_root_path[PATH_MAX] = { 0 };
     size_t slen = 0;
     char *spath = NULL;
     char real_root_path[PATH_MAX] = { 0 };
@@ -2570,8 +2570,7 @@ static char *get_prepare_share_shm_path(const char *truntime, const char *cid)
         ERROR("Failed to set runtime");
         return NULL;
     }
-    c_root_path = conf_get_routine_rootdir(truntime);
-    if (c_root_path == NULL) {
+    if (conf_snapshot_routine_rootdir(truntime, c_root_path, sizeof(c_root_path)) != 0) {
         goto err_out;
     }
 
@@ -2598,12 +2597,10 @@ static char *get_prepare_share_shm_path(const char *truntime, const char *cid)
         goto err_out;
     }
 
-    free(c_root_path);
     return spath;
 
 err_out:
     free(spath);
-    free(c_root_path);
     return NULL;
 }
 
@@ -23,6 +23,8 @@
 #include <linux/capability.h>
 #include <stdint.h>
 #include <strings.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #include "isula_libutils/log.h"
 #include "isula_libutils/oci_runtime_spec.h"
@@ -37,6 +39,7 @@
 #include "utils_array.h"
 #include "utils_string.h"
 #include "utils_verify.h"
+#include "map.h"
 
 #define MAX_CAP_LEN 32
 
@@ -730,26 +733,228 @@ done:
     return oci_seccomp_spec;
 }
 
-int merge_default_seccomp_spec(oci_runtime_spec *oci_spec, const defs_process_capabilities *capabilities)
+/*
+ * default seccomp profiles already translated to oci format, keyed by the bounding capabilities
+ * they were filtered with. Parsing the default profile and filtering its syscalls is the same
+ * for every container with the same capabilities, until the profile file is changed.
+ */
+static map_t *g_default_seccomp_templates = NULL; // map string oci_runtime_config_linux_seccomp
+static struct timespec g_default_seccomp_mtime = { 0 };
+static off_t g_default_seccomp_size = 0;
+// bumped whenever the templates are dropped, a template built under an older generation is not kept
+static uint64_t g_default_seccomp_generation = 0;
+static pthread_mutex_t g_default_seccomp_templates_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void default_seccomp_template_kvfree(void *key, void *value)
 {
-    oci_runtime_config_linux_seccomp *oci_seccomp_spec = NULL;
-    docker_seccomp *docker_seccomp_spec = NULL;
+    free(key);
+    free_oci_runtime_config_linux_seccomp((oci_runtime_config_linux_seccomp *)value);
+}
 
-    if (oci_spec == NULL || oci_spec->process == NULL || oci_spec->process->capabilities == NULL) {
-        return 0;
+static char *default_seccomp_template_key(const defs_process_capabilities *capabilities)
+{
+    if (capabilities == NULL || capabilities->bounding_len == 0) {
+        return util_strdup_s("");
+    }
+
+    return util_string_join(",", (const char **)capabilities->bounding, capabilities->bounding_len);
+}
+
+static defs_syscall *dup_oci_syscall(const defs_syscall *src)
+{
+    size_t i = 0;
+    defs_syscall *dst = NULL;
+
+    dst = util_common_calloc_s(sizeof(defs_syscall));
+    if (dst == NULL) {
+        return NULL;
+    }
+
+    dst->names = util_str_array_dup((const char **)src->names, src->names_len);
+    if (src->names_len > 0 && dst->names == NULL) {
+        goto err_out;
+    }
+    dst->names_len = src->names_len;
+    dst->action = util_strdup_s(src->action);
+
+    if (src->args_len == 0) {
+        return dst;
+    }
+    dst->args = util_smart_calloc_s(sizeof(defs_syscall_arg *), src->args_len);
+    if (dst->args == NULL) {
+        goto err_out;
+    }
+    for (i = 0; i < src->args_len; i++) {
+        dst->args[i] = util_common_calloc_s(sizeof(defs_syscall_arg));
+        if (dst->args[i] == NULL) {
+            goto err_out;
+        }
+        dst->args_len++;
+        dst->args[i]->index = src->args[i]->index;
+        dst->args[i]->value = src->args[i]->value;
+        dst->args[i]->value_two = src->args[i]->value_two;
+        dst->args[i]->op = util_strdup_s(src->args[i]->op);
+    }
+
+    return dst;
+
+err_out:
+    free_defs_syscall(dst);
+    return NULL;
+}
+
+/* only the fields filled by trans_docker_seccomp_to_oci_format are copied */
+static oci_runtime_config_linux_seccomp *dup_default_seccomp_template(const oci_runtime_config_linux_seccomp *src)
+{
+    size_t i = 0;
+    oci_runtime_config_linux_seccomp *dst = NULL;
+
+    dst = util_common_calloc_s(sizeof(oci_runtime_config_linux_seccomp));
+    if (dst == NULL) {
+        return NULL;
+    }
+
+    dst->default_action = util_strdup_s(src->default_action);
+    dst->architectures = util_str_array_dup((const char **)src->architectures, src->architectures_len);
+    if (src->architectures_len > 0 && dst->architectures == NULL) {
+        goto err_out;
+    }
+    dst->architectures_len = src->architectures_len;
+
+    if (src->syscalls_len == 0) {
+        return dst;
+    }
+    dst->syscalls = util_smart_calloc_s(sizeof(defs_syscall *), src->syscalls_len);
+    if (dst->syscalls == NULL) {
+        goto err_out;
+    }
+    for (i = 0; i < src->syscalls_len; i++) {
+        dst->syscalls[i] = dup_oci_syscall(src->syscalls[i]);
+        if (dst->syscalls[i] == NULL) {
+            goto err_out;
+        }
+        dst->syscalls_len++;
+    }
+
+    return dst;
+
+err_out:
+    free_oci_runtime_config_linux_seccomp(dst);
+    return NULL;
+}
+
+/* drop the templates if the default profile changed since they were built, must hold the lock */
+static void default_seccomp_templates_check_stale(void)
+{
+    struct stat st = { 0 };
+
+    if (stat(SECCOMP_DEFAULT_PATH, &st) != 0) {
+        map_free(g_default_seccomp_templates);
+        g_default_seccomp_templates = NULL;
+        g_default_seccomp_generation++;
+        return;
+    }
+
+    if (g_default_seccomp_templates != NULL && st.st_size == g_default_seccomp_size &&
+        st.st_mtim.tv_sec == g_default_seccomp_mtime.tv_sec && st.st_mtim.tv_nsec == g_default_seccomp_mtime.tv_nsec) {
+        return;
+    }
+
+    map_free(g_default_seccomp_templates);
+    g_default_seccomp_generation++;
+    g_default_seccomp_templates = map_new(MAP_STR_PTR, MAP_DEFAULT_CMP_FUNC, default_seccomp_template_kvfree);
+    if (g_default_seccomp_templates == NULL) {
+        ERROR("Out of memory");
+        return;
     }
+    g_default_seccomp_mtime = st.st_mtim;
+    g_default_seccomp_size = st.st_size;
+}
+
+static oci_runtime_config_linux_seccomp *build_default_seccomp_spec(const defs_process_capabilities *capabilities)
+{
+    oci_runtime_config_linux_seccomp *oci_seccomp_spec = NULL;
+    docker_seccomp *docker_seccomp_spec = NULL;
 
     docker_seccomp_spec = get_seccomp_security_opt_spec(SECCOMP_DEFAULT_PATH);
     if (docker_seccomp_spec == NULL) {
         ERROR("Failed to parse docker format seccomp specification file \"%s\"", SECCOMP_DEFAULT_PATH);
         isulad_set_error_message("failed to parse seccomp file: %s", SECCOMP_DEFAULT_PATH);
-        return -1;
+        return NULL;
     }
     oci_seccomp_spec = trans_docker_seccomp_to_oci_format(docker_seccomp_spec, capabilities);
     free_docker_seccomp(docker_seccomp_spec);
     if (oci_seccomp_spec == NULL) {
         ERROR("Failed to trans docker format seccomp profile to oci standard");
         isulad_set_error_message("Failed to trans docker format seccomp profile to oci standard");
+        return NULL;
+    }
+
+    return oci_seccomp_spec;
+}
+
+static oci_runtime_config_linux_seccomp *get_default_seccomp_spec(const defs_process_capabilities *capabilities)
+{
+    __isula_auto_free char *key = NULL;
+    oci_runtime_config_linux_seccomp *tmpl = NULL;
+    oci_runtime_config_linux_seccomp *oci_seccomp_spec = NULL;
+    uint64_t generation = 0;
+
+    key = default_seccomp_template_key(capabilities);
+    if (key == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+
+    (void)pthread_mutex_lock(&g_default_seccomp_templates_lock);
+    default_seccomp_templates_check_stale();
+    if (g_default_seccomp_templates != NULL) {
+        tmpl = map_search(g_default_seccomp_templates, (void *)key);
+    }
+    if (tmpl != NULL) {
+        oci_seccomp_spec = dup_default_seccomp_template(tmpl);
+        (void)pthread_mutex_unlock(&g_default_seccomp_templates_lock);
+        if (oci_seccomp_spec == NULL) {
+            ERROR("Out of memory");
+        }
+        return oci_seccomp_spec;
+    }
+    generation = g_default_seccomp_generation;
+    (void)pthread_mutex_unlock(&g_default_seccomp_templates_lock);
+
+    // the profile is parsed without the lock, it may be changed and the templates rebuilt meanwhile
+    tmpl = build_default_seccomp_spec(capabilities);
+    if (tmpl == NULL) {
+        return NULL;
+    }
+
+    oci_seccomp_spec = dup_default_seccomp_template(tmpl);
+    if (oci_seccomp_spec == NULL) {
+        ERROR("Out of memory");
+        free_oci_runtime_config_linux_seccomp(tmpl);
+        return NULL;
+    }
+
+    (void)pthread_mutex_lock(&g_default_seccomp_templates_lock);
+    if (g_default_seccomp_templates == NULL || generation != g_default_seccomp_generation ||
+        !map_replace(g_default_seccomp_templates, (void *)key, (void *)tmpl)) {
+        free_oci_runtime_config_linux_seccomp(tmpl);
+    }
+    (void)pthread_mutex_unlock(&g_default_seccomp_templates_lock);
+
+    return oci_seccomp_spec;
+}
+
+int merge_default_seccomp_spec(oci_runtime_spec *oci_spec, const defs_process_capabilities *capabilities)
+{
+    oci_runtime_config_linux_seccomp *oci_seccomp_spec = NULL;
+
+    if (oci_spec == NULL || oci_spec->process == NULL || oci_spec->process->capabilities == NULL) {
+        return 0;
+    }
+
+    oci_seccomp_spec = get_default_seccomp_spec(capabilities);
+    if (oci_seccomp_spec == NULL) {
         return -1;
     }
 
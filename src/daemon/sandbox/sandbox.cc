@@ -93,6 +93,7 @@ Sandbox::Sandbox(const std::string id, const std::string &rootdir, const std::st
     m_state.status = SANDBOX_STATUS_UNKNOWN;
     m_netNsPath = netNsPath;
     m_networkReady = false;
+    m_networkSettingsLoaded = true;
     m_netMode = netMode;
     m_sandboxConfig = std::make_shared<runtime::v1::PodSandboxConfig>(sandboxConfig);
     m_statsInfo = {0, 0};
@@ -191,7 +192,17 @@ auto Sandbox::GetNetNsPath() const -> const std::string &
 
 auto Sandbox::GetNetworkSettings() -> const std::string &
 {
-    ReadGuard<RWMutex> lock(m_stateMutex);
+    {
+        ReadGuard<RWMutex> lock(m_stateMutex);
+        if (m_networkSettingsLoaded) {
+            return m_networkSettings;
+        }
+    }
+
+    WriteGuard<RWMutex> lock(m_stateMutex);
+    if (!m_networkSettingsLoaded) {
+        LoadNetworkSetting();
+    }
     return m_networkSettings;
 }
 
@@ -486,7 +497,8 @@ auto Sandbox::Load(Errors &error) -> bool
         return false;
     }
 
-    LoadNetworkSetting();
+    // the network settings are only needed by the cri status, defer reading them to the first access
+    m_networkSettingsLoaded = false;
 
     if (!UpdateStatus(error)) {
         ERROR("Failed to update status of Sandbox, id='%s'", m_id.c_str());
@@ -986,11 +998,14 @@ auto Sandbox::LoadMetadata(Errors &error) -> bool
     return true;
 }
 
+// m_stateMutex must be held for writing
 void Sandbox::LoadNetworkSetting()
 {
     __isula_auto_free char *settings = NULL;
     const std::string path = GetNetworkSettingsPath();
 
+    m_networkSettingsLoaded = true;
+
     // for the sandbox whose net_mode is host. No need to load networkSetting.
     if (namespace_is_host(m_netMode.c_str())) {
         return;
@@ -1016,6 +1031,7 @@ void Sandbox::SetNetworkSettings(const std::string &settings, Errors &error)
 {
     m_stateMutex.wrlock();
     m_networkSettings = settings;
+    m_networkSettingsLoaded = true;
     m_stateMutex.unlock();
     if (!SaveNetworkSetting(error)) {
         ERROR("Failed to save networkSettings for %s", m_id.c_str());
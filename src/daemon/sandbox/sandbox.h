@@ -198,6 +198,8 @@ private:
     std::string m_networkMode;
     bool m_networkReady;
     std::string m_networkSettings;
+    // the network settings of a restored sandbox are read from disk on first access
+    bool m_networkSettingsLoaded;
     // container id lists
     std::vector<std::string> m_containers;
     RWMutex m_containersMutex;
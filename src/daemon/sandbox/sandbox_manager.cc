@@ -16,7 +16,10 @@
 #include "sandbox_manager.h"
 
 #include <string>
+#include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
 #include <mutex>
 
 #include <isula_libutils/auto_cleanup.h>
@@ -31,8 +34,17 @@
 #include "id_name_manager.h"
 #include "namespace.h"
 #include "utils.h"
+#include "utils_thread_pool.h"
 
 namespace sandbox {
+// restoring a sandbox mostly waits on its controller, a few workers are enough
+const size_t RESTORE_SANDBOX_MAX_THREADS = 8;
+
+struct RestoreSandboxTask {
+    SandboxManager *manager;
+    std::string id;
+};
+
 std::atomic<SandboxManager *> SandboxManager::m_instance;
 
 SandboxManager *SandboxManager::GetInstance() noexcept
@@ -136,31 +148,72 @@ out:
 auto SandboxManager::RestoreSandboxes(Errors &error) -> bool
 {
     std::vector<std::string> subdir;
+    thread_pool_t *pool = nullptr;
 
     if (!ListAllSandboxdir(subdir)) {
         error.SetError("Failed to list sandboxes");
         return false;
     }
 
+    if (subdir.size() > 1) {
+        pool = util_thread_pool_new(util_thread_pool_default_size(std::min(subdir.size(), RESTORE_SANDBOX_MAX_THREADS)),
+                                    0, "SandboxRestore");
+        if (pool == nullptr) {
+            WARN("Failed to create sandbox restore workers, restore sandboxes one by one");
+        }
+    }
+
+    // sandboxes are independent of each other, restore them in parallel
     for (auto &id : subdir) {
-        std::shared_ptr<Sandbox> sandbox = LoadSandbox(id);
-        if (sandbox != nullptr) {
-            SaveSandboxToStore(id, sandbox);
-            continue;
+        if (pool != nullptr) {
+            auto task = new (std::nothrow) RestoreSandboxTask { this, id };
+            if (task != nullptr && util_thread_pool_submit(pool, RestoreSandboxTaskCallback, task) == 0) {
+                continue;
+            }
+            delete task;
         }
-        // If loading fails, delete the residual directory
-        CleanInValidSandboxDir(id);
+        RestoreSandbox(id);
     }
 
+    util_thread_pool_free(pool);
+
     return true;
 }
 
+void SandboxManager::RestoreSandboxTaskCallback(void *arg)
+{
+    std::unique_ptr<RestoreSandboxTask> task(static_cast<RestoreSandboxTask *>(arg));
+
+    task->manager->RestoreSandbox(task->id);
+}
+
+void SandboxManager::RestoreSandbox(std::string &id)
+{
+    std::shared_ptr<Sandbox> sandbox = LoadSandbox(id);
+    if (sandbox != nullptr) {
+        SaveSandboxToStore(id, sandbox);
+        return;
+    }
+    // If loading fails, delete the residual directory
+    CleanInValidSandboxDir(id);
+}
+
 void SandboxManager::ListAllSandboxes(const runtime::v1::PodSandboxFilter &filters,
                                       std::vector<std::shared_ptr<Sandbox>> &sandboxes)
 {
-    // 1. get all sandboxes
     std::vector<std::shared_ptr<Sandbox>> allsandboxes;
-    StoreGetAll(allsandboxes);
+
+    // 1. get all sandboxes, or only the ones matching the label selector from the label index
+    if (filters.label_selector_size() == 0) {
+        StoreGetAll(allsandboxes);
+    } else {
+        for (const auto &id : LabelIndexMatch(filters.label_selector())) {
+            auto sandbox = StoreGetById(id);
+            if (sandbox != nullptr) {
+                allsandboxes.push_back(sandbox);
+            }
+        }
+    }
     // 2. filter sandboxes by filter
     for (const auto &sandbox : allsandboxes) {
         // (1) filter by id
@@ -176,28 +229,7 @@ void SandboxManager::ListAllSandboxes(const runtime::v1::PodSandboxFilter &filte
                 continue;
             }
         }
-        // (3) filter by labels
-        if (filters.label_selector_size() == 0) {
-            sandboxes.push_back(sandbox);
-            continue;
-        }
-
-        if (sandbox->GetMutableSandboxConfig() == nullptr) {
-            continue;
-        }
-
-        bool match = true;
-        auto labels = sandbox->GetMutableSandboxConfig()->labels();
-        for (auto &iter : filters.label_selector()) {
-            auto val = labels.find(iter.first);
-            if (val == labels.end() || val->second != iter.second) {
-                match = false;
-                break;
-            }
-        }
-        if (match) {
-            sandboxes.push_back(sandbox);
-        }
+        sandboxes.push_back(sandbox);
     }
 }
 
@@ -231,6 +263,7 @@ bool SandboxManager::IDNameManagerNewEntry(std::string &id, const std::string &n
 void SandboxManager::SaveSandboxToStore(const std::string &id, std::shared_ptr<Sandbox> sandbox)
 {
     NameIndexAdd(sandbox->GetName(), id);
+    LabelIndexAdd(id, sandbox);
     StoreAdd(id, sandbox);
 }
 
@@ -238,6 +271,7 @@ void SandboxManager::SaveSandboxToStore(const std::string &id, std::shared_ptr<S
 void SandboxManager::DeleteSandboxFromStore(const std::string &id, const std::string &name)
 {
     NameIndexRemove(name);
+    LabelIndexRemove(id);
     StoreRemove(id);
 }
 
@@ -394,6 +428,86 @@ auto SandboxManager::NameIndexGetAll(void) -> std::map<std::string, std::string>
     return m_nameIndexMap;
 }
 
+void SandboxManager::LabelIndexAdd(const std::string &id, std::shared_ptr<Sandbox> sandbox)
+{
+    std::map<std::string, std::string> labels;
+
+    auto config = sandbox->GetMutableSandboxConfig();
+    if (config != nullptr) {
+        labels.insert(config->labels().begin(), config->labels().end());
+    }
+
+    WriteGuard<RWMutex> lock(m_indexRWMutex);
+    LabelIndexEraseLocked(id);
+    for (const auto &label : labels) {
+        m_labelIndexMap[label].insert(id);
+    }
+    m_labelsById[id] = std::move(labels);
+}
+
+void SandboxManager::LabelIndexRemove(const std::string &id)
+{
+    WriteGuard<RWMutex> lock(m_indexRWMutex);
+    LabelIndexEraseLocked(id);
+}
+
+// m_indexRWMutex must be held for writing
+void SandboxManager::LabelIndexEraseLocked(const std::string &id)
+{
+    auto old = m_labelsById.find(id);
+    if (old == m_labelsById.end()) {
+        return;
+    }
+    for (const auto &label : old->second) {
+        auto iter = m_labelIndexMap.find(label);
+        if (iter == m_labelIndexMap.end()) {
+            continue;
+        }
+        iter->second.erase(id);
+        if (iter->second.empty()) {
+            m_labelIndexMap.erase(iter);
+        }
+    }
+    m_labelsById.erase(old);
+}
+
+// Intersect the id sets of all labels in the selector, starting from the smallest one
+auto SandboxManager::LabelIndexMatch(const google::protobuf::Map<std::string, std::string> &selector)
+-> std::set<std::string>
+{
+    std::vector<const std::set<std::string> *> postings;
+    std::set<std::string> result;
+
+    ReadGuard<RWMutex> lock(m_indexRWMutex);
+    for (const auto &label : selector) {
+        auto iter = m_labelIndexMap.find(std::make_pair(label.first, label.second));
+        if (iter == m_labelIndexMap.end()) {
+            return result;
+        }
+        postings.push_back(&iter->second);
+    }
+    if (postings.empty()) {
+        return result;
+    }
+
+    std::sort(postings.begin(), postings.end(),
+              [](const std::set<std::string> *a, const std::set<std::string> *b) { return a->size() < b->size(); });
+    for (const auto &id : *postings[0]) {
+        bool match = true;
+        for (size_t i = 1; i < postings.size(); i++) {
+            if (postings[i]->find(id) == postings[i]->end()) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            result.insert(id);
+        }
+    }
+
+    return result;
+}
+
 auto SandboxManager::GetSandboxRootpath() -> std::string
 {
     __isula_auto_free char *root_path = NULL;
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <map>
+#include <set>
 #include <mutex>
 
 #include "api_v1.grpc.pb.h"
@@ -63,6 +64,11 @@ private:
     auto NameIndexGet(const std::string &name) -> std::string;
     auto NameIndexGetAll(void) -> std::map<std::string, std::string>;
 
+    void LabelIndexAdd(const std::string &id, std::shared_ptr<Sandbox> sandbox);
+    void LabelIndexRemove(const std::string &id);
+    void LabelIndexEraseLocked(const std::string &id);
+    auto LabelIndexMatch(const google::protobuf::Map<std::string, std::string> &selector) -> std::set<std::string>;
+
     auto IDNameManagerRemoveEntry(const std::string &id, const std::string &name) -> bool;
     auto IDNameManagerNewEntry(std::string &id, const std::string &name) -> bool;
 
@@ -73,6 +79,8 @@ private:
     auto GetSandboxStatepath() -> std::string;
     bool ListAllSandboxdir(std::vector<std::string> &allSubdir);
     auto LoadSandbox(std::string &id) -> std::shared_ptr<Sandbox>;
+    void RestoreSandbox(std::string &id);
+    static void RestoreSandboxTaskCallback(void *arg);
     void CleanInValidSandboxDir(const std::string &id);
 
 private:
@@ -83,6 +91,10 @@ private:
     std::map<std::string, std::shared_ptr<Sandbox>> m_storeMap;
     // name --> id map
     std::map<std::string, std::string> m_nameIndexMap;
+    // (label key, label value) --> ids map, label selectors only do exact matches
+    std::map<std::pair<std::string, std::string>, std::set<std::string>> m_labelIndexMap;
+    // id --> labels indexed for the sandbox, so that removal does not depend on the sandbox config
+    std::map<std::string, std::map<std::string, std::string>> m_labelsById;
     // Read-write locks can only be used if the C++ standard is greater than 17
     RWMutex m_storeRWMutex;
     RWMutex m_indexRWMutex;
@@ -12,6 +12,7 @@
  * Create: 2018-11-08
  * Description: provide console definition
  ******************************************************************************/
+#define _GNU_SOURCE /* See feature_test_macros(7) */
 #include "console.h"
 #include <unistd.h>
 #include <limits.h>
@@ -23,6 +24,7 @@
 #include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/ioctl.h>
 
 #include "mainloop.h"
 #include "isula_libutils/log.h"
@@ -106,11 +108,57 @@ static int console_writer_write_data(const struct io_write_wrapper *writer, cons
     return 0;
 }
 
+#define SPLICE_COPY_SIZE (64 * 1024)
+#define SPLICE_RETRY_INTERVAL_US 100
+
+enum {
+    SPLICE_COPY_DONE,
+    SPLICE_COPY_EOF,
+    SPLICE_COPY_FAILED,
+    SPLICE_COPY_FALLBACK,
+};
+
+/* move data from fd to the writer fd inside kernel */
+static int console_splice_copy(struct tty_state *ts, int fd)
+{
+    ssize_t n;
+    int avail = 0;
+
+    for (;;) {
+        n = splice(fd, NULL, ts->splice_writer, NULL, SPLICE_COPY_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (n > 0) {
+            return SPLICE_COPY_DONE;
+        }
+        if (n == 0) {
+            return SPLICE_COPY_EOF;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EINVAL) {
+            // neither side is a pipe, or fd does not support splice
+            ts->use_splice = false;
+            return SPLICE_COPY_FALLBACK;
+        }
+        if (errno != EAGAIN) {
+            SYSERROR("Failed to splice data from %d to %d", fd, ts->splice_writer);
+            return SPLICE_COPY_FAILED;
+        }
+        // nothing to read, let read handle it
+        if (ioctl(fd, FIONREAD, &avail) != 0 || avail == 0) {
+            return SPLICE_COPY_FALLBACK;
+        }
+        // writer is full, wait a while as util_write_nointr_in_total does
+        util_usleep_nointerupt(SPLICE_RETRY_INTERVAL_US);
+    }
+}
+
 static int console_cb_stdio_copy(int fd, uint32_t events, void *cbdata, struct epoll_descr *descr)
 {
     struct tty_state *ts = cbdata;
     char buf[MAX_BUFFER_SIZE] = { 0 };
     int ret = EPOLL_LOOP_HANDLE_CONTINUE;
+    int splice_ret = SPLICE_COPY_FALLBACK;
     ssize_t r_ret;
 
     if (fd != ts->sync_fd && fd != ts->stdin_reader && fd != ts->stdout_reader && fd != ts->stderr_reader) {
@@ -118,7 +166,22 @@ static int console_cb_stdio_copy(int fd, uint32_t events, void *cbdata, struct e
         goto out;
     }
 
-    r_ret = util_read_nointr(fd, buf, sizeof(buf) - 1);
+    if (ts->use_splice && fd != ts->sync_fd) {
+        splice_ret = console_splice_copy(ts, fd);
+        if (splice_ret == SPLICE_COPY_DONE) {
+            goto out;
+        }
+        if (splice_ret == SPLICE_COPY_FAILED) {
+            ret = EPOLL_LOOP_HANDLE_CLOSE;
+            goto out;
+        }
+    }
+
+    if (splice_ret == SPLICE_COPY_EOF) {
+        r_ret = 0;
+    } else {
+        r_ret = util_read_nointr(fd, buf, sizeof(buf) - 1);
+    }
     if (r_ret <= 0) {
         // if we close the sync fd, it means the IO COPY thread had beed made to detached, continue to watch other fds
         if (fd == ts->sync_fd) {
@@ -454,7 +517,7 @@ err_out:
 }
 
 /* console loop copy */
-int console_loop_io_copy(int sync_fd, const int *srcfds, struct io_write_wrapper *writers,
+int console_loop_io_copy(int sync_fd, const int *srcfds, const int *dstfds, struct io_write_wrapper *writers,
                          const transfer_channel_type *channels, size_t len)
 {
     int ret = 0;
@@ -481,6 +544,11 @@ int console_loop_io_copy(int sync_fd, const int *srcfds, struct io_write_wrapper
         ts[i].stdout_reader = -1;
         ts[i].stderr_reader = -1;
         ts[i].sync_fd = -1;
+        ts[i].splice_writer = -1;
+        if (dstfds != NULL && dstfds[i] >= 0) {
+            ts[i].use_splice = true;
+            ts[i].splice_writer = dstfds[i];
+        }
         if (channels[i] == STDIN_CHANNEL) {
             ts[i].stdin_reader = srcfds[i];
             ts[i].stdin_writer.context = writers[i].context;
@@ -41,6 +41,9 @@ struct tty_state {
     /* Flag to mark whether detected escape sequence. */
     int saw_tty_exit;
     bool ignore_stdin_close;
+    /* Writer is a fd which supports splice, move data into it without copying to user space. */
+    bool use_splice;
+    int splice_writer;
 };
 
 typedef enum { STDIN_CHANNEL, STDOUT_CHANNEL, STDERR_CHANNEL, MAX_CHANNEL } transfer_channel_type;
@@ -61,7 +64,8 @@ void console_fifo_close(int fd);
 int console_loop_with_std_fd(int stdinfd, int stdoutfd, int stderrfd, int fifoinfd, int fifooutfd, int fifoerrfd,
                              int tty_exit, bool tty);
 
-int console_loop_io_copy(int sync_fd, const int *srcfds, struct io_write_wrapper *writers,
+/* dstfds can be NULL, otherwise dstfds[i] is the fd of writers[i] or -1 if writer is not a fd */
+int console_loop_io_copy(int sync_fd, const int *srcfds, const int *dstfds, struct io_write_wrapper *writers,
                          const transfer_channel_type *channels, size_t len);
 
 int setup_tios(int fd, struct termios *curr_tios);
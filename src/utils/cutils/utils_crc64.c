@@ -0,0 +1,332 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide crc64 (ISO polynomial) functions
+ ********************************************************************************/
+#define _GNU_SOURCE
+#include "utils_crc64.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define CRC64_HAVE_CLMUL 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define CRC64_HAVE_PMULL 1
+#endif
+
+#include "isula_libutils/log.h"
+#include "utils.h"
+#include "utils_file.h"
+
+// reversed ISO polynomial x^64 + x^4 + x^3 + x + 1
+#define CRC64_ISO_POLY_REV 0xD800000000000000ULL
+
+/*
+ * fold constants, bit reversed (x^n mod P) of the ISO polynomial.
+ * the product of two reversed 64 bits values is shifted by one bit,
+ * so n is one less than the distance to fold.
+ */
+#define CRC64_K_127 0xf500000000000001ULL
+#define CRC64_K_191 0x6b70000000000001ULL
+#define CRC64_K_511 0xb100010100000001ULL
+#define CRC64_K_575 0x01b001b1b0000001ULL
+
+// inputs shorter than this are not worth the setup of carry-less folding
+#define CRC64_CLMUL_MIN_LEN 64
+
+#define CRC64_READ_BUFFER_SIZE (128 * 1024)
+/*
+ * big files are read in big blocks to keep the folding loop busy. They are not mapped, a file
+ * truncated while it is checked would raise SIGBUS on the mapping but only shortens a read.
+ */
+#define CRC64_LARGE_FILE_SIZE (1024 * 1024)
+#define CRC64_LARGE_READ_BUFFER_SIZE (1024 * 1024)
+
+typedef uint64_t (*crc64_update_func_t)(uint64_t crc, const unsigned char *p, size_t len);
+
+static uint64_t g_crc64_table[8][256];
+static crc64_update_func_t g_crc64_raw_update;
+static pthread_once_t g_crc64_once = PTHREAD_ONCE_INIT;
+
+static inline uint64_t crc64_load_le64(const unsigned char *p)
+{
+    uint64_t v = 0;
+    size_t i;
+
+    for (i = 0; i < 8; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+
+    return v;
+}
+
+// crc of @p without pre and post inversion, slicing by 8 bytes
+static uint64_t crc64_raw_update_generic(uint64_t crc, const unsigned char *p, size_t len)
+{
+    while (len >= 8) {
+        crc ^= crc64_load_le64(p);
+        crc = g_crc64_table[7][crc & 0xff] ^ g_crc64_table[6][(crc >> 8) & 0xff] ^
+              g_crc64_table[5][(crc >> 16) & 0xff] ^ g_crc64_table[4][(crc >> 24) & 0xff] ^
+              g_crc64_table[3][(crc >> 32) & 0xff] ^ g_crc64_table[2][(crc >> 40) & 0xff] ^
+              g_crc64_table[1][(crc >> 48) & 0xff] ^ g_crc64_table[0][crc >> 56];
+        p += 8;
+        len -= 8;
+    }
+
+    while (len > 0) {
+        crc = g_crc64_table[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+        p++;
+        len--;
+    }
+
+    return crc;
+}
+
+#ifdef CRC64_HAVE_CLMUL
+__attribute__((target("pclmul,sse2"))) static inline __m128i crc64_clmul_fold(__m128i x, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11));
+}
+
+__attribute__((target("pclmul,sse2"))) static uint64_t crc64_raw_update_clmul(uint64_t crc, const unsigned char *p,
+                                                                             size_t len)
+{
+    // low lane folds the first 8 bytes of a block, high lane folds the last 8 bytes
+    const __m128i k128 = _mm_set_epi64x((long long)CRC64_K_127, (long long)CRC64_K_191);
+    const __m128i k512 = _mm_set_epi64x((long long)CRC64_K_511, (long long)CRC64_K_575);
+    unsigned char rest[16] = { 0 };
+    __m128i x0, x1, x2, x3;
+
+    if (len < CRC64_CLMUL_MIN_LEN) {
+        return crc64_raw_update_generic(crc, p, len);
+    }
+
+    x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)p), _mm_cvtsi64_si128((long long)crc));
+    x1 = _mm_loadu_si128((const __m128i *)(p + 16));
+    x2 = _mm_loadu_si128((const __m128i *)(p + 32));
+    x3 = _mm_loadu_si128((const __m128i *)(p + 48));
+    p += 64;
+    len -= 64;
+
+    // four independent lanes to hide the latency of pclmulqdq
+    while (len >= 64) {
+        x0 = _mm_xor_si128(crc64_clmul_fold(x0, k512), _mm_loadu_si128((const __m128i *)p));
+        x1 = _mm_xor_si128(crc64_clmul_fold(x1, k512), _mm_loadu_si128((const __m128i *)(p + 16)));
+        x2 = _mm_xor_si128(crc64_clmul_fold(x2, k512), _mm_loadu_si128((const __m128i *)(p + 32)));
+        x3 = _mm_xor_si128(crc64_clmul_fold(x3, k512), _mm_loadu_si128((const __m128i *)(p + 48)));
+        p += 64;
+        len -= 64;
+    }
+
+    x1 = _mm_xor_si128(x1, crc64_clmul_fold(x0, k128));
+    x2 = _mm_xor_si128(x2, crc64_clmul_fold(x1, k128));
+    x0 = _mm_xor_si128(x3, crc64_clmul_fold(x2, k128));
+
+    while (len >= 16) {
+        x0 = _mm_xor_si128(crc64_clmul_fold(x0, k128), _mm_loadu_si128((const __m128i *)p));
+        p += 16;
+        len -= 16;
+    }
+
+    // the folded block has the same remainder as all data consumed so far
+    _mm_storeu_si128((__m128i *)rest, x0);
+    crc = crc64_raw_update_generic(0, rest, sizeof(rest));
+
+    return crc64_raw_update_generic(crc, p, len);
+}
+
+static bool crc64_cpu_has_clmul(void)
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+
+    return (ecx & bit_PCLMUL) != 0 && (edx & bit_SSE2) != 0;
+}
+#endif
+
+#ifdef CRC64_HAVE_PMULL
+static inline uint64x2_t crc64_pmull_fold(uint64x2_t x, uint64_t k_lo, uint64_t k_hi)
+{
+    poly128_t lo = vmull_p64((poly64_t)vgetq_lane_u64(x, 0), (poly64_t)k_lo);
+    poly128_t hi = vmull_p64((poly64_t)vgetq_lane_u64(x, 1), (poly64_t)k_hi);
+
+    return veorq_u64(vreinterpretq_u64_p128(lo), vreinterpretq_u64_p128(hi));
+}
+
+static inline uint64x2_t crc64_pmull_load(const unsigned char *p)
+{
+    return vreinterpretq_u64_u8(vld1q_u8(p));
+}
+
+static uint64_t crc64_raw_update_pmull(uint64_t crc, const unsigned char *p, size_t len)
+{
+    unsigned char rest[16] = { 0 };
+    uint64x2_t x0, x1, x2, x3;
+
+    if (len < CRC64_CLMUL_MIN_LEN) {
+        return crc64_raw_update_generic(crc, p, len);
+    }
+
+    x0 = veorq_u64(crc64_pmull_load(p), vcombine_u64(vcreate_u64(crc), vcreate_u64(0)));
+    x1 = crc64_pmull_load(p + 16);
+    x2 = crc64_pmull_load(p + 32);
+    x3 = crc64_pmull_load(p + 48);
+    p += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x0 = veorq_u64(crc64_pmull_fold(x0, CRC64_K_575, CRC64_K_511), crc64_pmull_load(p));
+        x1 = veorq_u64(crc64_pmull_fold(x1, CRC64_K_575, CRC64_K_511), crc64_pmull_load(p + 16));
+        x2 = veorq_u64(crc64_pmull_fold(x2, CRC64_K_575, CRC64_K_511), crc64_pmull_load(p + 32));
+        x3 = veorq_u64(crc64_pmull_fold(x3, CRC64_K_575, CRC64_K_511), crc64_pmull_load(p + 48));
+        p += 64;
+        len -= 64;
+    }
+
+    x1 = veorq_u64(x1, crc64_pmull_fold(x0, CRC64_K_191, CRC64_K_127));
+    x2 = veorq_u64(x2, crc64_pmull_fold(x1, CRC64_K_191, CRC64_K_127));
+    x0 = veorq_u64(x3, crc64_pmull_fold(x2, CRC64_K_191, CRC64_K_127));
+
+    while (len >= 16) {
+        x0 = veorq_u64(crc64_pmull_fold(x0, CRC64_K_191, CRC64_K_127), crc64_pmull_load(p));
+        p += 16;
+        len -= 16;
+    }
+
+    vst1q_u8(rest, vreinterpretq_u8_u64(x0));
+    crc = crc64_raw_update_generic(0, rest, sizeof(rest));
+
+    return crc64_raw_update_generic(crc, p, len);
+}
+#endif
+
+static void crc64_init(void)
+{
+    size_t i, k;
+
+    for (i = 0; i < 256; i++) {
+        uint64_t crc = i;
+        for (k = 0; k < 8; k++) {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ CRC64_ISO_POLY_REV : crc >> 1;
+        }
+        g_crc64_table[0][i] = crc;
+    }
+    for (i = 0; i < 256; i++) {
+        for (k = 1; k < 8; k++) {
+            uint64_t prev = g_crc64_table[k - 1][i];
+            g_crc64_table[k][i] = g_crc64_table[0][prev & 0xff] ^ (prev >> 8);
+        }
+    }
+
+    g_crc64_raw_update = crc64_raw_update_generic;
+#ifdef CRC64_HAVE_CLMUL
+    if (crc64_cpu_has_clmul()) {
+        g_crc64_raw_update = crc64_raw_update_clmul;
+    }
+#endif
+#ifdef CRC64_HAVE_PMULL
+    if ((getauxval(AT_HWCAP) & HWCAP_PMULL) != 0) {
+        g_crc64_raw_update = crc64_raw_update_pmull;
+    }
+#endif
+}
+
+bool util_crc64_accelerated(void)
+{
+    (void)pthread_once(&g_crc64_once, crc64_init);
+
+    return g_crc64_raw_update != crc64_raw_update_generic;
+}
+
+uint64_t util_crc64_iso_update(uint64_t crc, const void *data, size_t len)
+{
+    if (data == NULL || len == 0) {
+        return crc;
+    }
+
+    (void)pthread_once(&g_crc64_once, crc64_init);
+
+    return ~g_crc64_raw_update(~crc, (const unsigned char *)data, len);
+}
+
+uint64_t util_crc64_iso_update_generic(uint64_t crc, const void *data, size_t len)
+{
+    if (data == NULL || len == 0) {
+        return crc;
+    }
+
+    (void)pthread_once(&g_crc64_once, crc64_init);
+
+    return ~crc64_raw_update_generic(~crc, (const unsigned char *)data, len);
+}
+
+int util_file_crc64_iso(const char *file, uint64_t *crc)
+{
+    int ret = 0;
+    int fd = -1;
+    void *buffer = NULL;
+    ssize_t size = 0;
+    size_t buffer_size = CRC64_READ_BUFFER_SIZE;
+    struct stat st = { 0 };
+
+    if (file == NULL || crc == NULL) {
+        return -1;
+    }
+
+    fd = util_open(file, O_RDONLY, 0);
+    if (fd < 0) {
+        SYSERROR("Open file: %s, failed", file);
+        return -1;
+    }
+
+    *crc = 0;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= CRC64_LARGE_FILE_SIZE) {
+        buffer_size = CRC64_LARGE_READ_BUFFER_SIZE;
+    }
+
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    buffer = util_common_calloc_s(buffer_size);
+    if (buffer == NULL) {
+        ERROR("out of memory");
+        ret = -1;
+        goto out;
+    }
+
+    while (true) {
+        size = util_read_nointr(fd, buffer, buffer_size);
+        if (size < 0) {
+            SYSERROR("read file %s failed", file);
+            ret = -1;
+            break;
+        } else if (size == 0) {
+            break;
+        }
+        *crc = util_crc64_iso_update(*crc, buffer, (size_t)size);
+    }
+
+out:
+    close(fd);
+    free(buffer);
+    return ret;
+}
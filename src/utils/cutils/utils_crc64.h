@@ -0,0 +1,45 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide crc64 (ISO polynomial) function definition
+ ********************************************************************************/
+#ifndef UTILS_CUTILS_UTILS_CRC64_H
+#define UTILS_CUTILS_UTILS_CRC64_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Update @crc with @data, the result is the same as go crc64.Update with ISO table
+ * and isula_crc_update of libisula, so checksums in tar split are compatible.
+ * Carry-less multiplication (PCLMULQDQ/PMULL) is used if cpu supports it.
+ */
+uint64_t util_crc64_iso_update(uint64_t crc, const void *data, size_t len);
+
+// portable table driven version, used as fallback
+uint64_t util_crc64_iso_update_generic(uint64_t crc, const void *data, size_t len);
+
+// checksum of a whole file, large files are read in bigger blocks
+int util_file_crc64_iso(const char *file, uint64_t *crc);
+
+bool util_crc64_accelerated(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTILS_CUTILS_UTILS_CRC64_H
@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide fixed size thread pool functions
+ ********************************************************************************/
+#define _GNU_SOURCE
+#include "utils_thread_pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+
+#include "isula_libutils/log.h"
+#include "utils.h"
+
+#define THREAD_POOL_DEFAULT_PENDING 128
+
+struct thread_pool_task {
+    thread_pool_task_cb_t cb;
+    void *arg;
+};
+
+struct thread_pool {
+    pthread_mutex_t mutex;
+    // signaled when a task is queued or the pool is stopping
+    pthread_cond_t task_cond;
+    // signaled when a task is dequeued or finished
+    pthread_cond_t done_cond;
+
+    // ring buffer of pending tasks
+    struct thread_pool_task *tasks;
+    size_t capacity;
+    size_t head;
+    size_t pending;
+    // queued and running tasks
+    size_t unfinished;
+    bool stopping;
+
+    pthread_t *workers;
+    size_t workers_len;
+    char name[16];
+};
+
+static void *thread_pool_worker(void *arg)
+{
+    thread_pool_t *pool = (thread_pool_t *)arg;
+    struct thread_pool_task task = { 0 };
+
+    (void)prctl(PR_SET_NAME, pool->name);
+
+    while (true) {
+        (void)pthread_mutex_lock(&pool->mutex);
+        while (pool->pending == 0 && !pool->stopping) {
+            (void)pthread_cond_wait(&pool->task_cond, &pool->mutex);
+        }
+        if (pool->pending == 0 && pool->stopping) {
+            (void)pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        task = pool->tasks[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->pending--;
+        (void)pthread_cond_broadcast(&pool->done_cond);
+        (void)pthread_mutex_unlock(&pool->mutex);
+
+        task.cb(task.arg);
+
+        (void)pthread_mutex_lock(&pool->mutex);
+        pool->unfinished--;
+        (void)pthread_cond_broadcast(&pool->done_cond);
+        (void)pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return NULL;
+}
+
+size_t util_thread_pool_default_size(size_t max)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t size = cpus > 0 ? (size_t)cpus : 1;
+
+    if (max != 0 && size > max) {
+        size = max;
+    }
+
+    return size;
+}
+
+static void thread_pool_stop(thread_pool_t *pool)
+{
+    size_t i;
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    (void)pthread_cond_broadcast(&pool->task_cond);
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->workers_len; i++) {
+        (void)pthread_join(pool->workers[i], NULL);
+    }
+    pool->workers_len = 0;
+}
+
+thread_pool_t *util_thread_pool_new(size_t threads, size_t max_pending, const char *name)
+{
+    thread_pool_t *pool = NULL;
+    size_t i;
+
+    if (threads == 0) {
+        threads = util_thread_pool_default_size(0);
+    }
+    if (max_pending == 0) {
+        max_pending = THREAD_POOL_DEFAULT_PENDING;
+    }
+
+    pool = util_common_calloc_s(sizeof(thread_pool_t));
+    if (pool == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+
+    pool->tasks = util_smart_calloc_s(sizeof(struct thread_pool_task), max_pending);
+    pool->workers = util_smart_calloc_s(sizeof(pthread_t), threads);
+    if (pool->tasks == NULL || pool->workers == NULL) {
+        ERROR("Out of memory");
+        goto err_out;
+    }
+    pool->capacity = max_pending;
+    (void)snprintf(pool->name, sizeof(pool->name), "%s", name != NULL ? name : "ThreadPool");
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0 || pthread_cond_init(&pool->task_cond, NULL) != 0 ||
+        pthread_cond_init(&pool->done_cond, NULL) != 0) {
+        ERROR("Failed to init thread pool locks");
+        goto err_out;
+    }
+
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&pool->workers[i], NULL, thread_pool_worker, pool) != 0) {
+            ERROR("Failed to create thread pool worker");
+            break;
+        }
+        pool->workers_len++;
+    }
+    if (pool->workers_len == 0) {
+        goto err_out;
+    }
+
+    return pool;
+
+err_out:
+    free(pool->tasks);
+    free(pool->workers);
+    free(pool);
+    return NULL;
+}
+
+int util_thread_pool_submit(thread_pool_t *pool, thread_pool_task_cb_t cb, void *arg)
+{
+    size_t tail;
+
+    if (pool == NULL || cb == NULL) {
+        ERROR("Invalid input arguments");
+        return -1;
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    while (pool->pending == pool->capacity && !pool->stopping) {
+        (void)pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    if (pool->stopping) {
+        (void)pthread_mutex_unlock(&pool->mutex);
+        ERROR("Thread pool %s is stopping", pool->name);
+        return -1;
+    }
+    tail = (pool->head + pool->pending) % pool->capacity;
+    pool->tasks[tail].cb = cb;
+    pool->tasks[tail].arg = arg;
+    pool->pending++;
+    pool->unfinished++;
+    (void)pthread_cond_signal(&pool->task_cond);
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    return 0;
+}
+
+void util_thread_pool_wait(thread_pool_t *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    while (pool->unfinished != 0) {
+        (void)pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    (void)pthread_mutex_unlock(&pool->mutex);
+}
+
+void util_thread_pool_free(thread_pool_t *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+
+    util_thread_pool_wait(pool);
+    thread_pool_stop(pool);
+
+    (void)pthread_cond_destroy(&pool->task_cond);
+    (void)pthread_cond_destroy(&pool->done_cond);
+    (void)pthread_mutex_destroy(&pool->mutex);
+    free(pool->tasks);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t util_thread_pool_size(const thread_pool_t *pool)
+{
+    return pool == NULL ? 0 : pool->workers_len;
+}
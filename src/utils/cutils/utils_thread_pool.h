@@ -0,0 +1,49 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide fixed size thread pool definition
+ ********************************************************************************/
+#ifndef UTILS_CUTILS_UTILS_THREAD_POOL_H
+#define UTILS_CUTILS_UTILS_THREAD_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*thread_pool_task_cb_t)(void *arg);
+
+typedef struct thread_pool thread_pool_t;
+
+// create a pool with @threads workers, at most @max_pending tasks are queued,
+// 0 @threads means the number of online cpus.
+thread_pool_t *util_thread_pool_new(size_t threads, size_t max_pending, const char *name);
+
+// queue a task, block if the queue is full
+int util_thread_pool_submit(thread_pool_t *pool, thread_pool_task_cb_t cb, void *arg);
+
+// wait until all queued tasks are done
+void util_thread_pool_wait(thread_pool_t *pool);
+
+// wait all queued tasks done, then stop and free the pool
+void util_thread_pool_free(thread_pool_t *pool);
+
+size_t util_thread_pool_size(const thread_pool_t *pool);
+
+size_t util_thread_pool_default_size(size_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTILS_CUTILS_UTILS_THREAD_POOL_H
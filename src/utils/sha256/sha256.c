@@ -393,3 +393,462 @@ char *util_without_sha256_prefix(char *digest)
 
     return digest + strlen(SHA256_PREFIX);
 }
+
+struct sha256_stream {
+#if OPENSSL_VERSION_MAJOR >= 3
+    EVP_MD_CTX *ctx;
+#else
+    SHA256_CTX ctx;
+#endif
+};
+
+sha256_stream_t *sha256_stream_new(void)
+{
+    sha256_stream_t *stream = NULL;
+
+    stream = util_common_calloc_s(sizeof(sha256_stream_t));
+    if (stream == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+
+#if OPENSSL_VERSION_MAJOR >= 3
+    stream->ctx = EVP_MD_CTX_new();
+    if (stream->ctx == NULL) {
+        ERROR("Failed to create a context for the digest operation");
+        goto err_out;
+    }
+    if (!EVP_DigestInit_ex(stream->ctx, EVP_sha256(), NULL)) {
+        ERROR("Failed to initialise the digest operation");
+        ERR_print_errors_fp(stderr);
+        goto err_out;
+    }
+#else
+    SHA256_Init(&stream->ctx);
+#endif
+
+    return stream;
+
+#if OPENSSL_VERSION_MAJOR >= 3
+err_out:
+    sha256_stream_free(stream);
+    return NULL;
+#endif
+}
+
+int sha256_stream_update(sha256_stream_t *stream, const void *data, size_t len)
+{
+    if (stream == NULL || (data == NULL && len != 0)) {
+        ERROR("Invalid NULL param");
+        return -1;
+    }
+
+    if (len == 0) {
+        return 0;
+    }
+
+#if OPENSSL_VERSION_MAJOR >= 3
+    if (!EVP_DigestUpdate(stream->ctx, data, len)) {
+        ERROR("Failed to pass the message to be digested");
+        ERR_print_errors_fp(stderr);
+        return -1;
+    }
+#else
+    SHA256_Update(&stream->ctx, data, len);
+#endif
+
+    return 0;
+}
+
+char *sha256_stream_full_digest(sha256_stream_t *stream)
+{
+    unsigned char hash[SHA256_DIGEST_LENGTH] = { 0x00 };
+    char output_buffer[(SHA256_DIGEST_LENGTH * 2) + 1] = { 0x00 };
+    int i = 0;
+#if OPENSSL_VERSION_MAJOR >= 3
+    unsigned int len = 0;
+#endif
+
+    if (stream == NULL) {
+        ERROR("Invalid NULL param");
+        return NULL;
+    }
+
+#if OPENSSL_VERSION_MAJOR >= 3
+    if (!EVP_DigestFinal_ex(stream->ctx, hash, &len)) {
+        ERROR("Failed to calculate the digest itself");
+        ERR_print_errors_fp(stderr);
+        return NULL;
+    }
+#else
+    SHA256_Final(hash, &stream->ctx);
+#endif
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        int sret = snprintf(output_buffer + (i * 2), 3, "%02x", (unsigned int)hash[i]);
+        if (sret >= 3 || sret < 0) {
+            ERROR("snprintf failed when calc sha256 of stream, result is %d", sret);
+            return NULL;
+        }
+    }
+    output_buffer[SHA256_DIGEST_LENGTH * 2] = '\0';
+
+    return util_full_digest(output_buffer);
+}
+
+void sha256_stream_free(sha256_stream_t *stream)
+{
+    if (stream == NULL) {
+        return;
+    }
+
+#if OPENSSL_VERSION_MAJOR >= 3
+    EVP_MD_CTX_free(stream->ctx);
+#endif
+    free(stream);
+}
+
+#define DIGEST_READER_BUF_SIZE (128 * 1024)
+#define GZIP_MAGIC_LEN 3
+
+struct sha256_digest_reader {
+    int fd;
+    bool detected;
+    bool gzip;
+    // no more data in fd
+    bool eof;
+    // current gzip member is complete, next one may follow
+    bool member_end;
+    bool finished;
+    // raw bytes left in buffer by type detection, only for non-gzip blob
+    size_t pending;
+    int64_t compressed_size;
+    z_stream strm;
+    bool strm_inited;
+    unsigned char *in;
+    unsigned char *out;
+    sha256_stream_t *compressed;
+    sha256_stream_t *uncompressed;
+};
+
+sha256_digest_reader_t *sha256_digest_reader_new(int fd)
+{
+    sha256_digest_reader_t *reader = NULL;
+
+    if (fd < 0) {
+        ERROR("Invalid fd");
+        return NULL;
+    }
+
+    reader = util_common_calloc_s(sizeof(sha256_digest_reader_t));
+    if (reader == NULL) {
+        ERROR("Out of memory");
+        return NULL;
+    }
+    reader->fd = fd;
+
+    reader->in = util_common_calloc_s(DIGEST_READER_BUF_SIZE);
+    reader->out = util_common_calloc_s(DIGEST_READER_BUF_SIZE);
+    if (reader->in == NULL || reader->out == NULL) {
+        ERROR("Out of memory");
+        goto err_out;
+    }
+
+    reader->compressed = sha256_stream_new();
+    reader->uncompressed = sha256_stream_new();
+    if (reader->compressed == NULL || reader->uncompressed == NULL) {
+        goto err_out;
+    }
+
+    return reader;
+
+err_out:
+    sha256_digest_reader_free(reader);
+    return NULL;
+}
+
+static ssize_t digest_reader_fill(sha256_digest_reader_t *reader, size_t offset)
+{
+    ssize_t n = 0;
+
+    n = util_read_nointr(reader->fd, reader->in + offset, DIGEST_READER_BUF_SIZE - offset);
+    if (n < 0) {
+        SYSERROR("Failed to read layer data");
+        return -1;
+    }
+    if (n == 0) {
+        reader->eof = true;
+        return 0;
+    }
+
+    if (sha256_stream_update(reader->compressed, reader->in + offset, (size_t)n) != 0) {
+        return -1;
+    }
+    reader->compressed_size += n;
+
+    return n;
+}
+
+static int digest_reader_detect(sha256_digest_reader_t *reader)
+{
+    const unsigned char gzip_key[GZIP_MAGIC_LEN] = { 0x1F, 0x8B, 0x08 };
+    size_t len = 0;
+    ssize_t n = 0;
+
+    while (len < GZIP_MAGIC_LEN && !reader->eof) {
+        n = digest_reader_fill(reader, len);
+        if (n < 0) {
+            return -1;
+        }
+        len += (size_t)n;
+    }
+
+    reader->detected = true;
+    reader->gzip = len >= GZIP_MAGIC_LEN && memcmp(reader->in, gzip_key, GZIP_MAGIC_LEN) == 0;
+    if (!reader->gzip) {
+        reader->pending = len;
+        return 0;
+    }
+
+    // 16 + MAX_WBITS means gzip format only
+    if (inflateInit2(&reader->strm, 16 + MAX_WBITS) != Z_OK) {
+        ERROR("Failed to init inflate stream");
+        return -1;
+    }
+    reader->strm_inited = true;
+    reader->strm.next_in = reader->in;
+    reader->strm.avail_in = (uInt)len;
+
+    return 0;
+}
+
+static ssize_t digest_reader_read_plain(sha256_digest_reader_t *reader, const void **buf)
+{
+    ssize_t n = 0;
+
+    if (reader->pending > 0) {
+        n = (ssize_t)reader->pending;
+        reader->pending = 0;
+    } else if (!reader->eof) {
+        n = digest_reader_fill(reader, 0);
+    }
+
+    if (n == 0) {
+        reader->finished = true;
+    }
+    *buf = reader->in;
+    return n;
+}
+
+// check whether another gzip member follows, trailing garbage is ignored as gzread does
+static int digest_reader_next_member(sha256_digest_reader_t *reader)
+{
+    ssize_t n = 0;
+
+    if (reader->strm.avail_in < 2 && !reader->eof) {
+        memmove(reader->in, reader->strm.next_in, reader->strm.avail_in);
+        reader->strm.next_in = reader->in;
+        n = digest_reader_fill(reader, reader->strm.avail_in);
+        if (n < 0) {
+            return -1;
+        }
+        reader->strm.avail_in += (uInt)n;
+        return 0;
+    }
+
+    if (reader->strm.avail_in >= 2 && reader->strm.next_in[0] == 0x1F && reader->strm.next_in[1] == 0x8B) {
+        if (inflateReset(&reader->strm) != Z_OK) {
+            ERROR("Failed to reset inflate stream");
+            return -1;
+        }
+        reader->member_end = false;
+        return 0;
+    }
+
+    reader->finished = true;
+    return 0;
+}
+
+static ssize_t digest_reader_read_gzip(sha256_digest_reader_t *reader, const void **buf)
+{
+    int nret = 0;
+    ssize_t n = 0;
+    size_t produced = 0;
+
+    while (!reader->finished) {
+        if (reader->member_end) {
+            if (digest_reader_next_member(reader) != 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        if (reader->strm.avail_in == 0) {
+            if (reader->eof) {
+                ERROR("Unexpected end of gzip stream");
+                return -1;
+            }
+            n = digest_reader_fill(reader, 0);
+            if (n < 0) {
+                return -1;
+            }
+            reader->strm.next_in = reader->in;
+            reader->strm.avail_in = (uInt)n;
+            continue;
+        }
+
+        reader->strm.next_out = reader->out;
+        reader->strm.avail_out = DIGEST_READER_BUF_SIZE;
+        nret = inflate(&reader->strm, Z_NO_FLUSH);
+        if (nret == Z_STREAM_END) {
+            reader->member_end = true;
+        } else if (nret != Z_OK && nret != Z_BUF_ERROR) {
+            ERROR("Failed to inflate layer data: %s", reader->strm.msg != NULL ? reader->strm.msg : "unknown");
+            return -1;
+        }
+
+        produced = DIGEST_READER_BUF_SIZE - reader->strm.avail_out;
+        if (produced > 0) {
+            if (sha256_stream_update(reader->uncompressed, reader->out, produced) != 0) {
+                return -1;
+            }
+            *buf = reader->out;
+            return (ssize_t)produced;
+        }
+    }
+
+    return 0;
+}
+
+ssize_t sha256_digest_reader_read(sha256_digest_reader_t *reader, const void **buf)
+{
+    if (reader == NULL || buf == NULL) {
+        ERROR("Invalid NULL param");
+        return -1;
+    }
+
+    if (!reader->detected && digest_reader_detect(reader) != 0) {
+        return -1;
+    }
+
+    if (reader->finished) {
+        return 0;
+    }
+
+    return reader->gzip ? digest_reader_read_gzip(reader, buf) : digest_reader_read_plain(reader, buf);
+}
+
+int sha256_digest_reader_drain(sha256_digest_reader_t *reader)
+{
+    const void *buf = NULL;
+    ssize_t n = 0;
+
+    if (reader == NULL) {
+        ERROR("Invalid NULL param");
+        return -1;
+    }
+
+    do {
+        n = sha256_digest_reader_read(reader, &buf);
+    } while (n > 0);
+
+    if (n < 0) {
+        return -1;
+    }
+
+    // bytes after the last gzip member are part of the blob
+    while (!reader->eof) {
+        if (digest_reader_fill(reader, 0) < 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int sha256_digest_reader_result(sha256_digest_reader_t *reader, char **compressed_digest,
+                                char **uncompressed_digest, int64_t *compressed_size)
+{
+    char *compressed = NULL;
+    char *uncompressed = NULL;
+
+    if (reader == NULL || compressed_digest == NULL || uncompressed_digest == NULL) {
+        ERROR("Invalid NULL param");
+        return -1;
+    }
+
+    if (!reader->finished || !reader->eof) {
+        ERROR("Layer data is not consumed completely");
+        return -1;
+    }
+
+    compressed = sha256_stream_full_digest(reader->compressed);
+    if (compressed == NULL) {
+        return -1;
+    }
+
+    uncompressed = reader->gzip ? sha256_stream_full_digest(reader->uncompressed) : util_strdup_s(compressed);
+    if (uncompressed == NULL) {
+        free(compressed);
+        return -1;
+    }
+
+    *compressed_digest = compressed;
+    *uncompressed_digest = uncompressed;
+    if (compressed_size != NULL) {
+        *compressed_size = reader->compressed_size;
+    }
+
+    return 0;
+}
+
+void sha256_digest_reader_free(sha256_digest_reader_t *reader)
+{
+    if (reader == NULL) {
+        return;
+    }
+
+    if (reader->strm_inited) {
+        (void)inflateEnd(&reader->strm);
+    }
+    sha256_stream_free(reader->compressed);
+    sha256_stream_free(reader->uncompressed);
+    free(reader->in);
+    free(reader->out);
+    free(reader);
+}
+
+int sha256_full_layer_digests(const char *filename, char **compressed_digest, char **uncompressed_digest)
+{
+    int ret = -1;
+    int fd = -1;
+    sha256_digest_reader_t *reader = NULL;
+
+    if (filename == NULL || compressed_digest == NULL || uncompressed_digest == NULL) {
+        ERROR("invalid NULL param");
+        return -1;
+    }
+
+    fd = util_open(filename, O_RDONLY, 0);
+    if (fd < 0) {
+        SYSERROR("failed to open file %s.", filename);
+        return -1;
+    }
+
+    reader = sha256_digest_reader_new(fd);
+    if (reader == NULL) {
+        goto out;
+    }
+
+    if (sha256_digest_reader_drain(reader) != 0) {
+        ERROR("Failed to read layer file %s", filename);
+        goto out;
+    }
+
+    ret = sha256_digest_reader_result(reader, compressed_digest, uncompressed_digest, NULL);
+
+out:
+    sha256_digest_reader_free(reader);
+    close(fd);
+    return ret;
+}
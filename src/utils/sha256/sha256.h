@@ -18,6 +18,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <sys/types.h>
 #include <zlib.h>
 
 #ifdef __cplusplus
@@ -38,6 +39,38 @@ char *sha256_full_digest_str(char *str);
 
 char *util_without_sha256_prefix(char *digest);
 
+typedef struct sha256_stream sha256_stream_t;
+
+sha256_stream_t *sha256_stream_new(void);
+
+int sha256_stream_update(sha256_stream_t *stream, const void *data, size_t len);
+
+// finalize the stream and return digest with "sha256:" prefix
+char *sha256_stream_full_digest(sha256_stream_t *stream);
+
+void sha256_stream_free(sha256_stream_t *stream);
+
+// digest_reader reads a layer blob from fd once, computes the digest of the raw
+// blob and the digest of its gunzipped content (same as raw if not gzip), and
+// hands the uncompressed data to the caller.
+typedef struct sha256_digest_reader sha256_digest_reader_t;
+
+sha256_digest_reader_t *sha256_digest_reader_new(int fd);
+
+// return size of uncompressed data in *buf, 0 on end of stream, -1 on error
+ssize_t sha256_digest_reader_read(sha256_digest_reader_t *reader, const void **buf);
+
+// consume the rest of stream, so digests cover the whole blob
+int sha256_digest_reader_drain(sha256_digest_reader_t *reader);
+
+int sha256_digest_reader_result(sha256_digest_reader_t *reader, char **compressed_digest,
+                                char **uncompressed_digest, int64_t *compressed_size);
+
+void sha256_digest_reader_free(sha256_digest_reader_t *reader);
+
+// calculate compressed digest and diff id of layer file in one pass
+int sha256_full_layer_digests(const char *filename, char **compressed_digest, char **uncompressed_digest);
+
 #ifdef __cplusplus
 }
 #endif
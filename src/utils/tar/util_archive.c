@@ -48,6 +48,7 @@
 #include "utils_file.h"
 #include "utils_string.h"
 #include "buffer.h"
+#include "sha256.h"
 
 struct archive;
 struct archive_entry;
@@ -1725,7 +1726,21 @@ static void free_archive_read(struct archive *read_a)
 
 #define READ_BLOCK_SIZE 10240
 
-static struct archive *create_archive_read(int fd)
+static ssize_t read_digest_content(struct archive *a, void *client_data, const void **buff)
+{
+    ssize_t n = 0;
+
+    n = sha256_digest_reader_read((sha256_digest_reader_t *)client_data, buff);
+    if (n < 0) {
+        archive_set_error(a, EIO, "Failed to read layer data");
+        return ARCHIVE_FATAL;
+    }
+
+    return n;
+}
+
+// if reader is not NULL, archive data is read through it instead of fd
+static struct archive *create_archive_read(int fd, sha256_digest_reader_t *reader)
 {
     int nret = 0;
     struct archive *ret = NULL;
@@ -1745,7 +1760,11 @@ static struct archive *create_archive_read(int fd)
         ERROR("archive read support format all failed");
         goto err_out;
     }
-    nret = archive_read_open_fd(ret, fd, READ_BLOCK_SIZE);
+    if (reader != NULL) {
+        nret = archive_read_open(ret, reader, NULL, read_digest_content, NULL);
+    } else {
+        nret = archive_read_open_fd(ret, fd, READ_BLOCK_SIZE);
+    }
     if (nret != 0) {
         ERROR("archive read open file failed: %s", archive_error_string(ret));
         goto err_out;
@@ -1877,7 +1896,8 @@ out:
     return ret;
 }
 
-static int foreach_archive_entry(archive_entry_cb_t cb, int fd, const char *dist, int64_t *size)
+static int foreach_archive_entry(archive_entry_cb_t cb, int fd, const char *dist, int64_t *size,
+                                 sha256_digest_reader_t *reader)
 {
     const size_t entry_init_buf_size = 4096;
     int ret = -1;
@@ -1898,7 +1918,7 @@ static int foreach_archive_entry(archive_entry_cb_t cb, int fd, const char *dist
         return -1;
     }
 
-    read_a = create_archive_read(fd);
+    read_a = create_archive_read(fd, reader);
     if (read_a == NULL) {
         goto out;
     }
@@ -1919,6 +1939,13 @@ static int foreach_archive_entry(archive_entry_cb_t cb, int fd, const char *dist
         }
         position++;
     }
+
+    // tar stream may have padding after end of archive, it is part of diff id
+    if (reader != NULL && sha256_digest_reader_drain(reader) != 0) {
+        ERROR("Failed to read rest of layer data");
+        goto out;
+    }
+
     nret = util_atomic_write_file(dist, json_buf->contents, json_buf->bytes_used, SECURE_CONFIG_FILE_MODE, true);
     if (nret != 0) {
         ERROR("save tar split failed");
@@ -1940,5 +1967,50 @@ int archive_copy_oci_tar_split_and_ret_size(int src_fd, const char *dist_file, i
         return -1;
     }
 
-    return foreach_archive_entry(archive_entry_parse, src_fd, dist_file, ret_size);
+    return foreach_archive_entry(archive_entry_parse, src_fd, dist_file, ret_size, NULL);
+}
+
+void free_archive_layer_digests(struct archive_layer_digests *digests)
+{
+    if (digests == NULL) {
+        return;
+    }
+
+    free(digests->compressed_digest);
+    digests->compressed_digest = NULL;
+    free(digests->uncompressed_digest);
+    digests->uncompressed_digest = NULL;
+    digests->compressed_size = 0;
+}
+
+int archive_copy_oci_tar_split_and_digest(int src_fd, const char *dist_file, int64_t *ret_size,
+                                          struct archive_layer_digests *digests)
+{
+    int ret = -1;
+    sha256_digest_reader_t *reader = NULL;
+
+    if (src_fd < 0 || dist_file == NULL || ret_size == NULL || digests == NULL) {
+        ERROR("Invalid arguments");
+        return -1;
+    }
+
+    reader = sha256_digest_reader_new(src_fd);
+    if (reader == NULL) {
+        return -1;
+    }
+
+    if (foreach_archive_entry(archive_entry_parse, src_fd, dist_file, ret_size, reader) != 0) {
+        goto out;
+    }
+
+    if (sha256_digest_reader_result(reader, &digests->compressed_digest, &digests->uncompressed_digest,
+                                    &digests->compressed_size) != 0) {
+        ERROR("Failed to get digests of layer data");
+        goto out;
+    }
+
+    ret = 0;
+out:
+    sha256_digest_reader_free(reader);
+    return ret;
 }
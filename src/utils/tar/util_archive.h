@@ -59,6 +59,20 @@ int archive_chroot_untar_stream(const struct io_read_wrapper *content, const cha
 
 int archive_copy_oci_tar_split_and_ret_size(int src_fd, const char *dist_file, int64_t *ret_size);
 
+struct archive_layer_digests {
+    // digest of layer blob
+    char *compressed_digest;
+    // digest of uncompressed tar stream, aka diff id
+    char *uncompressed_digest;
+    int64_t compressed_size;
+};
+
+void free_archive_layer_digests(struct archive_layer_digests *digests);
+
+// same as archive_copy_oci_tar_split_and_ret_size, and calculate digests of layer in the same pass
+int archive_copy_oci_tar_split_and_digest(int src_fd, const char *dist_file, int64_t *ret_size,
+                                          struct archive_layer_digests *digests);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
 #define _GNU_SOURCE /* See feature_test_macros(7) */
 #include "util_gzip.h"
 #include <zlib.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -22,11 +23,54 @@
 #include "utils.h"
 #include "isula_libutils/log.h"
 #include "utils_file.h"
+#include "utils_thread_pool.h"
 
 #define BLKSIZE 32768
 
-// Compress
-int util_gzip_z(const char *srcfile, const char *dstfile, const mode_t mode)
+// input size of each independently deflated block
+#define GZIP_PARALLEL_BLOCK_SIZE (128 * 1024)
+// deflate window size, tail of previous block used as dictionary
+#define GZIP_DICT_SIZE 32768
+#define GZIP_PARALLEL_MAX_THREADS 8
+#define GZIP_HEADER_SIZE 10
+#define GZIP_TRAILER_SIZE 8
+
+struct gzip_block {
+    unsigned char *in;
+    size_t in_len;
+    unsigned char dict[GZIP_DICT_SIZE];
+    size_t dict_len;
+    unsigned char *out;
+    size_t out_len;
+    uLong crc;
+    bool last;
+    // protected by writer mutex
+    bool done;
+    int ret;
+    struct gzip_parallel_writer *writer;
+    struct gzip_block *next;
+};
+
+struct gzip_parallel_writer {
+    int fd;
+    thread_pool_t *pool;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    // block being filled by caller
+    struct gzip_block *cur;
+    // submitted blocks in stream order
+    struct gzip_block *head;
+    struct gzip_block *tail;
+    size_t inflight;
+    size_t max_inflight;
+    unsigned char prev_tail[GZIP_DICT_SIZE];
+    size_t prev_tail_len;
+    uLong crc;
+    uint64_t total_in;
+    int error;
+};
+
+static int gzip_z_serial(const char *srcfile, const char *dstfile, const mode_t mode)
 {
     int ret = 0;
     int srcfd = 0;
@@ -99,6 +143,435 @@ out:
     return ret;
 }
 
+static void gzip_block_free(struct gzip_block *block)
+{
+    if (block == NULL) {
+        return;
+    }
+
+    free(block->in);
+    free(block->out);
+    free(block);
+}
+
+static int gzip_block_deflate(struct gzip_block *block)
+{
+    z_stream strm = { 0 };
+    int flush = block->last ? Z_FINISH : Z_SYNC_FLUSH;
+    size_t out_cap = 0;
+    int nret = 0;
+    int ret = 0;
+
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        ERROR("Failed to init deflate stream");
+        return -1;
+    }
+
+    // prime with previous data, so compress ratio is close to a single stream
+    if (block->dict_len > 0 && deflateSetDictionary(&strm, block->dict, (uInt)block->dict_len) != Z_OK) {
+        ERROR("Failed to set deflate dictionary");
+        ret = -1;
+        goto out;
+    }
+
+    strm.next_in = block->in;
+    strm.avail_in = (uInt)block->in_len;
+    for (;;) {
+        if (strm.avail_out == 0) {
+            size_t new_cap = out_cap + deflateBound(&strm, block->in_len) + 64;
+            unsigned char *new_out = NULL;
+
+            if (util_mem_realloc((void **)&new_out, new_cap, block->out, out_cap) != 0) {
+                ERROR("Out of memory");
+                ret = -1;
+                goto out;
+            }
+            block->out = new_out;
+            strm.next_out = block->out + block->out_len;
+            strm.avail_out = (uInt)(new_cap - block->out_len);
+            out_cap = new_cap;
+        }
+
+        nret = deflate(&strm, flush);
+        block->out_len = out_cap - strm.avail_out;
+        if (nret == Z_STREAM_ERROR) {
+            ERROR("Failed to deflate block");
+            ret = -1;
+            goto out;
+        }
+        // sync flush is complete when there is output space left
+        if ((flush == Z_FINISH && nret == Z_STREAM_END) || (flush != Z_FINISH && strm.avail_out != 0)) {
+            break;
+        }
+    }
+
+    block->crc = crc32(0L, block->in, (uInt)block->in_len);
+
+out:
+    (void)deflateEnd(&strm);
+    return ret;
+}
+
+static void gzip_block_task(void *arg)
+{
+    struct gzip_block *block = (struct gzip_block *)arg;
+    struct gzip_parallel_writer *writer = block->writer;
+    int ret = gzip_block_deflate(block);
+
+    (void)pthread_mutex_lock(&writer->mutex);
+    block->ret = ret;
+    block->done = true;
+    (void)pthread_cond_broadcast(&writer->cond);
+    (void)pthread_mutex_unlock(&writer->mutex);
+}
+
+static int gzip_write_all(int fd, const void *data, size_t len)
+{
+    ssize_t nwrite = util_write_nointr_in_total(fd, (const char *)data, len);
+
+    if (nwrite < 0 || (size_t)nwrite != len) {
+        SYSERROR("Failed to write gzip data");
+        return -1;
+    }
+
+    return 0;
+}
+
+// write finished blocks in stream order, wait for all submitted blocks if @wait_all
+static void gzip_write_done_blocks(struct gzip_parallel_writer *writer, bool wait_all)
+{
+    struct gzip_block *block = NULL;
+
+    while (true) {
+        (void)pthread_mutex_lock(&writer->mutex);
+        block = writer->head;
+        while (block != NULL && !block->done && (wait_all || writer->inflight >= writer->max_inflight)) {
+            (void)pthread_cond_wait(&writer->cond, &writer->mutex);
+        }
+        if (block == NULL || !block->done) {
+            (void)pthread_mutex_unlock(&writer->mutex);
+            return;
+        }
+        writer->head = block->next;
+        if (writer->head == NULL) {
+            writer->tail = NULL;
+        }
+        writer->inflight--;
+        (void)pthread_mutex_unlock(&writer->mutex);
+
+        if (block->ret != 0) {
+            writer->error = -1;
+        }
+        if (writer->error == 0 && gzip_write_all(writer->fd, block->out, block->out_len) != 0) {
+            writer->error = -1;
+        }
+        writer->crc = crc32_combine(writer->crc, block->crc, (z_off_t)block->in_len);
+        writer->total_in += block->in_len;
+        gzip_block_free(block);
+    }
+}
+
+static void gzip_update_prev_tail(struct gzip_parallel_writer *writer, const struct gzip_block *block)
+{
+    size_t keep = 0;
+
+    if (block->in_len == 0) {
+        return;
+    }
+
+    if (block->in_len >= GZIP_DICT_SIZE) {
+        (void)memcpy(writer->prev_tail, block->in + block->in_len - GZIP_DICT_SIZE, GZIP_DICT_SIZE);
+        writer->prev_tail_len = GZIP_DICT_SIZE;
+        return;
+    }
+
+    keep = GZIP_DICT_SIZE - block->in_len;
+    if (keep > writer->prev_tail_len) {
+        keep = writer->prev_tail_len;
+    }
+    (void)memmove(writer->prev_tail, writer->prev_tail + writer->prev_tail_len - keep, keep);
+    (void)memcpy(writer->prev_tail + keep, block->in, block->in_len);
+    writer->prev_tail_len = keep + block->in_len;
+}
+
+static int gzip_submit_block(struct gzip_parallel_writer *writer, bool last)
+{
+    struct gzip_block *block = writer->cur;
+
+    if (block == NULL) {
+        block = util_common_calloc_s(sizeof(struct gzip_block));
+        if (block == NULL) {
+            ERROR("Out of memory");
+            return -1;
+        }
+    }
+    writer->cur = NULL;
+
+    block->writer = writer;
+    block->last = last;
+    (void)memcpy(block->dict, writer->prev_tail, writer->prev_tail_len);
+    block->dict_len = writer->prev_tail_len;
+    gzip_update_prev_tail(writer, block);
+
+    // keep memory bounded, wait for the oldest block before queue more
+    gzip_write_done_blocks(writer, false);
+
+    (void)pthread_mutex_lock(&writer->mutex);
+    if (writer->tail == NULL) {
+        writer->head = block;
+    } else {
+        writer->tail->next = block;
+    }
+    writer->tail = block;
+    writer->inflight++;
+    (void)pthread_mutex_unlock(&writer->mutex);
+
+    if (util_thread_pool_submit(writer->pool, gzip_block_task, block) != 0) {
+        ERROR("Failed to submit gzip block");
+        (void)pthread_mutex_lock(&writer->mutex);
+        block->ret = -1;
+        block->done = true;
+        (void)pthread_mutex_unlock(&writer->mutex);
+        return -1;
+    }
+
+    return 0;
+}
+
+static ssize_t gzip_parallel_write(void *context, const void *data, size_t len)
+{
+    struct gzip_parallel_writer *writer = (struct gzip_parallel_writer *)context;
+    const unsigned char *p = (const unsigned char *)data;
+    size_t remain = len;
+
+    if (writer == NULL || (data == NULL && len != 0)) {
+        return -1;
+    }
+
+    while (remain > 0 && writer->error == 0) {
+        size_t size = 0;
+
+        if (writer->cur == NULL) {
+            writer->cur = util_common_calloc_s(sizeof(struct gzip_block));
+            if (writer->cur == NULL) {
+                ERROR("Out of memory");
+                return -1;
+            }
+            writer->cur->in = util_common_calloc_s(GZIP_PARALLEL_BLOCK_SIZE);
+            if (writer->cur->in == NULL) {
+                ERROR("Out of memory");
+                return -1;
+            }
+        }
+
+        size = GZIP_PARALLEL_BLOCK_SIZE - writer->cur->in_len;
+        if (size > remain) {
+            size = remain;
+        }
+        (void)memcpy(writer->cur->in + writer->cur->in_len, p, size);
+        writer->cur->in_len += size;
+        p += size;
+        remain -= size;
+
+        if (writer->cur->in_len == GZIP_PARALLEL_BLOCK_SIZE && gzip_submit_block(writer, false) != 0) {
+            writer->error = -1;
+        }
+    }
+
+    return writer->error == 0 ? (ssize_t)len : -1;
+}
+
+static int gzip_write_trailer(struct gzip_parallel_writer *writer)
+{
+    unsigned char trailer[GZIP_TRAILER_SIZE] = { 0 };
+    uint32_t isize = (uint32_t)(writer->total_in & 0xffffffff);
+    size_t i;
+
+    for (i = 0; i < 4; i++) {
+        trailer[i] = (unsigned char)((writer->crc >> (8 * i)) & 0xff);
+        trailer[4 + i] = (unsigned char)((isize >> (8 * i)) & 0xff);
+    }
+
+    return gzip_write_all(writer->fd, trailer, sizeof(trailer));
+}
+
+static int gzip_parallel_close(void *context, char **err)
+{
+    struct gzip_parallel_writer *writer = (struct gzip_parallel_writer *)context;
+    int ret = 0;
+
+    if (writer == NULL) {
+        return -1;
+    }
+
+    if (writer->error == 0 && gzip_submit_block(writer, true) != 0) {
+        writer->error = -1;
+    }
+    gzip_write_done_blocks(writer, true);
+    if (writer->error == 0 && gzip_write_trailer(writer) != 0) {
+        writer->error = -1;
+    }
+    ret = writer->error;
+    if (ret != 0 && err != NULL && *err == NULL) {
+        *err = util_strdup_s("parallel gzip failed");
+    }
+
+    util_thread_pool_free(writer->pool);
+    gzip_block_free(writer->cur);
+    (void)pthread_cond_destroy(&writer->cond);
+    (void)pthread_mutex_destroy(&writer->mutex);
+    free(writer);
+
+    return ret;
+}
+
+int util_gzip_parallel_writer_new(int dstfd, size_t threads, struct io_write_wrapper *writer)
+{
+    static const unsigned char header[GZIP_HEADER_SIZE] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 3 };
+    struct gzip_parallel_writer *ctx = NULL;
+
+    if (dstfd < 0 || writer == NULL) {
+        ERROR("Invalid input arguments");
+        return -1;
+    }
+
+    if (threads == 0) {
+        threads = util_thread_pool_default_size(GZIP_PARALLEL_MAX_THREADS);
+    }
+
+    ctx = util_common_calloc_s(sizeof(struct gzip_parallel_writer));
+    if (ctx == NULL) {
+        ERROR("Out of memory");
+        return -1;
+    }
+    ctx->fd = dstfd;
+    ctx->crc = crc32(0L, Z_NULL, 0);
+    ctx->max_inflight = threads * 2;
+
+    if (pthread_mutex_init(&ctx->mutex, NULL) != 0) {
+        ERROR("Failed to init gzip writer mutex");
+        free(ctx);
+        return -1;
+    }
+    if (pthread_cond_init(&ctx->cond, NULL) != 0) {
+        ERROR("Failed to init gzip writer cond");
+        (void)pthread_mutex_destroy(&ctx->mutex);
+        free(ctx);
+        return -1;
+    }
+
+    ctx->pool = util_thread_pool_new(threads, ctx->max_inflight, "GzipWorker");
+    if (ctx->pool == NULL || gzip_write_all(dstfd, header, sizeof(header)) != 0) {
+        ERROR("Failed to start parallel gzip writer");
+        util_thread_pool_free(ctx->pool);
+        (void)pthread_cond_destroy(&ctx->cond);
+        (void)pthread_mutex_destroy(&ctx->mutex);
+        free(ctx);
+        return -1;
+    }
+
+    writer->context = ctx;
+    writer->write_func = gzip_parallel_write;
+    writer->close_func = gzip_parallel_close;
+
+    return 0;
+}
+
+static int gzip_z_parallel(const char *srcfile, const char *dstfile, const mode_t mode, size_t threads)
+{
+    struct io_write_wrapper writer = { 0 };
+    int srcfd = -1;
+    int dstfd = -1;
+    ssize_t size = 0;
+    void *buffer = NULL;
+    int ret = 0;
+
+    srcfd = util_open(srcfile, O_RDONLY, SECURE_CONFIG_FILE_MODE);
+    if (srcfd < 0) {
+        SYSERROR("Open src file: %s, failed", srcfile);
+        return -1;
+    }
+
+    dstfd = util_open(dstfile, O_WRONLY | O_CREAT | O_TRUNC, mode);
+    if (dstfd < 0) {
+        SYSERROR("Open dst file: %s, failed", dstfile);
+        close(srcfd);
+        return -1;
+    }
+
+    buffer = util_common_calloc_s(GZIP_PARALLEL_BLOCK_SIZE);
+    if (buffer == NULL) {
+        ERROR("out of memory");
+        ret = -1;
+        goto out;
+    }
+
+    if (util_gzip_parallel_writer_new(dstfd, threads, &writer) != 0) {
+        ret = -1;
+        goto out;
+    }
+
+    while (true) {
+        size = util_read_nointr(srcfd, buffer, GZIP_PARALLEL_BLOCK_SIZE);
+        if (size < 0) {
+            SYSERROR("read file %s failed", srcfile);
+            ret = -1;
+            break;
+        } else if (size == 0) {
+            break;
+        }
+
+        if (writer.write_func(writer.context, buffer, (size_t)size) != size) {
+            ERROR("Failed to compress file %s", srcfile);
+            ret = -1;
+            break;
+        }
+    }
+
+    if (writer.close_func(writer.context, NULL) != 0) {
+        ret = -1;
+    }
+
+    if (chmod(dstfile, mode) != 0) {
+        ERROR("Change mode of tar-split file");
+        ret = -1;
+    }
+
+out:
+    close(dstfd);
+    close(srcfd);
+    free(buffer);
+    if (ret != 0) {
+        if (util_path_remove(dstfile) != 0) {
+            SYSERROR("Remove file %s failed", dstfile);
+        }
+    }
+
+    return ret;
+}
+
+int util_gzip_z_parallel(const char *srcfile, const char *dstfile, const mode_t mode, size_t threads)
+{
+    struct stat st = { 0 };
+
+    if (srcfile == NULL || dstfile == NULL) {
+        return -1;
+    }
+
+    // small files are not worth starting worker threads
+    if (threads == 1 || stat(srcfile, &st) != 0 || st.st_size < 2 * GZIP_PARALLEL_BLOCK_SIZE) {
+        return gzip_z_serial(srcfile, dstfile, mode);
+    }
+
+    return gzip_z_parallel(srcfile, dstfile, mode, threads);
+}
+
+// Compress
+int util_gzip_z(const char *srcfile, const char *dstfile, const mode_t mode)
+{
+    return util_gzip_z_parallel(srcfile, dstfile, mode, 0);
+}
+
 // Decompress
 int util_gzip_d(const char *srcfile, const FILE *dstfp)
 {
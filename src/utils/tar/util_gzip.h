@@ -18,6 +18,8 @@
 #include <stdio.h>
 #include <sys/types.h>
 
+#include "io_wrapper.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +27,16 @@ extern "C" {
 // Compress
 int util_gzip_z(const char *srcfile, const char *dstfile, const mode_t mode);
 
+// Compress with @threads workers, 0 means decided by online cpus
+int util_gzip_z_parallel(const char *srcfile, const char *dstfile, const mode_t mode, size_t threads);
+
+/*
+ * create a writer which compresses data into one gzip stream on @dstfd,
+ * blocks are deflated by @threads workers in parallel, 0 means decided by online cpus.
+ * close_func of @writer must be called to finish the stream, @dstfd is not closed.
+ */
+int util_gzip_parallel_writer_new(int dstfd, size_t threads, struct io_write_wrapper *writer);
+
 // Decompress
 int util_gzip_d(const char *srcfile, const FILE *destfp);
 
@@ -15,6 +15,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "daemon_arguments.h"
@@ -22,6 +24,8 @@
 #include "mock.h"
 #include "sysinfo.h"
 #include "utils.h"
+#include "utils_file.h"
+#include "cgroup.h"
 
 extern "C" {
     DECLARE_WRAPPER(util_common_calloc_s, void *, (size_t size));
@@ -79,3 +83,144 @@ TEST(CgroupCpuUnitTest, test_sysinfo_cgroup_controller_cpurt_mnt_path)
     ASSERT_EQ(sysinfo_cgroup_controller_cpurt_mnt_path(), nullptr);
     MOCK_CLEAR(util_common_calloc_s);
 }
+
+TEST(CgroupCpuUnitTest, test_common_get_cgroup_v2_metrics)
+{
+    cgroup_metrics_t metrics = { 0 };
+
+    ASSERT_EQ(common_get_cgroup_v2_metrics(nullptr, &metrics), -1);
+    ASSERT_EQ(common_get_cgroup_v2_metrics("", &metrics), -1);
+    ASSERT_EQ(common_get_cgroup_v2_metrics("isulad", nullptr), -1);
+    ASSERT_EQ(common_get_cgroup_v2_metrics("isulad/not-exist-cgroup", &metrics), -1);
+}
+
+class CgroupMetricsUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/cgroup_metrics_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+    }
+
+    void TearDown() override
+    {
+        (void)util_recursive_rmdir(m_dir.c_str(), 0);
+    }
+
+    std::string MakeDir(const std::string &rel)
+    {
+        std::string path = m_dir + "/" + rel;
+
+        EXPECT_EQ(util_mkdir_p(path.c_str(), 0755), 0);
+        return path;
+    }
+
+    void WriteFile(const std::string &dir, const std::string &file, const std::string &content)
+    {
+        std::string path = dir + "/" + file;
+
+        ASSERT_EQ(util_write_file(path.c_str(), content.c_str(), content.size(), 0644), 0);
+    }
+
+    std::string m_dir;
+};
+
+TEST_F(CgroupMetricsUnitTest, test_common_get_cgroup_v2_metrics_from_fixture)
+{
+    cgroup_metrics_t metrics = { 0 };
+    std::string cg = MakeDir("v2/isulad/abc");
+
+    WriteFile(cg, "cpu.stat", "usage_usec 1500\nuser_usec 1000\nsystem_usec 500\n");
+    WriteFile(cg, "memory.max", "max\n");
+    WriteFile(cg, "memory.current", "4096\n");
+    WriteFile(cg, "memory.stat", "anon 1024\nfile 2048\ninactive_file 512\npgfault 7\npgmajfault 3\n");
+    WriteFile(cg, "pids.current", "5\n");
+
+    std::string mountpoint = m_dir + "/v2";
+    ASSERT_EQ(common_get_cgroup_v2_metrics_in_mountpoint(mountpoint.c_str(), "isulad/abc", &metrics), 0);
+    ASSERT_EQ(metrics.cgcpu_metrics.cpu_use_nanos, 1500000);
+    ASSERT_EQ(metrics.cgmem_metrics.mem_limit, UINT64_MAX);
+    ASSERT_EQ(metrics.cgmem_metrics.mem_used, 4096);
+    ASSERT_EQ(metrics.cgmem_metrics.total_rss, 1024);
+    ASSERT_EQ(metrics.cgmem_metrics.total_inactive_file, 512);
+    ASSERT_EQ(metrics.cgmem_metrics.total_pgfault, 7);
+    ASSERT_EQ(metrics.cgmem_metrics.total_pgmajfault, 3);
+    ASSERT_EQ(metrics.cgpids_metrics.pid_current, 5);
+
+    ASSERT_EQ(common_get_cgroup_v2_metrics_in_mountpoint(mountpoint.c_str(), "isulad/missing", &metrics), -1);
+}
+
+TEST_F(CgroupMetricsUnitTest, test_common_get_cgroup_v1_metrics_from_fixture)
+{
+    cgroup_metrics_t metrics = { 0 };
+    std::string cpuacct = MakeDir("v1/cpu,cpuacct/isulad/abc");
+    std::string memory = MakeDir("v1/memory/isulad/abc");
+    std::string pids = MakeDir("v1/pids/isulad/abc");
+    std::string cpuacct_mnt = m_dir + "/v1/cpu,cpuacct";
+    std::string memory_mnt = m_dir + "/v1/memory";
+    std::string pids_mnt = m_dir + "/v1/pids";
+    char *cpuacct_ctrls[] = { (char *)"cpu", (char *)"cpuacct", nullptr };
+    char *memory_ctrls[] = { (char *)"memory", nullptr };
+    char *pids_ctrls[] = { (char *)"pids", nullptr };
+    cgroup_layers_item items[] = {
+        { cpuacct_ctrls, (char *)cpuacct_mnt.c_str() },
+        { memory_ctrls, (char *)memory_mnt.c_str() },
+        { pids_ctrls, (char *)pids_mnt.c_str() },
+    };
+    cgroup_layers_item *item_ptrs[] = { &items[0], &items[1], &items[2] };
+    cgroup_layer_t layers = { item_ptrs, 3, 3 };
+
+    WriteFile(cpuacct, "cpuacct.usage", "123456789\n");
+    WriteFile(memory, "memory.limit_in_bytes", "9223372036854771712\n");
+    WriteFile(memory, "memory.usage_in_bytes", "8192\n");
+    WriteFile(memory, "memory.stat",
+              "cache 100\nrss 200\ntotal_cache 300\ntotal_rss 2048\ntotal_pgfault 11\n"
+              "total_pgmajfault 2\ntotal_inactive_file 1024\n");
+    WriteFile(pids, "pids.current", "9\n");
+
+    ASSERT_EQ(common_get_cgroup_v1_metrics_in_layers(&layers, "isulad/abc", &metrics), 0);
+    ASSERT_EQ(metrics.cgcpu_metrics.cpu_use_nanos, 123456789);
+    ASSERT_EQ(metrics.cgmem_metrics.mem_limit, 9223372036854771712ULL);
+    ASSERT_EQ(metrics.cgmem_metrics.mem_used, 8192);
+    ASSERT_EQ(metrics.cgmem_metrics.total_rss, 2048);
+    ASSERT_EQ(metrics.cgmem_metrics.total_pgfault, 11);
+    ASSERT_EQ(metrics.cgmem_metrics.total_pgmajfault, 2);
+    ASSERT_EQ(metrics.cgmem_metrics.total_inactive_file, 1024);
+    ASSERT_EQ(metrics.cgpids_metrics.pid_current, 9);
+
+    ASSERT_EQ(common_get_cgroup_v1_metrics_in_layers(&layers, "isulad/missing", &metrics), -1);
+}
+
+TEST(CgroupCpuUnitTest, test_common_cgroup_path_from_oci)
+{
+    struct {
+        const char *input;
+        const char *expect;
+    } cases[] = {
+        { "/isulad/abc", "/isulad/abc" },
+        { "isulad/abc", "isulad/abc" },
+        { "system.slice:isulad:abc", "/system.slice/isulad-abc.scope" },
+        { ":isulad:abc", "/system.slice/isulad-abc.scope" },
+        { "kubepods-besteffort-pod1.slice:cri-containerd:abc",
+          "/kubepods.slice/kubepods-besteffort.slice/kubepods-besteffort-pod1.slice/cri-containerd-abc.scope" },
+        { "-.slice:isulad:abc", "/isulad-abc.scope" },
+        { "kubepods.slice:isulad:pod1.slice", "/kubepods.slice/pod1.slice" },
+    };
+    const char *invalid[] = { "isulad:abc", "a:b:c:d", "system.slice:isulad:", "system:isulad:abc",
+                              "a--b.slice:isulad:abc", "a/b.slice:isulad:abc"
+                            };
+    size_t i;
+
+    ASSERT_EQ(common_cgroup_path_from_oci(nullptr), nullptr);
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char *path = common_cgroup_path_from_oci(cases[i].input);
+        ASSERT_NE(path, nullptr) << cases[i].input;
+        ASSERT_STREQ(path, cases[i].expect);
+        free(path);
+    }
+    for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        ASSERT_EQ(common_cgroup_path_from_oci(invalid[i]), nullptr) << invalid[i];
+    }
+}
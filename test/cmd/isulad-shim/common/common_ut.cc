@@ -16,6 +16,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <signal.h>
+#include <string.h>
 #include <unistd.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -87,3 +89,116 @@ TEST_F(CommonUnitTest, test_combined_output)
     params[0] = non_cmd.c_str();
     EXPECT_EQ(cmd_combined_output(non_cmd.c_str(), params, output, &output_len), -1);
 }
+
+TEST_F(CommonUnitTest, test_forward_in_kernel_splice)
+{
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    char buf[32] = { 0 };
+    ssize_t moved = 0;
+
+    ASSERT_EQ(pipe2(src, O_NONBLOCK), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+
+    // splice moves data out of the source
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, false, true, &moved), SHIM_FORWARD_DONE);
+    EXPECT_EQ(moved, 5);
+    EXPECT_EQ(read(dst[0], buf, sizeof(buf)), 5);
+    EXPECT_EQ(memcmp(buf, "hello", 5), 0);
+
+    // nothing to read, wait for more data if reading blocked, otherwise treat as the end
+    moved = -1;
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, false, true, &moved), SHIM_FORWARD_DONE);
+    EXPECT_EQ(moved, 0);
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, false, false, &moved), SHIM_FORWARD_EOF);
+
+    close(src[1]);
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, false, true, &moved), SHIM_FORWARD_EOF);
+
+    close(src[0]);
+    close(dst[0]);
+    close(dst[1]);
+}
+
+TEST_F(CommonUnitTest, test_forward_in_kernel_tee)
+{
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    char buf[32] = { 0 };
+    ssize_t moved = 0;
+
+    ASSERT_EQ(pipe2(src, O_NONBLOCK), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+
+    // tee copies data to the destination and keeps it in the source for container log
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, true, true, &moved), SHIM_FORWARD_DONE);
+    EXPECT_EQ(moved, 5);
+    EXPECT_EQ(read(dst[0], buf, sizeof(buf)), 5);
+    EXPECT_EQ(memcmp(buf, "hello", 5), 0);
+    (void)memset(buf, 0, sizeof(buf));
+    EXPECT_EQ(read(src[0], buf, sizeof(buf)), 5);
+    EXPECT_EQ(memcmp(buf, "hello", 5), 0);
+
+    close(src[0]);
+    close(src[1]);
+    close(dst[0]);
+    close(dst[1]);
+}
+
+TEST_F(CommonUnitTest, test_forward_in_kernel_unsupported)
+{
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    char tmpl[] = "/tmp/shim_forward_XXXXXX";
+    int file_fd = mkstemp(tmpl);
+    int append_fd = -1;
+    ssize_t moved = 0;
+    char buf[32] = { 0 };
+
+    ASSERT_GE(file_fd, 0);
+    append_fd = open(tmpl, O_WRONLY | O_APPEND);
+    ASSERT_GE(append_fd, 0);
+    ASSERT_EQ(pipe2(src, O_NONBLOCK), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+
+    // splice can not write to a file opened with O_APPEND, data stays for the copy loop
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &append_fd, 4096, false, true, &moved), SHIM_FORWARD_UNSUPPORTED);
+    EXPECT_GE(append_fd, 0);
+    // tee needs pipes on both sides
+    EXPECT_EQ(shim_forward_in_kernel(file_fd, &dst[1], 4096, true, true, &moved), SHIM_FORWARD_UNSUPPORTED);
+    EXPECT_EQ(read(src[0], buf, sizeof(buf)), 5);
+
+    int invalid_fd = -1;
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &invalid_fd, 4096, false, true, &moved), SHIM_FORWARD_FALLBACK);
+
+    close(append_fd);
+    close(file_fd);
+    (void)unlink(tmpl);
+    close(src[0]);
+    close(src[1]);
+    close(dst[0]);
+    close(dst[1]);
+}
+
+TEST_F(CommonUnitTest, test_forward_in_kernel_write_error)
+{
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    ssize_t moved = 0;
+
+    ASSERT_EQ(pipe2(src, O_NONBLOCK), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+    close(dst[0]);
+
+    // the reader of destination is gone, destination is closed and data is left for the copy loop
+    signal(SIGPIPE, SIG_IGN);
+    EXPECT_EQ(shim_forward_in_kernel(src[0], &dst[1], 4096, false, true, &moved), SHIM_FORWARD_FALLBACK);
+    EXPECT_EQ(dst[1], -1);
+
+    close(src[0]);
+    close(src[1]);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: isulad config snapshot unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <string>
+#include <gtest/gtest.h>
+#include "daemon_arguments.h"
+#include "isulad_config.h"
+#include "utils.h"
+
+static struct service_arguments *new_args(const char *graph, const char *state)
+{
+    struct service_arguments *args = (struct service_arguments *)util_common_calloc_s(sizeof(struct service_arguments));
+    if (args == nullptr) {
+        return nullptr;
+    }
+
+    args->json_confs = (isulad_daemon_configs *)util_common_calloc_s(sizeof(isulad_daemon_configs));
+    if (args->json_confs == nullptr) {
+        free(args);
+        return nullptr;
+    }
+
+    if (graph != nullptr) {
+        args->json_confs->graph = util_strdup_s(graph);
+    }
+    if (state != nullptr) {
+        args->json_confs->state = util_strdup_s(state);
+    }
+
+    return args;
+}
+
+static std::string to_string(char *str)
+{
+    std::string result = str != nullptr ? str : "(null)";
+
+    free(str);
+    return result;
+}
+
+// all the cases share the process wide conf, keep them in one test so the order is fixed
+TEST(IsuladConfigUnitTest, test_conf_snapshot_build_and_publish)
+{
+    const struct isulad_conf_snapshot *first = nullptr;
+    const struct isulad_conf_snapshot *second = nullptr;
+    char path[PATH_MAX] = { 0 };
+    char small[8] = { 0 };
+
+    ASSERT_EQ(conf_get_snapshot(), nullptr);
+    ASSERT_EQ(conf_snapshot_rootdir(), nullptr);
+    ASSERT_EQ(conf_get_isulad_rootdir(), nullptr);
+    ASSERT_EQ(conf_snapshot_routine_rootdir("lcr", path, sizeof(path)), -1);
+
+    ASSERT_EQ(save_args_to_conf(new_args("/var/lib/isulad", "/var/run/isulad")), 0);
+    first = conf_get_snapshot();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(conf_snapshot_retired_count(), (size_t)0);
+
+    // derived paths are built once and keep the old format
+    ASSERT_STREQ(first->rootdir, "/var/lib/isulad");
+    ASSERT_STREQ(first->statedir, "/var/run/isulad");
+    ASSERT_STREQ(first->engine_rootpath, "/var/lib/isulad/engines");
+    ASSERT_STREQ(first->mount_rootfs, "/var/lib/isulad/mnt/rootfs");
+    ASSERT_STREQ(first->graph_check_flag_file, "/var/lib/isulad/storage/NEED_CHECK");
+    ASSERT_STREQ(first->monitor_fifo_path, "/var/run/isulad/monitord_fifo");
+
+    // the const accessors return the snapshot strings themselves
+    ASSERT_EQ(conf_snapshot_rootdir(), first->rootdir);
+    ASSERT_EQ(conf_snapshot_statedir(), first->statedir);
+    ASSERT_EQ(conf_snapshot_engine_rootpath(), first->engine_rootpath);
+    ASSERT_EQ(conf_snapshot_monitor_fifo_path(), first->monitor_fifo_path);
+
+    ASSERT_EQ(conf_snapshot_routine_rootdir("lcr", path, sizeof(path)), 0);
+    ASSERT_STREQ(path, "/var/lib/isulad/engines/lcr");
+    ASSERT_EQ(conf_snapshot_routine_statedir("lcr", path, sizeof(path)), 0);
+    ASSERT_STREQ(path, "/var/run/isulad/lcr");
+    ASSERT_EQ(conf_snapshot_routine_rootdir(nullptr, path, sizeof(path)), -1);
+    ASSERT_EQ(conf_snapshot_routine_statedir(nullptr, path, sizeof(path)), -1);
+    ASSERT_EQ(conf_snapshot_routine_rootdir("lcr", small, sizeof(small)), -1);
+
+    // the copying getters agree with the snapshot
+    ASSERT_EQ(to_string(conf_get_isulad_rootdir()), "/var/lib/isulad");
+    ASSERT_EQ(to_string(conf_get_isulad_statedir()), "/var/run/isulad");
+    ASSERT_EQ(to_string(conf_get_engine_rootpath()), "/var/lib/isulad/engines");
+    ASSERT_EQ(to_string(conf_get_routine_rootdir("lcr")), "/var/lib/isulad/engines/lcr");
+    ASSERT_EQ(to_string(conf_get_routine_statedir("lcr")), "/var/run/isulad/lcr");
+    ASSERT_EQ(to_string(conf_get_isulad_mount_rootfs()), "/var/lib/isulad/mnt/rootfs");
+    ASSERT_EQ(to_string(conf_get_isulad_monitor_fifo_path()), "/var/run/isulad/monitord_fifo");
+    ASSERT_EQ(to_string(conf_get_graph_check_flag_file()), "/var/lib/isulad/storage/NEED_CHECK");
+
+    // publishing again retires the old snapshot, a reader still holding it sees valid paths
+    ASSERT_EQ(save_args_to_conf(new_args("/data/isulad", nullptr)), 0);
+    second = conf_get_snapshot();
+    ASSERT_NE(second, nullptr);
+    ASSERT_NE(second, first);
+    ASSERT_EQ(conf_snapshot_retired_count(), (size_t)1);
+    ASSERT_STREQ(first->engine_rootpath, "/var/lib/isulad/engines");
+    ASSERT_STREQ(first->monitor_fifo_path, "/var/run/isulad/monitord_fifo");
+
+    ASSERT_STREQ(conf_snapshot_rootdir(), "/data/isulad");
+    ASSERT_STREQ(conf_snapshot_engine_rootpath(), "/data/isulad/engines");
+    ASSERT_EQ(conf_snapshot_statedir(), nullptr);
+    ASSERT_EQ(conf_snapshot_monitor_fifo_path(), nullptr);
+    ASSERT_EQ(conf_snapshot_routine_statedir("lcr", path, sizeof(path)), -1);
+    ASSERT_EQ(conf_get_isulad_monitor_fifo_path(), nullptr);
+
+    // the list only grows by one per save
+    ASSERT_EQ(save_args_to_conf(new_args("/data/isulad", "/run/isulad")), 0);
+    ASSERT_EQ(conf_snapshot_retired_count(), (size_t)2);
+    ASSERT_STREQ(conf_snapshot_monitor_fifo_path(), "/run/isulad/monitord_fifo");
+}
+
+TEST(IsuladConfigUnitTest, test_conf_snapshot_path_too_long)
+{
+    const struct isulad_conf_snapshot *current = conf_get_snapshot();
+    size_t retired = conf_snapshot_retired_count();
+    std::string graph = "/" + std::string(PATH_MAX, 'a');
+    struct service_arguments *args = new_args(graph.c_str(), "/run/isulad");
+
+    ASSERT_NE(args, nullptr);
+    // a snapshot that can not be built is not published, the old one stays
+    ASSERT_EQ(save_args_to_conf(args), -1);
+    ASSERT_EQ(conf_get_snapshot(), current);
+    ASSERT_EQ(conf_snapshot_retired_count(), retired);
+    service_arguments_free(args);
+    free(args);
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: console io copy unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <gtest/gtest.h>
+#include "console.h"
+
+namespace {
+ssize_t string_write(void *context, const void *data, size_t len)
+{
+    static_cast<std::string *>(context)->append(static_cast<const char *>(data), len);
+    return (ssize_t)len;
+}
+}
+
+class ConsoleIOCopyUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/console_ut_XXXXXX";
+
+        m_file_fd = mkstemp(tmpl);
+        ASSERT_GE(m_file_fd, 0);
+        m_file = tmpl;
+        // splice refuses to write to a file opened with O_APPEND
+        m_append_fd = open(m_file.c_str(), O_WRONLY | O_APPEND);
+        ASSERT_GE(m_append_fd, 0);
+    }
+
+    void TearDown() override
+    {
+        close(m_append_fd);
+        close(m_file_fd);
+        (void)unlink(m_file.c_str());
+    }
+
+    static std::string ReadPipe(int fd)
+    {
+        std::string out;
+        char buf[4096];
+        ssize_t n;
+
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            out.append(buf, n);
+        }
+        return out;
+    }
+
+    std::string m_file;
+    int m_file_fd { -1 };
+    int m_append_fd { -1 };
+};
+
+TEST_F(ConsoleIOCopyUnitTest, test_splice_to_fd_writer)
+{
+    int src[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    std::string copied;
+    struct io_write_wrapper writer = { &copied, string_write, nullptr, 0 };
+    transfer_channel_type channel = STDOUT_CHANNEL;
+
+    ASSERT_EQ(pipe(src), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+    close(src[1]);
+
+    ASSERT_EQ(console_loop_io_copy(-1, &src[0], &dst[1], &writer, &channel, 1), 0);
+    // data is moved inside kernel, the writer callback is not used
+    ASSERT_EQ(ReadPipe(dst[0]), "hello");
+    ASSERT_TRUE(copied.empty());
+
+    close(src[0]);
+    close(dst[0]);
+    close(dst[1]);
+}
+
+TEST_F(ConsoleIOCopyUnitTest, test_fallback_to_copy)
+{
+    int src[2] = { -1, -1 };
+    std::string copied;
+    struct io_write_wrapper writer = { &copied, string_write, nullptr, 0 };
+    transfer_channel_type channel = STDERR_CHANNEL;
+
+    ASSERT_EQ(pipe(src), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+    close(src[1]);
+
+    // writer fd does not support splice, copy data by the writer callback
+    ASSERT_EQ(console_loop_io_copy(-1, &src[0], &m_append_fd, &writer, &channel, 1), 0);
+    ASSERT_EQ(copied, "hello");
+
+    close(src[0]);
+}
+
+TEST_F(ConsoleIOCopyUnitTest, test_no_fd_writer)
+{
+    int src[2] = { -1, -1 };
+    std::string copied;
+    struct io_write_wrapper writer = { &copied, string_write, nullptr, 0 };
+    transfer_channel_type channel = STDOUT_CHANNEL;
+
+    ASSERT_EQ(pipe(src), 0);
+    ASSERT_EQ(write(src[1], "hello", 5), 5);
+    close(src[1]);
+
+    ASSERT_EQ(console_loop_io_copy(-1, &src[0], nullptr, &writer, &channel, 1), 0);
+    ASSERT_EQ(copied, "hello");
+
+    close(src[0]);
+}
+
+TEST_F(ConsoleIOCopyUnitTest, test_fallback_is_per_channel)
+{
+    int out[2] = { -1, -1 };
+    int err[2] = { -1, -1 };
+    int dst[2] = { -1, -1 };
+    std::string out_copied;
+    std::string err_copied;
+    struct io_write_wrapper writers[2] = { { &out_copied, string_write, nullptr, 0 },
+        { &err_copied, string_write, nullptr, 0 } };
+    transfer_channel_type channels[2] = { STDOUT_CHANNEL, STDERR_CHANNEL };
+    int srcfds[2];
+    int dstfds[2];
+
+    ASSERT_EQ(pipe(out), 0);
+    ASSERT_EQ(pipe(err), 0);
+    ASSERT_EQ(pipe2(dst, O_NONBLOCK), 0);
+    ASSERT_EQ(write(out[1], "stdout", 6), 6);
+    ASSERT_EQ(write(err[1], "stderr", 6), 6);
+    close(out[1]);
+    close(err[1]);
+
+    srcfds[0] = out[0];
+    srcfds[1] = err[0];
+    dstfds[0] = m_append_fd;
+    dstfds[1] = dst[1];
+    ASSERT_EQ(console_loop_io_copy(-1, srcfds, dstfds, writers, channels, 2), 0);
+
+    // stdout falls back to copy, stderr keeps splicing
+    ASSERT_EQ(out_copied, "stdout");
+    ASSERT_TRUE(err_copied.empty());
+    ASSERT_EQ(ReadPipe(dst[0]), "stderr");
+
+    close(out[0]);
+    close(err[0]);
+    close(dst[0]);
+    close(dst[1]);
+}
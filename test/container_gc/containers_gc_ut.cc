@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: containers gc journal unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "containers_gc.h"
+#include "isulad_config.h"
+#include "isula_libutils/container_garbage_config.h"
+#include "isulad_config_mock.h"
+#include "utils.h"
+#include "utils_file.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+// records appended before garbage.json is rewritten
+#define GC_UT_COMPACT_RECORDS 64
+
+class ContainersGcUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/containers_gc_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_rootdir = tmpl;
+        m_snapshot.rootdir = const_cast<char *>(m_rootdir.c_str());
+        MockIsuladConf_SetMock(&m_isuladConf);
+        ON_CALL(m_isuladConf, ConfGetSnapshot()).WillByDefault(Return(&m_snapshot));
+    }
+
+    void TearDown() override
+    {
+        MockIsuladConf_SetMock(nullptr);
+        (void)util_recursive_rmdir(m_rootdir.c_str(), 0);
+    }
+
+    std::string JournalPath()
+    {
+        return m_rootdir + "/garbage.journal";
+    }
+
+    std::string ConfigPath()
+    {
+        return m_rootdir + "/garbage.json";
+    }
+
+    void WriteFile(const std::string &path, const std::string &content)
+    {
+        ASSERT_EQ(util_write_file(path.c_str(), content.c_str(), content.size(), 0600), 0);
+    }
+
+    size_t JournalRecords()
+    {
+        char *content = util_read_content_from_file(JournalPath().c_str());
+        size_t records = 0;
+
+        if (content == nullptr) {
+            return 0;
+        }
+        for (char *c = content; *c != '\0'; c++) {
+            if (*c == '\n') {
+                records++;
+            }
+        }
+        free(content);
+        return records;
+    }
+
+    static void AddContainer(const std::string &id, int pid)
+    {
+        pid_ppid_info_t pid_info = { 0 };
+
+        pid_info.pid = pid;
+        pid_info.start_time = 1;
+        pid_info.ppid = pid + 1;
+        pid_info.pstart_time = 2;
+        ASSERT_EQ(gc_add_container(id.c_str(), "runc", &pid_info), 0);
+    }
+
+    NiceMock<MockIsuladConf> m_isuladConf;
+    struct isulad_conf_snapshot m_snapshot = { 0 };
+    std::string m_rootdir;
+};
+
+TEST_F(ContainersGcUnitTest, test_replay_journal_records)
+{
+    container_garbage_config_gc_containers_element saved = { 0 };
+    container_garbage_config_gc_containers_element *saves[] = { &saved };
+    container_garbage_config config = { 0 };
+    container_garbage_config *restored = nullptr;
+    parser_error err = nullptr;
+    char *json = nullptr;
+
+    saved.id = const_cast<char *>("c1");
+    saved.runtime = const_cast<char *>("runc");
+    saved.pid = 100;
+    config.gc_containers = saves;
+    config.gc_containers_len = 1;
+    json = container_garbage_config_generate_json(&config, nullptr, &err);
+    ASSERT_NE(json, nullptr);
+    WriteFile(ConfigPath(), json);
+    free(json);
+    free(err);
+
+    WriteFile(JournalPath(),
+              "add c2 runc 200 1 201 18446744073709551615\n"
+              // a record replayed twice after a crash during compaction is applied once
+              "add c2 runc 200 1 201 18446744073709551615\n"
+              "add c3 runc 300 1 301 2\n"
+              "del c1 100\n"
+              // a del of another process of the container keeps the entry
+              "del c3 999\n"
+              "add c4 runc notapid 1 401 2\n"
+              "add c5 runc 500 1 501\n"
+              "del c6\n"
+              "unknown c7 700\n"
+              // a truncated last record is ignored
+              "add c8 runc 8");
+
+    ASSERT_EQ(new_gchandler(), 0);
+
+    ASSERT_FALSE(gc_is_gc_progress("c1"));
+    ASSERT_TRUE(gc_is_gc_progress("c2"));
+    ASSERT_TRUE(gc_is_gc_progress("c3"));
+    ASSERT_FALSE(gc_is_gc_progress("c4"));
+    ASSERT_FALSE(gc_is_gc_progress("c5"));
+    ASSERT_FALSE(gc_is_gc_progress("c8"));
+
+    // restore compacts the journal into garbage.json
+    ASSERT_FALSE(util_file_exists(JournalPath().c_str()));
+    restored = read_gc_config();
+    ASSERT_NE(restored, nullptr);
+    ASSERT_EQ(restored->gc_containers_len, 2);
+    ASSERT_STREQ(restored->gc_containers[0]->id, "c2");
+    ASSERT_STREQ(restored->gc_containers[0]->runtime, "runc");
+    ASSERT_EQ(restored->gc_containers[0]->pid, 200);
+    ASSERT_EQ(restored->gc_containers[0]->start_time, 1);
+    ASSERT_EQ(restored->gc_containers[0]->ppid, 201);
+    ASSERT_EQ(restored->gc_containers[0]->p_start_time, UINT64_MAX);
+    ASSERT_STREQ(restored->gc_containers[1]->id, "c3");
+    ASSERT_EQ(restored->gc_containers[1]->pid, 300);
+    free_container_garbage_config(restored);
+}
+
+TEST_F(ContainersGcUnitTest, test_journal_compact_after_records)
+{
+    container_garbage_config *restored = nullptr;
+    int i;
+
+    ASSERT_EQ(new_gchandler(), 0);
+
+    for (i = 1; i < GC_UT_COMPACT_RECORDS; i++) {
+        AddContainer("c" + std::to_string(i), 1000 + i);
+    }
+    // records are only appended to the journal
+    ASSERT_EQ(JournalRecords(), GC_UT_COMPACT_RECORDS - 1);
+    restored = read_gc_config();
+    ASSERT_NE(restored, nullptr);
+    ASSERT_EQ(restored->gc_containers_len, 0);
+    free_container_garbage_config(restored);
+
+    // the 64th record rewrites garbage.json and drops the journal
+    AddContainer("c" + std::to_string(GC_UT_COMPACT_RECORDS), 1000 + GC_UT_COMPACT_RECORDS);
+    ASSERT_FALSE(util_file_exists(JournalPath().c_str()));
+    restored = read_gc_config();
+    ASSERT_NE(restored, nullptr);
+    ASSERT_EQ(restored->gc_containers_len, GC_UT_COMPACT_RECORDS);
+    ASSERT_STREQ(restored->gc_containers[GC_UT_COMPACT_RECORDS - 1]->id, "c64");
+    free_container_garbage_config(restored);
+
+    // the journal starts again and is replayed on top of garbage.json
+    AddContainer("c65", 1065);
+    ASSERT_EQ(JournalRecords(), 1);
+    ASSERT_EQ(new_gchandler(), 0);
+    ASSERT_TRUE(gc_is_gc_progress("c1"));
+    ASSERT_TRUE(gc_is_gc_progress("c64"));
+    ASSERT_TRUE(gc_is_gc_progress("c65"));
+    restored = read_gc_config();
+    ASSERT_NE(restored, nullptr);
+    ASSERT_EQ(restored->gc_containers_len, GC_UT_COMPACT_RECORDS + 1);
+    free_container_garbage_config(restored);
+}
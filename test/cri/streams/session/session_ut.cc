@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: websocket session ring buffer unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "session.h"
+#include "ws_server.h"
+#include "utils.h"
+
+// must match the ring layout in session.cc
+#define SESSION_UT_RING_SIZE (256 * 1024)
+#define SESSION_UT_FRAME_HEADER_LEN 5
+
+class SessionUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_session.sessionMutex = &m_mutex;
+        m_session.bufferCond = &m_cond;
+        m_session.close = false;
+        m_session.pipes = { -1, -1 };
+        ASSERT_EQ(m_session.InitBuffer(), 0);
+    }
+
+    void TearDown() override
+    {
+        m_session.FreeBuffer();
+        for (auto fd : m_stdin) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // a stdin pipe the container does not read, filled up to the last byte
+    void FillStdinPipe()
+    {
+        std::string filler(4096, 'f');
+        int fds[2] = { -1, -1 };
+
+        ASSERT_EQ(pipe2(fds, O_NONBLOCK | O_CLOEXEC), 0);
+        m_stdin = { fds[0], fds[1] };
+        m_session.pipes = { -1, fds[1] };
+        while (write(fds[1], filler.data(), filler.size()) > 0) {
+        }
+        while (write(fds[1], "f", 1) > 0) {
+        }
+        ASSERT_EQ(errno, EAGAIN);
+    }
+
+    // what the container reads from stdin, after the filler of FillStdinPipe
+    std::string ReadStdin()
+    {
+        std::string data;
+        char buf[4096];
+        ssize_t n;
+
+        while ((n = read(m_stdin[0], buf, sizeof(buf))) > 0) {
+            data.append(buf, static_cast<size_t>(n));
+        }
+        data.erase(0, data.find_first_not_of('f'));
+        return data;
+    }
+
+    static std::string MakePayload(size_t len, unsigned int seed)
+    {
+        std::string data(len, '\0');
+        size_t i;
+
+        for (i = 0; i < len; i++) {
+            seed = seed * 1103515245 + 12345;
+            // every fourth byte is a NUL, the others are random
+            data[i] = (i % 4 == 0) ? '\0' : static_cast<char>(seed >> 16);
+        }
+        return data;
+    }
+
+    void ExpectFront(unsigned char channel, const std::string &data)
+    {
+        std::vector<unsigned char> buf(MAX_BUFFER_SIZE + 1);
+
+        ASSERT_EQ(m_session.FrontMessage(buf.data(), buf.size()), static_cast<ssize_t>(data.size() + 1));
+        ASSERT_EQ(buf[0], channel);
+        ASSERT_EQ(std::string(reinterpret_cast<char *>(buf.data() + 1), data.size()), data);
+    }
+
+    // fill the ring with frames until one more frame of len bytes does not fit, return the bytes used
+    size_t FillRing(size_t len)
+    {
+        std::string data = MakePayload(len, 1);
+        size_t used = 0;
+
+        while (used + SESSION_UT_FRAME_HEADER_LEN + len <= SESSION_UT_RING_SIZE) {
+            EXPECT_EQ(m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size()), 0);
+            used += SESSION_UT_FRAME_HEADER_LEN + len;
+        }
+        return used;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    SessionData m_session {};
+    std::array<int, 2> m_stdin { -1, -1 };
+};
+
+TEST_F(SessionUnitTest, test_push_front_pop)
+{
+    std::vector<unsigned char> buf(MAX_BUFFER_SIZE + 1);
+    std::string binary("a\0b\0\0c", 6);
+
+    ASSERT_FALSE(m_session.HasMessage());
+    ASSERT_EQ(m_session.FrontMessage(buf.data(), buf.size()), -1);
+
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, binary.data(), binary.size()), 0);
+    ASSERT_EQ(m_session.PushMessage(STDERRCHANNEL, "", 0), 0);
+    ASSERT_TRUE(m_session.HasMessage());
+
+    // front does not consume the message
+    ExpectFront(STDOUTCHANNEL, binary);
+    ExpectFront(STDOUTCHANNEL, binary);
+    m_session.PopMessage();
+    ExpectFront(STDERRCHANNEL, "");
+    m_session.PopMessage();
+    ASSERT_FALSE(m_session.HasMessage());
+
+    // pop of an empty ring is a no-op
+    m_session.PopMessage();
+    ASSERT_FALSE(m_session.HasMessage());
+    ASSERT_EQ(m_session.stats.messagesOut, 2);
+    ASSERT_EQ(m_session.stats.bytesOut, binary.size());
+}
+
+TEST_F(SessionUnitTest, test_front_buffer_too_small)
+{
+    std::string data = MakePayload(100, 3);
+    unsigned char buf[100] = { 0 };
+
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size()), 0);
+    // the channel byte needs room too
+    ASSERT_EQ(m_session.FrontMessage(buf, sizeof(buf)), -1);
+    ASSERT_EQ(m_session.FrontMessage(buf, 0), -1);
+    ASSERT_EQ(m_session.FrontMessage(nullptr, sizeof(buf)), -1);
+    ASSERT_TRUE(m_session.HasMessage());
+}
+
+TEST_F(SessionUnitTest, test_ring_wrap_around)
+{
+    std::deque<std::pair<unsigned char, std::string>> expected;
+    unsigned int seed = 7;
+    size_t used = 0;
+    size_t pushed = 0;
+    int i;
+
+    // odd frame sizes wrap the ring at every offset, splitting the channel byte, the length and the payload
+    for (i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        size_t len = (seed >> 8) % (MAX_BUFFER_SIZE + 1);
+        bool push = ((seed >> 4) % 3 != 0) && used + SESSION_UT_FRAME_HEADER_LEN + len <= SESSION_UT_RING_SIZE;
+
+        if (push) {
+            unsigned char channel = (i % 2 == 0) ? STDOUTCHANNEL : STDERRCHANNEL;
+            std::string data = MakePayload(len, seed);
+            ASSERT_EQ(m_session.PushMessage(channel, data.data(), data.size()), 0);
+            expected.emplace_back(channel, data);
+            used += SESSION_UT_FRAME_HEADER_LEN + len;
+            pushed += SESSION_UT_FRAME_HEADER_LEN + len;
+            continue;
+        }
+        if (expected.empty()) {
+            continue;
+        }
+        ExpectFront(expected.front().first, expected.front().second);
+        used -= SESSION_UT_FRAME_HEADER_LEN + expected.front().second.size();
+        expected.pop_front();
+        m_session.PopMessage();
+    }
+
+    // make sure the ring wrapped many times
+    ASSERT_GT(pushed, 10 * SESSION_UT_RING_SIZE);
+    while (!expected.empty()) {
+        ExpectFront(expected.front().first, expected.front().second);
+        expected.pop_front();
+        m_session.PopMessage();
+    }
+    ASSERT_FALSE(m_session.HasMessage());
+    ASSERT_LE(m_session.stats.peakQueueBytes, SESSION_UT_RING_SIZE);
+}
+
+TEST_F(SessionUnitTest, test_writer_blocks_until_drained)
+{
+    std::string data = MakePayload(MAX_BUFFER_SIZE, 5);
+
+    FillRing(data.size());
+    auto writer = std::async(std::launch::async, [this, &data]() {
+        return m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size());
+    });
+
+    // the ring is full, the writer waits for the client
+    ASSERT_EQ(writer.wait_for(std::chrono::milliseconds(300)), std::future_status::timeout);
+    m_session.PopMessage();
+    ASSERT_EQ(writer.get(), 0);
+    ASSERT_EQ(m_session.stats.backpressureWaits, 1);
+    ASSERT_EQ(m_session.stats.messagesDropped, 0);
+}
+
+TEST_F(SessionUnitTest, test_writer_unblocked_by_close)
+{
+    std::string data = MakePayload(MAX_BUFFER_SIZE, 5);
+
+    FillRing(data.size());
+    auto writer = std::async(std::launch::async, [this, &data]() {
+        return m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size());
+    });
+
+    ASSERT_EQ(writer.wait_for(std::chrono::milliseconds(300)), std::future_status::timeout);
+    m_session.CloseSession();
+    ASSERT_EQ(writer.get(), -1);
+    ASSERT_EQ(m_session.stats.messagesDropped, 1);
+
+    // a closed session takes no more messages
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, "x", 1), -1);
+}
+
+TEST_F(SessionUnitTest, test_writer_drops_after_timeout)
+{
+    std::string data = MakePayload(MAX_BUFFER_SIZE, 5);
+    auto start = std::chrono::steady_clock::now();
+
+    FillRing(data.size());
+    // nobody drains the ring, the message is dropped after 30 seconds instead of blocking forever
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size()), -1);
+    ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::seconds(30));
+    ASSERT_EQ(m_session.stats.messagesDropped, 1);
+
+    // until the client reads again, the following writers drop at once instead of waiting 30 seconds each
+    start = std::chrono::steady_clock::now();
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size()), -1);
+    ASSERT_EQ(m_session.PushMessage(STDERRCHANNEL, data.data(), data.size()), -1);
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    ASSERT_EQ(m_session.stats.messagesDropped, 3);
+    ASSERT_EQ(m_session.stats.backpressureWaits, 1);
+
+    // the ring still holds the queued messages
+    m_session.PopMessage();
+    ASSERT_EQ(m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size()), 0);
+}
+
+TEST_F(SessionUnitTest, test_stdin_does_not_block_with_full_ring)
+{
+    std::string data = MakePayload(MAX_BUFFER_SIZE, 5);
+    auto start = std::chrono::steady_clock::now();
+
+    FillStdinPipe();
+    FillRing(data.size());
+    // the output of the container waits for the client, like an echoing exec -i
+    auto writer = std::async(std::launch::async, [this, &data]() {
+        return m_session.PushMessage(STDOUTCHANNEL, data.data(), data.size());
+    });
+
+    // the container does not read stdin, the service thread still returns at once
+    ASSERT_EQ(m_session.WriteStdin("abc", 3), 0);
+    ASSERT_EQ(m_session.WriteStdin("def", 3), 0);
+    ASSERT_TRUE(m_session.HasPendingStdin());
+    ASSERT_EQ(m_session.FlushStdin(), 0);
+    ASSERT_TRUE(m_session.HasPendingStdin());
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    // and goes on draining the ring for the client
+    ASSERT_EQ(writer.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    m_session.PopMessage();
+    ASSERT_EQ(writer.get(), 0);
+
+    // once the container reads, the pending stdin follows in order
+    std::string got = ReadStdin();
+    ASSERT_EQ(m_session.FlushStdin(), 0);
+    ASSERT_FALSE(m_session.HasPendingStdin());
+    got += ReadStdin();
+    ASSERT_EQ(got, "abcdef");
+    ASSERT_EQ(m_session.stats.messagesDropped, 0);
+}
+
+TEST_F(SessionUnitTest, test_stdin_write_failure)
+{
+    int fds[2] = { -1, -1 };
+
+    ASSERT_EQ(m_session.WriteStdin("abc", 3), -1);
+    ASSERT_EQ(m_session.WriteStdin("", 0), 0);
+
+    // the container closed its stdin
+    ASSERT_EQ(pipe2(fds, O_NONBLOCK | O_CLOEXEC), 0);
+    m_stdin = { -1, fds[1] };
+    m_session.pipes = { -1, fds[1] };
+    close(fds[0]);
+    signal(SIGPIPE, SIG_IGN);
+    ASSERT_EQ(m_session.WriteStdin("abc", 3), -1);
+    ASSERT_FALSE(m_session.HasPendingStdin());
+}
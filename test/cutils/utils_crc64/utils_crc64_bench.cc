@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: compare crc64 of libisula and utils_crc64
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <isula_libutils/go_crc64.h>
+#include "utils_crc64.h"
+
+// usage: utils_crc64_bench [size in MB] [rounds]
+int main(int argc, char **argv)
+{
+    size_t mb = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+    int rounds = argc > 2 ? atoi(argv[2]) : 3;
+    std::vector<unsigned char> data(mb * 1024 * 1024, 0x5a);
+    const isula_crc_table_t *ctab = new_isula_crc_table(ISO_POLY);
+
+    if (ctab == nullptr || mb == 0 || rounds <= 0) {
+        fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+
+    auto bench = [&](const char *name, uint64_t (*fn)(const isula_crc_table_t *, const std::vector<unsigned char> &)) {
+        uint64_t crc = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++) {
+            crc = fn(ctab, data);
+        }
+        std::chrono::duration<double> cost = std::chrono::steady_clock::now() - start;
+        printf("%-10s crc 0x%016llx %10.1f MB/s\n", name, (unsigned long long)crc, mb * rounds / cost.count());
+    };
+
+    bench("libisula", [](const isula_crc_table_t *t, const std::vector<unsigned char> &d) {
+        uint64_t crc = 0;
+        (void)isula_crc_update(t, &crc, const_cast<unsigned char *>(d.data()), d.size());
+        return crc;
+    });
+    bench("generic", [](const isula_crc_table_t *t, const std::vector<unsigned char> &d) {
+        return util_crc64_iso_update_generic(0, d.data(), d.size());
+    });
+    bench(util_crc64_accelerated() ? "clmul" : "default", [](const isula_crc_table_t *t,
+    const std::vector<unsigned char> &d) {
+        return util_crc64_iso_update(0, d.data(), d.size());
+    });
+
+    return 0;
+}
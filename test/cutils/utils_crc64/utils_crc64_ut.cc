@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: utils_crc64 unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <isula_libutils/go_crc64.h>
+#include "utils_crc64.h"
+
+TEST(utils_crc64, test_util_crc64_iso_update_known_value)
+{
+    const char *data = "hello world";
+
+    ASSERT_EQ(util_crc64_iso_update(0, nullptr, 0), 0);
+    ASSERT_EQ(util_crc64_iso_update(0, data, strlen(data)), 0xb9cf3f572ad9ac3eULL);
+    ASSERT_EQ(util_crc64_iso_update_generic(0, data, strlen(data)), 0xb9cf3f572ad9ac3eULL);
+}
+
+TEST(utils_crc64, test_util_crc64_iso_update_same_as_libisula)
+{
+    const isula_crc_table_t *ctab = new_isula_crc_table(ISO_POLY);
+    std::vector<unsigned char> data(64 * 1024 + 37);
+
+    ASSERT_NE(ctab, nullptr);
+    srand(1);
+    for (auto &c : data) {
+        c = (unsigned char)rand();
+    }
+
+    // cover lengths around the folding boundaries and unaligned start
+    for (size_t len = 0; len < 1024; len++) {
+        uint64_t expected = 0;
+        ASSERT_TRUE(isula_crc_update(ctab, &expected, data.data() + 3, len));
+        ASSERT_EQ(util_crc64_iso_update(0, data.data() + 3, len), expected) << "len " << len;
+        ASSERT_EQ(util_crc64_iso_update_generic(0, data.data() + 3, len), expected) << "len " << len;
+    }
+
+    uint64_t expected = 0;
+    uint64_t crc = 0;
+    ASSERT_TRUE(isula_crc_update(ctab, &expected, data.data(), data.size()));
+    // update in chunks equals update at once
+    for (size_t off = 0; off < data.size(); off += 1000) {
+        size_t len = data.size() - off < 1000 ? data.size() - off : 1000;
+        crc = util_crc64_iso_update(crc, data.data() + off, len);
+    }
+    ASSERT_EQ(crc, expected);
+}
+
+TEST(utils_crc64, test_util_file_crc64_iso)
+{
+    char path[] = "/tmp/utils_crc64_ut_XXXXXX";
+    std::vector<unsigned char> data(2 * 1024 * 1024 + 5, 'a');
+    uint64_t crc = 0;
+    int fd = mkstemp(path);
+
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, data.data(), data.size()), (ssize_t)data.size());
+    close(fd);
+
+    ASSERT_EQ(util_file_crc64_iso(path, &crc), 0);
+    ASSERT_EQ(crc, util_crc64_iso_update_generic(0, data.data(), data.size()));
+
+    ASSERT_NE(util_file_crc64_iso(nullptr, &crc), 0);
+    unlink(path);
+    ASSERT_NE(util_file_crc64_iso(path, &crc), 0);
+}
+
+TEST(utils_crc64, test_util_file_crc64_iso_truncated_while_reading)
+{
+    char path[] = "/tmp/utils_crc64_ut_XXXXXX";
+    std::vector<unsigned char> data(4 * 1024 * 1024, 'b');
+    std::atomic<bool> stop(false);
+    uint64_t crc = 0;
+    int fd = mkstemp(path);
+
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, data.data(), data.size()), (ssize_t)data.size());
+
+    // a large file shrinking under the checksum gives a short result, never a fault
+    std::thread truncater([fd, &data, &stop]() {
+        while (!stop.load()) {
+            (void)ftruncate(fd, 0);
+            (void)pwrite(fd, data.data(), data.size(), 0);
+        }
+    });
+    for (int i = 0; i < 50; i++) {
+        ASSERT_EQ(util_file_crc64_iso(path, &crc), 0);
+    }
+    stop = true;
+    truncater.join();
+    close(fd);
+
+    ASSERT_EQ(util_file_crc64_iso(path, &crc), 0);
+    ASSERT_EQ(crc, util_crc64_iso_update_generic(0, data.data(), data.size()));
+    unlink(path);
+}
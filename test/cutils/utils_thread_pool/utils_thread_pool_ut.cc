@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: utils_thread_pool unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include "utils_thread_pool.h"
+
+static void add_one(void *arg)
+{
+    std::atomic<int> *counter = static_cast<std::atomic<int> *>(arg);
+    (*counter)++;
+}
+
+TEST(utils_thread_pool, test_util_thread_pool_submit_and_wait)
+{
+    std::atomic<int> counter(0);
+    thread_pool_t *pool = util_thread_pool_new(4, 2, "UtPool");
+
+    ASSERT_NE(pool, nullptr);
+    ASSERT_EQ(util_thread_pool_size(pool), 4);
+
+    // more tasks than queue capacity, submit blocks instead of failing
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(util_thread_pool_submit(pool, add_one, &counter), 0);
+    }
+    util_thread_pool_wait(pool);
+    ASSERT_EQ(counter.load(), 1000);
+
+    ASSERT_EQ(util_thread_pool_submit(pool, add_one, &counter), 0);
+    util_thread_pool_free(pool);
+    ASSERT_EQ(counter.load(), 1001);
+}
+
+TEST(utils_thread_pool, test_util_thread_pool_invalid)
+{
+    std::atomic<int> counter(0);
+
+    ASSERT_NE(util_thread_pool_submit(nullptr, add_one, &counter), 0);
+    ASSERT_EQ(util_thread_pool_size(nullptr), 0);
+    util_thread_pool_wait(nullptr);
+    util_thread_pool_free(nullptr);
+
+    thread_pool_t *pool = util_thread_pool_new(0, 0, nullptr);
+    ASSERT_NE(pool, nullptr);
+    ASSERT_EQ(util_thread_pool_size(pool), util_thread_pool_default_size(0));
+    ASSERT_NE(util_thread_pool_submit(pool, nullptr, &counter), 0);
+    util_thread_pool_free(pool);
+}
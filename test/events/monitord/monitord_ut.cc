@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: monitord queue unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "monitord.h"
+#include "events_collector_api.h"
+#include "events_sender_api.h"
+#include "isulad_config_mock.h"
+
+using ::testing::NiceMock;
+using ::testing::Invoke;
+
+// same as the size of monitord queue
+#define MONITORD_UT_QUEUE_SIZE 2048
+
+namespace {
+std::mutex g_mutex;
+std::condition_variable g_cond;
+std::vector<int> g_pids;
+bool g_blocked = false;
+bool g_block_first = false;
+bool g_reentrant_done = false;
+}
+
+// events are handled by the monitored thread in the order they are posted
+void events_handler(struct monitord_msg *msg)
+{
+    std::unique_lock<std::mutex> lock(g_mutex);
+
+    if (strcmp(msg->name, "reentrant") == 0) {
+        struct monitord_msg inner = { };
+        int i;
+
+        lock.unlock();
+        // the monitored thread can not wait for space of its own queue, the overflow is dropped
+        (void)strcpy(inner.name, "inner");
+        for (i = 0; i <= MONITORD_UT_QUEUE_SIZE; i++) {
+            inner.pid = i + 1;
+            EXPECT_EQ(monitord_post_msg(&inner), 0);
+        }
+        lock.lock();
+        g_reentrant_done = true;
+        g_cond.notify_all();
+        return;
+    }
+
+    g_pids.push_back(msg->pid);
+    if (g_block_first) {
+        g_block_first = false;
+        g_blocked = true;
+        g_cond.notify_all();
+        g_cond.wait(lock, [] { return !g_blocked; });
+    }
+    g_cond.notify_all();
+}
+
+class MonitordUnitTest : public testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+        char tmpl[] = "/tmp/monitord_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+    }
+
+    static void TearDownTestCase()
+    {
+        std::string fifo = m_dir + "/monitord_fifo";
+
+        (void)unlink(fifo.c_str());
+        (void)rmdir(m_dir.c_str());
+    }
+
+    void SetUp() override
+    {
+        MockIsuladConf_SetMock(&m_conf_mock);
+        ON_CALL(m_conf_mock, GetMonitordPath()).WillByDefault(Invoke([]() {
+            return strdup((m_dir + "/monitord_fifo").c_str());
+        }));
+        ON_CALL(m_conf_mock, ConfGetIsuladStateDir()).WillByDefault(Invoke([]() {
+            return strdup(m_dir.c_str());
+        }));
+    }
+
+    void TearDown() override
+    {
+        MockIsuladConf_SetMock(nullptr);
+    }
+
+    // monitored runs until the process exits, start it once for all cases
+    static void StartMonitord()
+    {
+        static bool started = false;
+        static sem_t sem;
+        static int exit_code = 0;
+        struct monitord_sync_data msync = { &sem, &exit_code };
+
+        if (started) {
+            return;
+        }
+        ASSERT_EQ(sem_init(&sem, 0, 0), 0);
+        ASSERT_EQ(new_monitord(&msync), 0);
+        ASSERT_EQ(sem_wait(&sem), 0);
+        ASSERT_EQ(exit_code, 0);
+        started = true;
+    }
+
+    static std::string m_dir;
+    NiceMock<MockIsuladConf> m_conf_mock;
+};
+
+std::string MonitordUnitTest::m_dir;
+
+TEST_F(MonitordUnitTest, test_post_without_monitored)
+{
+    struct monitord_msg msg = { };
+
+    ASSERT_NE(monitord_post_msg(&msg), 0);
+    ASSERT_NE(monitord_post_msg(nullptr), 0);
+}
+
+TEST_F(MonitordUnitTest, test_events_keep_order_when_queue_full)
+{
+    const int total = 2 * MONITORD_UT_QUEUE_SIZE + 100;
+    int i;
+
+    StartMonitord();
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_pids.clear();
+        g_block_first = true;
+    }
+
+    // the first event blocks the handler, so producer fills the queue and has to wait for space
+    std::thread producer([total]() {
+        int j;
+        for (j = 1; j <= total; j++) {
+            (void)isulad_monitor_send_container_event("order", STOPPED, j, 0, nullptr, nullptr);
+        }
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(g_mutex);
+        ASSERT_TRUE(g_cond.wait_for(lock, std::chrono::seconds(10), [] { return g_blocked; }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_blocked = false;
+        g_cond.notify_all();
+    }
+    producer.join();
+
+    std::unique_lock<std::mutex> lock(g_mutex);
+    ASSERT_TRUE(g_cond.wait_for(lock, std::chrono::seconds(10), [total] { return g_pids.size() == (size_t)total; }));
+    for (i = 0; i < total; i++) {
+        ASSERT_EQ(g_pids[i], i + 1);
+    }
+}
+
+TEST_F(MonitordUnitTest, test_post_from_monitored_does_not_block)
+{
+    struct monitord_msg msg = { };
+
+    StartMonitord();
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_pids.clear();
+        g_reentrant_done = false;
+    }
+
+    (void)strcpy(msg.name, "reentrant");
+    ASSERT_EQ(monitord_post_msg(&msg), 0);
+
+    std::unique_lock<std::mutex> lock(g_mutex);
+    ASSERT_TRUE(g_cond.wait_for(lock, std::chrono::seconds(10), [] {
+        return g_reentrant_done && g_pids.size() == MONITORD_UT_QUEUE_SIZE;
+    }));
+    // the last one did not fit into the queue
+    ASSERT_EQ(g_pids.front(), 1);
+    ASSERT_EQ(g_pids.back(), MONITORD_UT_QUEUE_SIZE);
+}
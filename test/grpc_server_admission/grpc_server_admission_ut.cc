@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: grpc server admission unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "grpc_server_admission.h"
+
+// limits of the long running class
+#define LONG_RUNNING_MAX_RUNNING 128
+#define LONG_RUNNING_MAX_WAITING 32
+
+namespace {
+const std::function<bool()> g_notCancelled = []() {
+    return false;
+};
+
+std::chrono::system_clock::time_point Forever()
+{
+    return std::chrono::system_clock::time_point::max();
+}
+
+// hold all running slots of the long running class
+std::vector<std::unique_ptr<GrpcAdmission>> FillRunning()
+{
+    std::vector<std::unique_ptr<GrpcAdmission>> held;
+    int i;
+
+    for (i = 0; i < LONG_RUNNING_MAX_RUNNING; i++) {
+        held.emplace_back(new GrpcAdmission(RpcClass::LONG_RUNNING, Forever(), g_notCancelled));
+        EXPECT_TRUE(held.back()->Admitted());
+    }
+    return held;
+}
+
+// a call which does not wait tells whether the waiting queue is full
+grpc::StatusCode TryWithoutWaiting(RpcClass rpcClass)
+{
+    GrpcAdmission admission(rpcClass, std::chrono::system_clock::now(), g_notCancelled);
+
+    if (admission.Admitted()) {
+        return grpc::StatusCode::OK;
+    }
+    return admission.RejectedStatus().error_code();
+}
+} // namespace
+
+TEST(grpc_server_admission, test_admit_and_release)
+{
+    std::vector<std::unique_ptr<GrpcAdmission>> held = FillRunning();
+
+    // the class is full, a call which can not wait is rejected by its deadline
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::LONG_RUNNING), grpc::StatusCode::DEADLINE_EXCEEDED);
+    // other classes are not affected
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::MUTATION), grpc::StatusCode::OK);
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::STREAM), grpc::StatusCode::OK);
+
+    // release one slot, it can be taken again
+    held.pop_back();
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::LONG_RUNNING), grpc::StatusCode::OK);
+
+    held.clear();
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::LONG_RUNNING), grpc::StatusCode::OK);
+}
+
+TEST(grpc_server_admission, test_reject_when_waiting_queue_full)
+{
+    std::vector<std::unique_ptr<GrpcAdmission>> held = FillRunning();
+    std::vector<std::thread> waiters;
+    std::atomic<int> admitted(0);
+    int i;
+
+    for (i = 0; i < LONG_RUNNING_MAX_WAITING; i++) {
+        waiters.emplace_back([&admitted]() {
+            GrpcAdmission admission(RpcClass::LONG_RUNNING, Forever(), g_notCancelled);
+            if (admission.Admitted()) {
+                admitted++;
+            }
+        });
+    }
+
+    // wait until all waiters are queued, then the next call is rejected at once
+    for (i = 0; i < 1000 && TryWithoutWaiting(RpcClass::LONG_RUNNING) != grpc::StatusCode::RESOURCE_EXHAUSTED; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    GrpcAdmission rejected(RpcClass::LONG_RUNNING, Forever(), g_notCancelled);
+    ASSERT_FALSE(rejected.Admitted());
+    ASSERT_EQ(rejected.RejectedStatus().error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+    ASSERT_EQ(admitted.load(), 0);
+
+    // released slots are handed to the waiters
+    held.clear();
+    for (auto &waiter : waiters) {
+        waiter.join();
+    }
+    ASSERT_EQ(admitted.load(), LONG_RUNNING_MAX_WAITING);
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::LONG_RUNNING), grpc::StatusCode::OK);
+}
+
+TEST(grpc_server_admission, test_waiting_call_cancelled)
+{
+    std::vector<std::unique_ptr<GrpcAdmission>> held = FillRunning();
+    std::atomic<bool> cancelled(false);
+    grpc::StatusCode code = grpc::StatusCode::OK;
+
+    std::thread waiter([&cancelled, &code]() {
+        GrpcAdmission admission(RpcClass::LONG_RUNNING, Forever(), [&cancelled]() {
+            return cancelled.load();
+        });
+        code = admission.Admitted() ? grpc::StatusCode::OK : admission.RejectedStatus().error_code();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    cancelled = true;
+    waiter.join();
+    ASSERT_EQ(code, grpc::StatusCode::CANCELLED);
+
+    // the cancelled call does not hold a slot
+    held.pop_back();
+    ASSERT_EQ(TryWithoutWaiting(RpcClass::LONG_RUNNING), grpc::StatusCode::OK);
+}
+
+TEST(grpc_server_admission, test_waiting_call_deadline_exceeded)
+{
+    std::vector<std::unique_ptr<GrpcAdmission>> held = FillRunning();
+    auto start = std::chrono::system_clock::now();
+    GrpcAdmission admission(RpcClass::LONG_RUNNING, start + std::chrono::milliseconds(300), g_notCancelled);
+
+    ASSERT_FALSE(admission.Admitted());
+    ASSERT_EQ(admission.RejectedStatus().error_code(), grpc::StatusCode::DEADLINE_EXCEEDED);
+    ASSERT_GE(std::chrono::system_clock::now() - start, std::chrono::milliseconds(300));
+}
+
+TEST(grpc_server_admission, test_server_context)
+{
+    grpc::ServerContext context;
+    GrpcAdmission admission(RpcClass::QUERY, &context);
+
+    ASSERT_TRUE(admission.Admitted());
+}
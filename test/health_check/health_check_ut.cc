@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: health check state save unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "health_check.h"
+#include "container_state.h"
+#include "containers_store_mock.h"
+#include "container_unix_mock.h"
+#include "utils.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+#define HEALTH_UT_RETRIES 3
+
+namespace {
+// calls of container_state_to_disk and the files it really wrote
+int g_state_saves = 0;
+int g_state_writes = 0;
+
+// what container_state_to_disk does without the file io
+int invoke_container_state_to_disk(const container_t *cont)
+{
+    char *json = nullptr;
+
+    g_state_saves++;
+    container_state_lock(cont->state);
+    if (container_state_generate_changed_json(cont->state, &json) != 0) {
+        container_state_unlock(cont->state);
+        return -1;
+    }
+    if (json != nullptr) {
+        g_state_writes++;
+        container_state_set_disk_json(cont->state, json);
+    }
+    container_state_unlock(cont->state);
+    return 0;
+}
+}
+
+class HealthCheckUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        m_cont = (container_t *)util_common_calloc_s(sizeof(container_t));
+        ASSERT_NE(m_cont, nullptr);
+        m_cont->common_config =
+            (container_config_v2_common_config *)util_common_calloc_s(sizeof(container_config_v2_common_config));
+        m_cont->common_config->id = util_strdup_s("health_check_ut");
+        m_cont->common_config->config = (container_config *)util_common_calloc_s(sizeof(container_config));
+        m_cont->common_config->config->healthcheck = (defs_health_check *)util_common_calloc_s(sizeof(defs_health_check));
+        m_cont->common_config->config->healthcheck->retries = HEALTH_UT_RETRIES;
+        m_cont->state = container_state_new();
+        ASSERT_NE(m_cont->state, nullptr);
+        m_cont->state->state->health = (defs_health *)util_common_calloc_s(sizeof(defs_health));
+        m_cont->health_check = (health_check_manager_t *)util_common_calloc_s(sizeof(health_check_manager_t));
+        ASSERT_EQ(pthread_mutex_init(&m_cont->health_check->mutex, nullptr), 0);
+        m_cont->health_check->init_mutex = true;
+        m_cont->health_check->monitor_status = MONITOR_INTERVAL;
+
+        g_state_saves = 0;
+        g_state_writes = 0;
+        MockContainersStore_SetMock(&m_containersStore);
+        MockContainerUnix_SetMock(&m_containerUnix);
+        ON_CALL(m_containersStore, ContainersStoreGet(_)).WillByDefault(Return(m_cont));
+        ON_CALL(m_containerUnix, ContainerStateToDisk(_)).WillByDefault(Invoke(invoke_container_state_to_disk));
+    }
+
+    void TearDown() override
+    {
+        MockContainersStore_SetMock(nullptr);
+        MockContainerUnix_SetMock(nullptr);
+        container_state_free(m_cont->state);
+        free_container_config_v2_common_config(m_cont->common_config);
+        pthread_mutex_destroy(&m_cont->health_check->mutex);
+        free(m_cont->health_check);
+        free(m_cont);
+    }
+
+    void SetHealth(const char *status, int failing_streak)
+    {
+        free(m_cont->state->state->health->status);
+        m_cont->state->state->health->status = util_strdup_s(status);
+        m_cont->state->state->health->failing_streak = failing_streak;
+        // the state as it is on disk now
+        ASSERT_EQ(invoke_container_state_to_disk(m_cont), 0);
+        g_state_saves = 0;
+        g_state_writes = 0;
+    }
+
+    int Probe(int exit_code)
+    {
+        defs_health_log_element result = { 0 };
+
+        result.start = (char *)"2026-10-18T10:00:00.000000000+08:00";
+        result.end = (char *)"2026-10-18T10:00:01.000000000+08:00";
+        result.exit_code = exit_code;
+        result.output = (char *)"probe output";
+        return health_check_handle_probe_result(m_cont->common_config->id, &result);
+    }
+
+    const char *Status()
+    {
+        return m_cont->state->state->health->status;
+    }
+
+    container_t *m_cont { nullptr };
+    NiceMock<MockContainersStore> m_containersStore;
+    NiceMock<MockContainerUnix> m_containerUnix;
+};
+
+TEST_F(HealthCheckUnitTest, test_unchanged_state_is_not_rewritten)
+{
+    char *json = nullptr;
+    container_state_t *s = m_cont->state;
+
+    container_state_lock(s);
+    ASSERT_EQ(container_state_generate_changed_json(s, &json), 0);
+    ASSERT_NE(json, nullptr);
+    std::string first = json;
+    container_state_set_disk_json(s, json);
+
+    // the json on disk is the same
+    ASSERT_EQ(container_state_generate_changed_json(s, &json), 0);
+    ASSERT_EQ(json, nullptr);
+    container_state_unlock(s);
+
+    container_state_set_paused(s);
+    container_state_lock(s);
+    ASSERT_EQ(container_state_generate_changed_json(s, &json), 0);
+    ASSERT_NE(json, nullptr);
+    ASSERT_NE(first, json);
+    container_state_set_disk_json(s, json);
+    ASSERT_EQ(container_state_generate_changed_json(s, &json), 0);
+    ASSERT_EQ(json, nullptr);
+    container_state_unlock(s);
+
+    ASSERT_EQ(container_state_generate_changed_json(nullptr, &json), -1);
+}
+
+TEST_F(HealthCheckUnitTest, test_healthy_probes_with_unchanged_status_skip_save)
+{
+    int i;
+
+    SetHealth(HEALTHY, 0);
+    for (i = 0; i < 3; i++) {
+        ASSERT_EQ(Probe(EXIT_STATUS_HEALTHY), 0);
+    }
+
+    ASSERT_STREQ(Status(), HEALTHY);
+    // the probe logs stay in memory until the next save
+    ASSERT_EQ(m_cont->state->state->health->log_len, 3);
+    ASSERT_EQ(g_state_saves, 0);
+    ASSERT_EQ(g_state_writes, 0);
+}
+
+TEST_F(HealthCheckUnitTest, test_streak_reset_saves)
+{
+    SetHealth(HEALTHY, 1);
+
+    ASSERT_EQ(Probe(EXIT_STATUS_HEALTHY), 0);
+    ASSERT_STREQ(Status(), HEALTHY);
+    ASSERT_EQ(m_cont->state->state->health->failing_streak, 0);
+    ASSERT_EQ(g_state_saves, 1);
+    ASSERT_EQ(g_state_writes, 1);
+
+    ASSERT_EQ(Probe(EXIT_STATUS_HEALTHY), 0);
+    ASSERT_EQ(g_state_saves, 1);
+}
+
+TEST_F(HealthCheckUnitTest, test_status_change_saves)
+{
+    int i;
+
+    SetHealth(UNHEALTHY, HEALTH_UT_RETRIES);
+    ASSERT_EQ(Probe(EXIT_STATUS_HEALTHY), 0);
+    ASSERT_STREQ(Status(), HEALTHY);
+    ASSERT_EQ(g_state_saves, 1);
+    ASSERT_EQ(g_state_writes, 1);
+
+    // each failure changes the streak and is saved, the one reaching the retries saves the status once
+    for (i = 1; i <= HEALTH_UT_RETRIES; i++) {
+        ASSERT_EQ(Probe(1), 0);
+        ASSERT_EQ(m_cont->state->state->health->failing_streak, i);
+        ASSERT_EQ(g_state_saves, 1 + i);
+    }
+    ASSERT_STREQ(Status(), UNHEALTHY);
+    ASSERT_EQ(g_state_writes, 1 + HEALTH_UT_RETRIES);
+}
+
+TEST_F(HealthCheckUnitTest, test_stopped_monitor_ignores_probe)
+{
+    SetHealth(HEALTHY, 1);
+    m_cont->health_check->monitor_status = MONITOR_STOP;
+
+    ASSERT_EQ(Probe(EXIT_STATUS_HEALTHY), 0);
+    ASSERT_EQ(m_cont->state->state->health->failing_streak, 1);
+    ASSERT_EQ(m_cont->state->state->health->log_len, 0);
+    ASSERT_EQ(g_state_saves, 0);
+}
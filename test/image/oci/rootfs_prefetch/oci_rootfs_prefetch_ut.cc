@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: oci rootfs prefetch unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "oci_rootfs_prefetch.h"
+#include "image_api.h"
+#include "storage_mock.h"
+#include "utils.h"
+#include "utils_array.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class OciRootfsPrefetchUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/oci_rootfs_prefetch_ut_XXXXXX";
+        char real_path[PATH_MAX] = { 0 };
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        // the paths read back from /proc are resolved, so should be the rootfs
+        ASSERT_NE(realpath(tmpl, real_path), nullptr);
+        m_dir = real_path;
+        m_rootfs = m_dir + "/rootfs";
+        ASSERT_EQ(mkdir(m_rootfs.c_str(), 0755), 0);
+        ASSERT_EQ(mkdir((m_rootfs + "/etc").c_str(), 0755), 0);
+        WriteFile(m_rootfs + "/etc/passwd", "root:x:0:0:root:/root:/bin/sh\n");
+        WriteFile(m_rootfs + "/etc/empty", "");
+        MockStorage_SetMock(&m_storage);
+    }
+
+    void TearDown() override
+    {
+        std::string command = "rm -rf " + m_dir;
+
+        MockStorage_SetMock(nullptr);
+        ASSERT_EQ(system(command.c_str()), 0);
+    }
+
+    void WriteFile(const std::string &path, const std::string &content)
+    {
+        FILE *fp = fopen(path.c_str(), "w");
+
+        ASSERT_NE(fp, nullptr);
+        if (!content.empty()) {
+            ASSERT_EQ(fwrite(content.c_str(), 1, content.size(), fp), content.size());
+        }
+        fclose(fp);
+    }
+
+    // the trace path of a file as the fanotify event fd of opening it would give
+    std::string EventPath(const std::string &path, const std::string &rootfs)
+    {
+        std::string result;
+        char *event_path = nullptr;
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        EXPECT_GE(fd, 0);
+        if (fd < 0) {
+            return result;
+        }
+        event_path = oci_rootfs_trace_event_path(fd, rootfs.c_str());
+        close(fd);
+        if (event_path == nullptr) {
+            return "(null)";
+        }
+        result = event_path;
+        free(event_path);
+        return result;
+    }
+
+    std::string m_dir;
+    std::string m_rootfs;
+    NiceMock<MockStorage> m_storage;
+};
+
+TEST_F(OciRootfsPrefetchUnitTest, test_trace_serialize_and_split)
+{
+    string_array *trace = util_string_array_new(2);
+    char *content = nullptr;
+    char **paths = nullptr;
+
+    ASSERT_NE(trace, nullptr);
+    ASSERT_EQ(oci_rootfs_trace_serialize(nullptr), nullptr);
+    ASSERT_EQ(oci_rootfs_trace_serialize(trace), nullptr);
+
+    ASSERT_EQ(util_append_string_array(trace, "/etc/passwd"), 0);
+    ASSERT_EQ(util_append_string_array(trace, "/usr/bin/sh"), 0);
+    content = oci_rootfs_trace_serialize(trace);
+    ASSERT_STREQ(content, "/etc/passwd\n/usr/bin/sh");
+
+    paths = oci_rootfs_trace_split(content);
+    ASSERT_NE(paths, nullptr);
+    ASSERT_EQ(util_array_len((const char **)paths), 2);
+    ASSERT_STREQ(paths[0], "/etc/passwd");
+    ASSERT_STREQ(paths[1], "/usr/bin/sh");
+    util_free_array(paths);
+    free(content);
+    util_free_string_array(trace);
+
+    ASSERT_EQ(oci_rootfs_trace_split(nullptr), nullptr);
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_trace_split_skips_relative_lines)
+{
+    char **paths = oci_rootfs_trace_split("etc/shadow\n/etc/passwd\n\n../../etc/hosts\n/usr/bin/sh\n");
+
+    ASSERT_NE(paths, nullptr);
+    ASSERT_EQ(util_array_len((const char **)paths), 2);
+    ASSERT_STREQ(paths[0], "/etc/passwd");
+    ASSERT_STREQ(paths[1], "/usr/bin/sh");
+    util_free_array(paths);
+
+    paths = oci_rootfs_trace_split("no absolute path");
+    ASSERT_NE(paths, nullptr);
+    ASSERT_EQ(paths[0], nullptr);
+    util_free_array(paths);
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_trace_is_capped)
+{
+    string_array *trace = util_string_array_new(OCI_ROOTFS_TRACE_MAX_FILES + 10);
+    std::string content;
+    char *serialized = nullptr;
+    char **paths = nullptr;
+    size_t i;
+
+    ASSERT_NE(trace, nullptr);
+    for (i = 0; i < OCI_ROOTFS_TRACE_MAX_FILES + 10; i++) {
+        std::string path = "/file" + std::to_string(i);
+        ASSERT_EQ(util_append_string_array(trace, path.c_str()), 0);
+        content += path + "\n";
+    }
+
+    serialized = oci_rootfs_trace_serialize(trace);
+    ASSERT_NE(serialized, nullptr);
+    paths = oci_rootfs_trace_split(serialized);
+    ASSERT_EQ(util_array_len((const char **)paths), OCI_ROOTFS_TRACE_MAX_FILES);
+    ASSERT_STREQ(paths[OCI_ROOTFS_TRACE_MAX_FILES - 1],
+                 ("/file" + std::to_string(OCI_ROOTFS_TRACE_MAX_FILES - 1)).c_str());
+    util_free_array(paths);
+    free(serialized);
+
+    // a trace big data written by anything else is capped on reading too
+    paths = oci_rootfs_trace_split(content.c_str());
+    ASSERT_EQ(util_array_len((const char **)paths), OCI_ROOTFS_TRACE_MAX_FILES);
+    util_free_array(paths);
+    util_free_string_array(trace);
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_trace_event_path)
+{
+    std::string sibling = m_dir + "/rootfs2";
+    std::string newline = m_rootfs + "/etc/bad\nname";
+
+    ASSERT_EQ(EventPath(m_rootfs + "/etc/passwd", m_rootfs), "/etc/passwd");
+
+    // seen from inside the container after it pivoted into the rootfs
+    ASSERT_EQ(EventPath(m_rootfs + "/etc/passwd", "/var/lib/isulad/other/merged"), m_rootfs + "/etc/passwd");
+
+    // a rootfs whose path only starts with the rootfs path is not stripped
+    ASSERT_EQ(mkdir(sibling.c_str(), 0755), 0);
+    WriteFile(sibling + "/passwd", "x");
+    ASSERT_EQ(EventPath(sibling + "/passwd", m_rootfs), sibling + "/passwd");
+
+    WriteFile(newline, "x");
+    ASSERT_EQ(EventPath(newline, m_rootfs), "(null)");
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_prefetch_file)
+{
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/passwd"), 0);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/empty"), 0);
+
+    // a symlink is resolved inside the rootfs
+    ASSERT_EQ(symlink("passwd", (m_rootfs + "/etc/link").c_str()), 0);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/link"), 0);
+    ASSERT_EQ(symlink("/etc/missing", (m_rootfs + "/etc/abs_link").c_str()), 0);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/abs_link"), -1);
+
+    ASSERT_EQ(mkfifo((m_rootfs + "/etc/fifo").c_str(), 0600), 0);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/fifo"), -1);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc"), -1);
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/etc/missing"), -1);
+
+    WriteFile(m_dir + "/outside", "x");
+    ASSERT_EQ(oci_rootfs_prefetch_file(m_rootfs.c_str(), "/../outside"), -1);
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_prefetch_enabled)
+{
+    json_map_string_string *annotations =
+        (json_map_string_string *)util_common_calloc_s(sizeof(json_map_string_string));
+
+    ASSERT_NE(annotations, nullptr);
+    ASSERT_FALSE(oci_rootfs_prefetch_enabled(nullptr));
+    ASSERT_FALSE(oci_rootfs_prefetch_enabled(annotations));
+
+    ASSERT_EQ(append_json_map_string_string(annotations, "io.kubernetes.cri.container-type", "container"), 0);
+    ASSERT_FALSE(oci_rootfs_prefetch_enabled(annotations));
+
+    ASSERT_EQ(append_json_map_string_string(annotations, IM_ROOTFS_PREFETCH_ANNOTATION, "false"), 0);
+    ASSERT_FALSE(oci_rootfs_prefetch_enabled(annotations));
+    free(annotations->values[1]);
+    annotations->values[1] = util_strdup_s("True");
+    ASSERT_FALSE(oci_rootfs_prefetch_enabled(annotations));
+    free(annotations->values[1]);
+    annotations->values[1] = util_strdup_s("true");
+    ASSERT_TRUE(oci_rootfs_prefetch_enabled(annotations));
+
+    free_json_map_string_string(annotations);
+}
+
+TEST_F(OciRootfsPrefetchUnitTest, test_prefetch_skips_without_annotation_or_image)
+{
+    json_map_string_string *annotations =
+        (json_map_string_string *)util_common_calloc_s(sizeof(json_map_string_string));
+
+    ASSERT_NE(annotations, nullptr);
+    EXPECT_CALL(m_storage, StorageRootfsGetImageId(_)).Times(0);
+    ASSERT_EQ(oci_rootfs_prefetch("prefetch_ut", m_rootfs.c_str(), nullptr), 0);
+    ASSERT_EQ(oci_rootfs_prefetch("prefetch_ut", m_rootfs.c_str(), annotations), 0);
+    testing::Mock::VerifyAndClearExpectations(&m_storage);
+
+    // a container of an external rootfs has no image to keep the trace
+    ASSERT_EQ(append_json_map_string_string(annotations, IM_ROOTFS_PREFETCH_ANNOTATION, "true"), 0);
+    EXPECT_CALL(m_storage, StorageRootfsGetImageId(_)).WillOnce(Return(nullptr));
+    EXPECT_CALL(m_storage, StorageImgGetBigData(_, _)).Times(0);
+    ASSERT_EQ(oci_rootfs_prefetch("prefetch_ut", m_rootfs.c_str(), annotations), 0);
+
+    ASSERT_EQ(oci_rootfs_prefetch(nullptr, m_rootfs.c_str(), annotations), -1);
+    ASSERT_EQ(oci_rootfs_prefetch("prefetch_ut", nullptr, annotations), -1);
+    free_json_map_string_string(annotations);
+}
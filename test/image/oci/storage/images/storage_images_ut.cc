@@ -25,6 +25,8 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "utils.h"
@@ -32,6 +34,8 @@
 #include "path.h"
 #include "isula_libutils/imagetool_images_list.h"
 #include "isula_libutils/imagetool_image.h"
+#include "isula_libutils/storage_image.h"
+#include "sha256.h"
 #include "storage_mock.h"
 #include "isulad_config_mock.h"
 
@@ -46,6 +50,9 @@ using ::testing::AtLeast;
 using ::testing::Invoke;
 using ::testing::_;
 
+#define IMAGES_UT_SAVE_THREADS 8
+#define IMAGES_UT_SAVE_ROUNDS 20
+
 std::string GetDirectory()
 {
     char abs_path[PATH_MAX] { 0x00 };
@@ -636,6 +643,26 @@ TEST_F(StorageImagesUnitTest, test_image_store_delete)
     Restore();
 }
 
+TEST_F(StorageImagesUnitTest, test_image_store_top_layer_index)
+{
+    std::string incorrectLayer { "ff67da98ab8540d713209" };
+
+    ASSERT_FALSE(image_store_is_top_layer(incorrectLayer.c_str()));
+
+    BackUp();
+
+    for (auto elem : ids) {
+        char *top_layer = image_store_top_layer(elem.c_str());
+        ASSERT_NE(top_layer, nullptr);
+        ASSERT_TRUE(image_store_is_top_layer(top_layer));
+        ASSERT_EQ(image_store_delete(elem.c_str()), 0);
+        ASSERT_FALSE(image_store_is_top_layer(top_layer));
+        free(top_layer);
+    }
+
+    Restore();
+}
+
 TEST_F(StorageImagesUnitTest, test_image_store_remove_single_name)
 {
     BackUp();
@@ -665,3 +692,142 @@ TEST_F(StorageImagesUnitTest, test_image_store_remove_multi_name)
 
     Restore();
 }
+
+TEST_F(StorageImagesUnitTest, test_image_store_rootfs_access_trace)
+{
+    std::string trace { "/etc/passwd\n/usr/bin/sh" };
+    char *data = nullptr;
+
+    BackUp();
+
+    ASSERT_EQ(image_store_big_data(ids.at(0).c_str(), "rootfs-access-trace"), nullptr);
+    ASSERT_EQ(image_store_set_big_data(ids.at(0).c_str(), "rootfs-access-trace", trace.c_str()), 0);
+    data = image_store_big_data(ids.at(0).c_str(), "rootfs-access-trace");
+    ASSERT_STREQ(data, trace.c_str());
+    free(data);
+
+    // the trace is kept by the image it is set on only
+    ASSERT_EQ(image_store_big_data(ids.at(1).c_str(), "rootfs-access-trace"), nullptr);
+    ASSERT_EQ(image_store_big_data("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+                                   "rootfs-access-trace"), nullptr);
+
+    Restore();
+}
+
+TEST_F(StorageImagesUnitTest, test_image_store_concurrent_saves_keep_latest)
+{
+    std::vector<std::thread> threads;
+    std::string image_json = std::string(store_real_path) + "/overlay-images/" + ids.at(0) + "/images.json";
+    storage_image *on_disk = nullptr;
+    parser_error err = nullptr;
+    char *metadata = nullptr;
+    char *data = nullptr;
+    char *digest = nullptr;
+    char *file_digest = nullptr;
+
+    BackUp();
+
+    for (int t = 0; t < IMAGES_UT_SAVE_THREADS; t++) {
+        threads.emplace_back([this, t]() {
+            for (int i = 0; i < IMAGES_UT_SAVE_ROUNDS; i++) {
+                std::string value = "value-" + std::to_string(t) + "-" + std::to_string(i);
+                EXPECT_EQ(image_store_set_metadata(ids.at(0).c_str(), value.c_str()), 0);
+                EXPECT_EQ(image_store_set_big_data(ids.at(0).c_str(), "concurrent", value.c_str()), 0);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    // whatever order the writers reached the disk in, the json on disk is the latest one in memory
+    metadata = image_store_metadata(ids.at(0).c_str());
+    ASSERT_NE(metadata, nullptr);
+    on_disk = storage_image_parse_file(image_json.c_str(), nullptr, &err);
+    ASSERT_NE(on_disk, nullptr);
+    ASSERT_STREQ(on_disk->metadata, metadata);
+
+    // and the big data file is the one whose digest is kept
+    data = image_store_big_data(ids.at(0).c_str(), "concurrent");
+    ASSERT_NE(data, nullptr);
+    digest = image_store_big_data_digest(ids.at(0).c_str(), "concurrent");
+    file_digest = sha256_full_digest_str(data);
+    ASSERT_STREQ(digest, file_digest);
+    ASSERT_STREQ(get_value_from_json_map_string_string(on_disk->big_data_digests, "concurrent"), digest);
+
+    free(file_digest);
+    free(digest);
+    free(data);
+    free(metadata);
+    free(err);
+    free_storage_image(on_disk);
+    Restore();
+}
+
+TEST_F(StorageImagesUnitTest, test_image_store_removed_image_is_not_saved)
+{
+    std::string id { "a5b1d0d7c2f1e4b3a6d9c8e7f0a1b2c3d4e5f60718293a4b5c6d7e8f90a1b2c3" };
+    std::string layer { "6194458b07fcf01f1483d96cd6c34302ffff7f382bb151a6d023c4e80ba3050a" };
+    std::string image_dir = std::string(store_real_path) + "/overlay-images/" + id;
+    types_timestamp_t time { 0x00 };
+    std::vector<std::thread> threads;
+
+    BackUp();
+
+    char *created_image = image_store_create(id.c_str(), nullptr, 0, layer.c_str(), "{}", &time, nullptr);
+    ASSERT_STREQ(created_image, id.c_str());
+    free(created_image);
+
+    // writers racing the delete either see the image removed or write before the directory goes away
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&id, t]() {
+            std::string value = "value-" + std::to_string(t);
+            while (image_store_set_big_data(id.c_str(), "removed", value.c_str()) == 0 &&
+                   image_store_set_metadata(id.c_str(), value.c_str()) == 0) {
+            }
+        });
+    }
+    ASSERT_EQ(image_store_delete(id.c_str()), 0);
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    ASSERT_FALSE(image_store_exists(id.c_str()));
+    ASSERT_FALSE(dirExists(image_dir.c_str()));
+    ASSERT_NE(image_store_set_big_data(id.c_str(), "removed", "value"), 0);
+    ASSERT_FALSE(dirExists(image_dir.c_str()));
+
+    Restore();
+}
+
+TEST_F(StorageImagesUnitTest, test_image_store_create_rollback_when_commit_fails)
+{
+    std::string id { "3f241394d1e2c3b4a5968778695a4b3c2d1e0f9e8d7c6b5a4938271605f4e3d2" };
+    const char *names[] = { "isula.org/library/rollback:latest" };
+    std::string layer { "6194458b07fcf01f1483d96cd6c34302ffff7f382bb151a6d023c4e80ba3050a" };
+    std::string image_dir = std::string(store_real_path) + "/overlay-images/" + id;
+    types_timestamp_t time { 0x00 };
+    size_t images_num = 0;
+
+    BackUp();
+    images_num = image_store_get_images_number();
+
+    // a file in the place of the image directory fails the write of the image json
+    std::ofstream blocker(image_dir);
+    blocker.close();
+    ASSERT_EQ(image_store_create(id.c_str(), names, 1, layer.c_str(), "{}", &time, nullptr), nullptr);
+    ASSERT_FALSE(image_store_exists(id.c_str()));
+    ASSERT_FALSE(image_store_exists(names[0]));
+    ASSERT_EQ(image_store_get_images_number(), images_num);
+
+    // nothing of the failed create is left in the indexes
+    (void)unlink(image_dir.c_str());
+    char *created_image = image_store_create(id.c_str(), names, 1, layer.c_str(), "{}", &time, nullptr);
+    ASSERT_STREQ(created_image, id.c_str());
+    ASSERT_TRUE(image_store_exists(names[0]));
+    ASSERT_EQ(image_store_get_images_number(), images_num + 1);
+    ASSERT_EQ(image_store_delete(id.c_str()), 0);
+    free(created_image);
+
+    Restore();
+}
@@ -269,4 +269,123 @@ TEST_F(StorageDriverUnitTest, test_graphdriver_try_repair_lowers)
 
     std::string id { "1be74353c3d0fd55fb5638a52953e6f1bc441e5b1710921db9ec2aa202725569" };
     ASSERT_EQ(graphdriver_try_repair_lowers(id.c_str(), nullptr), 0);
-}
\ No newline at end of file
+}
+static bool writeLowerFile(const std::string &layer_dir, const std::string &lowers)
+{
+    std::string lower_file = layer_dir + "/lower";
+
+    return util_write_file(lower_file.c_str(), lowers.c_str(), lowers.length(), 0644) == 0;
+}
+
+static bool mountAndUmount(const std::string &id)
+{
+    char *mount_dir = nullptr;
+
+    FLAGS_gmock_catch_leaked_mocks = false;
+    mount_dir = graphdriver_mount_layer(id.c_str(), nullptr);
+    FLAGS_gmock_catch_leaked_mocks = true;
+    if (mount_dir == nullptr) {
+        return false;
+    }
+    free(mount_dir);
+
+    return graphdriver_umount_layer(id.c_str()) == 0;
+}
+
+TEST_F(StorageDriverUnitTest, test_graphdriver_mount_hits_lower_dir_cache)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "1be74353c3d0fd55fb5638a52953e6f1bc441e5b1710921db9ec2aa202725569" };
+    std::string layer_dir = "/tmp/isulad/data/overlay/" + id;
+
+    EXPECT_CALL(m_driver_quota_mock, GetPageSize()).WillRepeatedly(Invoke(invokeGetPageSize));
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    // the second mount takes the lowers from the cache instead of the lower file
+    ASSERT_TRUE(writeLowerFile(layer_dir, "l/notexist"));
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+}
+
+TEST_F(StorageDriverUnitTest, test_graphdriver_lower_dir_cache_detects_removed_lower)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "1be74353c3d0fd55fb5638a52953e6f1bc441e5b1710921db9ec2aa202725569" };
+    std::string layer_dir = "/tmp/isulad/data/overlay/" + id;
+    std::string lower_link = "/tmp/isulad/data/overlay/l/c3343428f60aab9c86d24293f6";
+
+    EXPECT_CALL(m_driver_quota_mock, GetPageSize()).WillRepeatedly(Invoke(invokeGetPageSize));
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    ASSERT_EQ(rename(lower_link.c_str(), (lower_link + ".bak").c_str()), 0);
+    ASSERT_FALSE(mountAndUmount(id));
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    ASSERT_EQ(rename((lower_link + ".bak").c_str(), lower_link.c_str()), 0);
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+}
+
+TEST_F(StorageDriverUnitTest, test_graphdriver_mount_failure_drops_lower_dir_cache)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "1be74353c3d0fd55fb5638a52953e6f1bc441e5b1710921db9ec2aa202725569" };
+    std::string layer_dir = "/tmp/isulad/data/overlay/" + id;
+
+    EXPECT_CALL(m_driver_quota_mock, GetPageSize()).WillRepeatedly(Invoke(invokeGetPageSize));
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    // overlay can not be mounted without the work dir
+    ASSERT_EQ(util_recursive_rmdir((layer_dir + "/work").c_str(), 0), 0);
+    ASSERT_FALSE(mountAndUmount(id));
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+}
+
+TEST_F(StorageDriverUnitTest, test_graphdriver_lower_dir_cache_invalidate)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "1be74353c3d0fd55fb5638a52953e6f1bc441e5b1710921db9ec2aa202725569" };
+    std::string parent { "9c27e219663c25e0f28493790cc0b88bc973ba3b1686355f221c38a36978ac63" };
+    std::string layer_dir = "/tmp/isulad/data/overlay/" + id;
+    std::string fake_home = "/tmp/isulad/not_mounted";
+    struct graphdriver fake_driver = { 0 };
+
+    EXPECT_CALL(m_driver_quota_mock, GetPageSize()).WillRepeatedly(Invoke(invokeGetPageSize));
+
+    // rewriting the lower file by repairing the lowers
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+    ASSERT_TRUE(writeLowerFile(layer_dir, "l/notexist"));
+    ASSERT_EQ(graphdriver_try_repair_lowers(id.c_str(), parent.c_str()), 0);
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    // cleaning up the driver, the cache is dropped even if the home can not be umounted
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+    ASSERT_EQ(mkdir(fake_home.c_str(), 0755), 0);
+    fake_driver.home = fake_home.c_str();
+    ASSERT_EQ(overlay2_clean_up(&fake_driver), -1);
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+
+    // removing the layer
+    ASSERT_TRUE(mountAndUmount(id));
+    ASSERT_TRUE(overlay2_lower_dir_cached(layer_dir.c_str()));
+    ASSERT_EQ(graphdriver_rm_layer(id.c_str()), 0);
+    ASSERT_FALSE(overlay2_lower_dir_cached(layer_dir.c_str()));
+}
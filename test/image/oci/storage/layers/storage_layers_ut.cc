@@ -21,14 +21,17 @@
 #include <fstream>
 #include <climits>
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <thread>
 #include <gtest/gtest.h>
 #include "path.h"
 #include "utils.h"
 #include "storage.h"
 #include "layer.h"
 #include "driver_quota_mock.h"
+#include "utils_thread_pool_mock.h"
 
 using ::testing::Args;
 using ::testing::ByRef;
@@ -59,6 +62,11 @@ std::string GetDirectory()
     return static_cast<std::string>(abs_path) + "../../../../../../test/image/oci/storage/layers";
 }
 
+static ssize_t read_layer_diff(void *context, void *buf, size_t len)
+{
+    return util_read_nointr(*(int *)context, buf, len);
+}
+
 bool check_support_overlay(std::string root_dir)
 {
     if (!util_support_overlay()) {
@@ -222,6 +230,32 @@ protected:
         ASSERT_EQ(system(rm_command.c_str()), 0);
     }
 
+    // options of a read only layer without diff
+    static struct layer_opts *NewLayerOpts(const char *parent, const char *name)
+    {
+        struct layer_opts *opts = (struct layer_opts *)util_common_calloc_s(sizeof(struct layer_opts));
+
+        if (opts == nullptr) {
+            return nullptr;
+        }
+        opts->parent = util_strdup_s(parent);
+        opts->writable = false;
+        if (name != nullptr) {
+            opts->names = (char **)util_common_calloc_s(sizeof(char *));
+            opts->names[0] = util_strdup_s(name);
+            opts->names_len = 1;
+        }
+        return opts;
+    }
+
+    bool LayerDirsExist(const std::string &id)
+    {
+        std::string driver_dir = std::string(real_path) + "/overlay/" + id;
+        std::string layer_dir = std::string(real_path) + "/overlay-layers/" + id;
+
+        return util_dir_exists(driver_dir.c_str()) || util_dir_exists(layer_dir.c_str());
+    }
+
     NiceMock<MockDriverQuota> m_driver_quota_mock;
     char real_path[PATH_MAX] = { 0x00 };
     char real_run_path[PATH_MAX] = { 0x00 };
@@ -324,3 +358,152 @@ TEST_F(StorageLayersUnitTest, test_layer_store_by_compress_digest)
 
     free_layer_list(layer_list);
 }
+
+TEST_F(StorageLayersUnitTest, test_layer_store_check_submit_failed)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "9c27e219663c25e0f28493790cc0b88bc973ba3b1686355f221c38a36978ac63" };
+    MockThreadPool thread_pool_mock;
+    thread_pool_t *workers = layer_store_new_check_workers();
+    ASSERT_NE(workers, nullptr);
+
+    ASSERT_NE(layer_store_check(id.c_str(), nullptr), 0);
+
+    // the check stops at the first file which can not be submitted, and frees the entry only once
+    MockThreadPool_SetMock(&thread_pool_mock);
+    EXPECT_CALL(thread_pool_mock, Submit(workers, _, _)).WillOnce(Return(-1));
+    ASSERT_NE(layer_store_check(id.c_str(), workers), 0);
+    MockThreadPool_SetMock(nullptr);
+    testing::Mock::VerifyAndClearExpectations(&thread_pool_mock);
+
+    util_thread_pool_free(workers);
+}
+
+TEST_F(StorageLayersUnitTest, test_layer_store_create_diff_id_mismatch)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "4d3c1b1e5a6f2b8d9c0e7f1a2b3c4d5e6f7a8b9c0d1e2f3a4b5c6d7e8f9a0b1c" };
+    std::string diff_dir = "/tmp/isulad/diff";
+    std::string diff_tar = "/tmp/isulad/diff.tar";
+    std::string tar_command = "echo hello > " + diff_dir + "/hello && tar -cf " + diff_tar + " -C " + diff_dir + " hello";
+    struct io_read_wrapper diff = { 0 };
+    int fd = -1;
+
+    ASSERT_EQ(util_mkdir_p(diff_dir.c_str(), 0755), 0);
+    ASSERT_EQ(system(tar_command.c_str()), 0);
+    fd = util_open(diff_tar.c_str(), O_RDONLY, 0);
+    ASSERT_GE(fd, 0);
+    diff.context = &fd;
+    diff.read = read_layer_diff;
+
+    struct layer_opts *layer_opt = (struct layer_opts *)util_common_calloc_s(sizeof(struct layer_opts));
+    layer_opt->writable = false;
+    layer_opt->uncompressed_digest =
+        strdup("sha256:0000000000000000000000000000000000000000000000000000000000000000");
+    layer_opt->verify_uncompressed_digest = true;
+
+    EXPECT_CALL(m_driver_quota_mock, IOCtl(_, _)).WillRepeatedly(Invoke(invokeIOCtl));
+
+    // diff id of the applied data differs from the expected one, the staged layer is rolled back
+    ASSERT_NE(layer_store_create(id.c_str(), layer_opt, &diff, nullptr), 0);
+    close(fd);
+
+    ASSERT_EQ(layer_store_lookup(id.c_str()), nullptr);
+    std::string driver_dir = std::string(real_path) + "/overlay/" + id;
+    std::string layer_dir = std::string(real_path) + "/overlay-layers/" + id;
+    ASSERT_FALSE(util_dir_exists(driver_dir.c_str()));
+    ASSERT_FALSE(util_dir_exists(layer_dir.c_str()));
+
+    free_layer_opts(layer_opt);
+}
+
+TEST_F(StorageLayersUnitTest, test_layer_store_create_same_id_takes_hold_ref)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string id { "5c3e1d2b4a6f8e0d9c7b5a3f1e2d4c6b8a0f9e7d5c3b1a2f4e6d8c0b9a7f5e3d" };
+    struct layer_opts *layer_opt = NewLayerOpts(nullptr, nullptr);
+    int results[2] = { -1, -1 };
+    int refs = 0;
+
+    ASSERT_NE(layer_opt, nullptr);
+    EXPECT_CALL(m_driver_quota_mock, IOCtl(_, _)).WillRepeatedly(Invoke(invokeIOCtl));
+
+    // the second creation waits for the staged one, then only holds the published layer
+    std::thread first([&]() {
+        results[0] = layer_store_create(id.c_str(), layer_opt, nullptr, nullptr);
+    });
+    std::thread second([&]() {
+        results[1] = layer_store_create(id.c_str(), layer_opt, nullptr, nullptr);
+    });
+    first.join();
+    second.join();
+    ASSERT_EQ(results[0], 0);
+    ASSERT_EQ(results[1], 0);
+    ASSERT_EQ(layer_get_hold_refs(id.c_str(), &refs), 0);
+    ASSERT_EQ(refs, 2);
+
+    ASSERT_EQ(layer_store_create(id.c_str(), layer_opt, nullptr, nullptr), 0);
+    ASSERT_EQ(layer_get_hold_refs(id.c_str(), &refs), 0);
+    ASSERT_EQ(refs, 3);
+
+    ASSERT_EQ(layer_store_delete(id.c_str()), 0);
+    ASSERT_FALSE(LayerDirsExist(id));
+    free_layer_opts(layer_opt);
+}
+
+TEST_F(StorageLayersUnitTest, test_layer_store_publish_failure_rolls_back)
+{
+    if (!support_overlay) {
+        return;
+    }
+
+    std::string parent { "2b4d6f8a0c1e3a5c7e9b1d3f5a7c9e0b2d4f6a8c0e1b3d5f7a9c0e2b4d6f8a0c" };
+    std::string child { "8e6c4a2f0d9b7e5c3a1f2d4b6e8c0a9f7d5b3e1c2a4f6d8b0e9c7a5f3d1b2e4c" };
+    std::string failed { "1f3b5d7e9a2c4e6f8b0d1a3c5e7f9b2d4a6c8e0f1b3d5a7c9e2f4b6d8a0c1e3f" };
+    struct layer_opts *parent_opt = NewLayerOpts(nullptr, nullptr);
+    struct layer_opts *child_opt = NewLayerOpts(parent.c_str(), nullptr);
+    // the name is already taken by the hello-world layer, so the publish fails
+    struct layer_opts *failed_opt = NewLayerOpts(parent.c_str(), "hello_world:latest");
+    struct layer *l = nullptr;
+
+    ASSERT_NE(parent_opt, nullptr);
+    ASSERT_NE(child_opt, nullptr);
+    ASSERT_NE(failed_opt, nullptr);
+    EXPECT_CALL(m_driver_quota_mock, IOCtl(_, _)).WillRepeatedly(Invoke(invokeIOCtl));
+
+    ASSERT_EQ(layer_store_create(parent.c_str(), parent_opt, nullptr, nullptr), 0);
+    ASSERT_FALSE(layer_store_has_children(parent.c_str()));
+
+    ASSERT_NE(layer_store_create(failed.c_str(), failed_opt, nullptr, nullptr), 0);
+    ASSERT_EQ(layer_store_lookup(failed.c_str()), nullptr);
+    ASSERT_FALSE(LayerDirsExist(failed));
+    l = layer_store_lookup("hello_world:latest");
+    ASSERT_NE(l, nullptr);
+    ASSERT_STREQ(l->id, "9c27e219663c25e0f28493790cc0b88bc973ba3b1686355f221c38a36978ac63");
+    free_layer(l);
+    // the child recorded while staging goes with the failed layer
+    ASSERT_FALSE(layer_store_has_children(parent.c_str()));
+
+    ASSERT_EQ(layer_store_create(child.c_str(), child_opt, nullptr, nullptr), 0);
+    ASSERT_TRUE(layer_store_has_children(parent.c_str()));
+    ASSERT_NE(layer_store_create(failed.c_str(), failed_opt, nullptr, nullptr), 0);
+    ASSERT_TRUE(layer_store_has_children(parent.c_str()));
+
+    // only the published child is counted
+    ASSERT_EQ(layer_store_delete(child.c_str()), 0);
+    ASSERT_FALSE(layer_store_has_children(parent.c_str()));
+    ASSERT_EQ(layer_store_delete(parent.c_str()), 0);
+
+    free_layer_opts(parent_opt);
+    free_layer_opts(child_opt);
+    free_layer_opts(failed_opt);
+}
@@ -487,6 +487,52 @@ TEST_F(RemoteLayerUnitTest, test_layer_refresh2)
     clean_layer_home(overlay->overlay_home);
 }
 
+TEST_F(RemoteLayerUnitTest, test_apply_changes)
+{
+    flag = false;
+    remove_layer_flag = false;
+    struct remote_overlay_data *overlay = remote_overlay_create("overlay", "overlay/RO");
+    struct remote_layer_data *layer = remote_layer_create("layers", "layers/RO");
+    char **ids = NULL;
+    char **retry_ids = NULL;
+
+    if (prepare_layer_home(layer->layer_home, layer->layer_ro, overlay->overlay_home, overlay->overlay_ro, true) != 0) {
+        return;
+    }
+    ASSERT_EQ(util_list_all_subdir(overlay->overlay_ro, &ids), 0);
+    ASSERT_NE(ids, nullptr);
+
+    ASSERT_TRUE(remote_ro_entry_exists(overlay->overlay_ro, ids[0]));
+    ASSERT_FALSE(remote_ro_entry_exists(overlay->overlay_ro, "not_exist"));
+
+    remote_overlay_apply_changes(overlay, (const char **)ids, &retry_ids);
+    ASSERT_EQ(retry_ids, nullptr);
+    ASSERT_TRUE(remote_overlay_layer_valid(ids[0]));
+
+    remote_layer_apply_changes(layer, (const char **)ids, &retry_ids);
+    ASSERT_EQ(retry_ids, nullptr);
+    ASSERT_TRUE(remote_layer_layer_valid(ids[0]));
+
+    // applying the same changes again is a no-op
+    remote_layer_apply_changes(layer, (const char **)ids, &retry_ids);
+    ASSERT_EQ(retry_ids, nullptr);
+
+    util_scan_subdirs(overlay->overlay_ro, remove_layer, (void *)overlay->overlay_ro);
+    util_scan_subdirs(layer->layer_ro, remove_layer, (void *)layer->layer_ro);
+
+    remote_overlay_apply_changes(overlay, (const char **)ids, &retry_ids);
+    remote_layer_apply_changes(layer, (const char **)ids, &retry_ids);
+    ASSERT_EQ(retry_ids, nullptr);
+    ASSERT_FALSE(remote_overlay_layer_valid(ids[0]));
+    ASSERT_FALSE(remote_layer_layer_valid(ids[0]));
+
+    util_free_array(ids);
+    clean_layer_home(layer->layer_home);
+    clean_layer_home(overlay->overlay_home);
+    remote_layer_destroy(layer);
+    remote_overlay_destroy(overlay);
+}
+
 TEST(remote_support, start_thread)
 {
     pthread_rwlock_t g_rwlock;
@@ -191,6 +191,56 @@ TEST_F(StorageRootfsUnitTest, test_rootfs_store_exists)
     ASSERT_FALSE(rootfs_store_exists(incorrectId.c_str()));
 }
 
+TEST_F(StorageRootfsUnitTest, test_rootfs_store_get_image_user)
+{
+    std::string id { "5aca18b065db4741a9e24ff898cec48307ee12cb9ecec5dcb83e8210230f766f" };
+    std::string image { "39891ff67da98ab8540d71320915f33d2eb80ab42908e398472cab3c1ce7ac10" };
+    std::string layer { "f32ca140c6716a68d7bba0fe6529334e98de529bd8fb7a203a21f08e772629a9" };
+    char *user = nullptr;
+
+    ASSERT_EQ(rootfs_store_get_image_user(image.c_str(), &user), 0);
+    ASSERT_EQ(user, nullptr);
+
+    char *created_container = rootfs_store_create(id.c_str(), nullptr, 0, image.c_str(), layer.c_str(), "{}",
+                                                  nullptr);
+    ASSERT_STREQ(created_container, id.c_str());
+    ASSERT_EQ(rootfs_store_get_image_user(image.c_str(), &user), 0);
+    ASSERT_STREQ(user, id.c_str());
+    free(user);
+    user = nullptr;
+
+    ASSERT_EQ(rootfs_store_delete(id.c_str()), 0);
+    ASSERT_EQ(rootfs_store_get_image_user(image.c_str(), &user), 0);
+    ASSERT_EQ(user, nullptr);
+    free(created_container);
+}
+
+TEST_F(StorageRootfsUnitTest, test_rootfs_store_get_image_id)
+{
+    std::string id { "5aca18b065db4741a9e24ff898cec48307ee12cb9ecec5dcb83e8210230f766f" };
+    std::string image { "39891ff67da98ab8540d71320915f33d2eb80ab42908e398472cab3c1ce7ac10" };
+    std::string layer { "f32ca140c6716a68d7bba0fe6529334e98de529bd8fb7a203a21f08e772629a9" };
+    char *image_id = nullptr;
+
+    ASSERT_EQ(rootfs_store_get_image_id(id.c_str()), nullptr);
+
+    char *created_container = rootfs_store_create(id.c_str(), nullptr, 0, image.c_str(), layer.c_str(), "{}",
+                                                  nullptr);
+    ASSERT_STREQ(created_container, id.c_str());
+    image_id = rootfs_store_get_image_id(id.c_str());
+    ASSERT_STREQ(image_id, image.c_str());
+    free(image_id);
+
+    image_id = rootfs_store_get_image_id(ids.at(0).c_str());
+    ASSERT_STREQ(image_id, "e4db68de4ff27c2adfea0c54bbb73a61a42f5b667c326de4d7d5b19ab71c6a3b");
+    free(image_id);
+
+    ASSERT_EQ(rootfs_store_delete(id.c_str()), 0);
+    ASSERT_EQ(rootfs_store_get_image_id(id.c_str()), nullptr);
+    ASSERT_EQ(rootfs_store_get_image_id(nullptr), nullptr);
+    free(created_container);
+}
+
 TEST_F(StorageRootfsUnitTest, test_rootfs_store_get_all_rootfs)
 {
     std::string source = std::string(store_real_path) + "/overlay-containers/" + ids.at(0);
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: metrics callback unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "metrics_cb.h"
+#include "callback_mock.h"
+#include "rpc_stats.h"
+#include "utils.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+/* each mem sample is about 150 bytes, so all of them are far more than the old 1MB buffer */
+#define METRICS_UT_CONTAINERS 20000
+#define METRICS_UT_OLD_BUFFER_SIZE (1024 * 1024)
+
+static int g_stats_calls = 0;
+
+static std::string container_id(size_t i)
+{
+    std::string id = std::to_string(i);
+
+    return std::string(64 - id.length(), '0') + id;
+}
+
+static int fake_container_stats(const container_stats_request *request, container_stats_response **response)
+{
+    container_stats_response *resp = nullptr;
+    size_t i;
+
+    g_stats_calls++;
+    resp = (container_stats_response *)util_common_calloc_s(sizeof(container_stats_response));
+    if (resp == nullptr) {
+        return -1;
+    }
+    resp->container_stats = (container_info **)util_smart_calloc_s(sizeof(container_info *), METRICS_UT_CONTAINERS);
+    if (resp->container_stats == nullptr) {
+        free(resp);
+        return -1;
+    }
+
+    for (i = 0; i < METRICS_UT_CONTAINERS; i++) {
+        container_info *info = (container_info *)util_common_calloc_s(sizeof(container_info));
+        if (info == nullptr) {
+            free_container_stats_response(resp);
+            return -1;
+        }
+        info->id = util_strdup_s(container_id(i).c_str());
+        info->name = util_strdup_s(("container_" + std::to_string(i)).c_str());
+        info->image_type = util_strdup_s("oci");
+        info->mem_used = i * 1024;
+        info->mem_limit = (i + 1) * 1024 * 1024;
+        info->pids_current = i % 100;
+        resp->container_stats[i] = info;
+        resp->container_stats_len++;
+    }
+
+    *response = resp;
+    return 0;
+}
+
+static int collect_chunk(void *ctx, const char *data, size_t len)
+{
+    std::vector<std::string> *chunks = static_cast<std::vector<std::string> *>(ctx);
+
+    chunks->emplace_back(data, len);
+    return 0;
+}
+
+static size_t count_of(const std::string &text, const std::string &pattern)
+{
+    size_t count = 0;
+    size_t pos = text.find(pattern);
+
+    while (pos != std::string::npos) {
+        count++;
+        pos = text.find(pattern, pos + pattern.length());
+    }
+
+    return count;
+}
+
+/*
+ * The stats snapshot is process wide and kept for 5 seconds, the cases run in
+ * the order they are defined: the first one takes the only snapshot.
+ */
+class MetricsCallbackUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        (void)memset(&m_executor, 0, sizeof(m_executor));
+        m_executor.container.stats = fake_container_stats;
+        metrics_callback_init(&m_executor.metrics);
+        MockCallback_SetMock(&m_callback);
+        ON_CALL(m_callback, GetServiceExecutor()).WillByDefault(Return(&m_executor));
+    }
+
+    void TearDown() override
+    {
+        MockCallback_SetMock(nullptr);
+    }
+
+    std::string Export(const char *url, std::vector<std::string> &chunks)
+    {
+        std::string output;
+
+        chunks.clear();
+        EXPECT_EQ(m_executor.metrics.export_metrics_by_type(url, collect_chunk, &chunks), 0);
+        for (const auto &chunk : chunks) {
+            output += chunk;
+        }
+        return output;
+    }
+
+    service_executor_t m_executor;
+    NiceMock<MockCallback> m_callback;
+};
+
+TEST_F(MetricsCallbackUnitTest, test_export_large_output_is_not_truncated)
+{
+    std::vector<std::string> chunks;
+    std::string last = container_id(METRICS_UT_CONTAINERS - 1);
+    std::string output;
+
+    g_stats_calls = 0;
+    output = Export("mem", chunks);
+    ASSERT_EQ(g_stats_calls, 1);
+
+    // one chunk for the request counter and one for the mem family
+    ASSERT_EQ(chunks.size(), 2U);
+    ASSERT_GT(chunks[1].length(), (size_t)METRICS_UT_OLD_BUFFER_SIZE);
+    ASSERT_EQ(count_of(output, "isula_container_mem_stat{"), (size_t)METRICS_UT_CONTAINERS);
+    ASSERT_NE(output.find("container_id=\"" + last + "\",name=\"container_" +
+                          std::to_string(METRICS_UT_CONTAINERS - 1) + "\""), std::string::npos);
+    ASSERT_EQ(output.substr(output.length() - 2), "\n\n");
+
+    ASSERT_EQ(m_executor.metrics.export_metrics_by_type(nullptr, collect_chunk, &chunks), -1);
+    ASSERT_EQ(m_executor.metrics.export_metrics_by_type("mem", nullptr, &chunks), -1);
+}
+
+TEST_F(MetricsCallbackUnitTest, test_export_reuses_snapshot_in_refresh_window)
+{
+    std::vector<std::string> chunks;
+    std::string output;
+
+    g_stats_calls = 0;
+    output = Export("mem", chunks);
+    ASSERT_EQ(count_of(output, "isula_container_mem_stat{"), (size_t)METRICS_UT_CONTAINERS);
+    output = Export("pids", chunks);
+    ASSERT_EQ(count_of(output, "isula_container_pids{"), (size_t)METRICS_UT_CONTAINERS);
+    ASSERT_EQ(g_stats_calls, 0);
+
+    // cpu usage needs a previous snapshot, the family is left out until there is one
+    output = Export("cpu", chunks);
+    ASSERT_EQ(g_stats_calls, 0);
+    ASSERT_EQ(chunks.size(), 1U);
+    ASSERT_EQ(output.find("isula_container_cpu_stat"), std::string::npos);
+
+    // families without container stats never take a snapshot
+    output = Export("sys", chunks);
+    ASSERT_EQ(g_stats_calls, 0);
+}
+
+TEST_F(MetricsCallbackUnitTest, test_export_counter_and_gauge_text)
+{
+    std::vector<std::string> chunks;
+    std::string output;
+    std::string id = container_id(1);
+    unsigned int first = 0;
+    unsigned int second = 0;
+
+    output = Export("mem,pids", chunks);
+    ASSERT_EQ(output.find("# HELP isula_metrics_http_req_count is metrics server accepted request count\n"
+                          "# TYPE isula_metrics_http_req_count counter\n"
+                          "isula_metrics_http_req_count "), 0U);
+    first = (unsigned int)strtoul(chunks[0].c_str() + chunks[0].rfind(' ') + 1, nullptr, 10);
+
+    ASSERT_NE(output.find("# TYPE isula_container_mem_stat gauge\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_container_mem_stat{container_id=\"" + id +
+                          "\",name=\"container_1\",image_type=\"oci\",limit=\"2048 Kb\"} 1024\n"), std::string::npos);
+    ASSERT_NE(output.find("# TYPE isula_container_pids gauge\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_container_pids{container_id=\"" + id +
+                          "\",name=\"container_1\",image_type=\"oci\"} 1\n"), std::string::npos);
+
+    // every family ends with an empty line
+    for (const auto &chunk : chunks) {
+        ASSERT_EQ(chunk.substr(chunk.length() - 2), "\n\n");
+    }
+
+    (void)Export("sys", chunks);
+    second = (unsigned int)strtoul(chunks[0].c_str() + chunks[0].rfind(' ') + 1, nullptr, 10);
+    ASSERT_EQ(second, first + 1);
+    ASSERT_NE(chunks[1].find("# TYPE isula_daemon_mem_stat gauge\n"), std::string::npos);
+    ASSERT_NE(chunks[1].find("isula_daemon_mem_stat{section=\"vmrss\"} "), std::string::npos);
+}
+
+TEST_F(MetricsCallbackUnitTest, test_export_histogram_text)
+{
+    std::vector<std::string> chunks;
+    std::string output;
+    std::string name = "isula_metrics_stats_snapshot_seconds";
+    size_t pos = 0;
+    unsigned long long prev = 0;
+    size_t buckets = 0;
+
+    output = Export("sys", chunks);
+    ASSERT_NE(output.find("# TYPE " + name + " histogram\n"), std::string::npos);
+
+    // the buckets are cumulative and end with +Inf, the one snapshot taken is counted once
+    pos = output.find(name + "_bucket{le=\"");
+    while (pos != std::string::npos) {
+        size_t value = output.find("} ", pos) + 2;
+        unsigned long long count = strtoull(output.c_str() + value, nullptr, 10);
+
+        ASSERT_GE(count, prev);
+        prev = count;
+        buckets++;
+        pos = output.find(name + "_bucket{le=\"", value);
+    }
+    ASSERT_EQ(buckets, 12U);
+    ASSERT_NE(output.find(name + "_bucket{le=\"0.005\"} "), std::string::npos);
+    ASSERT_NE(output.find(name + "_bucket{le=\"10\"} "), std::string::npos);
+    ASSERT_NE(output.find(name + "_bucket{le=\"+Inf\"} 1\n" + name + "_sum "), std::string::npos);
+    ASSERT_NE(output.find(name + "_count 1\n"), std::string::npos);
+}
+
+TEST_F(MetricsCallbackUnitTest, test_export_rpc_histogram_text)
+{
+    std::vector<std::string> chunks;
+    std::string output;
+    std::string labels = "kind=\"grpc\",method=\"/metrics.ut/Call\"";
+    rpc_method_stats_t *stats = rpc_stats_method(RPC_STATS_KIND_GRPC, "/metrics.ut/Call");
+
+    ASSERT_NE(stats, nullptr);
+    rpc_stats_end(stats, rpc_stats_begin(stats), false);
+    rpc_stats_end(stats, rpc_stats_begin(stats), true);
+
+    output = Export("rpc", chunks);
+    ASSERT_NE(output.find("# TYPE isula_rpc_requests_total counter\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_requests_total{" + labels + "} 2\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_errors_total{" + labels + "} 1\n"), std::string::npos);
+    ASSERT_NE(output.find("# TYPE isula_rpc_in_flight gauge\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_in_flight{" + labels + "} 0\n"), std::string::npos);
+    ASSERT_NE(output.find("# TYPE isula_rpc_latency_seconds histogram\n"), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_latency_seconds_bucket{" + labels + ",le=\"0.000128\"} "), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_latency_seconds_bucket{" + labels + ",le=\"+Inf\"} 2\n"
+                          "isula_rpc_latency_seconds_sum{" + labels + "} "), std::string::npos);
+    ASSERT_NE(output.find("isula_rpc_latency_seconds_count{" + labels + "} 2\n"), std::string::npos);
+}
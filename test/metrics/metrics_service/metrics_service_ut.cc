@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: metrics service unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <string.h>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <event2/buffer.h>
+#include "metrics_service.h"
+#include "callback_mock.h"
+#include "evhtp_mock.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+#define METRICS_UT_FAMILY_SIZE (512 * 1024)
+#define METRICS_UT_FAMILIES 5
+
+static int fake_export_large(const char *metric_type, metrics_write_cb_t write_cb, void *ctx)
+{
+    int i;
+
+    for (i = 0; i < METRICS_UT_FAMILIES; i++) {
+        std::string family(METRICS_UT_FAMILY_SIZE, (char)('a' + i));
+
+        if (write_cb(ctx, family.c_str(), family.length()) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int fake_export_empty(const char *metric_type, metrics_write_cb_t write_cb, void *ctx)
+{
+    return write_cb(ctx, "", 0);
+}
+
+static int fake_export_failed(const char *metric_type, metrics_write_cb_t write_cb, void *ctx)
+{
+    return -1;
+}
+
+class MetricsServiceUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        (void)memset(&m_executor, 0, sizeof(m_executor));
+        (void)memset(&m_req, 0, sizeof(m_req));
+        (void)memset(&m_uri, 0, sizeof(m_uri));
+        (void)memset(&m_path, 0, sizeof(m_path));
+        m_path.full = m_full;
+        m_path.path = m_prefix;
+        m_uri.path = &m_path;
+        m_req.uri = &m_uri;
+
+        MockCallback_SetMock(&m_callback);
+        MockEvhtp_SetMock(&m_evhtp);
+        ON_CALL(m_callback, GetServiceExecutor()).WillByDefault(Return(&m_executor));
+    }
+
+    void TearDown() override
+    {
+        MockCallback_SetMock(nullptr);
+        MockEvhtp_SetMock(nullptr);
+    }
+
+    char m_full[32] = METRIC_GET_BY_TYPE "/all";
+    char m_prefix[32] = METRIC_GET_BY_TYPE;
+    service_executor_t m_executor;
+    evhtp_request_t m_req;
+    evhtp_uri_t m_uri;
+    evhtp_path_t m_path;
+    NiceMock<MockCallback> m_callback;
+    NiceMock<MockEvhtp> m_evhtp;
+};
+
+TEST_F(MetricsServiceUnitTest, test_reply_is_streamed_without_size_limit)
+{
+    std::string body;
+    int chunks = 0;
+
+    m_executor.metrics.export_metrics_by_type = fake_export_large;
+    EXPECT_CALL(m_evhtp, SendReplyChunkStart(&m_req, 200)).Times(1);
+    EXPECT_CALL(m_evhtp, SendReplyChunk(&m_req, _)).WillRepeatedly(Invoke([&](evhtp_request_t *req,
+                                                                               struct evbuffer *buf) {
+        size_t len = evbuffer_get_length(buf);
+        std::string data(len, '\0');
+
+        ASSERT_EQ(evbuffer_copyout(buf, &data[0], len), (ev_ssize_t)len);
+        body += data;
+        chunks++;
+    }));
+    EXPECT_CALL(m_evhtp, SendReplyChunkEnd(&m_req)).Times(1);
+    EXPECT_CALL(m_evhtp, SendReply(_, _)).Times(0);
+
+    metrics_get_by_type_cb(&m_req, nullptr);
+
+    // every family is its own chunk, all of them reach the client
+    ASSERT_EQ(chunks, METRICS_UT_FAMILIES);
+    ASSERT_EQ(body.length(), (size_t)METRICS_UT_FAMILY_SIZE * METRICS_UT_FAMILIES);
+    ASSERT_EQ(body.front(), 'a');
+    ASSERT_EQ(body.back(), (char)('a' + METRICS_UT_FAMILIES - 1));
+}
+
+TEST_F(MetricsServiceUnitTest, test_reply_fails_without_metrics)
+{
+    m_executor.metrics.export_metrics_by_type = fake_export_empty;
+    EXPECT_CALL(m_evhtp, SendReplyChunkStart(_, _)).Times(0);
+    EXPECT_CALL(m_evhtp, SendReplyChunk(_, _)).Times(0);
+    EXPECT_CALL(m_evhtp, SendReply(&m_req, 401)).Times(1);
+    metrics_get_by_type_cb(&m_req, nullptr);
+    testing::Mock::VerifyAndClearExpectations(&m_evhtp);
+
+    m_executor.metrics.export_metrics_by_type = fake_export_failed;
+    EXPECT_CALL(m_evhtp, SendReply(&m_req, 401)).Times(1);
+    metrics_get_by_type_cb(&m_req, nullptr);
+    testing::Mock::VerifyAndClearExpectations(&m_evhtp);
+
+    m_executor.metrics.export_metrics_by_type = nullptr;
+    EXPECT_CALL(m_evhtp, SendReply(&m_req, 501)).Times(1);
+    metrics_get_by_type_cb(&m_req, nullptr);
+}
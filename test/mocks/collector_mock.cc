@@ -50,3 +50,9 @@ int isulad_monitor_send_container_event(const char *name, runtime_state_t state,
     }
     return 0;
 }
+
+int monitord_post_msg(const struct monitord_msg *msg)
+{
+    (void)msg;
+    return -1;
+}
@@ -100,3 +100,41 @@ const char *container_state_to_string(Container_Status cs)
     }
     return "unknown";
 }
+
+char *container_state_get_started_at(container_state_t *s)
+{
+    if (g_container_state_mock != nullptr) {
+        return g_container_state_mock->StateGetStartedAt(s);
+    }
+    return nullptr;
+}
+
+uint32_t container_state_get_exitcode(container_state_t *s)
+{
+    if (g_container_state_mock != nullptr) {
+        return g_container_state_mock->StateGetExitcode(s);
+    }
+    return 0;
+}
+
+bool container_state_get_has_been_manual_stopped(container_state_t *s)
+{
+    if (g_container_state_mock != nullptr) {
+        return g_container_state_mock->StateGetHasBeenManualStopped(s);
+    }
+    return false;
+}
+
+void container_state_increase_restart_count(container_state_t *s)
+{
+    if (g_container_state_mock != nullptr) {
+        g_container_state_mock->StateIncreaseRestartCount(s);
+    }
+}
+
+void container_state_set_restarting(container_state_t *s, int exit_code)
+{
+    if (g_container_state_mock != nullptr) {
+        g_container_state_mock->StateSetRestarting(s, exit_code);
+    }
+}
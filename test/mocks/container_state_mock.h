@@ -31,6 +31,11 @@ public:
     MOCK_METHOD1(IsRemovalInProgress, bool(container_state_t *s));
     MOCK_METHOD1(ContainerStateGetStatus, Container_Status(container_state_t *s));
     MOCK_METHOD1(ContainerStatetoString, const char *(Container_Status cs));
+    MOCK_METHOD1(StateGetStartedAt, char *(container_state_t *s));
+    MOCK_METHOD1(StateGetExitcode, uint32_t(container_state_t *s));
+    MOCK_METHOD1(StateGetHasBeenManualStopped, bool(container_state_t *s));
+    MOCK_METHOD1(StateIncreaseRestartCount, void(container_state_t *s));
+    MOCK_METHOD2(StateSetRestarting, void(container_state_t *s, int exit_code));
 };
 
 void MockContainerState_SetMock(MockContainerState *mock);
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide evhtp reply mock
+ ******************************************************************************/
+
+#include "evhtp_mock.h"
+
+namespace {
+MockEvhtp *g_evhtp_mock = nullptr;
+}
+
+void MockEvhtp_SetMock(MockEvhtp *mock)
+{
+    g_evhtp_mock = mock;
+}
+
+void evhtp_send_reply(evhtp_request_t *request, evhtp_res code)
+{
+    if (g_evhtp_mock != nullptr) {
+        g_evhtp_mock->SendReply(request, code);
+    }
+}
+
+void evhtp_send_reply_chunk_start(evhtp_request_t *request, evhtp_res code)
+{
+    if (g_evhtp_mock != nullptr) {
+        g_evhtp_mock->SendReplyChunkStart(request, code);
+    }
+}
+
+void evhtp_send_reply_chunk(evhtp_request_t *request, struct evbuffer *buf)
+{
+    if (g_evhtp_mock != nullptr) {
+        g_evhtp_mock->SendReplyChunk(request, buf);
+    }
+}
+
+void evhtp_send_reply_chunk_end(evhtp_request_t *request)
+{
+    if (g_evhtp_mock != nullptr) {
+        g_evhtp_mock->SendReplyChunkEnd(request);
+    }
+}
+
+// the headers of the fake requests are not inspected
+evhtp_header_t *evhtp_header_new(const char *key, const char *val, char kalloc, char valloc)
+{
+    return nullptr;
+}
+
+void evhtp_headers_add_header(evhtp_headers_t *headers, evhtp_header_t *header)
+{
+}
@@ -0,0 +1,33 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide evhtp reply mock
+ ******************************************************************************/
+
+#ifndef _ISULAD_TEST_MOCKS_EVHTP_MOCK_H
+#define _ISULAD_TEST_MOCKS_EVHTP_MOCK_H
+
+#include <gmock/gmock.h>
+#include <evhtp.h>
+
+class MockEvhtp {
+public:
+    virtual ~MockEvhtp() = default;
+    MOCK_METHOD2(SendReply, void(evhtp_request_t *request, evhtp_res code));
+    MOCK_METHOD2(SendReplyChunkStart, void(evhtp_request_t *request, evhtp_res code));
+    MOCK_METHOD2(SendReplyChunk, void(evhtp_request_t *request, struct evbuffer *buf));
+    MOCK_METHOD1(SendReplyChunkEnd, void(evhtp_request_t *request));
+};
+
+void MockEvhtp_SetMock(MockEvhtp *mock);
+
+#endif
@@ -15,6 +15,9 @@
 
 #include "isulad_config_mock.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+
 static isulad_daemon_constants g_isulad_daemon_constants = {0};
 
 namespace {
@@ -42,6 +45,74 @@ char *conf_get_isulad_monitor_fifo_path()
     return nullptr;
 }
 
+const struct isulad_conf_snapshot *conf_get_snapshot(void)
+{
+    if (g_isulad_conf_mock != nullptr) {
+        return g_isulad_conf_mock->ConfGetSnapshot();
+    }
+    return nullptr;
+}
+
+const char *conf_snapshot_rootdir(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != nullptr ? snapshot->rootdir : nullptr;
+}
+
+const char *conf_snapshot_statedir(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != nullptr ? snapshot->statedir : nullptr;
+}
+
+const char *conf_snapshot_engine_rootpath(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != nullptr ? snapshot->engine_rootpath : nullptr;
+}
+
+const char *conf_snapshot_monitor_fifo_path(void)
+{
+    const struct isulad_conf_snapshot *snapshot = conf_get_snapshot();
+
+    return snapshot != nullptr ? snapshot->monitor_fifo_path : nullptr;
+}
+
+// the runtime root is still taken from GetRuntimeDir, so the old expectations keep working
+int conf_snapshot_routine_rootdir(const char *runtime, char *path, size_t len)
+{
+    char *dir = conf_get_routine_rootdir(runtime);
+    int nret;
+
+    if (dir == nullptr || path == nullptr) {
+        free(dir);
+        return -1;
+    }
+    nret = snprintf(path, len, "%s", dir);
+    free(dir);
+    return (nret < 0 || (size_t)nret >= len) ? -1 : 0;
+}
+
+int conf_snapshot_routine_statedir(const char *runtime, char *path, size_t len)
+{
+    const char *statedir = conf_snapshot_statedir();
+    int nret;
+
+    if (runtime == nullptr || statedir == nullptr || path == nullptr) {
+        return -1;
+    }
+    nret = snprintf(path, len, "%s/%s", statedir, runtime);
+    return (nret < 0 || (size_t)nret >= len) ? -1 : 0;
+}
+
+size_t conf_snapshot_retired_count(void)
+{
+    return 0;
+}
+
 int parse_log_opts(struct service_arguments *args, const char *key, const char *value)
 {
     if (g_isulad_conf_mock != nullptr) {
@@ -147,6 +218,14 @@ char *conf_get_isulad_rootdir()
     return nullptr;
 }
 
+char *conf_get_isulad_statedir()
+{
+    if (g_isulad_conf_mock != nullptr) {
+        return g_isulad_conf_mock->ConfGetIsuladStateDir();
+    }
+    return nullptr;
+}
+
 char *conf_get_sandbox_rootpath()
 {
     if (g_isulad_conf_mock != nullptr) {
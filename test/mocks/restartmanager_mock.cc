@@ -23,3 +23,20 @@ void MockRestartmanager_SetMock(MockRestartmanager *mock)
 {
     g_restartmanager_mock = mock;
 }
+
+bool restart_manager_should_restart(const char *id, uint32_t exit_code, bool has_been_manually_stopped,
+                                    int64_t exec_duration, uint64_t *timeout)
+{
+    if (g_restartmanager_mock != nullptr) {
+        return g_restartmanager_mock->ShouldRestart(id, exit_code, has_been_manually_stopped, exec_duration, timeout);
+    }
+    return false;
+}
+
+int container_restart_in_thread(const char *id, uint64_t timeout, int exit_code)
+{
+    if (g_restartmanager_mock != nullptr) {
+        return g_restartmanager_mock->RestartInThread(id, timeout, exit_code);
+    }
+    return 0;
+}
@@ -21,6 +21,9 @@
 
 class MockRestartmanager {
 public:
+    MOCK_METHOD5(ShouldRestart, bool(const char *id, uint32_t exit_code, bool has_been_manually_stopped,
+                                     int64_t exec_duration, uint64_t *timeout));
+    MOCK_METHOD3(RestartInThread, int(const char *id, uint64_t timeout, int exit_code));
 };
 
 void MockRestartmanager_SetMock(MockRestartmanager *mock);
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide service container api mock
+ ******************************************************************************/
+
+#include "service_container_api_mock.h"
+
+namespace {
+MockServiceContainerApi *g_service_container_api_mock = nullptr;
+}
+
+void MockServiceContainerApi_SetMock(MockServiceContainerApi *mock)
+{
+    g_service_container_api_mock = mock;
+}
+
+int clean_container_resource(const char *id, const char *runtime, pid_t pid)
+{
+    if (g_service_container_api_mock != nullptr) {
+        return g_service_container_api_mock->CleanContainerResource(id, runtime, pid);
+    }
+    return 0;
+}
+
+int set_container_to_removal(const container_t *cont)
+{
+    if (g_service_container_api_mock != nullptr) {
+        return g_service_container_api_mock->SetContainerToRemoval(cont);
+    }
+    return 0;
+}
+
+int delete_container(container_t *cont, bool force)
+{
+    if (g_service_container_api_mock != nullptr) {
+        return g_service_container_api_mock->DeleteContainer(cont, force);
+    }
+    return 0;
+}
+
+int stop_container(container_t *cont, int timeout, bool force, bool restart)
+{
+    if (g_service_container_api_mock != nullptr) {
+        return g_service_container_api_mock->StopContainer(cont, timeout, force, restart);
+    }
+    return 0;
+}
+
+int exec_container(const container_t *cont, const container_exec_request *request, container_exec_response *response,
+                   int stdinfd, struct io_write_wrapper *stdout_handler, struct io_write_wrapper *stderr_handler)
+{
+    if (g_service_container_api_mock != nullptr) {
+        return g_service_container_api_mock->ExecContainer(cont, request, response, stdinfd, stdout_handler,
+                                                           stderr_handler);
+    }
+    return 0;
+}
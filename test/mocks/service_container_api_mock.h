@@ -0,0 +1,35 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide service container api mock
+ ******************************************************************************/
+
+#ifndef _ISULAD_TEST_MOCKS_SERVICE_CONTAINER_API_MOCK_H
+#define _ISULAD_TEST_MOCKS_SERVICE_CONTAINER_API_MOCK_H
+
+#include <gmock/gmock.h>
+#include "service_container_api.h"
+
+class MockServiceContainerApi {
+public:
+    MOCK_METHOD3(CleanContainerResource, int(const char *id, const char *runtime, pid_t pid));
+    MOCK_METHOD1(SetContainerToRemoval, int(const container_t *cont));
+    MOCK_METHOD2(DeleteContainer, int(container_t *cont, bool force));
+    MOCK_METHOD4(StopContainer, int(container_t *cont, int timeout, bool force, bool restart));
+    MOCK_METHOD6(ExecContainer, int(const container_t *cont, const container_exec_request *request,
+                                    container_exec_response *response, int stdinfd,
+                                    struct io_write_wrapper *stdout_handler, struct io_write_wrapper *stderr_handler));
+};
+
+void MockServiceContainerApi_SetMock(MockServiceContainerApi *mock);
+
+#endif
@@ -73,6 +73,14 @@ int storage_img_set_big_data(const char *img_id, const char *key, const char *va
     return -1;
 }
 
+char *storage_img_get_big_data(const char *img_id, const char *key)
+{
+    if (g_storage_mock != nullptr) {
+        return g_storage_mock->StorageImgGetBigData(img_id, key);
+    }
+    return nullptr;
+}
+
 int storage_img_add_name(const char *img_id, const char *img_name)
 {
     if (g_storage_mock != nullptr) {
@@ -177,6 +185,14 @@ int storage_rootfs_umount(const char *container_id, bool force)
     return -1;
 }
 
+char *storage_rootfs_get_image_id(const char *container_id)
+{
+    if (g_storage_mock != nullptr) {
+        return g_storage_mock->StorageRootfsGetImageId(container_id);
+    }
+    return nullptr;
+}
+
 container_inspect_graph_driver *storage_get_metadata_by_container_id(const char *id)
 {
     if (g_storage_mock != nullptr) {
@@ -29,6 +29,7 @@ public:
     MOCK_METHOD1(StorageImgGet, imagetool_image * (const char *img_id));
     MOCK_METHOD1(StorageImgGetSummary, imagetool_image_summary * (const char *img_id));
     MOCK_METHOD3(StorageImgSetBigData, int(const char *img_id, const char *key, const char *val));
+    MOCK_METHOD2(StorageImgGetBigData, char *(const char *img_id, const char *key));
     MOCK_METHOD2(StorageImgAddName, int(const char *img_id, const char *img_name));
     MOCK_METHOD2(StorageImgDelete, int(const char *img_id, bool commit));
     MOCK_METHOD2(StorageImgSetLoadedTime, int(const char *img_id, types_timestamp_t *loaded_time));
@@ -42,6 +43,7 @@ public:
     MOCK_METHOD1(StorageDecHoldRefs, int(const char *layer_id));
     MOCK_METHOD1(StorageRootfsMount, char *(const char *container_id));
     MOCK_METHOD2(StorageRootfsUmount, int(const char *container_id, bool force));
+    MOCK_METHOD1(StorageRootfsGetImageId, char *(const char *container_id));
     MOCK_METHOD1(StorageGetMetadataByContainerId, container_inspect_graph_driver * (const char *id));
     MOCK_METHOD1(StorageLayerChainDelete, int (const char *layer_id));
 };
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide thread pool mock, tasks run inline unless the mock is set
+ ******************************************************************************/
+
+#include "utils_thread_pool_mock.h"
+
+#include <new>
+
+struct thread_pool {
+    size_t threads;
+};
+
+namespace {
+MockThreadPool *g_thread_pool_mock = nullptr;
+}
+
+void MockThreadPool_SetMock(MockThreadPool *mock)
+{
+    g_thread_pool_mock = mock;
+}
+
+thread_pool_t *util_thread_pool_new(size_t threads, size_t max_pending, const char *name)
+{
+    thread_pool_t *pool = new (std::nothrow) thread_pool_t;
+
+    if (pool != nullptr) {
+        pool->threads = threads == 0 ? 1 : threads;
+    }
+    return pool;
+}
+
+int util_thread_pool_submit(thread_pool_t *pool, thread_pool_task_cb_t cb, void *arg)
+{
+    if (g_thread_pool_mock != nullptr) {
+        return g_thread_pool_mock->Submit(pool, cb, arg);
+    }
+    if (pool == nullptr || cb == nullptr) {
+        return -1;
+    }
+    cb(arg);
+    return 0;
+}
+
+void util_thread_pool_wait(thread_pool_t *pool)
+{
+}
+
+void util_thread_pool_free(thread_pool_t *pool)
+{
+    delete pool;
+}
+
+size_t util_thread_pool_size(const thread_pool_t *pool)
+{
+    return pool == nullptr ? 0 : pool->threads;
+}
+
+size_t util_thread_pool_default_size(size_t max)
+{
+    return 1;
+}
@@ -0,0 +1,30 @@
+/******************************************************************************
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Author: isulad
+ * Create: 2026-10-18
+ * Description: provide thread pool mock
+ ******************************************************************************/
+
+#ifndef _ISULAD_TEST_MOCKS_UTILS_THREAD_POOL_MOCK_H
+#define _ISULAD_TEST_MOCKS_UTILS_THREAD_POOL_MOCK_H
+
+#include <gmock/gmock.h>
+#include "utils_thread_pool.h"
+
+class MockThreadPool {
+public:
+    virtual ~MockThreadPool() = default;
+    MOCK_METHOD3(Submit, int(thread_pool_t *, thread_pool_task_cb_t, void *));
+};
+
+void MockThreadPool_SetMock(MockThreadPool *mock);
+
+#endif // _ISULAD_TEST_MOCKS_UTILS_THREAD_POOL_MOCK_H
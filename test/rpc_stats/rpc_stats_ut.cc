@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: rpc stats unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "rpc_stats.h"
+
+TEST(rpc_stats, test_rpc_stats_method)
+{
+    ASSERT_EQ(rpc_stats_method(nullptr, "/a/b"), nullptr);
+    ASSERT_EQ(rpc_stats_method(RPC_STATS_KIND_GRPC, nullptr), nullptr);
+
+    rpc_method_stats_t *grpc = rpc_stats_method(RPC_STATS_KIND_GRPC, "/test.Service/Method");
+    rpc_method_stats_t *rest = rpc_stats_method(RPC_STATS_KIND_REST, "/test.Service/Method");
+    ASSERT_NE(grpc, nullptr);
+    ASSERT_NE(rest, nullptr);
+    ASSERT_NE(grpc, rest);
+    ASSERT_EQ(rpc_stats_method(RPC_STATS_KIND_GRPC, "/test.Service/Method"), grpc);
+
+    // nullptr stats is tolerated
+    rpc_stats_end(nullptr, rpc_stats_begin(nullptr), false);
+}
+
+TEST(rpc_stats, test_rpc_stats_latency)
+{
+    rpc_method_stats_t *stats = rpc_stats_method(RPC_STATS_KIND_GRPC, "/test.Service/Latency");
+    ASSERT_NE(stats, nullptr);
+
+    int64_t begin = rpc_stats_begin(stats);
+    ASSERT_EQ(stats->in_flight, 1);
+    usleep(2000);
+    rpc_stats_end(stats, begin, false);
+
+    begin = rpc_stats_begin(stats);
+    usleep(20000);
+    rpc_stats_end(stats, begin, true);
+
+    ASSERT_EQ(stats->in_flight, 0);
+    ASSERT_EQ(stats->calls, 2);
+    ASSERT_EQ(stats->errors, 1);
+    ASSERT_GE(stats->latency_max_us, 20000);
+    ASSERT_EQ(rpc_stats_latency_count_below(stats, 1024), 0);
+    ASSERT_EQ(rpc_stats_latency_count_below(stats, UINT64_MAX), 2);
+
+    // quantiles are within one sub bucket of the recorded value
+    uint64_t p50 = rpc_stats_latency_quantile_us(stats, 0.5);
+    ASSERT_GE(p50, 2000);
+    ASSERT_LT(p50, 20000);
+    ASSERT_EQ(rpc_stats_latency_quantile_us(stats, 0.99), stats->latency_max_us);
+}
+
+TEST(rpc_stats, test_rpc_stats_concurrent)
+{
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([]() {
+            for (int j = 0; j < 1000; j++) {
+                rpc_method_stats_t *stats = rpc_stats_method(RPC_STATS_KIND_REST, "/test.Service/Concurrent");
+                rpc_stats_end(stats, rpc_stats_begin(stats), false);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    rpc_method_stats_t *stats = rpc_stats_method(RPC_STATS_KIND_REST, "/test.Service/Concurrent");
+    ASSERT_EQ(stats->calls, 8000);
+    ASSERT_EQ(stats->in_flight, 0);
+    ASSERT_EQ(rpc_stats_latency_count_below(stats, UINT64_MAX), 8000);
+}
@@ -16,17 +16,24 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <gtest/gtest.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <signal.h>
 #include "mock.h"
 #include "isula_rt_ops.h"
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "engine_mock.h"
 #include "isulad_config_mock.h"
+#include "daemon_arguments.h"
+#include "isula_libutils/isulad_daemon_configs.h"
 #include "utils.h"
+#include "utils_file.h"
 
 using ::testing::Args;
 using ::testing::ByRef;
@@ -90,6 +97,45 @@ TEST_F(IsulaRtOpsUnitTest, test_rt_isula_start)
     ASSERT_EQ(rt_isula_start("123", "kata-runtime", &params, nullptr), -1);
 }
 
+TEST_F(IsulaRtOpsUnitTest, test_rt_isula_start_pid_sync_failed)
+{
+    rt_start_params_t params = {};
+    pid_ppid_info_t pid_info = {};
+    std::string workdir = "/tmp/isula_start_pid_sync_ut/123";
+    std::string sync_fifo = workdir + "/pid-sync";
+    struct timespec beg = { 0 };
+    struct timespec end = { 0 };
+
+    ASSERT_EQ(system(("mkdir -p " + workdir).c_str()), 0);
+    ASSERT_EQ(mkfifo(sync_fifo.c_str(), 0600), 0);
+
+    // fake shim: report a failed create after the daemon starts waiting
+    pid_t shim = fork();
+    ASSERT_GE(shim, 0);
+    if (shim == 0) {
+        usleep(200000);
+        int fd = open(sync_fifo.c_str(), O_WRONLY);
+        if (fd >= 0) {
+            (void)write(fd, "-1", 2);
+            close(fd);
+        }
+        pause();
+        _exit(0);
+    }
+    ASSERT_EQ(system(("echo " + std::to_string(shim) + " > " + workdir + "/shim-pid").c_str()), 0);
+
+    params.state = "/tmp/isula_start_pid_sync_ut";
+    ASSERT_EQ(clock_gettime(CLOCK_MONOTONIC, &beg), 0);
+    ASSERT_EQ(rt_isula_start("123", "kata-runtime", &params, &pid_info), -1);
+    ASSERT_EQ(clock_gettime(CLOCK_MONOTONIC, &end), 0);
+    ASSERT_LT(end.tv_sec - beg.tv_sec, 10);
+    ASSERT_FALSE(util_file_exists(sync_fifo.c_str()));
+
+    // failed start kills the shim
+    ASSERT_EQ(waitpid(shim, nullptr, 0), shim);
+    ASSERT_EQ(system("rm -rf /tmp/isula_start_pid_sync_ut"), 0);
+}
+
 TEST_F(IsulaRtOpsUnitTest, test_rt_isula_clean_resource)
 {
     rt_clean_params_t params = {};
@@ -134,6 +180,34 @@ TEST_F(IsulaRtOpsUnitTest, test_rt_isula_status)
     ASSERT_EQ(rt_isula_status("123", "kata-runtime", &params, &status), -1);
 }
 
+TEST_F(IsulaRtOpsUnitTest, test_rt_isula_status_without_runtime)
+{
+    rt_status_params_t params = {};
+    struct runtime_container_status_info status = {};
+    std::string workdir = "/tmp/isula_status_ut/123";
+    siginfo_t info = {};
+
+    ASSERT_EQ(system(("mkdir -p " + workdir).c_str()), 0);
+
+    // the test process acts as the shim, an unreaped child as the exited container
+    pid_t init = fork();
+    ASSERT_GE(init, 0);
+    if (init == 0) {
+        _exit(0);
+    }
+    ASSERT_EQ(waitid(P_PID, init, &info, WEXITED | WNOWAIT), 0);
+    ASSERT_EQ(system(("echo " + std::to_string(getpid()) + " > " + workdir + "/shim-pid").c_str()), 0);
+    ASSERT_EQ(system(("echo " + std::to_string(init) + " > " + workdir + "/pid").c_str()), 0);
+
+    // no runtime binary is called, so this must not fail
+    params.state = "/tmp/isula_status_ut";
+    ASSERT_EQ(rt_isula_status("123", "isula-ut-no-runtime", &params, &status), 0);
+    ASSERT_EQ(status.status, RUNTIME_CONTAINER_STATUS_STOPPED);
+
+    ASSERT_EQ(waitpid(init, nullptr, 0), init);
+    ASSERT_EQ(system("rm -rf /tmp/isula_status_ut"), 0);
+}
+
 TEST_F(IsulaRtOpsUnitTest, test_rt_isula_exec_resize)
 {
     rt_exec_resize_params_t params = {};
@@ -237,4 +311,237 @@ TEST_F(IsulaRtOpsUnitTest, test_rt_isula_listpids)
     ASSERT_EQ(rt_isula_listpids("123", nullptr, &params, &out), -1);
 
     ASSERT_EQ(rt_isula_listpids("123", "runc", &params, &out), -1);
-}
\ No newline at end of file
+}
+class IsulaRtOpsProbeExecUnitTest : public IsulaRtOpsUnitTest {
+public:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/isula_probe_exec_ut_XXXXXX";
+        parser_error err = nullptr;
+        const char *path = getenv("PATH");
+
+        IsulaRtOpsUnitTest::SetUp();
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+        m_oldPath = path != nullptr ? path : "";
+        // a fake isulad-shim in PATH tells whether the shim was used
+        ASSERT_EQ(setenv("PATH", (m_dir + ":" + m_oldPath).c_str(), 1), 0);
+
+        WriteScript(m_dir + "/isulad-shim",
+                    "echo \"$@\" > " + m_dir + "/shim-args\n"
+                    "echo $$ > pid\n");
+        WriteScript(m_dir + "/runtime",
+                    "pidfile=\"\"\n"
+                    "while [ $# -gt 0 ]; do\n"
+                    "    [ \"$1\" = \"--pid-file\" ] && pidfile=\"$2\"\n"
+                    "    shift\n"
+                    "done\n"
+                    "echo $PPID > " + m_dir + "/runtime-ppid\n"
+                    "echo $$ > " + m_dir + "/runtime-pid\n"
+                    "if [ -f " + m_dir + "/hang ]; then\n"
+                    "    sleep 100 &\n"
+                    "    echo $! > \"$pidfile\"\n"
+                    "    echo $! > " + m_dir + "/exec-pid\n"
+                    "    wait\n"
+                    "fi\n"
+                    "echo $$ > \"$pidfile\"\n"
+                    "echo probe output\n"
+                    "exit 3\n");
+
+        const std::string conf = "{\"runtimes\": {\"isula-ut-runtime\": {\"path\": \"" + m_dir + "/runtime\"}, "
+                                 "\"kata-runtime\": {\"path\": \"" + m_dir + "/runtime\"}}}";
+        m_args.json_confs = isulad_daemon_configs_parse_data(conf.c_str(), nullptr, &err);
+        free(err);
+        ASSERT_NE(m_args.json_confs, nullptr);
+        ON_CALL(m_isulad_conf, ConfGetServerConf()).WillByDefault(Return(&m_args));
+
+        m_stdout = m_dir + "/stdout";
+        m_stderr = m_dir + "/stderr";
+        m_fifos[1] = m_stdout.c_str();
+        m_fifos[2] = m_stderr.c_str();
+        m_params.rootpath = m_dir.c_str();
+        m_params.state = m_dir.c_str();
+        m_params.console_fifos = m_fifos;
+        m_params.suffix = "probe";
+        m_params.spec = &m_process;
+    }
+
+    void TearDown() override
+    {
+        free_isulad_daemon_configs(m_args.json_confs);
+        (void)setenv("PATH", m_oldPath.c_str(), 1);
+        (void)util_recursive_rmdir(m_dir.c_str(), 0);
+        IsulaRtOpsUnitTest::TearDown();
+    }
+
+    void WriteScript(const std::string &path, const std::string &body)
+    {
+        const std::string content = "#!/bin/sh\n" + body;
+
+        ASSERT_EQ(util_write_file(path.c_str(), content.c_str(), content.size(), 0700), 0);
+    }
+
+    int ReadInt(const std::string &name)
+    {
+        char *content = util_read_content_from_file((m_dir + "/" + name).c_str());
+        int val = -1;
+
+        if (content != nullptr) {
+            val = atoi(content);
+            free(content);
+        }
+        return val;
+    }
+
+    // a killed process which is not our child may linger as a zombie until it is reaped
+    static bool ProcessGone(int pid)
+    {
+        std::string stat = "/proc/" + std::to_string(pid) + "/stat";
+        int i;
+
+        for (i = 0; i < 500; i++) {
+            char *content = util_read_content_from_file(stat.c_str());
+            if (content == nullptr) {
+                return true;
+            }
+            const char *state = strrchr(content, ')');
+            bool zombie = state != nullptr && state[1] == ' ' && (state[2] == 'Z' || state[2] == 'X');
+            free(content);
+            if (zombie) {
+                return true;
+            }
+            usleep(10000);
+        }
+        return false;
+    }
+
+    // the runtime is forked by isulad itself only on the probe path
+    bool RuntimeForkedByIsulad()
+    {
+        return ReadInt("runtime-ppid") == getpid();
+    }
+
+    // a detached shim may still be starting when the exec returns
+    bool ShimUsed()
+    {
+        int i;
+
+        for (i = 0; i < 500; i++) {
+            if (util_file_exists((m_dir + "/shim-args").c_str())) {
+                return true;
+            }
+            usleep(10000);
+        }
+        return false;
+    }
+
+    std::string m_dir;
+    std::string m_oldPath;
+    std::string m_stdout;
+    std::string m_stderr;
+    const char *m_fifos[3] = { nullptr, nullptr, nullptr };
+    struct service_arguments m_args = {};
+    defs_process m_process = {};
+    rt_exec_params_t m_params = {};
+};
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_without_shim)
+{
+    int exit_code = 0;
+    char *output = nullptr;
+
+    ASSERT_EQ(rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code), 0);
+    ASSERT_EQ(exit_code, 3);
+    ASSERT_TRUE(RuntimeForkedByIsulad());
+    ASSERT_FALSE(ShimUsed());
+
+    output = util_read_content_from_file(m_stdout.c_str());
+    ASSERT_NE(output, nullptr);
+    ASSERT_STREQ(output, "probe output\n");
+    free(output);
+
+    // the exec workdir is removed
+    ASSERT_FALSE(util_dir_exists((m_dir + "/123/exec/probe").c_str()));
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_only_stderr)
+{
+    int exit_code = 0;
+
+    m_fifos[1] = nullptr;
+    ASSERT_EQ(rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code), 0);
+    ASSERT_EQ(exit_code, 3);
+    ASSERT_TRUE(RuntimeForkedByIsulad());
+    ASSERT_FALSE(ShimUsed());
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_disabled_with_tty)
+{
+    int exit_code = 0;
+
+    m_process.terminal = true;
+    (void)rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code);
+    ASSERT_TRUE(ShimUsed());
+    ASSERT_FALSE(RuntimeForkedByIsulad());
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_disabled_with_stdin)
+{
+    int exit_code = 0;
+    const std::string stdin_fifo = m_dir + "/stdin";
+
+    m_params.attach_stdin = true;
+    (void)rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code);
+    ASSERT_TRUE(ShimUsed());
+    ASSERT_FALSE(RuntimeForkedByIsulad());
+
+    ASSERT_EQ(unlink((m_dir + "/shim-args").c_str()), 0);
+    m_params.attach_stdin = false;
+    m_fifos[0] = stdin_fifo.c_str();
+    (void)rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code);
+    ASSERT_TRUE(ShimUsed());
+    ASSERT_FALSE(RuntimeForkedByIsulad());
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_disabled_for_kata)
+{
+    int exit_code = 0;
+
+    (void)rt_isula_exec("123", "kata-runtime", &m_params, &exit_code);
+    ASSERT_TRUE(ShimUsed());
+    ASSERT_FALSE(RuntimeForkedByIsulad());
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_disabled_without_output)
+{
+    int exit_code = 0;
+
+    // a detached exec has no fifos at all
+    m_fifos[1] = nullptr;
+    m_fifos[2] = nullptr;
+    (void)rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code);
+    ASSERT_TRUE(ShimUsed());
+    ASSERT_FALSE(RuntimeForkedByIsulad());
+}
+
+TEST_F(IsulaRtOpsProbeExecUnitTest, test_probe_exec_timeout)
+{
+    int exit_code = 0;
+    struct timespec beg = { 0 };
+    struct timespec end = { 0 };
+
+    ASSERT_EQ(util_write_file((m_dir + "/hang").c_str(), "1", 1, 0600), 0);
+    m_params.timeout = 1;
+
+    ASSERT_EQ(clock_gettime(CLOCK_MONOTONIC, &beg), 0);
+    ASSERT_EQ(rt_isula_exec("123", "isula-ut-runtime", &m_params, &exit_code), -1);
+    ASSERT_EQ(clock_gettime(CLOCK_MONOTONIC, &end), 0);
+    ASSERT_LT(end.tv_sec - beg.tv_sec, 10);
+    ASSERT_TRUE(RuntimeForkedByIsulad());
+
+    // both the exec process from the pid file and the runtime are killed
+    ASSERT_GT(ReadInt("exec-pid"), 0);
+    ASSERT_TRUE(ProcessGone(ReadInt("exec-pid")));
+    ASSERT_GT(ReadInt("runtime-pid"), 0);
+    ASSERT_TRUE(ProcessGone(ReadInt("runtime-pid")));
+}
@@ -15,7 +15,19 @@
 
 #include <gtest/gtest.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
 #include "sandbox.h"
+#include "sandbox_manager.h"
+#include "controller_manager.h"
+#include "id_name_manager.h"
+#include "isulad_config.h"
+#include "daemon_arguments.h"
+#include "utils.h"
+#include "utils_file.h"
 
 namespace sandbox {
 
@@ -58,6 +70,7 @@ TEST_F(SandboxTest, TestDefaultGetters)
     ASSERT_EQ(sandbox->GetStatsInfo().cpuUseNanos, 0);
     ASSERT_EQ(sandbox->GetNetworkReady(), false);
     ASSERT_STREQ(sandbox->GetNetMode().c_str(), DEFAULT_NETMODE.c_str());
+    ASSERT_TRUE(sandbox->GetNetworkSettings().empty());
 }
 
 TEST_F(SandboxTest, TestGettersAndSetters)
@@ -107,4 +120,176 @@ TEST_F(SandboxTest, TestGettersAndSetters)
     EXPECT_TRUE(sandbox->GetNetworkReady());
 }
 
-}
\ No newline at end of file
+static const int RESTORE_SANDBOX_COUNT = 6;
+
+static std::string SandboxIdOf(int i)
+{
+    char id[65] = { 0 };
+
+    (void)snprintf(id, sizeof(id), "%064x", i + 1);
+    return std::string(id);
+}
+
+static std::string SandboxNameOf(int i)
+{
+    return "restore_sandbox_" + std::to_string(i);
+}
+
+/*
+ * The conf, the controllers and the sandbox manager are process wide,
+ * they are set up once for all the cases of this suite.
+ */
+class SandboxRestoreTest : public testing::Test {
+protected:
+    static void SetUpTestCase()
+    {
+        Errors err;
+        parser_error perr = nullptr;
+        char tmpl[] = "/tmp/sandbox_ut_XXXXXX";
+        struct service_arguments *args = nullptr;
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+        m_rootdir = m_dir + "/root/sandbox";
+        m_statedir = m_dir + "/state/sandbox";
+
+        std::string conf = "{\"graph\": \"" + m_dir + "/root\", \"state\": \"" + m_dir + "/state\", "
+                           "\"cri-sandboxers\": {\"kuasar\": {\"name\": \"vmm\", \"address\": \"/tmp/vmm-sandboxer.sock\"}}}";
+        args = (struct service_arguments *)util_common_calloc_s(sizeof(struct service_arguments));
+        ASSERT_NE(args, nullptr);
+        args->json_confs = isulad_daemon_configs_parse_data(conf.c_str(), nullptr, &perr);
+        free(perr);
+        ASSERT_NE(args->json_confs, nullptr);
+        ASSERT_EQ(save_args_to_conf(args), 0);
+
+        // without a client mock every call of the vmm sandboxer succeeds
+        ASSERT_TRUE(ControllerManager::GetInstance()->Init(err));
+        ASSERT_EQ(id_name_manager_init(), 0);
+        ASSERT_TRUE(SandboxManager::GetInstance()->Init(err));
+    }
+
+    static void TearDownTestCase()
+    {
+        std::string command = "rm -rf " + m_dir;
+
+        id_name_manager_release();
+        (void)system(command.c_str());
+    }
+
+    // write the metadata, state and network settings of a sandbox as a running daemon would
+    static void SaveSandbox(const std::string &id, const std::string &name, const std::string &settings)
+    {
+        Errors err;
+        RuntimeInfo info = {"kata", "vmm", "kuasar"};
+        runtime::v1::PodSandboxConfig config;
+
+        (*config.mutable_labels())["app"] = name;
+        auto sandbox = std::make_shared<Sandbox>(id, m_rootdir, m_statedir, name, info, "cni",
+                                                 "/var/run/netns/" + name, config);
+        ASSERT_EQ(util_mkdir_p(sandbox->GetRootDir().c_str(), 0700), 0);
+        ASSERT_EQ(util_mkdir_p(sandbox->GetStateDir().c_str(), 0700), 0);
+        sandbox->SetNetworkSettings(settings, err);
+        ASSERT_TRUE(sandbox->Save(err));
+    }
+
+    static void WriteNetworkSettings(const std::string &id, const std::string &settings)
+    {
+        std::string path = m_rootdir + "/" + id + "/" + NETWORK_SETTINGS_JSON;
+
+        ASSERT_EQ(util_write_file(path.c_str(), settings.c_str(), settings.length(), 0600), 0);
+    }
+
+    static std::string m_dir;
+    static std::string m_rootdir;
+    static std::string m_statedir;
+};
+
+std::string SandboxRestoreTest::m_dir;
+std::string SandboxRestoreTest::m_rootdir;
+std::string SandboxRestoreTest::m_statedir;
+
+TEST_F(SandboxRestoreTest, TestRestoreSandboxesInParallel)
+{
+    Errors err;
+    std::string corruptId = SandboxIdOf(RESTORE_SANDBOX_COUNT);
+    std::string corruptMetadata = m_rootdir + "/" + corruptId + "/" + SANDBOX_METADATA_JSON;
+    std::vector<std::shared_ptr<Sandbox>> all;
+    auto manager = SandboxManager::GetInstance();
+
+    for (int i = 0; i < RESTORE_SANDBOX_COUNT; i++) {
+        SaveSandbox(SandboxIdOf(i), SandboxNameOf(i), "{}");
+    }
+    // a sandbox whose metadata is broken is dropped together with its directories
+    ASSERT_EQ(util_mkdir_p((m_rootdir + "/" + corruptId).c_str(), 0700), 0);
+    ASSERT_EQ(util_mkdir_p((m_statedir + "/" + corruptId).c_str(), 0700), 0);
+    ASSERT_EQ(util_write_file(corruptMetadata.c_str(), "{corrupt", strlen("{corrupt"), 0600), 0);
+
+    // more than one sandbox dir, so they are restored on the worker pool
+    ASSERT_TRUE(manager->RestoreSandboxes(err));
+    ASSERT_TRUE(err.Empty());
+
+    for (int i = 0; i < RESTORE_SANDBOX_COUNT; i++) {
+        std::string id = SandboxIdOf(i);
+        std::string name = SandboxNameOf(i);
+        std::vector<std::shared_ptr<Sandbox>> matched;
+        runtime::v1::PodSandboxFilter filter;
+        char *newId = nullptr;
+
+        auto sandbox = manager->GetSandbox(id);
+        ASSERT_NE(sandbox, nullptr);
+        EXPECT_EQ(sandbox->GetName(), name);
+        EXPECT_EQ(sandbox->GetSandboxer(), "vmm");
+        EXPECT_EQ(sandbox->GetNetNsPath(), "/var/run/netns/" + name);
+
+        // name index
+        EXPECT_EQ(manager->GetSandbox(name), sandbox);
+
+        // label index
+        (*filter.mutable_label_selector())["app"] = name;
+        manager->ListAllSandboxes(filter, matched);
+        ASSERT_EQ(matched.size(), 1U);
+        EXPECT_EQ(matched[0], sandbox);
+
+        // the name is reserved in the id name manager
+        EXPECT_FALSE(id_name_manager_add_entry_with_new_id(name.c_str(), &newId));
+        free(newId);
+    }
+
+    manager->ListAllSandboxes(runtime::v1::PodSandboxFilter::default_instance(), all);
+    EXPECT_EQ(all.size(), (size_t)RESTORE_SANDBOX_COUNT);
+    EXPECT_EQ(manager->GetSandbox(corruptId), nullptr);
+    EXPECT_FALSE(util_dir_exists((m_rootdir + "/" + corruptId).c_str()));
+    EXPECT_FALSE(util_dir_exists((m_statedir + "/" + corruptId).c_str()));
+}
+
+TEST_F(SandboxRestoreTest, TestNetworkSettingsLoadedOnFirstGet)
+{
+    Errors err;
+    std::string id = SandboxIdOf(RESTORE_SANDBOX_COUNT + 1);
+
+    SaveSandbox(id, "lazy_network_sandbox", "{\"saved\":true}");
+
+    auto sandbox = std::make_shared<Sandbox>(id, m_rootdir, m_statedir);
+    ASSERT_TRUE(sandbox->Load(err));
+    EXPECT_EQ(sandbox->GetName(), "lazy_network_sandbox");
+
+    // the file is not read by Load, the first get sees what is on disk now
+    WriteNetworkSettings(id, "{\"updated\":true}");
+    EXPECT_EQ(sandbox->GetNetworkSettings(), "{\"updated\":true}");
+
+    // later gets are served from memory
+    WriteNetworkSettings(id, "{\"ignored\":true}");
+    EXPECT_EQ(sandbox->GetNetworkSettings(), "{\"updated\":true}");
+
+    // settings set in memory count as loaded as well
+    auto other = std::make_shared<Sandbox>(id, m_rootdir, m_statedir);
+    ASSERT_TRUE(other->Load(err));
+    other->SetNetworkSettings("{\"set\":true}", err);
+    WriteNetworkSettings(id, "{\"ignored\":true}");
+    EXPECT_EQ(other->GetNetworkSettings(), "{\"set\":true}");
+
+    ASSERT_EQ(util_recursive_rmdir(sandbox->GetRootDir().c_str(), 0), 0);
+    ASSERT_EQ(util_recursive_rmdir(sandbox->GetStateDir().c_str(), 0), 0);
+}
+
+}
@@ -171,8 +171,11 @@ TEST_F(SandboxManagerTest, TestCreateSandbox)
     error.Clear();
 
     // testcase for sandbox create success
-    // create sandbox(id: randomly generated; name: "test2")
+    // create sandbox(id: randomly generated; name: "test2"; labels: "app=mysql")
+    auto labeledConfig = std::make_shared<runtime::v1::PodSandboxConfig>(sandboxConfig);
+    (*labeledConfig->mutable_labels())["app"] = "mysql";
     EXPECT_CALL(*m_sandbox, GetName).Times(1).WillOnce(testing::ReturnRef(name));
+    EXPECT_CALL(*m_sandbox, GetMutableSandboxConfig()).Times(1).WillOnce(testing::Return(labeledConfig));
     result = SandboxManager::GetInstance()->CreateSandbox(name, info, netNspath, netMode, sandboxConfig, error);
     ASSERT_NE(result, nullptr);
     ASSERT_NE(SandboxManager::GetInstance()->GetSandbox(name), nullptr);
@@ -219,18 +222,27 @@ TEST_F(SandboxManagerTest, TestListAllSandboxes)
     SandboxManager::GetInstance()->ListAllSandboxes(filters2, sandboxes2);
     EXPECT_EQ(sandboxes2.size(), 0);
 
+    // label selectors are answered from the label index, the sandbox config is not read again
+    EXPECT_CALL(*m_sandbox, GetMutableSandboxConfig()).Times(0);
+
     runtime::v1::PodSandboxFilter filters3;
     std::vector<std::shared_ptr<Sandbox>> sandboxes3;
-    auto sandboxConfig = runtime::v1::PodSandboxConfig::default_instance();
-    auto labels = sandboxConfig.mutable_labels();
-    (*labels)["app"] = "mysql";
     filters3.mutable_label_selector()->insert({"app", "nginx"});
-    auto expectedConfig = std::make_shared<runtime::v1::PodSandboxConfig>(sandboxConfig);
-    EXPECT_CALL(*m_sandbox, GetMutableSandboxConfig()).Times(4).WillRepeatedly(testing::Return(expectedConfig));
-    // auto sandboxConfig = runtime::v1::PodSandboxConfig::default_instance();
-    // EXPECT_CALL(*m_sandbox, GetSandboxConfig).Times(2).WillRepeatedly(testing::Return(sandboxConfig));
     SandboxManager::GetInstance()->ListAllSandboxes(filters3, sandboxes3);
-    EXPECT_EQ(sandboxes2.size(), 0);
+    EXPECT_EQ(sandboxes3.size(), 0);
+
+    runtime::v1::PodSandboxFilter filters4;
+    std::vector<std::shared_ptr<Sandbox>> sandboxes4;
+    filters4.mutable_label_selector()->insert({"app", "mysql"});
+    SandboxManager::GetInstance()->ListAllSandboxes(filters4, sandboxes4);
+    EXPECT_EQ(sandboxes4.size(), 1);
+
+    runtime::v1::PodSandboxFilter filters5;
+    std::vector<std::shared_ptr<Sandbox>> sandboxes5;
+    filters5.mutable_label_selector()->insert({"app", "mysql"});
+    filters5.mutable_label_selector()->insert({"tier", "db"});
+    SandboxManager::GetInstance()->ListAllSandboxes(filters5, sandboxes5);
+    EXPECT_EQ(sandboxes5.size(), 0);
 }
 
 TEST_F(SandboxManagerTest, TestDeleteSandbox)
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: sha256 digest reader unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <openssl/sha.h>
+#include <zlib.h>
+#include <gtest/gtest.h>
+#include "sha256.h"
+
+class Sha256DigestReaderUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/sha256_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+        m_file = m_dir + "/layer";
+    }
+
+    void TearDown() override
+    {
+        (void)unlink(m_file.c_str());
+        (void)rmdir(m_dir.c_str());
+    }
+
+    static std::string MakeData(size_t len, unsigned int seed)
+    {
+        std::string data(len, '\0');
+        size_t i;
+
+        for (i = 0; i < len; i++) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = (i % 3 == 0) ? (char)(seed >> 16) : 'a' + (char)(i % 26);
+        }
+        return data;
+    }
+
+    static std::string Digest(const std::string &data)
+    {
+        unsigned char hash[SHA256_DIGEST_LENGTH];
+        char hex[2 * SHA256_DIGEST_LENGTH + 1] = { 0 };
+        int i;
+
+        SHA256(reinterpret_cast<const unsigned char *>(data.data()), data.size(), hash);
+        for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+            (void)snprintf(hex + 2 * i, 3, "%02x", hash[i]);
+        }
+        return std::string("sha256:") + hex;
+    }
+
+    // one gzip member of data
+    static std::string Gzip(const std::string &data)
+    {
+        std::string out;
+        z_stream strm = {};
+        unsigned char buf[16384];
+        int nret;
+
+        EXPECT_EQ(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY), Z_OK);
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+        strm.avail_in = data.size();
+        do {
+            strm.next_out = buf;
+            strm.avail_out = sizeof(buf);
+            nret = deflate(&strm, Z_FINISH);
+            out.append(reinterpret_cast<char *>(buf), sizeof(buf) - strm.avail_out);
+        } while (nret == Z_OK);
+        EXPECT_EQ(nret, Z_STREAM_END);
+        deflateEnd(&strm);
+        return out;
+    }
+
+    void WriteFile(const std::string &data)
+    {
+        FILE *fp = fopen(m_file.c_str(), "w");
+
+        ASSERT_NE(fp, nullptr);
+        ASSERT_EQ(fwrite(data.data(), 1, data.size(), fp), data.size());
+        fclose(fp);
+    }
+
+    // read blob through the reader, return the data handed out
+    std::string ReadAll(char **compressed, char **uncompressed, int64_t *size)
+    {
+        std::string out;
+        const void *buf = nullptr;
+        ssize_t n;
+        int fd = open(m_file.c_str(), O_RDONLY);
+        sha256_digest_reader_t *reader = nullptr;
+
+        EXPECT_GE(fd, 0);
+        reader = sha256_digest_reader_new(fd);
+        EXPECT_NE(reader, nullptr);
+        if (reader == nullptr) {
+            close(fd);
+            return out;
+        }
+        while ((n = sha256_digest_reader_read(reader, &buf)) > 0) {
+            out.append(static_cast<const char *>(buf), n);
+        }
+        EXPECT_EQ(n, 0);
+        EXPECT_EQ(sha256_digest_reader_drain(reader), 0);
+        EXPECT_EQ(sha256_digest_reader_result(reader, compressed, uncompressed, size), 0);
+        sha256_digest_reader_free(reader);
+        close(fd);
+        return out;
+    }
+
+    std::string m_dir;
+    std::string m_file;
+};
+
+TEST_F(Sha256DigestReaderUnitTest, test_plain_blob)
+{
+    std::string tar = MakeData(300 * 1024 + 17, 1);
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int64_t size = 0;
+
+    WriteFile(tar);
+    ASSERT_EQ(ReadAll(&compressed, &uncompressed, &size), tar);
+    ASSERT_STREQ(compressed, Digest(tar).c_str());
+    ASSERT_STREQ(uncompressed, Digest(tar).c_str());
+    ASSERT_EQ(size, (int64_t)tar.size());
+    free(compressed);
+    free(uncompressed);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_short_plain_blob)
+{
+    // shorter than the gzip magic
+    std::string tar = "ab";
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int64_t size = 0;
+
+    WriteFile(tar);
+    ASSERT_EQ(ReadAll(&compressed, &uncompressed, &size), tar);
+    ASSERT_STREQ(uncompressed, Digest(tar).c_str());
+    ASSERT_EQ(size, 2);
+    free(compressed);
+    free(uncompressed);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_gzip_blob)
+{
+    std::string tar = MakeData(500 * 1024 + 3, 2);
+    std::string blob = Gzip(tar);
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int64_t size = 0;
+
+    WriteFile(blob);
+    ASSERT_EQ(ReadAll(&compressed, &uncompressed, &size), tar);
+    ASSERT_STREQ(compressed, Digest(blob).c_str());
+    ASSERT_STREQ(uncompressed, Digest(tar).c_str());
+    ASSERT_EQ(size, (int64_t)blob.size());
+    free(compressed);
+    free(uncompressed);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_multi_member_gzip_blob)
+{
+    std::string first = MakeData(200 * 1024, 3);
+    std::string second = MakeData(70 * 1024 + 9, 4);
+    std::string blob = Gzip(first) + Gzip(second);
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int64_t size = 0;
+
+    WriteFile(blob);
+    ASSERT_EQ(ReadAll(&compressed, &uncompressed, &size), first + second);
+    ASSERT_STREQ(compressed, Digest(blob).c_str());
+    ASSERT_STREQ(uncompressed, Digest(first + second).c_str());
+    free(compressed);
+    free(uncompressed);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_gzip_blob_with_trailing_data)
+{
+    std::string tar = MakeData(64 * 1024, 5);
+    std::string blob = Gzip(tar) + std::string(1000, '\0') + "garbage";
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int64_t size = 0;
+
+    WriteFile(blob);
+    // trailing data is ignored by the diff id, but is a part of the blob digest
+    ASSERT_EQ(ReadAll(&compressed, &uncompressed, &size), tar);
+    ASSERT_STREQ(compressed, Digest(blob).c_str());
+    ASSERT_STREQ(uncompressed, Digest(tar).c_str());
+    ASSERT_EQ(size, (int64_t)blob.size());
+    free(compressed);
+    free(uncompressed);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_truncated_gzip_blob)
+{
+    std::string blob = Gzip(MakeData(64 * 1024, 6));
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    int fd = -1;
+    sha256_digest_reader_t *reader = nullptr;
+
+    WriteFile(blob.substr(0, blob.size() / 2));
+    fd = open(m_file.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    reader = sha256_digest_reader_new(fd);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_NE(sha256_digest_reader_drain(reader), 0);
+    ASSERT_NE(sha256_digest_reader_result(reader, &compressed, &uncompressed, nullptr), 0);
+    sha256_digest_reader_free(reader);
+    close(fd);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_result_before_end)
+{
+    std::string tar = MakeData(300 * 1024, 7);
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+    const void *buf = nullptr;
+    int fd = -1;
+    sha256_digest_reader_t *reader = nullptr;
+
+    WriteFile(tar);
+    fd = open(m_file.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    reader = sha256_digest_reader_new(fd);
+    ASSERT_NE(reader, nullptr);
+    ASSERT_GT(sha256_digest_reader_read(reader, &buf), 0);
+    ASSERT_NE(sha256_digest_reader_result(reader, &compressed, &uncompressed, nullptr), 0);
+    sha256_digest_reader_free(reader);
+    close(fd);
+}
+
+TEST_F(Sha256DigestReaderUnitTest, test_sha256_full_layer_digests)
+{
+    std::string tar = MakeData(10 * 1024, 8);
+    std::string blob = Gzip(tar);
+    char *compressed = nullptr;
+    char *uncompressed = nullptr;
+
+    WriteFile(blob);
+    ASSERT_EQ(sha256_full_layer_digests(m_file.c_str(), &compressed, &uncompressed), 0);
+    ASSERT_STREQ(compressed, Digest(blob).c_str());
+    ASSERT_STREQ(uncompressed, Digest(tar).c_str());
+    free(compressed);
+    free(uncompressed);
+
+    ASSERT_NE(sha256_full_layer_digests(nullptr, &compressed, &uncompressed), 0);
+    ASSERT_EQ(sha256_digest_reader_new(-1), nullptr);
+}
@@ -15,11 +15,18 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include "mock.h"
 #include "isula_libutils/oci_runtime_spec.h"
 #include "specs_api.h"
 #include "specs_namespace.h"
+#include "specs_security.h"
 #include "isula_libutils/host_config.h"
 #include "isula_libutils/container_config.h"
 #include "oci_ut_common.h"
@@ -344,3 +351,186 @@ TEST_F(SpecsUnitTest, test_merge_container_cgroups_path_5)
 
     testing::Mock::VerifyAndClearExpectations(&m_isulad_conf);
 }
+
+#define SECCOMP_UT_PROFILE_HEAD "{\"defaultAction\": \"SCMP_ACT_ERRNO\", " \
+    "\"archMap\": [{\"architecture\": \"SCMP_ARCH_X86_64\", \"subArchitectures\": [\"SCMP_ARCH_X86\"]}, " \
+    "{\"architecture\": \"SCMP_ARCH_AARCH64\", \"subArchitectures\": [\"SCMP_ARCH_ARM\"]}], " \
+    "\"syscalls\": [" \
+    "{\"names\": [\"mount\", \"umount2\"], \"action\": \"SCMP_ACT_ALLOW\", \"args\": [], " \
+    "\"includes\": {\"caps\": [\"CAP_SYS_ADMIN\"]}, \"excludes\": {}}, " \
+    "{\"names\": [\"clone\"], \"action\": \"SCMP_ACT_ALLOW\", " \
+    "\"args\": [{\"index\": 0, \"value\": 2080505856, \"valueTwo\": 0, \"op\": \"SCMP_CMP_MASKED_EQ\"}], " \
+    "\"includes\": {}, \"excludes\": {\"caps\": [\"CAP_SYS_ADMIN\"]}}, " \
+    "{\"names\": [\"read\", \"write\", "
+#define SECCOMP_UT_PROFILE_TAIL "], \"action\": \"SCMP_ACT_ALLOW\", \"args\": [], \"includes\": {}, \"excludes\": {}}]}"
+
+class SpecsSeccompTemplateUnitTest : public testing::Test {
+protected:
+    void TearDown() override
+    {
+        (void)unlink(SECCOMP_DEFAULT_PATH);
+    }
+
+    // the default profile with one more allowed syscall, so profiles of different syscalls differ in content
+    static std::string Profile(const std::string &syscall)
+    {
+        return std::string(SECCOMP_UT_PROFILE_HEAD) + "\"" + syscall + "\"" + SECCOMP_UT_PROFILE_TAIL;
+    }
+
+    static void WriteProfile(const std::string &content, time_t mtime)
+    {
+        struct timespec times[2] = { { mtime, 0 }, { mtime, 0 } };
+
+        ASSERT_EQ(util_write_file(SECCOMP_DEFAULT_PATH, content.c_str(), content.size(), 0644), 0);
+        ASSERT_EQ(utimensat(AT_FDCWD, SECCOMP_DEFAULT_PATH, times, 0), 0);
+    }
+
+    static oci_runtime_spec *NewSpec(const std::vector<std::string> &caps)
+    {
+        oci_runtime_spec *oci_spec = (oci_runtime_spec *)util_common_calloc_s(sizeof(oci_runtime_spec));
+        size_t i;
+
+        oci_spec->process = (defs_process *)util_common_calloc_s(sizeof(defs_process));
+        oci_spec->process->capabilities =
+            (defs_process_capabilities *)util_common_calloc_s(sizeof(defs_process_capabilities));
+        oci_spec->process->capabilities->bounding = (char **)util_smart_calloc_s(sizeof(char *), caps.size() + 1);
+        for (i = 0; i < caps.size(); i++) {
+            oci_spec->process->capabilities->bounding[i] = util_strdup_s(caps[i].c_str());
+        }
+        oci_spec->process->capabilities->bounding_len = caps.size();
+        oci_spec->linux = (oci_runtime_config_linux *)util_common_calloc_s(sizeof(oci_runtime_config_linux));
+        return oci_spec;
+    }
+
+    static std::string ToJson(const oci_runtime_spec *oci_spec)
+    {
+        struct parser_context ctx = { OPT_PARSE_STRICT, stderr };
+        parser_error err = nullptr;
+        char *json = oci_runtime_spec_generate_json(oci_spec, &ctx, &err);
+        std::string result = json != nullptr ? json : "";
+
+        free(json);
+        free(err);
+        return result;
+    }
+
+    // the default seccomp profile as the container with caps gets it, through the template cache
+    static std::string DefaultSeccomp(const std::vector<std::string> &caps)
+    {
+        oci_runtime_spec *oci_spec = NewSpec(caps);
+        std::string json;
+
+        EXPECT_EQ(merge_default_seccomp_spec(oci_spec, oci_spec->process->capabilities), 0);
+        EXPECT_NE(oci_spec->linux->seccomp, nullptr);
+        json = ToJson(oci_spec);
+        free_oci_runtime_spec(oci_spec);
+        return json;
+    }
+
+    // the same profile translated without any cache, like a seccomp security opt is
+    static std::string FreshSeccomp(const std::vector<std::string> &caps, const std::string &profile)
+    {
+        oci_runtime_spec *oci_spec = NewSpec(caps);
+        std::string json;
+
+        EXPECT_EQ(merge_seccomp(oci_spec, profile.c_str()), 0);
+        EXPECT_NE(oci_spec->linux->seccomp, nullptr);
+        json = ToJson(oci_spec);
+        free_oci_runtime_spec(oci_spec);
+        return json;
+    }
+};
+
+TEST_F(SpecsSeccompTemplateUnitTest, test_cached_template_equals_fresh_translation)
+{
+    std::vector<std::string> caps = { "CAP_CHOWN", "CAP_KILL" };
+    std::vector<std::string> admin_caps = { "CAP_CHOWN", "CAP_KILL", "CAP_SYS_ADMIN" };
+    std::string profile = Profile("getpid");
+
+    WriteProfile(profile, 1000000);
+
+    std::string fresh = FreshSeccomp(caps, profile);
+    ASSERT_NE(fresh, "");
+    // the first call builds the template, the following ones copy it
+    ASSERT_EQ(DefaultSeccomp(caps), fresh);
+    ASSERT_EQ(DefaultSeccomp(caps), fresh);
+    ASSERT_EQ(DefaultSeccomp(caps), fresh);
+    ASSERT_EQ(fresh.find("\"mount\""), std::string::npos);
+    ASSERT_NE(fresh.find("\"clone\""), std::string::npos);
+
+    // templates are per capability set
+    std::string admin_fresh = FreshSeccomp(admin_caps, profile);
+    ASSERT_NE(admin_fresh, fresh);
+    ASSERT_EQ(DefaultSeccomp(admin_caps), admin_fresh);
+    ASSERT_EQ(DefaultSeccomp(admin_caps), admin_fresh);
+    ASSERT_NE(admin_fresh.find("\"mount\""), std::string::npos);
+    ASSERT_EQ(admin_fresh.find("\"clone\""), std::string::npos);
+    ASSERT_EQ(DefaultSeccomp(caps), fresh);
+}
+
+TEST_F(SpecsSeccompTemplateUnitTest, test_profile_change_invalidates_templates)
+{
+    std::vector<std::string> caps = { "CAP_CHOWN" };
+
+    WriteProfile(Profile("getpid"), 2000000);
+    ASSERT_NE(DefaultSeccomp(caps).find("\"getpid\""), std::string::npos);
+
+    // same size and mtime, the cached template is still used
+    WriteProfile(Profile("getuid"), 2000000);
+    ASSERT_NE(DefaultSeccomp(caps).find("\"getpid\""), std::string::npos);
+
+    // mtime change
+    WriteProfile(Profile("getuid"), 2000001);
+    std::string json = DefaultSeccomp(caps);
+    ASSERT_EQ(json, FreshSeccomp(caps, Profile("getuid")));
+    ASSERT_EQ(json.find("\"getpid\""), std::string::npos);
+
+    // size change with the same mtime
+    WriteProfile(Profile("getppid"), 2000001);
+    json = DefaultSeccomp(caps);
+    ASSERT_EQ(json, FreshSeccomp(caps, Profile("getppid")));
+    ASSERT_EQ(json.find("\"getuid\""), std::string::npos);
+
+    // a missing profile fails instead of using a stale template
+    ASSERT_EQ(unlink(SECCOMP_DEFAULT_PATH), 0);
+    oci_runtime_spec *oci_spec = NewSpec(caps);
+    ASSERT_EQ(merge_default_seccomp_spec(oci_spec, oci_spec->process->capabilities), -1);
+    free_oci_runtime_spec(oci_spec);
+}
+
+TEST_F(SpecsSeccompTemplateUnitTest, test_template_of_old_profile_is_not_cached)
+{
+    std::vector<std::string> caps = { "CAP_CHOWN" };
+    std::vector<std::string> syscalls = { "getpid", "getppid", "getuid", "geteuid", "getgid", "getegid" };
+    std::vector<std::thread> workers;
+    std::atomic<bool> stop(false);
+    std::string last;
+    size_t i;
+
+    WriteProfile(Profile(syscalls[0]), 3000000);
+
+    // templates are built without the lock while the profile keeps changing under them
+    for (i = 0; i < 4; i++) {
+        workers.emplace_back([&caps, &stop]() {
+            while (!stop.load()) {
+                oci_runtime_spec *oci_spec = NewSpec(caps);
+                (void)merge_default_seccomp_spec(oci_spec, oci_spec->process->capabilities);
+                free_oci_runtime_spec(oci_spec);
+            }
+        });
+    }
+    for (i = 1; i < 200; i++) {
+        struct timespec times[2] = { { (time_t)(3000000 + i), 0 }, { (time_t)(3000000 + i), 0 } };
+
+        last = Profile(syscalls[i % syscalls.size()]);
+        ASSERT_EQ(util_atomic_write_file(SECCOMP_DEFAULT_PATH, last.c_str(), last.size(), 0644, false), 0);
+        ASSERT_EQ(utimensat(AT_FDCWD, SECCOMP_DEFAULT_PATH, times, 0), 0);
+    }
+    stop = true;
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // whatever the workers raced, the cached template is the one of the last profile
+    ASSERT_EQ(DefaultSeccomp(caps), FreshSeccomp(caps, last));
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: util_archive tar split and digest unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <openssl/sha.h>
+#include <zlib.h>
+#include <gtest/gtest.h>
+#include "util_archive.h"
+
+#define TAR_BLOCK_SIZE 512
+
+class UtilArchiveDigestUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/util_archive_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+        m_layer = m_dir + "/layer";
+        m_split = m_dir + "/layer.tar-split";
+    }
+
+    void TearDown() override
+    {
+        (void)unlink(m_layer.c_str());
+        (void)unlink(m_split.c_str());
+        (void)rmdir(m_dir.c_str());
+    }
+
+    // ustar header and padded content of one regular file
+    static std::string TarFile(const std::string &name, const std::string &content)
+    {
+        std::string header(TAR_BLOCK_SIZE, '\0');
+        unsigned int sum = 0;
+        size_t i;
+
+        memcpy(&header[0], name.c_str(), name.size());
+        memcpy(&header[100], "0000644", 7);
+        memcpy(&header[108], "0000000", 7);
+        memcpy(&header[116], "0000000", 7);
+        (void)snprintf(&header[124], 12, "%011lo", (unsigned long)content.size());
+        memcpy(&header[136], "00000000000", 11);
+        header[156] = '0';
+        memcpy(&header[257], "ustar", 6);
+        memcpy(&header[263], "00", 2);
+        memset(&header[148], ' ', 8);
+        for (i = 0; i < TAR_BLOCK_SIZE; i++) {
+            sum += (unsigned char)header[i];
+        }
+        (void)snprintf(&header[148], 8, "%06o", sum);
+
+        std::string body = content;
+        body.resize((content.size() + TAR_BLOCK_SIZE - 1) / TAR_BLOCK_SIZE * TAR_BLOCK_SIZE, '\0');
+        return header + body;
+    }
+
+    static std::string MakeTar()
+    {
+        std::string big(100 * 1024 + 5, 'x');
+
+        return TarFile("hello", "hello world\n") + TarFile("dir-file", big) + std::string(2 * TAR_BLOCK_SIZE, '\0');
+    }
+
+    static std::string Digest(const std::string &data)
+    {
+        unsigned char hash[SHA256_DIGEST_LENGTH];
+        char hex[2 * SHA256_DIGEST_LENGTH + 1] = { 0 };
+        int i;
+
+        SHA256(reinterpret_cast<const unsigned char *>(data.data()), data.size(), hash);
+        for (i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+            (void)snprintf(hex + 2 * i, 3, "%02x", hash[i]);
+        }
+        return std::string("sha256:") + hex;
+    }
+
+    static std::string Gzip(const std::string &data)
+    {
+        std::string out;
+        z_stream strm = {};
+        unsigned char buf[16384];
+        int nret;
+
+        EXPECT_EQ(deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY), Z_OK);
+        strm.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+        strm.avail_in = data.size();
+        do {
+            strm.next_out = buf;
+            strm.avail_out = sizeof(buf);
+            nret = deflate(&strm, Z_FINISH);
+            out.append(reinterpret_cast<char *>(buf), sizeof(buf) - strm.avail_out);
+        } while (nret == Z_OK);
+        EXPECT_EQ(nret, Z_STREAM_END);
+        deflateEnd(&strm);
+        return out;
+    }
+
+    void WriteLayer(const std::string &data)
+    {
+        std::ofstream out(m_layer, std::ios::binary | std::ios::trunc);
+
+        ASSERT_TRUE(out.good());
+        out.write(data.data(), data.size());
+    }
+
+    std::string ReadSplit()
+    {
+        std::ifstream in(m_split, std::ios::binary);
+        std::stringstream ss;
+
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    // copy the layer and compare with the expected blob digest and diff id
+    void CheckDigests(const std::string &blob, const std::string &tar)
+    {
+        struct archive_layer_digests digests = { 0 };
+        int64_t size = 0;
+        int fd = -1;
+
+        WriteLayer(blob);
+        fd = open(m_layer.c_str(), O_RDONLY);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(archive_copy_oci_tar_split_and_digest(fd, m_split.c_str(), &size, &digests), 0);
+        close(fd);
+
+        ASSERT_STREQ(digests.compressed_digest, Digest(blob).c_str());
+        ASSERT_STREQ(digests.uncompressed_digest, Digest(tar).c_str());
+        ASSERT_EQ(digests.compressed_size, (int64_t)blob.size());
+        ASSERT_EQ(size, (int64_t)(strlen("hello world\n") + 100 * 1024 + 5));
+        free_archive_layer_digests(&digests);
+
+        std::string split = ReadSplit();
+        ASSERT_NE(split.find("\"name\":\"hello\""), std::string::npos);
+        ASSERT_NE(split.find("\"name\":\"dir-file\""), std::string::npos);
+    }
+
+    std::string m_dir;
+    std::string m_layer;
+    std::string m_split;
+};
+
+TEST_F(UtilArchiveDigestUnitTest, test_plain_layer)
+{
+    std::string tar = MakeTar();
+
+    CheckDigests(tar, tar);
+}
+
+TEST_F(UtilArchiveDigestUnitTest, test_plain_layer_with_padding)
+{
+    // padding after the end of archive is a part of diff id
+    std::string tar = MakeTar() + std::string(10 * TAR_BLOCK_SIZE, '\0');
+
+    CheckDigests(tar, tar);
+}
+
+TEST_F(UtilArchiveDigestUnitTest, test_gzip_layer)
+{
+    std::string tar = MakeTar();
+
+    CheckDigests(Gzip(tar), tar);
+}
+
+TEST_F(UtilArchiveDigestUnitTest, test_multi_member_gzip_layer)
+{
+    std::string tar = MakeTar();
+    size_t half = tar.size() / 2;
+
+    CheckDigests(Gzip(tar.substr(0, half)) + Gzip(tar.substr(half)), tar);
+}
+
+TEST_F(UtilArchiveDigestUnitTest, test_gzip_layer_with_trailing_data)
+{
+    std::string tar = MakeTar();
+
+    CheckDigests(Gzip(tar) + std::string(300, '\0'), tar);
+}
+
+TEST_F(UtilArchiveDigestUnitTest, test_invalid_layer)
+{
+    struct archive_layer_digests digests = { 0 };
+    int64_t size = 0;
+    std::string blob = Gzip(MakeTar());
+    int fd = -1;
+
+    // truncated gzip stream
+    WriteLayer(blob.substr(0, blob.size() / 2));
+    fd = open(m_layer.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    ASSERT_NE(archive_copy_oci_tar_split_and_digest(fd, m_split.c_str(), &size, &digests), 0);
+    close(fd);
+    free_archive_layer_digests(&digests);
+
+    ASSERT_NE(archive_copy_oci_tar_split_and_digest(-1, m_split.c_str(), &size, &digests), 0);
+    ASSERT_NE(archive_copy_oci_tar_split_and_digest(0, nullptr, &size, &digests), 0);
+    ASSERT_NE(archive_copy_oci_tar_split_and_digest(0, m_split.c_str(), &size, nullptr), 0);
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2026. All rights reserved.
+ * iSulad licensed under the Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *     http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR FIT FOR A PARTICULAR
+ * PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * Description: util_gzip unit test
+ * Author: isulad
+ * Create: 2026-10-18
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "util_gzip.h"
+
+#define GZIP_UT_BLOCK_SIZE (128 * 1024)
+
+class UtilGzipUnitTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        char tmpl[] = "/tmp/util_gzip_ut_XXXXXX";
+
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_dir = tmpl;
+        m_src = m_dir + "/src";
+        m_gz = m_dir + "/src.gz";
+        m_out = m_dir + "/out";
+    }
+
+    void TearDown() override
+    {
+        (void)unlink(m_src.c_str());
+        (void)unlink(m_gz.c_str());
+        (void)unlink(m_out.c_str());
+        (void)rmdir(m_dir.c_str());
+    }
+
+    // half random and half repeated text, so blocks both compress and reference the previous block
+    static std::vector<char> MakeData(size_t len)
+    {
+        std::vector<char> data(len);
+        unsigned int seed = 0x1234;
+        size_t i;
+
+        for (i = 0; i < len; i++) {
+            if ((i / 4096) % 2 == 0) {
+                seed = seed * 1103515245 + 12345;
+                data[i] = (char)(seed >> 16);
+            } else {
+                data[i] = "isulad layer tar split\n"[i % 23];
+            }
+        }
+        return data;
+    }
+
+    void WriteFile(const std::string &path, const std::vector<char> &data)
+    {
+        FILE *fp = fopen(path.c_str(), "w");
+
+        ASSERT_NE(fp, nullptr);
+        if (!data.empty()) {
+            ASSERT_EQ(fwrite(data.data(), 1, data.size(), fp), data.size());
+        }
+        fclose(fp);
+    }
+
+    std::vector<char> Decompress()
+    {
+        std::vector<char> data;
+        FILE *fp = fopen(m_out.c_str(), "w+");
+        char buf[4096];
+        size_t n;
+
+        EXPECT_NE(fp, nullptr);
+        if (fp == nullptr) {
+            return data;
+        }
+        EXPECT_EQ(util_gzip_d(m_gz.c_str(), fp), 0);
+        rewind(fp);
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) {
+            data.insert(data.end(), buf, buf + n);
+        }
+        fclose(fp);
+        return data;
+    }
+
+    void RoundTrip(size_t len, size_t threads)
+    {
+        std::vector<char> data = MakeData(len);
+
+        WriteFile(m_src, data);
+        ASSERT_EQ(util_gzip_z_parallel(m_src.c_str(), m_gz.c_str(), 0640, threads), 0);
+        std::vector<char> result = Decompress();
+        ASSERT_EQ(result.size(), data.size());
+        ASSERT_TRUE(result == data);
+    }
+
+    std::string m_dir;
+    std::string m_src;
+    std::string m_gz;
+    std::string m_out;
+};
+
+TEST_F(UtilGzipUnitTest, test_round_trip_just_over_parallel_threshold)
+{
+    // 2 blocks is the smallest input taking the parallel path
+    RoundTrip(2 * GZIP_UT_BLOCK_SIZE + 1, 2);
+}
+
+TEST_F(UtilGzipUnitTest, test_round_trip_more_than_one_batch)
+{
+    // 2 workers keep at most 4 blocks in flight, so this needs several batches and an odd tail
+    RoundTrip(23 * GZIP_UT_BLOCK_SIZE + 4321, 2);
+    RoundTrip(23 * GZIP_UT_BLOCK_SIZE + 4321, 8);
+}
+
+TEST_F(UtilGzipUnitTest, test_round_trip_serial_and_small)
+{
+    RoundTrip(4 * GZIP_UT_BLOCK_SIZE, 1);
+    RoundTrip(100, 4);
+    RoundTrip(0, 4);
+}
+
+TEST_F(UtilGzipUnitTest, test_parallel_writer_empty_stream)
+{
+    struct io_write_wrapper writer = { 0 };
+    int fd = open(m_gz.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0640);
+
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(util_gzip_parallel_writer_new(fd, 4, &writer), 0);
+    ASSERT_EQ(writer.close_func(writer.context, nullptr), 0);
+    close(fd);
+
+    ASSERT_TRUE(Decompress().empty());
+}
+
+TEST_F(UtilGzipUnitTest, test_parallel_writer_odd_writes)
+{
+    std::vector<char> data = MakeData(9 * GZIP_UT_BLOCK_SIZE + 77);
+    struct io_write_wrapper writer = { 0 };
+    size_t off = 0;
+    size_t step = 1;
+    int fd = open(m_gz.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0640);
+
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(util_gzip_parallel_writer_new(fd, 3, &writer), 0);
+    // writes of varying sizes cross block boundaries at different offsets
+    while (off < data.size()) {
+        size_t len = std::min(step, data.size() - off);
+        ASSERT_EQ(writer.write_func(writer.context, data.data() + off, len), (ssize_t)len);
+        off += len;
+        step = step * 3 + 7;
+    }
+    ASSERT_EQ(writer.close_func(writer.context, nullptr), 0);
+    close(fd);
+
+    ASSERT_TRUE(Decompress() == data);
+}
+
+TEST(util_gzip, test_invalid_args)
+{
+    struct io_write_wrapper writer = { 0 };
+
+    ASSERT_NE(util_gzip_z_parallel(nullptr, "/tmp/x", 0640, 2), 0);
+    ASSERT_NE(util_gzip_parallel_writer_new(-1, 2, &writer), 0);
+    ASSERT_NE(util_gzip_parallel_writer_new(1, 2, nullptr), 0);
+}